@@ -20,8 +20,10 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "adc.h"
+#include "dma.h"
 #include "i2c.h"
 #include "spi.h"
+#include "tim.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -30,7 +32,29 @@
 #include "lcd.h"
 #include "gui.h"
 #include "test.h"
-//#include "Power_SW.h"
+#include "sched.h"
+#include "console.h"
+#include "lpm.h"
+#include "acq.h"
+#include "i2c_bus.h"
+#include "timestamp.h"
+#include "Power_SW.h"
+#include "log.h"
+#include "key.h"
+#include "boot.h"
+#include "clock.h"
+#include "cal.h"
+#include "cap.h"
+#include "stats.h"
+#include "ripple.h"
+#include "charge.h"
+#include "capacity.h"
+#include "cable.h"
+#include "strip.h"
+#include "frame.h"
+#include "backlight.h"
+#include "tile.h"
+#include <string.h>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -42,9 +66,8 @@
 /* USER CODE BEGIN PD */
 #define debug 0
 
-#define PWR_On HAL_GPIO_WritePin(PWR_EN_GPIO_Port,PWR_EN_Pin,GPIO_PIN_SET)
-
-#define PWR_Off HAL_GPIO_WritePin(PWR_EN_GPIO_Port,PWR_EN_Pin,GPIO_PIN_RESET)
+#define APP_SIG_TICK      0		//UI: page timer, key signals follow (KEY_SIG_x)
+#define APP_RETRY_MS      20		//page change put off while the display strips are lent
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -55,6 +78,8 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
+static sched_timer_t bus_timer;
+static sched_timer_t ui_timer;
 
 /* USER CODE END PV */
 
@@ -66,6 +91,213 @@ void SystemClock_Config(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+/*****************************************************************************
+ * @name       :static void App_BusTask(uint8_t sig, uint32_t arg)
+ * @date       :2026-10-19
+ * @function   :I2C queue service and RTC discipline. Woken by the bus on
+                submit/completion, otherwise sleeps until the timestamp
+                state machine or the transfer watchdog is due.
+ * @parameters :sig,arg:unused
+ * @retvalue   :None
+******************************************************************************/
+static void App_BusTask(uint8_t sig, uint32_t arg)
+{
+	uint32_t due;
+
+	I2C_Bus_Process();
+	due = TS_Process();
+	if(!I2C_Bus_Idle() && due > I2C_BUS_TIMEOUT_MS)
+		due = I2C_BUS_TIMEOUT_MS;
+	Sched_TimerStart(&bus_timer, SCHED_TASK_BUS, I2C_BUS_SIG, due, 0);
+}
+
+static void App_PowerTask(uint8_t sig, uint32_t arg)
+{
+	if(sig == CLOCK_SIG_RETRY)
+		Clock_Process(sig);
+	else if(sig != BOOT_SIG_STEP)
+		Power_Process(sig);
+	else if(Boot_Process())
+		Sched_Signal(SCHED_TASK_UI, APP_SIG_TICK);	//display is up, start the UI
+}
+
+static void App_LogTask(uint8_t sig, uint32_t arg)
+{
+	if(sig == CAL_SIG_TEMP || sig == CAL_SIG_POLL)
+		Cal_Process(sig);
+	else if(sig == CAP_SIG_POLL)
+		Cap_Process(sig);
+	else if(sig == CAPACITY_SIG_POLL)
+		Capacity_Process(sig);
+	else
+		Log_Process(sig);
+}
+
+static void App_AcqTask(uint8_t sig, uint32_t arg)
+{
+	if(sig == ACQ_SIG_BLOCK)
+		Acq_Process(arg);
+	else if(sig == ACQ_SIG_BURST)
+		Acq_BurstDone();
+}
+
+//the panel is up and lit, and the tile strips are not lent out (Tile_Lend())
+static uint8_t App_CanDraw(void)
+{
+	return Boot_DisplayReady() && Backlight_Visible() && !Tile_Lent();
+}
+
+static void App_UiTask(uint8_t sig, uint32_t arg)
+{
+	static uint8_t wake_keys;		//keys that woke the screen, ignored until released
+	static uint8_t page_due;		//page change put off while the screen is dark
+	key_event_t ev;
+	uint8_t next = (sig == APP_SIG_TICK);
+	uint16_t dwell;
+
+	if(sig == KEY_SIG_EDGE || sig == KEY_SIG_TIMER)
+		Key_Process(sig);
+	if(sig == BL_SIG_IDLE || sig == BL_SIG_STEP)
+		Backlight_Process(sig);
+	while(Key_GetEvent(&ev))
+	{
+		if(Backlight_Wake() && ev.type != KEY_EV_RELEASE)
+			wake_keys |= ev.keys;	//the key that wakes the screen does nothing else
+		else if(ev.type == KEY_EV_PRESS)
+			wake_keys &= ~ev.keys;	//its release was lost in a full queue
+		if(ev.keys & wake_keys)
+		{
+			if(ev.type == KEY_EV_RELEASE)
+				wake_keys &= ~ev.keys;
+			continue;
+		}
+		if(ev.type == KEY_EV_LONG && ev.keys == KEY_MASK_ENTER)
+			Power_Shutdown();
+		else if(ev.type == KEY_EV_CHORD && ev.keys == (KEY_MASK_UP | KEY_MASK_DOWN))
+			Cap_Trigger();	//manual capture trigger
+		else if(ev.type == KEY_EV_CLICK || ev.type == KEY_EV_REPEAT)
+			next = 1;		//a key skips to the next page
+	}
+	if(sig == STRIP_SIG_LINE && App_CanDraw())
+	{
+		LCD_FrameStart();		//the strip page holds the full profile while it is up
+		Strip_Draw();
+		LCD_FrameEnd();
+	}
+	if(sig == FRAME_SIG_TICK && App_CanDraw())
+		Frame_Process();
+	if(page_due && Backlight_Visible())
+		next = 1;		//the screen is back, show the page that was due
+	if(!next || !Boot_DisplayReady())
+		return;
+	page_due = !Backlight_Visible();
+	if(page_due)
+		return;			//no redraw and no page timer while nothing is shown
+	if(Tile_Lent())
+	{
+		Sched_TimerStart(&ui_timer, SCHED_TASK_UI, APP_SIG_TICK, APP_RETRY_MS, 0);
+		return;
+	}
+	Clock_Require(CLOCK_USER_UI, CLOCK_FULL);		//full SPI1 rate for the redraw
+	LCD_FrameStart();
+	dwell = Demo_Step();
+	LCD_FrameEnd();
+	Clock_Require(CLOCK_USER_UI, CLOCK_IDLE);
+	Sched_TimerStart(&ui_timer, SCHED_TASK_UI, 0, dwell, 0);
+}
+
+static void App_TelemTask(uint8_t sig, uint32_t arg)
+{
+	if(sig == CONSOLE_SIG_LINE)
+		Console_Process();
+	else
+		Ripple_Process(sig, arg);
+}
+
+static void App_CmdTasks(const char *args)
+{
+	Sched_Report();
+}
+
+static void App_CmdLpm(const char *args)
+{
+	LPM_Report();
+}
+
+static void App_CmdPower(const char *args)
+{
+	Power_Report();
+	Log_Report();
+}
+
+static void App_CmdBoot(const char *args)
+{
+	Boot_Report();
+}
+
+static void App_CmdClock(const char *args)
+{
+	static const char * const name[CLOCK_NUM] = {"idle", "log", "full"};
+	uint8_t i;
+
+	if(strcmp(args, "auto") == 0)
+		Clock_Force(CLOCK_AUTO);
+	for(i = 0; i < CLOCK_NUM; i++)
+		if(strcmp(args, name[i]) == 0)
+			Clock_Force(i);
+	Clock_Report();
+}
+
+static void App_CmdCal(const char *args)
+{
+	Cal_Command(args);
+}
+
+static void App_CmdCap(const char *args)
+{
+	Cap_Command(args);
+}
+
+static void App_CmdStats(const char *args)
+{
+	Stats_Command(args);
+}
+
+static void App_CmdRipple(const char *args)
+{
+	Ripple_Command(args);
+}
+
+static void App_CmdCharge(const char *args)
+{
+	Charge_Report();
+}
+
+static void App_CmdCapacity(const char *args)
+{
+	Capacity_Command(args);
+}
+
+static void App_CmdCable(const char *args)
+{
+	Cable_Command(args);
+}
+
+static void App_CmdLcd(const char *args)
+{
+	LCD_Report();
+	Frame_Command(args);
+}
+
+static void App_CmdBl(const char *args)
+{
+	Backlight_Command(args);
+}
+
+static void App_CmdTime(const char *args)
+{
+	TS_Command(args);
+}
 
 /* USER CODE END 0 */
 
@@ -76,7 +308,7 @@ void SystemClock_Config(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
-	uint16_t t;
+
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -97,66 +329,52 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_ADC1_Init();
   MX_ADC2_Init();
   MX_I2C1_Init();
   MX_SPI1_Init();
   MX_SPI2_Init();
   MX_USART1_UART_Init();
+  MX_TIM3_Init();
   /* USER CODE BEGIN 2 */
-//  if(HAL_GPIO_ReadPin(Key_down_GPIO_Port,Key_down_Pin) == GPIO_PIN_RESET)
-//  {
-//	  HAL_Delay(10);
-//	  if(HAL_GPIO_ReadPin(Key_down_GPIO_Port,Key_down_Pin) == GPIO_PIN_RESET)
-//	  {
-		  HAL_Delay(2500);
-		  PWR_On;
-//	  }
-//  }
-	LCD_Init();
+	Sched_Init();
+	Clock_Init();
+	LPM_Init();
+	Sched_Register(SCHED_TASK_ACQ, "acq", App_AcqTask);
+	Sched_Register(SCHED_TASK_BUS, "bus", App_BusTask);
+	Sched_Register(SCHED_TASK_POWER, "power", App_PowerTask);
+	Sched_Register(SCHED_TASK_LOG, "log", App_LogTask);
+	Sched_Register(SCHED_TASK_UI, "ui", App_UiTask);
+	Sched_Register(SCHED_TASK_TELEM, "telem", App_TelemTask);
+	Key_Init();
+	Console_Init();
+	Console_Register("tasks", App_CmdTasks, "task runtime since last call");
+	Console_Register("lpm", App_CmdLpm, "power mode residency since last call");
+	Console_Register("power", App_CmdPower, "supply state, battery and log status");
+	Console_Register("boot", App_CmdBoot, "boot phase timestamps");
+	Console_Register("clock", App_CmdClock, "clock profile [idle|log|full|auto]");
+	Console_Register("cal", App_CmdCal, "calibration [<ch> <value>|<ch> reset|<ch> tc <ppm>|save]");
+	Console_Register("cap", App_CmdCap, "transient capture [over|slope <mA>|drop <mV>|key|pre <n>|fast|frames|off]");
+	Console_Register("stats", App_CmdStats, "load statistics [win|hist|reset]");
+	Console_Register("ripple", App_CmdRipple, "ripple spectrum <i4a|i100m|uin|bat> [n]");
+	Console_Register("charge", App_CmdCharge, "supply plateau and negotiation steps");
+	Console_Register("capacity", App_CmdCapacity, "capacity test [start [imin_mA [umin_mV [hold_s [timeout_min]]]]|stop]");
+	Console_Register("cable", App_CmdCable, "supply path resistance from load steps [reset]");
+	Console_Register("bl", App_CmdBl, "backlight and display sleep [<percent>|dim <s>|off <s>]");
+	Console_Register("lcd", App_CmdLcd, "display traffic and frame pacing since last call [fps <n>]");
+	Console_Register("time", App_CmdTime, "wall clock, RTC flags and drift [YYYY-MM-DD HH:MM:SS|sync]");
+	I2C_Bus_Init();
+	TS_Init();			//RTC read runs on the I2C DMA from here
+	Boot_Start();		//PWR_EN, ADC, flash now; panel bring-up on timers
+	Power_Init();
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-		main_test(); 		//
-		menu_test();     //3D˵ʾ
-		
-	#if debug
-	LCD_LED_Off;
-	#endif
-	  
-		Test_Color();  		//ˢ
-	  
-	#if debug
-	LCD_LED_On;
-	#endif
-	  
-		Test_FillRec();		//GUIλͼ
-	  
-	#if debug
-	LCD_LED_On;
-	#endif
-		//	Test_Triangle();    //GUIλͼ
-		//	English_Font_test();//Ӣʾ
-		//	Chinese_Font_test();//ʾ
-		Pic_test();			//ͼƬʾʾ
-		//	Rotate_Test();   //תʾ
-		
-//		LCD_LED_Off;
-//		HAL_Delay(1000);
-//		LCD_LED_On;
-//		HAL_Delay(1000);
-//	  if(HAL_GPIO_ReadPin(Key_down_GPIO_Port,Key_down_Pin) == GPIO_PIN_RESET)
-//	  {
-//		  t ++;
-//		  if(t == 2)
-//		  {
-//			  t = 0;
-			  PWR_Off;
-//		  }
-//	  }
+		Sched_Run();		//dispatches tasks, never returns
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
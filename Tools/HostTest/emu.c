@@ -0,0 +1,383 @@
+#include "emu.h"
+#include "main.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+emu_stat_t emu_stat;
+
+static uint16_t gram[EMU_ROWS][EMU_COLS];
+static uint8_t cs = 1, rs, res = 1;
+static uint8_t cmd, arg[8], nargs;
+static uint16_t xs, xe = EMU_COLS - 1, ys, ye = EMU_ROWS - 1, cx, cy;
+static uint8_t madctl, hi, have_hi, writing;
+static uint8_t asleep = 1, on, idle;
+static uint16_t tfa, vsa = EMU_ROWS, vsp;
+
+void Emu_Reset(void)
+{
+	memset(gram, 0, sizeof(gram));
+	memset(&emu_stat, 0, sizeof(emu_stat));
+	cmd = nargs = writing = 0;
+	xs = ys = 0;
+	xe = EMU_COLS - 1;
+	ye = EMU_ROWS - 1;
+	madctl = 0;
+	asleep = 1;
+	on = idle = 0;
+	tfa = vsp = 0;
+	vsa = EMU_ROWS;
+}
+
+void Emu_Pin(uint16_t pin, int level)
+{
+	if(pin == TFT_CS_Pin)
+	{
+		cs = level;
+		have_hi = 0;
+	}
+	else if(pin == TFT_RS_Pin)
+		rs = level;
+	else if(pin == TFT_RES_Pin)
+	{
+		if(res && !level)
+			Emu_Reset();
+		res = level;
+	}
+}
+
+//logical address to frame memory column and panel line, as MADCTL maps it
+static void Emu_Map(uint16_t x, uint16_t y, uint16_t *col, uint16_t *line)
+{
+	uint16_t c = x, r = y;
+
+	if(madctl & 0x20)   //MV
+	{
+		c = y;
+		r = x;
+	}
+	if(madctl & 0x40)   //MX
+		c = EMU_COLS - 1 - c;
+	if(madctl & 0x80)   //MY
+		r = EMU_ROWS - 1 - r;
+	*col = c;
+	*line = r;
+}
+
+static void Emu_Command(uint8_t b)
+{
+	cmd = b;
+	nargs = 0;
+	writing = 0;
+	emu_stat.cmds++;
+	switch(b)
+	{
+		case 0x01: Emu_Reset(); break;              //SWRESET
+		case 0x10: asleep = 1; break;               //SLPIN
+		case 0x11: asleep = 0; break;               //SLPOUT
+		case 0x28: on = 0; break;                   //DISPOFF
+		case 0x29: on = 1; break;                   //DISPON
+		case 0x38: idle = 0; break;                 //IDMOFF
+		case 0x39: idle = 1; break;                 //IDMON
+		case 0x2C:                                  //RAMWR
+			cx = xs;
+			cy = ys;
+			writing = 1;
+			break;
+		case 0x3C: writing = 1; break;              //RAMWRC
+		default: break;
+	}
+}
+
+static void Emu_Data(uint8_t b)
+{
+	uint16_t c, r;
+
+	if(writing)
+	{
+		if(!have_hi)
+		{
+			hi = b;
+			have_hi = 1;
+			return;
+		}
+		have_hi = 0;
+		if(cy > ye)
+			return;
+		Emu_Map(cx, cy, &c, &r);
+		if(c < EMU_COLS && r < EMU_ROWS)
+			gram[r][c] = hi << 8 | b;
+		emu_stat.pixels++;
+		if(++cx > xe)
+		{
+			cx = xs;
+			cy++;
+		}
+		return;
+	}
+	if(nargs < sizeof(arg))
+		arg[nargs] = b;
+	nargs++;
+	switch(cmd)
+	{
+		case 0x2A:
+			if(nargs == 4)
+			{
+				xs = arg[0] << 8 | arg[1];
+				xe = arg[2] << 8 | arg[3];
+				emu_stat.windows++;
+			}
+			break;
+		case 0x2B:
+			if(nargs == 4)
+			{
+				ys = arg[0] << 8 | arg[1];
+				ye = arg[2] << 8 | arg[3];
+			}
+			break;
+		case 0x36:
+			if(nargs == 1)
+				madctl = b;
+			break;
+		case 0x33:
+			if(nargs == 6)
+			{
+				tfa = arg[0] << 8 | arg[1];
+				vsa = arg[2] << 8 | arg[3];
+				if(tfa + vsa + (arg[4] << 8 | arg[5]) != EMU_ROWS || vsa == 0)
+				{
+					fprintf(stderr, "emu: VSCRDEF %u+%u+%u does not cover the frame memory\n",
+					        tfa, vsa, arg[4] << 8 | arg[5]);
+					tfa = 0;
+					vsa = EMU_ROWS;
+				}
+			}
+			break;
+		case 0x37:
+			if(nargs == 2)
+				vsp = arg[0] << 8 | arg[1];
+			break;
+		default:
+			break;
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Emu_Bytes(const uint8_t *b, uint16_t n, uint32_t sck_hz)
+ * @function   :One SPI transfer to the panel, a command or data as RS
+                says. Counted with its wire time at the given clock.
+ * @parameters :b:bytes
+                n:number of bytes
+                sck_hz:SPI clock
+ * @retvalue   :None
+******************************************************************************/
+void Emu_Bytes(const uint8_t *b, uint16_t n, uint32_t sck_hz)
+{
+	uint16_t i;
+
+	if(cs)
+	{
+		emu_stat.stray += n;
+		return;
+	}
+	emu_stat.xfers++;
+	emu_stat.bytes += n;
+	emu_stat.wire_ns += (uint64_t)n * 8 * 1000000000 / sck_hz;
+	if(asleep || !on)
+		emu_stat.dark += n;
+	for(i = 0; i < n; i++)
+	{
+		if(rs)
+			Emu_Data(b[i]);
+		else
+			Emu_Command(b[i]);
+	}
+}
+
+//what the panel shows at a position of the drawing orientation
+uint16_t Emu_Pixel(uint16_t x, uint16_t y)
+{
+	uint16_t c, l, r;
+	uint16_t p;
+
+	Emu_Map(x, y, &c, &l);
+	r = l;
+	if(l >= tfa && l < tfa + vsa)
+		r = tfa + (l - tfa + vsp - tfa + vsa) % vsa;
+	p = gram[r % EMU_ROWS][c % EMU_COLS];
+	if(idle)
+		p &= 0x8410;    //8 colours, the MSB of each channel
+	return p;
+}
+
+uint8_t Emu_Visible(void)
+{
+	return !asleep && on;
+}
+
+static void Emu_Rgb(uint16_t p, uint8_t *o)
+{
+	o[0] = (p >> 11 & 0x1F) << 3 | (p >> 13 & 0x07);
+	o[1] = (p >> 5 & 0x3F) << 2 | (p >> 9 & 0x03);
+	o[2] = (p & 0x1F) << 3 | (p >> 2 & 0x07);
+}
+
+static void Emu_Chunk(FILE *f, const char *type, const uint8_t *d, uint32_t n)
+{
+	uint8_t be[4] = {n >> 24, n >> 16, n >> 8, n};
+	uLong crc = crc32(0, (const Bytef *)type, 4);
+
+	crc = crc32(crc, d, n);
+	fwrite(be, 1, 4, f);
+	fwrite(type, 1, 4, f);
+	fwrite(d, 1, n, f);
+	be[0] = crc >> 24;
+	be[1] = crc >> 16;
+	be[2] = crc >> 8;
+	be[3] = crc;
+	fwrite(be, 1, 4, f);
+}
+
+//the panel as unfiltered RGB rows, each led by its filter byte
+static uint8_t *Emu_Rows(uint16_t w, uint16_t h)
+{
+	uint32_t stride = 1 + 3 * w;
+	uint8_t *raw = calloc(h, stride);
+	uint16_t x, y;
+
+	for(y = 0; raw && y < h; y++)
+		for(x = 0; x < w; x++)
+			Emu_Rgb(Emu_Pixel(x, y), raw + y * stride + 1 + 3 * x);
+	return raw;
+}
+
+/*****************************************************************************
+ * @name       :int Emu_WritePng(const char *path, uint16_t w, uint16_t h)
+ * @function   :Save the panel area w x h of the drawing orientation as an
+                8-bit RGB PNG
+ * @retvalue   :0 on success
+******************************************************************************/
+int Emu_WritePng(const char *path, uint16_t w, uint16_t h)
+{
+	static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	uint8_t ihdr[13] = {0, 0, w >> 8, w, 0, 0, h >> 8, h, 8, 2, 0, 0, 0};
+	uLong raw_n = (uLong)h * (1 + 3 * w), z_n = compressBound(raw_n);
+	uint8_t *raw = Emu_Rows(w, h), *z = malloc(z_n);
+	FILE *f = fopen(path, "wb");
+	int rc = -1;
+
+	if(raw && z && f && compress2(z, &z_n, raw, raw_n, 9) == Z_OK)
+	{
+		fwrite(sig, 1, sizeof(sig), f);
+		Emu_Chunk(f, "IHDR", ihdr, sizeof(ihdr));
+		Emu_Chunk(f, "IDAT", z, z_n);
+		Emu_Chunk(f, "IEND", NULL, 0);
+		rc = ferror(f) ? -1 : 0;
+	}
+	if(f)
+		fclose(f);
+	free(raw);
+	free(z);
+	return rc;
+}
+
+static uint32_t Emu_Be32(const uint8_t *b)
+{
+	return (uint32_t)b[0] << 24 | b[1] << 16 | b[2] << 8 | b[3];
+}
+
+static uint8_t Emu_Paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+	int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+
+	return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+//undo the PNG row filters in place, 3 bytes per pixel
+static int Emu_Unfilter(uint8_t *raw, uint16_t w, uint16_t h)
+{
+	uint32_t stride = 1 + 3 * w, i;
+	uint16_t y;
+
+	for(y = 0; y < h; y++)
+	{
+		uint8_t *r = raw + y * stride + 1, *u = y ? r - stride : NULL;
+
+		for(i = 0; i < 3U * w; i++)
+		{
+			uint8_t a = i >= 3 ? r[i - 3] : 0, b = u ? u[i] : 0, c = u && i >= 3 ? u[i - 3] : 0;
+
+			switch(r[-1])
+			{
+				case 0: break;
+				case 1: r[i] += a; break;
+				case 2: r[i] += b; break;
+				case 3: r[i] += (a + b) / 2; break;
+				case 4: r[i] += Emu_Paeth(a, b, c); break;
+				default: return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+/*****************************************************************************
+ * @name       :long Emu_ComparePng(const char *path, uint16_t w, uint16_t h)
+ * @function   :Compare the panel area w x h with an 8-bit RGB PNG
+ * @retvalue   :pixels that differ, -1 when the file is missing or not an
+                image of that size and format
+******************************************************************************/
+long Emu_ComparePng(const char *path, uint16_t w, uint16_t h)
+{
+	FILE *f = fopen(path, "rb");
+	uint8_t *file = NULL, *z = NULL, *raw = NULL, *ref = NULL;
+	long n = 0, pos = 8, diff = -1;
+	uint32_t zn = 0;
+	uLong raw_n = (uLong)h * (1 + 3 * w);
+	uint16_t x, y;
+
+	if(!f)
+		return -1;
+	fseek(f, 0, SEEK_END);
+	n = ftell(f);
+	rewind(f);
+	file = malloc(n);
+	z = malloc(n);
+	ref = malloc(raw_n);
+	if(!file || !z || !ref || fread(file, 1, n, f) != (size_t)n || n < 8 + 25)
+		goto out;
+	if(memcmp(file + 1, "PNG", 3) || Emu_Be32(file + 16) != w || Emu_Be32(file + 20) != h ||
+	   file[24] != 8 || file[25] != 2 || file[28] != 0)
+		goto out;
+	while(pos + 12 <= n)
+	{
+		uint32_t len = Emu_Be32(file + pos);
+
+		if(pos + 12 + len > (uint32_t)n)
+			goto out;
+		if(memcmp(file + pos + 4, "IDAT", 4) == 0)
+		{
+			memcpy(z + zn, file + pos + 8, len);
+			zn += len;
+		}
+		pos += 12 + len;
+	}
+	if(uncompress(ref, &raw_n, z, zn) != Z_OK || raw_n != (uLong)h * (1 + 3 * w) || Emu_Unfilter(ref, w, h))
+		goto out;
+	raw = Emu_Rows(w, h);
+	if(!raw)
+		goto out;
+	diff = 0;
+	for(y = 0; y < h; y++)
+		for(x = 0; x < w; x++)
+			if(memcmp(raw + y * (1 + 3 * w) + 1 + 3 * x, ref + y * (1 + 3 * w) + 1 + 3 * x, 3))
+				diff++;
+out:
+	fclose(f);
+	free(file);
+	free(z);
+	free(raw);
+	free(ref);
+	return diff;
+}
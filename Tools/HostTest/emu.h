@@ -0,0 +1,36 @@
+#ifndef __EMU_H
+#define __EMU_H
+
+#include <stdint.h>
+
+//ST7789 model behind the mocked SPI1 and the TFT_CS/RS/RES pins. The byte
+//stream is decoded as the controller would (CASET, RASET, RAMWR, MADCTL,
+//VSCRDEF, VSCSAD, sleep, display and idle mode) into a 240x320 frame
+//memory. Pixels are read back through the current MADCTL and scroll
+//settings, i.e. as the panel shows them in the drawing orientation.
+#define EMU_COLS            240
+#define EMU_ROWS            320
+
+typedef struct
+{
+	uint32_t xfers;         //SPI transfers while CS was low
+	uint32_t bytes;         //bytes on the wire, commands included
+	uint32_t cmds;          //command bytes
+	uint32_t windows;       //CASET commands
+	uint32_t pixels;        //pixels written to the frame memory
+	uint32_t dark;          //bytes sent while the panel was asleep or off
+	uint32_t stray;         //bytes sent with CS high, lost on hardware
+	uint64_t wire_ns;       //modelled transfer time at the SPI1 clock
+} emu_stat_t;
+
+extern emu_stat_t emu_stat;
+
+void Emu_Reset(void);
+void Emu_Pin(uint16_t pin, int level);
+void Emu_Bytes(const uint8_t *b, uint16_t n, uint32_t sck_hz);
+uint16_t Emu_Pixel(uint16_t x, uint16_t y);
+uint8_t Emu_Visible(void);
+int Emu_WritePng(const char *path, uint16_t w, uint16_t h);
+long Emu_ComparePng(const char *path, uint16_t w, uint16_t h);
+
+#endif
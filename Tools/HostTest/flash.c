@@ -0,0 +1,68 @@
+//W25Qxx driver functions the firmware sources call, on a RAM model of the
+//chip (flash.h).
+#include "w25qxx.h"
+#include "flash.h"
+#include <string.h>
+
+#define W25_SECTOR_SIZE   4096
+#define W25_PAGE_SIZE     256
+
+w25qxx_t w25qxx = {.ID = W25Q16, .PageSize = W25_PAGE_SIZE, .PageCount = FLASH_SECTORS * 16,
+                   .SectorSize = W25_SECTOR_SIZE, .SectorCount = FLASH_SECTORS};
+flash_stat_t flash_stat;
+uint8_t flash_mem[FLASH_SECTORS * W25_SECTOR_SIZE];
+
+static int32_t tear = -1;
+
+//the whole chip erased, as new
+void Flash_Erase(void)
+{
+	memset(flash_mem, 0xFF, sizeof(flash_mem));
+	memset(&flash_stat, 0, sizeof(flash_stat));
+}
+
+//the next page program stops after this many bytes, as at a power loss
+void Flash_Tear(uint16_t bytes)
+{
+	tear = bytes;
+}
+
+uint32_t W25qxx_SectorToPage(uint32_t SectorAddress)
+{
+	return SectorAddress * W25_SECTOR_SIZE / W25_PAGE_SIZE;
+}
+
+bool W25qxx_IsBusy(void)
+{
+	return 0;
+}
+
+void W25qxx_EraseSectorStart(uint32_t SectorAddr)
+{
+	if(SectorAddr < FLASH_SECTORS)
+		memset(flash_mem + SectorAddr * W25_SECTOR_SIZE, 0xFF, W25_SECTOR_SIZE);
+	flash_stat.erases++;
+}
+
+void W25qxx_WritePageStart(uint8_t *pBuffer, uint32_t Page_Address, uint32_t OffsetInByte, uint32_t NumByteToWrite_up_to_PageSize)
+{
+	uint32_t i, n = NumByteToWrite_up_to_PageSize;
+
+	flash_stat.progs++;
+	if(OffsetInByte + n > W25_PAGE_SIZE || Page_Address >= FLASH_SECTORS * W25_SECTOR_SIZE / W25_PAGE_SIZE)
+	{
+		flash_stat.overruns++;
+		return;
+	}
+	if(tear >= 0 && (uint32_t)tear < n)
+		n = tear;
+	tear = -1;
+	for(i = 0; i < n; i++)
+		flash_mem[Page_Address * W25_PAGE_SIZE + OffsetInByte + i] &= pBuffer[i];
+}
+
+void W25qxx_ReadBytesNow(uint8_t *pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
+{
+	if(ReadAddr + NumByteToRead <= sizeof(flash_mem))
+		memcpy(pBuffer, flash_mem + ReadAddr, NumByteToRead);
+}
@@ -0,0 +1,25 @@
+#ifndef __FLASH_H
+#define __FLASH_H
+
+#include <stdint.h>
+
+//W25Qxx model on RAM, for the modules that keep records in the flash: a
+//64-sector W25Q16 whose operations finish at once. Programming only
+//clears bits and must stay inside one page, an erase sets the sector to
+//0xFF.
+#define FLASH_SECTORS       64
+
+typedef struct
+{
+	uint32_t erases;
+	uint32_t progs;
+	uint32_t overruns;              //programs that crossed a page
+} flash_stat_t;
+
+extern flash_stat_t flash_stat;
+extern uint8_t flash_mem[];
+
+void Flash_Erase(void);
+void Flash_Tear(uint16_t bytes);
+
+#endif
@@ -0,0 +1,207 @@
+//HAL functions the firmware sources call, mocked for the host. SPI1 and
+//the TFT pins drive the panel model, DMA transfers complete at once, the
+//tick and the cycle counter run from the modelled wire time.
+#include "main.h"
+#include "emu.h"
+#include "host.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+#define HOST_HCLK           72000000
+#define HOST_PCLK2          72000000
+
+DWT_Type host_dwt;
+CoreDebug_Type host_coredebug;
+RCC_TypeDef host_rcc;
+SysTick_Type host_systick = {.LOAD = HOST_HCLK / 1000 - 1};      //as HAL_InitTick()
+SCB_Type host_scb;
+SPI_TypeDef host_spi1 = {.CR1 = SPI_BAUDRATEPRESCALER_4};   //as MX_SPI1_Init()
+SPI_HandleTypeDef hspi1 = {.Instance = &host_spi1};
+uint32_t SystemCoreClock = HOST_HCLK;
+
+static uint32_t host_ms;
+static uint64_t host_ns;
+static uint16_t host_gpio[5];           //GPIOA..GPIOE: inputs as set by Host_Pin(), outputs as written
+
+uint32_t HAL_GetTick(void)
+{
+	return host_ms;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	host_ms += Delay;
+}
+
+//advance the tick, SysTick and the cycle counter
+void Host_Advance(uint64_t ns)
+{
+	host_ns += ns;
+	host_ms = (uint32_t)(host_ns / 1000000);
+	host_dwt.CYCCNT = (uint32_t)(host_ns * (HOST_HCLK / 1000000) / 1000);
+	host_systick.VAL = host_systick.LOAD - (uint32_t)(host_ns % 1000000 * (host_systick.LOAD + 1) / 1000000);
+}
+
+uint64_t Host_Ns(void)
+{
+	return host_ns;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void)
+{
+	return HOST_PCLK2;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+	return HOST_PCLK2 / 2;
+}
+
+static uint16_t *Host_Gpio(GPIO_TypeDef *port)
+{
+	return &host_gpio[((uintptr_t)port - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE)];
+}
+
+//drive an input pin, as the outside world would
+void Host_Pin(GPIO_TypeDef *port, uint16_t pin, int level)
+{
+	if(level)
+		*Host_Gpio(port) |= pin;
+	else
+		*Host_Gpio(port) &= ~pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	return *Host_Gpio(GPIOx) & GPIO_Pin ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+//an output driven by the firmware, for the models of what is on the line
+__weak void Host_PinOut(GPIO_TypeDef *port, uint16_t pin, int level)
+{
+	(void)port;
+	(void)pin;
+	(void)level;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	Host_Pin(GPIOx, GPIO_Pin, PinState == GPIO_PIN_SET);
+	if(GPIOx == TFT_CS_GPIO_Port || GPIOx == TFT_RES_GPIO_Port)
+		Emu_Pin(GPIO_Pin, PinState == GPIO_PIN_SET);
+	Host_PinOut(GPIOx, GPIO_Pin, PinState == GPIO_PIN_SET);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+	(void)GPIOx;
+	(void)GPIO_Init;
+}
+
+static uint32_t Host_Sck(SPI_HandleTypeDef *hspi)
+{
+	return HOST_PCLK2 >> (((hspi->Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos) + 1);
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	uint64_t ns = emu_stat.wire_ns;
+
+	(void)Timeout;
+	if(hspi != &hspi1)
+		return HAL_ERROR;
+	Emu_Bytes(pData, Size, Host_Sck(hspi));
+	Host_Advance(emu_stat.wire_ns - ns);
+	return HAL_OK;
+}
+
+__weak void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	(void)hspi;
+}
+
+//the strip goes out at once, the buffer is free again when this returns
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size)
+{
+	if(HAL_SPI_Transmit(hspi, pData, Size, 0) != HAL_OK)
+		return HAL_ERROR;
+	HAL_SPI_TxCpltCallback(hspi);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+	(void)hdma;
+	return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+	(void)hdma;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+	(void)IRQn;
+	(void)PreemptPriority;
+	(void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+	(void)IRQn;
+}
+
+int host_fails;
+
+void Error_Handler(void)
+{
+	Host_Check(0, "Error_Handler() called");
+}
+
+void Host_Check(int ok, const char *what, ...)
+{
+	va_list ap;
+
+	if(ok)
+		return;
+	host_fails++;
+	printf("FAIL: ");
+	va_start(ap, what);
+	vprintf(what, ap);
+	va_end(ap);
+	printf("\n");
+}
+
+//exit status of a test program
+int Host_Done(const char *test)
+{
+	printf("%s: %s\n", test, host_fails ? "FAILED" : "ok");
+	return host_fails != 0;
+}
+
+static uint32_t host_seed = 1;
+
+void Host_Seed(uint32_t seed)
+{
+	host_seed = seed;
+}
+
+//15 bits from the LCG of the C standard's example rand(), the same on
+//every host
+uint32_t Host_Rand(void)
+{
+	host_seed = host_seed * 1103515245 + 12345;
+	return host_seed >> 16 & 0x7fff;
+}
+
+//roughly normal, sd 1: the sum of twelve uniforms
+double Host_Gauss(void)
+{
+	double g = -6;
+	int i;
+
+	for(i = 0; i < 12; i++)
+		g += Host_Rand() / 32768.0;
+	return g;
+}
@@ -0,0 +1,34 @@
+#ifndef __HOST_H
+#define __HOST_H
+
+#include "main.h"
+#include <stdint.h>
+
+//hal.c: the tick, SysTick and the DWT cycle counter only move when this is
+//called, the mocked SPI1 and I2C1 call it with the modelled wire time of
+//each transfer; Host_Ns() is the time advanced so far
+void Host_Advance(uint64_t ns);
+uint64_t Host_Ns(void);
+
+//hal.c: set the level of an input pin for HAL_GPIO_ReadPin(); written
+//outputs read back as written
+void Host_Pin(GPIO_TypeDef *port, uint16_t pin, int level);
+
+//hal.c calls this on every HAL_GPIO_WritePin(), a model of the line can
+//override it (weak, does nothing)
+void Host_PinOut(GPIO_TypeDef *port, uint16_t pin, int level);
+
+//check helpers, report on stdout and count failures
+extern int host_fails;
+void Host_Check(int ok, const char *what, ...);
+int Host_Done(const char *test);
+
+//hal.c: repeatable random numbers, each test seeds them once
+void Host_Seed(uint32_t seed);
+uint32_t Host_Rand(void);
+double Host_Gauss(void);
+
+//panel.c: bring the panel model up in direction dir, as Boot_Process()
+void Host_Panel(uint8_t dir);
+
+#endif
@@ -0,0 +1,177 @@
+//HAL I2C functions the firmware sources call, on a model of I2C1 and its
+//slaves (i2cdev.h).
+#include "main.h"
+#include "i2cdev.h"
+#include "host.h"
+
+#define I2C_BITS(len)       (9 * ((len) + 4) + 2)   //address, register, address again, data, START/STOP
+
+I2C_TypeDef host_i2c1;
+I2C_HandleTypeDef hi2c1 = {.Instance = &host_i2c1, .Init.ClockSpeed = 400000, .State = HAL_I2C_STATE_READY};
+i2cdev_stat_t i2cdev_stat;
+
+static i2cdev_t *slaves;
+static struct
+{
+	uint8_t on;                     //a transfer is on the bus
+	uint8_t dev, reg, len, read;
+	uint8_t *buf;
+} xfer;
+static uint8_t held;                //SCL clocks until the hanging slave lets SDA go
+static uint8_t scl = 1, sda = 1;    //levels driven by the recovery
+
+void I2cDev_Attach(i2cdev_t *d)
+{
+	d->next = slaves;
+	slaves = d;
+}
+
+//BUSY set in SR2 until the peripheral is re-initialised
+void I2cDev_StuckBusy(void)
+{
+	host_i2c1.SR2 |= I2C_SR2_BUSY;
+}
+
+uint8_t I2cDev_Busy(void)
+{
+	return xfer.on;
+}
+
+static HAL_StatusTypeDef I2cDev_Start(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint8_t *pData, uint16_t Size, uint8_t read)
+{
+	if(hi2c != &hi2c1 || hi2c->State != HAL_I2C_STATE_READY)
+		return HAL_BUSY;
+	if(host_i2c1.SR2 & I2C_SR2_BUSY)
+	{
+		Host_Advance(25000000ULL);      //I2C_TIMEOUT_BUSY_FLAG
+		hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+		i2cdev_stat.refused++;
+		return HAL_BUSY;
+	}
+	hi2c->State = read ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	xfer.on = 1;
+	xfer.dev = DevAddress;
+	xfer.reg = MemAddress;
+	xfer.buf = pData;
+	xfer.len = Size;
+	xfer.read = read;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	HAL_StatusTypeDef st = I2cDev_Start(hi2c, DevAddress, MemAddress, pData, Size, 1);
+
+	(void)MemAddSize;
+	if(st == HAL_OK)
+	{
+		i2cdev_stat.dma++;
+		i2cdev_stat.dma_single += Size == 1;
+	}
+	return st;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	HAL_StatusTypeDef st = I2cDev_Start(hi2c, DevAddress, MemAddress, pData, Size, 1);
+
+	(void)MemAddSize;
+	i2cdev_stat.it += st == HAL_OK;
+	return st;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	HAL_StatusTypeDef st = I2cDev_Start(hi2c, DevAddress, MemAddress, pData, Size, 0);
+
+	(void)MemAddSize;
+	i2cdev_stat.it += st == HAL_OK;
+	return st;
+}
+
+/*the interrupt that ends the transfer on the bus, after its wire time;
+  0 when there is none or its slave hangs the bus*/
+uint8_t I2cDev_Run(void)
+{
+	i2cdev_t *d;
+
+	if(!xfer.on || held)
+		return 0;
+	for(d = slaves; d && d->dev != xfer.dev; d = d->next)
+		;
+	if(d && d->hang)
+	{
+		held = d->hang;
+		d->hang = 0;
+		i2cdev_stat.hangs++;
+		Host_Pin(RTC_SDA_GPIO_Port, RTC_SDA_Pin, 0);
+		return 0;
+	}
+	Host_Advance((uint64_t)I2C_BITS(xfer.len) * 1000000000 / hi2c1.Init.ClockSpeed);
+	xfer.on = 0;
+	hi2c1.State = HAL_I2C_STATE_READY;
+	if(!d || d->fail)
+	{
+		if(d)
+			d->fail--;
+		hi2c1.ErrorCode = d ? d->error : HAL_I2C_ERROR_AF;
+		i2cdev_stat.errors++;
+		HAL_I2C_ErrorCallback(&hi2c1);
+		return 1;
+	}
+	i2cdev_stat.done++;
+	if(xfer.read)
+	{
+		d->read(xfer.reg, xfer.buf, xfer.len);
+		HAL_I2C_MemRxCpltCallback(&hi2c1);
+	}
+	else
+	{
+		d->write(xfer.reg, xfer.buf, xfer.len);
+		HAL_I2C_MemTxCpltCallback(&hi2c1);
+	}
+	return 1;
+}
+
+//the pins as open drain outputs: a held SDA stays low
+void Host_PinOut(GPIO_TypeDef *port, uint16_t pin, int level)
+{
+	if(port != RTC_SCL_GPIO_Port)
+		return;
+	if(pin & RTC_SCL_Pin)
+	{
+		if(scl && !level && held && !--held)
+			Host_Pin(RTC_SDA_GPIO_Port, RTC_SDA_Pin, sda);
+		i2cdev_stat.clocks += scl && !level;
+		scl = level;
+	}
+	if(pin & RTC_SDA_Pin)
+	{
+		i2cdev_stat.stops += scl && !sda && level && !held;
+		sda = level;
+		if(held)
+			Host_Pin(RTC_SDA_GPIO_Port, RTC_SDA_Pin, 0);
+	}
+}
+
+//stops the transfer on the bus without a callback
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
+{
+	xfer.on = 0;
+	hi2c->State = HAL_I2C_STATE_RESET;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
+{
+	host_i2c1.SR2 = held ? I2C_SR2_BUSY : 0;
+	hi2c->State = HAL_I2C_STATE_READY;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	i2cdev_stat.inits++;
+	return HAL_OK;
+}
@@ -0,0 +1,46 @@
+#ifndef __I2CDEV_H
+#define __I2CDEV_H
+
+#include <stdint.h>
+
+//I2C1 model behind the mocked HAL_I2C_Mem_xxx calls and the RTC_SCL/SDA
+//pins, at the 400 kHz of MX_I2C1_Init(). A transfer stays on the bus
+//until I2cDev_Run() plays the interrupt that ends it: the slave at the
+//address takes or gives the data through its callbacks, a missing slave
+//NACKs. A slave can also be made to fail its next transfers with a HAL
+//error, to hang the bus by holding SDA low until the recovery clocks it
+//free, and BUSY can be left stuck until the peripheral is re-initialised
+//(F1 errata 2.13.7).
+typedef struct i2cdev
+{
+	uint8_t dev;                    //8-bit address
+	uint8_t fail;                   //end this many transfers with 'error'
+	uint32_t error;                 //HAL_I2C_ERROR_xxx, AF for a NACK
+	uint8_t hang;                   //hold SDA on the next transfer for this many SCL clocks
+	void (*read)(uint8_t reg, uint8_t *buf, uint8_t len);
+	void (*write)(uint8_t reg, const uint8_t *buf, uint8_t len);
+	struct i2cdev *next;
+} i2cdev_t;
+
+typedef struct
+{
+	uint32_t dma;                   //reads started with DMA
+	uint32_t dma_single;            //of them one byte long, unreliable on the F1
+	uint32_t it;                    //reads and writes started with interrupts
+	uint32_t done;
+	uint32_t errors;                //transfers ended with an error callback
+	uint32_t refused;               //starts refused with BUSY stuck
+	uint32_t hangs;
+	uint32_t clocks;                //SCL pulses sent by the recovery
+	uint32_t stops;                 //STOP conditions sent by the recovery
+	uint32_t inits;                 //HAL_I2C_Init() calls
+} i2cdev_stat_t;
+
+extern i2cdev_stat_t i2cdev_stat;
+
+void I2cDev_Attach(i2cdev_t *d);
+uint8_t I2cDev_Run(void);
+uint8_t I2cDev_Busy(void);
+void I2cDev_StuckBusy(void);
+
+#endif
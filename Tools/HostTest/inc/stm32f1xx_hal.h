@@ -0,0 +1,49 @@
+//Host build of the HAL header. The real HAL and CMSIS headers are used for
+//the types, defines and prototypes, so the firmware sources compile
+//unchanged; what a host cannot run is replaced after them:
+// - the core registers the sources touch are host variables
+// - instructions without a host equivalent become no-ops or builtins
+//The HAL functions themselves are mocked in hal.c.
+#ifndef __HOST_STM32F1XX_HAL_H
+#define __HOST_STM32F1XX_HAL_H
+
+#include_next "stm32f1xx_hal.h"
+
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_coredebug;
+extern SPI_TypeDef host_spi1;
+extern RCC_TypeDef host_rcc;
+extern SysTick_Type host_systick;
+extern SCB_Type host_scb;
+
+#undef DWT
+#define DWT (&host_dwt)
+#undef CoreDebug
+#define CoreDebug (&host_coredebug)
+#undef SPI1
+#define SPI1 (&host_spi1)
+#undef RCC
+#define RCC (&host_rcc)
+#undef SysTick
+#define SysTick (&host_systick)
+#undef SCB
+#define SCB (&host_scb)
+
+#undef __DMB
+#define __DMB() __sync_synchronize()
+#undef __DSB
+#define __DSB() __sync_synchronize()
+#undef __ISB
+#define __ISB() __sync_synchronize()
+#undef __WFI
+#define __WFI() ((void)0)
+#undef __disable_irq
+#define __disable_irq() ((void)0)
+#undef __enable_irq
+#define __enable_irq() ((void)0)
+#undef __get_PRIMASK
+#define __get_PRIMASK() 0U
+#undef __set_PRIMASK
+#define __set_PRIMASK(x) ((void)(x))
+
+#endif
@@ -0,0 +1,213 @@
+//Golden-image test of the display pages in User/LCD/test.c. Each page is
+//drawn on the panel model and compared with golden/<name>.png; a page
+//that differs is saved to out/<name>.png. With -g the golden images are
+//written instead. Every page prints its panel traffic, and the bytes
+//lcd.c counted must match the bytes the panel saw.
+//The data pages read fixed values from the stubs below.
+#include "main.h"
+#include "lcd.h"
+#include "gui.h"
+#include "test.h"
+#include "strip.h"
+#include "frame.h"
+#include "stats.h"
+#include "ripple.h"
+#include "capacity.h"
+#include "cable.h"
+#include "emu.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+	const char *name;
+	void (*draw)(void);
+} page_t;
+
+static uint8_t golden;
+
+//====================stubs for the data modules====================//
+void Stats_Get(uint8_t ch, uint8_t which, stats_acc_t *a)
+{
+	static const int32_t mean[ACQ_CH_NUM] = {512, 1500, 5012, 3987};
+
+	(void)which;
+	a->n = 1000;
+	a->min = mean[ch] - 37;
+	a->max = mean[ch] + 212;
+	a->mean = (int64_t)mean[ch] << 16;
+	a->m2 = (int64_t)a->n * 25 * 25;
+}
+
+int32_t Stats_Mean(const stats_acc_t *a)
+{
+	return (int32_t)(a->mean >> 16);
+}
+
+uint32_t Stats_Std(const stats_acc_t *a)
+{
+	return a->n > 1 ? 25 : 0;
+}
+
+int32_t Stats_Quantile(uint8_t q)
+{
+	static const int32_t v[] = {498000, 655000, 702000};
+
+	return q < sizeof(v) / sizeof(v[0]) ? v[q] : 0;
+}
+
+uint8_t Ripple_Get(ripple_result_t *r)
+{
+	memset(r, 0, sizeof(*r));
+	r->ch = ACQ_CH_UIN;
+	r->n = 256;
+	r->rate_hz = 8000;
+	r->rms = 12;
+	r->pp = 41;
+	r->peaks = 3;
+	r->peak[0].hz = 100;
+	r->peak[0].amp = 15;
+	r->peak[1].hz = 1250;
+	r->peak[1].amp = 6;
+	r->peak[2].hz = 3125;
+	r->peak[2].amp = 2;
+	return 1;
+}
+
+static capacity_rec_t capacity = {.ms = 5025000, .q = 1234567LL * 3600, .e = 4567890LL * 3600,
+                                  .peak_ua = 1012000, .state = CAPACITY_STATE_DONE, .reason = 1};
+
+const capacity_rec_t *Capacity_Get(void)
+{
+	return &capacity;
+}
+
+uint32_t Capacity_MahX10(const capacity_rec_t *r)
+{
+	return (uint32_t)(r->q / 360000);
+}
+
+uint32_t Capacity_MwhX10(const capacity_rec_t *r)
+{
+	return (uint32_t)(r->e / 360000000);
+}
+
+uint8_t Cable_Get(cable_est_t *e)
+{
+	e->r_mohm = 183;
+	e->median_mohm = 180;
+	e->mad_mohm = 7;
+	e->pairs = 12;
+	e->used = 10;
+	e->steps = 15;
+	e->rejected = 3;
+	return 1;
+}
+//==========================end of stubs============================//
+
+//one live frame from a block
+static void Frame(uint32_t seq, int32_t mv, int32_t ma)
+{
+	acq_block_t b;
+
+	memset(&b, 0, sizeof(b));
+	b.seq = seq;
+	b.val[ACQ_CH_UIN] = mv;
+	b.val[ACQ_CH_I4A] = ma;
+	b.load_ua = ma * 1000;
+	Frame_Publish(&b);
+	Host_Advance(1000000000ULL / FRAME_FPS);
+	Frame_Process();
+}
+
+static void Readout(void)
+{
+	Test_Readout();
+	Frame(1, 5012, 1250);
+	Frame(2, 5008, 1250);   //one digit changes
+	Frame_Stop();
+}
+
+static void Panel(void)
+{
+	uint32_t i;
+
+	Test_Panel();
+	for(i = 1; i <= 160; i++)
+		Frame(i, 5000 + (int32_t)(i % 7), (int32_t)(i * 37 % 3900));
+	Frame_Stop();
+}
+
+static void StripPage(void)
+{
+	uint32_t i;
+
+	Test_Strip();
+	for(i = 0; i < 260; i++)
+	{
+		Strip_Add(0, (int32_t)(i * 13 % 900));
+		Strip_Add(1, 5000 + (int32_t)(i % 40));
+		Strip_Commit();
+		if(i % 3 == 2)
+			Strip_Draw();
+	}
+	Strip_Draw();
+}
+
+//Demo_Step() order
+static const page_t pages[] = {
+	{"stats", Test_Stats},
+	{"ripple", Test_Ripple},
+	{"capacity", Test_Capacity},
+	{"cable", Test_Cable},
+	{"readout", Readout},
+	{"panel", Panel},
+	{"strip", StripPage},
+};
+
+static void Page(const page_t *p)
+{
+	char path[64];
+	u32 lcd_bytes;
+	long diff;
+
+	Strip_Hide();           //as Demo_Step(), the pages draw on the normal display
+	lcd_bytes = lcd_stat.bytes;
+	memset(&emu_stat, 0, sizeof(emu_stat));
+	p->draw();
+	printf("%-14s %6lu xfers %7lu bytes %5lu cmds %5lu windows %7.2f ms\n", p->name,
+	       (unsigned long)emu_stat.xfers, (unsigned long)emu_stat.bytes, (unsigned long)emu_stat.cmds,
+	       (unsigned long)emu_stat.windows, emu_stat.wire_ns / 1e6);
+	Host_Check(lcd_stat.bytes - lcd_bytes == emu_stat.bytes, "%s: lcd.c counted %lu bytes, the panel saw %lu",
+	           p->name, (unsigned long)(lcd_stat.bytes - lcd_bytes), (unsigned long)emu_stat.bytes);
+	Host_Check(!emu_stat.stray, "%s: %lu bytes sent with CS high", p->name, (unsigned long)emu_stat.stray);
+	Host_Check(!emu_stat.dark, "%s: %lu bytes sent to a dark panel", p->name, (unsigned long)emu_stat.dark);
+	snprintf(path, sizeof(path), "golden/%s.png", p->name);
+	if(golden)
+	{
+		Host_Check(Emu_WritePng(path, lcddev.width, lcddev.height) == 0, "%s: cannot write", path);
+		return;
+	}
+	diff = Emu_ComparePng(path, lcddev.width, lcddev.height);
+	if(diff == 0)
+		return;
+	snprintf(path, sizeof(path), "out/%s.png", p->name);
+	Emu_WritePng(path, lcddev.width, lcddev.height);
+	if(diff < 0)
+		Host_Check(0, "%s: no %ux%u golden image, see %s", p->name, lcddev.width, lcddev.height, path);
+	else
+		Host_Check(0, "%s: %ld pixels differ, see %s", p->name, diff, path);
+}
+
+int main(int argc, char **argv)
+{
+	uint8_t i;
+
+	golden = argc > 1 && strcmp(argv[1], "-g") == 0;
+	Host_Panel(USE_HORIZONTAL);
+	for(i = 0; i < sizeof(pages) / sizeof(pages[0]); i++)
+		Page(&pages[i]);
+	LCD_Report();
+	return Host_Done("pages");
+}
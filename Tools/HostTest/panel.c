@@ -0,0 +1,56 @@
+//For the display tests: the panel bring-up of Boot_Process() and the
+//scheduler, clock and low-power calls the display code makes, as no-ops.
+#include "main.h"
+#include "lcd.h"
+#include "tile.h"
+#include "clock.h"
+#include "lpm.h"
+#include "host.h"
+
+void Clock_Require(uint8_t user, uint8_t profile)
+{
+	(void)user;
+	(void)profile;
+}
+
+void LPM_Lock(uint8_t lock)
+{
+	(void)lock;
+}
+
+void LPM_Unlock(uint8_t lock)
+{
+	(void)lock;
+}
+
+void Sched_Signal(uint8_t task, uint8_t sig)
+{
+	(void)task;
+	(void)sig;
+}
+
+void Sched_TimerStart(sched_timer_t *t, uint8_t task, uint8_t sig, uint32_t delay, uint32_t period)
+{
+	(void)t;
+	(void)task;
+	(void)sig;
+	(void)delay;
+	(void)period;
+}
+
+void Sched_TimerStop(sched_timer_t *t)
+{
+	(void)t;
+}
+
+//Boot_Process() order, without the waits
+void Host_Panel(uint8_t dir)
+{
+	LCD_ResetStart();
+	Tile_Init();
+	LCD_ResetEnd();
+	LCD_InitRegs();
+	LCD_direction(dir);
+	LCD_Clear(BLACK);
+	LCD_DisplayOn();
+}
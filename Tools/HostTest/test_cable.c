@@ -0,0 +1,97 @@
+//User/Cable on synthetic supply traces, simulated per millisecond and
+//averaged into blocks as Acq_Process() does: random load steps through a
+//known resistance with block noise and slow source drift, plus short
+//current spikes, ramps and 5/9 V negotiation steps that must not pull
+//the estimate. The fit must land within 4 mOhm (2 % above 200 mOhm) of
+//the true value.
+#include "cable.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define BLOCK_MS            (ACQ_BLOCK * 1000 / ACQ_RATE_HZ)
+
+static double r_ohm, src_mv, load_ma;
+
+static void Run(uint32_t ms)
+{
+	static double su, si;
+	static uint32_t k;
+	acq_block_t b = {0};
+
+	while(ms--)
+	{
+		su += src_mv - r_ohm * load_ma;
+		si += load_ma;
+		if(++k < BLOCK_MS)
+			continue;
+		si /= BLOCK_MS;
+		b.load_ua = (int32_t)lround(si * 1000 + Host_Gauss() * (si > 95 ? 600 : 50));
+		b.val[ACQ_CH_UIN] = (int32_t)lround(su / BLOCK_MS + Host_Gauss() * 2.5);
+		Cable_Block(&b);
+		su = si = 0;
+		k = 0;
+	}
+}
+
+static void Scenario(const char *name, uint32_t r_mohm, uint8_t steps, uint8_t negotiate, uint8_t ramps)
+{
+	cable_est_t e;
+	double nl;
+	uint8_t s, k;
+
+	Cable_Reset();
+	r_ohm = r_mohm / 1000.0;
+	src_mv = 5100;
+	load_ma = 300;
+	Run(2000);
+	for(s = 0; s < steps; s++)
+	{
+		nl = 100 + Host_Rand() % 2400;
+		if(fabs(nl - load_ma) < 120)
+			nl = load_ma + 300;
+		if(ramps && s % 4 == 0)
+			for(k = 0; k < 20; k++)
+			{
+				load_ma += (nl - load_ma) / (20 - k);
+				Run(BLOCK_MS);
+			}
+		else
+			load_ma = nl;
+		Run(300 + Host_Rand() % 2000);
+		if(negotiate && s % 5 == 2)
+		{
+			src_mv = src_mv > 6000 ? 5100 : 9050;
+			load_ma *= src_mv > 6000 ? 0.6 : 1.6;
+			Run(1500);
+		}
+		src_mv += Host_Gauss() * 5;
+		if(s % 7 == 3)
+		{
+			nl = load_ma;
+			load_ma += 1500;    //40 ms spike
+			Run(40);
+			load_ma = nl;
+			Run(800);
+		}
+	}
+	Host_Check(Cable_Get(&e), "%s: no estimate", name);
+	printf("%-26s true %4lu  fit %4ld  median %4ld mad %3ld  used %2u/%2u  steps %lu rejected %lu\n", name,
+	       (unsigned long)r_mohm, (long)e.r_mohm, (long)e.median_mohm, (long)e.mad_mohm, e.used, e.pairs,
+	       (unsigned long)e.steps, (unsigned long)e.rejected);
+	Host_Check(labs(e.r_mohm - (int32_t)r_mohm) <= (r_mohm > 200 ? r_mohm / 50 : 4), "%s: fit off", name);
+}
+
+int main(void)
+{
+	Host_Seed(1);
+	Scenario("clean 180 mOhm", 180, 40, 0, 0);
+	Scenario("clean 50 mOhm", 50, 40, 0, 0);
+	Scenario("thick 20 mOhm", 20, 40, 0, 0);
+	Scenario("thin 600 mOhm", 600, 40, 0, 0);
+	Scenario("180 + negotiation", 180, 60, 1, 0);
+	Scenario("300 + ramps", 300, 60, 0, 1);
+	Scenario("250 + negotiation + ramps", 250, 80, 1, 1);
+	return Host_Done("cable");
+}
@@ -0,0 +1,324 @@
+//User/Capture on the flash model (flash.h), fed as Acq feeds it: frame
+//blocks through Cap_Block() while the scan runs, stream halves through the
+//callback given to Acq_Stream() while the fast path holds the ADC, each
+//with the time of its last unit. Calibration is the identity, so levels
+//are raw counts. Covered: a frame capture of a current step, a 20 us
+//current spike, a 50 us input dip and a 1 ms current ramp on the fast
+//path, each stored with the trigger unit at 'pre' and the time of that
+//unit; the ADC handed back to the scan for the write and the stream
+//restarted after it, a stream refused while Ripple holds the ADC, the key
+//trigger waiting for the pre-trigger part, and the event ring found again
+//after a reset, with a frame capture of an input dip.
+#include "cap.h"
+#include "cal.h"
+#include "log.h"
+#include "flash.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+#define RATE                176470  //Acq_BurstRate() at a 12 MHz ADC clock
+#define I_IDLE              300
+#define U_IDLE              3300
+#define EPOCH               1700000000
+
+#define EV_NONE             0
+#define EV_PULSE            1       //I_4A at 'to' for 'len'
+#define EV_DIP              2       //Uin at 'to' for 'len'
+#define EV_RAMP             3       //I_4A from idle to 'to' over 'len', then held
+
+static struct
+{
+	uint8_t type;
+	double at;                      //s
+	double len;
+	uint16_t to;
+} ev;
+
+static double now;                  //s, time of the next unit
+static acq_stream_fn stream;
+static uint8_t stream_ch;
+static uint8_t stream_busy;         //a Ripple burst holds the ADC
+static uint32_t streams, stops;
+static uint8_t pending;
+
+//====================stubs for the modules around====================//
+int32_t Cal_Apply(uint8_t ch, uint16_t raw)
+{
+	(void)ch;
+	return raw;
+}
+
+uint32_t Log_GetSeq(void)
+{
+	return 7;
+}
+
+void TS_Now(ts_t *ts)
+{
+	ts->sec = EPOCH + Host_Ns() / 1000000000;
+	ts->usec = Host_Ns() / 1000 % 1000000;
+}
+
+uint8_t TS_GetFlags(void)
+{
+	return TS_FLAG_VALID;
+}
+
+void Sched_Signal(uint8_t task, uint8_t sig)
+{
+	(void)task;
+	(void)sig;
+	pending = 1;
+}
+
+void Sched_TimerStart(sched_timer_t *t, uint8_t task, uint8_t sig, uint32_t delay, uint32_t period)
+{
+	(void)t;
+	(void)task;
+	(void)sig;
+	(void)delay;
+	(void)period;
+	pending = 1;
+}
+
+uint32_t Acq_BurstRate(void)
+{
+	return RATE;
+}
+
+HAL_StatusTypeDef Acq_Stream(uint8_t ch, acq_stream_fn fn, uint8_t task, uint8_t sig)
+{
+	(void)task;
+	(void)sig;
+	if(stream || stream_busy)
+		return HAL_BUSY;
+	stream = fn;
+	stream_ch = ch;
+	streams++;
+	return HAL_OK;
+}
+
+void Acq_StreamStop(void)
+{
+	stops += stream != NULL;
+	stream = NULL;
+}
+
+uint8_t Acq_Streaming(void)
+{
+	return stream != NULL;
+}
+//==========================end of stubs============================//
+
+static uint16_t Input(uint8_t ch, double t)
+{
+	double v = ch == ACQ_CH_UIN ? U_IDLE : ch == ACQ_CH_I4A ? I_IDLE : 1000;
+	double in = t - ev.at;
+
+	if(ev.type == EV_PULSE && ch == ACQ_CH_I4A && in >= 0 && in < ev.len)
+		v = ev.to;
+	else if(ev.type == EV_DIP && ch == ACQ_CH_UIN && in >= 0 && in < ev.len)
+		v = ev.to;
+	else if(ev.type == EV_RAMP && ch == ACQ_CH_I4A && in >= 0)
+		v = in < ev.len ? I_IDLE + (ev.to - I_IDLE) * in / ev.len : ev.to;
+	return (uint16_t)(v + Host_Gauss());
+}
+
+//the interrupt of a DMA half comes at the time of its last unit
+static void At(double t)
+{
+	uint64_t ns = (uint64_t)(t * 1e9 + 0.5);
+
+	if(ns > Host_Ns())
+		Host_Advance(ns - Host_Ns());
+}
+
+//CAP_TASK until the event is on the flash
+static void Poll(void)
+{
+	uint8_t k;
+
+	for(k = 0; pending && k < 100; k++)
+	{
+		pending = 0;
+		Cap_Process(CAP_SIG_POLL);
+	}
+}
+
+//s seconds of whatever holds the ADC: a stream or the scan
+static void Feed(double s)
+{
+	uint16_t buf[ACQ_STREAM_HALF], (*f)[ACQ_CH_NUM] = (uint16_t (*)[ACQ_CH_NUM])buf;
+	double end = now + s;
+	uint16_t k;
+	uint8_t c;
+
+	while(now < end)
+	{
+		if(stream)
+		{
+			for(k = 0; k < ACQ_STREAM_HALF; k++)
+				buf[k] = Input(stream_ch, now + (double)k / RATE);
+			now += (double)ACQ_STREAM_HALF / RATE;
+			At(now - 1.0 / RATE);
+			stream(buf, ACQ_STREAM_HALF);
+		}
+		else
+		{
+			for(k = 0; k < ACQ_BLOCK; k++)
+				for(c = 0; c < ACQ_CH_NUM; c++)
+					f[k][c] = Input(c, now + k * 0.001);
+			now += ACQ_BLOCK * 0.001;
+			At(now - 0.001);
+			Cap_Block(f, ACQ_BLOCK);
+		}
+		Poll();
+	}
+}
+
+static const cap_hdr_t *Newest(void)
+{
+	const cap_hdr_t *h, *best = NULL;
+	uint8_t s;
+
+	for(s = 0; s < CAP_SECTORS; s++)
+	{
+		h = (const cap_hdr_t *)&flash_mem[(FLASH_SECTORS - 1 - CAP_SECTORS + s) * 4096];
+		if(h->magic == CAP_MAGIC && (!best || h->id > best->id))
+			best = h;
+	}
+	return best;
+}
+
+//the newest record: its trigger unit crosses the level, at the time 'at'
+static const cap_hdr_t *Event(const char *what, uint32_t id, uint8_t ch, uint8_t trig, uint16_t lv, double at,
+                              double tol)
+{
+	const cap_hdr_t *h = Newest();
+	const uint16_t *u;
+	uint16_t v, p;
+	uint8_t c;
+	double t;
+
+	if(!h || h->id != id)
+	{
+		Host_Check(0, "%s: event %lu not stored", what, (unsigned long)id);
+		return NULL;
+	}
+	u = (const uint16_t *)(h + 1);
+	t = h->sec - EPOCH + h->us * 1e-6;
+	printf("%s: event %lu at %.6f s (expected %.6f), pre %u, %lu Hz, peak %u, min %u\n", what,
+	       (unsigned long)h->id, t, at, h->pre, (unsigned long)h->rate_hz, h->peak, h->min);
+	Host_Check(h->ch == ch && h->trig == trig && h->log_seq == 7, "%s: ch %u trig %u", what, h->ch, h->trig);
+	Host_Check(h->rate_hz == (ch == CAP_CH_ALL ? ACQ_RATE_HZ : RATE), "%s: rate %lu", what,
+	           (unsigned long)h->rate_hz);
+	Host_Check(t > at - tol && t < at + tol, "%s: time %.6f s, expected %.6f", what, t, at);
+	if(ch == CAP_CH_ALL)
+	{
+		c = trig == CAP_TRIG_DROP ? ACQ_CH_UIN : ACQ_CH_I4A;
+		v = u[h->pre * ACQ_CH_NUM + c];
+		p = u[(h->pre - 1) * ACQ_CH_NUM + c];
+	}
+	else
+	{
+		v = u[h->pre];
+		p = u[h->pre - 1];
+	}
+	if(trig == CAP_TRIG_OVER)
+		Host_Check(v >= lv && p < lv, "%s: %u after %u around the trigger", what, v, p);
+	else if(trig == CAP_TRIG_DROP)
+		Host_Check(v < lv && p >= lv, "%s: %u after %u around the trigger", what, v, p);
+	return h;
+}
+
+static void Frames(void)
+{
+	Cap_Command("over 1500");
+	ev = (typeof(ev)){EV_PULSE, now + 0.3002, 0.004, 2000};
+	Feed(0.8);
+	Event("frames", 0, CAP_CH_ALL, CAP_TRIG_OVER, 1500, ev.at + 0.0008, 2e-6);
+	Host_Check(!streams, "frames: %lu streams", (unsigned long)streams);
+}
+
+static void Spike(void)
+{
+	const cap_hdr_t *h;
+
+	Cap_Command("fast");
+	Host_Check(streams == 1 && stream_ch == ACQ_CH_I4A, "spike: %lu streams of channel %u", (unsigned long)streams,
+	           stream_ch);
+	ev = (typeof(ev)){EV_PULSE, now + 0.1, 20e-6, 2000};
+	Feed(0.11);
+	h = Event("spike", 1, ACQ_CH_I4A, CAP_TRIG_OVER, 1500, ev.at, 1.0 / RATE + 1e-6);
+	Host_Check(h && h->pre == CAP_PRE_DEFAULT * ACQ_CH_NUM && h->peak >= 1995, "spike: pre %u peak %u",
+	           h ? h->pre : 0, h ? h->peak : 0);
+	Host_Check(stops == 1 && streams == 2 && Acq_Streaming(), "spike: %lu stops, %lu streams", (unsigned long)stops,
+	           (unsigned long)streams);
+}
+
+static void Dip(void)
+{
+	const cap_hdr_t *h;
+
+	Cap_Command("drop 2800");
+	Host_Check(stream_ch == ACQ_CH_UIN, "dip: streaming channel %u", stream_ch);
+	ev = (typeof(ev)){EV_DIP, now + 0.05, 50e-6, 2500};
+	Feed(0.06);
+	h = Event("dip", 2, ACQ_CH_UIN, CAP_TRIG_DROP, 2800, ev.at, 1.0 / RATE + 1e-6);
+	Host_Check(h && h->min <= 2505 && h->peak >= U_IDLE - 5, "dip: min %u peak %u", h ? h->min : 0,
+	           h ? h->peak : 0);
+}
+
+//a 1000 mA rise over 2 ms: 400 mA within 1 ms is reached 0.8 ms in
+static void Ramp(void)
+{
+	Cap_Command("slope 400");
+	ev = (typeof(ev)){EV_RAMP, now + 0.05, 0.002, I_IDLE + 1000};
+	Feed(0.06);
+	Event("ramp", 3, ACQ_CH_I4A, CAP_TRIG_SLOPE, 0, ev.at + 0.0008, 20e-6);
+}
+
+static void Busy(void)
+{
+	uint32_t s = streams;
+	double t;
+
+	ev.type = EV_NONE;
+	stream_busy = 1;
+	Cap_Command("key");
+	Feed(0.05);
+	Host_Check(!Acq_Streaming(), "busy: streaming while the ADC is held");
+	stream_busy = 0;
+	Poll();                                 //the retry timer
+	Host_Check(Acq_Streaming() && streams == s + 1, "busy: %lu streams after the ADC came back",
+	           (unsigned long)(streams - s));
+	t = now;
+	Cap_Trigger();                          //counts once the pre-trigger part is full
+	Feed(0.02);
+	Event("key", 4, ACQ_CH_I4A, CAP_TRIG_KEY, 0, t + (double)CAP_PRE_DEFAULT * ACQ_CH_NUM / RATE, 2.0 / RATE);
+}
+
+int main(void)
+{
+	Host_Seed(35);
+	Flash_Erase();
+	Host_Advance(1000000000);
+	now = 1;
+	Cap_Init();
+	Frames();
+	Spike();
+	Dip();
+	Ramp();
+	Busy();
+	Cap_Command("frames");
+	Host_Check(!Acq_Streaming(), "frames again: still streaming");
+	Cap_Init();
+	Cap_Command("drop 2800");
+	ev = (typeof(ev)){EV_DIP, now + 0.2004, 0.003, 2500};
+	Feed(0.6);
+	Event("after a reset", 5, CAP_CH_ALL, CAP_TRIG_DROP, 2800, ev.at + 0.0006, 2e-6);
+	printf("flash: %lu erases, %lu programs\n", (unsigned long)flash_stat.erases, (unsigned long)flash_stat.progs);
+	Host_Check(!flash_stat.overruns, "%lu programs crossed a page", (unsigned long)flash_stat.overruns);
+	return Host_Done("cap");
+}
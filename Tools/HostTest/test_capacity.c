@@ -0,0 +1,198 @@
+//User/Capacity on the flash model (flash.h):
+//A  a 2 A power bank for 2.5 h with ripple bursts stealing 50 ms every
+//   100 s and a reset after 1 h, ending when the output collapses; the
+//   charge must match the reference and the summary survive a reset
+//B  a charge taper ending on the current, with the checkpoint at 960 s
+//   torn by a reset: the test resumes from the one before
+//C  the timeout, D  "capacity stop"
+#include "capacity.h"
+#include "log.h"
+#include "flash.h"
+#include "host.h"
+#include <stdio.h>
+#include <math.h>
+
+#define BLOCK_MS            (ACQ_BLOCK * 1000 / ACQ_RATE_HZ)
+
+static uint8_t pending;
+static uint16_t events, event_mah;
+
+//====================stubs for the modules around====================//
+//the STM32 CRC unit in software: poly 0x04C11DB7, no reflection, words
+uint32_t Log_Crc(const void *p, uint32_t len)
+{
+	const uint32_t *w = p;
+	uint32_t crc = 0xFFFFFFFF;
+	uint8_t i;
+
+	for(len >>= 2; len; len--)
+	{
+		crc ^= *w++;
+		for(i = 0; i < 32; i++)
+			crc = crc & 0x80000000 ? crc << 1 ^ 0x04C11DB7 : crc << 1;
+	}
+	return crc;
+}
+
+void Log_Event(uint8_t type, const ts_t *ts, uint16_t a, uint16_t b)
+{
+	(void)ts;
+	(void)b;
+	if(type != LOG_EVT_CAPACITY)
+		return;
+	events++;
+	event_mah = a;
+}
+
+void TS_Now(ts_t *ts)
+{
+	ts->sec = 1700000000 + HAL_GetTick() / 1000;
+	ts->usec = HAL_GetTick() % 1000 * 1000;
+}
+
+uint8_t TS_GetFlags(void)
+{
+	return TS_FLAG_VALID;
+}
+
+void Sched_Signal(uint8_t task, uint8_t sig)
+{
+	(void)task;
+	(void)sig;
+	pending = 1;
+}
+
+void Sched_TimerStart(sched_timer_t *t, uint8_t task, uint8_t sig, uint32_t delay, uint32_t period)
+{
+	(void)t;
+	(void)task;
+	(void)sig;
+	(void)delay;
+	(void)period;
+	pending = 1;
+}
+//==========================end of stubs============================//
+
+//CAPACITY_TASK until the checkpoint is in the flash
+static void Poll(void)
+{
+	uint8_t k;
+
+	for(k = 0; pending && k < 100; k++)
+	{
+		pending = 0;
+		Capacity_Process(CAPACITY_SIG_POLL);
+	}
+}
+
+//one block after gap_ms without any
+static void Block(double ma, double mv, uint32_t gap_ms)
+{
+	acq_block_t b = {0};
+
+	Host_Advance((BLOCK_MS + gap_ms) * 1000000ULL);
+	b.val[ACQ_CH_I4A] = (int32_t)lround(ma);
+	b.val[ACQ_CH_UIN] = (int32_t)lround(mv);
+	b.load_ua = (int32_t)lround(ma * 1000);
+	Capacity_Block(&b);
+	Poll();
+}
+
+static void Reset(void)
+{
+	Capacity_Init();
+	Poll();
+}
+
+static double Mah(void)
+{
+	return Capacity_MahX10(Capacity_Get()) / 10.0;
+}
+
+static void PowerBank(void)
+{
+	double q = 0, ma, mv;
+	uint32_t t = 0, gap;
+	capacity_rec_t done;
+
+	Capacity_Start(CAPACITY_IMIN_MA, CAPACITY_UMIN_MV, CAPACITY_HOLD_S, CAPACITY_TIMEOUT_MIN);
+	Poll();
+	while(Capacity_Get()->state != CAPACITY_STATE_DONE && t < 30000000)
+	{
+		if(t < 10000)
+			ma = 0, mv = 5100;  //load not on yet
+		else if(t < 9010000)
+			ma = 2000 + 30 * sin(t * 0.001), mv = 5100 - 200.0 * (t - 10000) / 9000000;
+		else
+			ma = 0, mv = 300;
+		gap = t % 100000 < BLOCK_MS && t > 20000 ? 50 : 0;
+		Block(ma, mv, gap);
+		t += BLOCK_MS + gap;
+		q += ma * (BLOCK_MS + gap);
+		if(t >= 3600000 && t < 3600000 + BLOCK_MS + 50)
+			Reset();            //just after a checkpoint: nothing lost
+	}
+	printf("A: %.1f/%.1f mAh, reason %u, %u event(s) with %u mAh\n", Mah(), q / 3.6e6,
+	       Capacity_Get()->reason, events, event_mah);
+	Host_Check(Capacity_Get()->reason == CAPACITY_END_VOLTAGE, "A: reason %u", Capacity_Get()->reason);
+	Host_Check(fabs(Mah() - q / 3.6e6) <= 0.5, "A: charge");
+	Host_Check(events == 1 && event_mah == (uint16_t)Mah(), "A: log event");
+	done = *Capacity_Get();
+	Reset();
+	Host_Check(Capacity_Get()->state == CAPACITY_STATE_DONE && Capacity_Get()->ms == done.ms &&
+	           Capacity_Get()->q == done.q && Capacity_Get()->reason == done.reason, "A: summary lost in a reset");
+}
+
+static void Taper(void)
+{
+	double q = 0, ma;
+	uint32_t t = 0;
+
+	Capacity_Command("start 50 0 30");
+	Poll();
+	for(;;)
+	{
+		ma = t < 1800000 ? 1000 : 1000 * exp(-((double)t - 1800000) / 900000.0);
+		if(t == BLOCK_MS * 29990)
+			Flash_Tear(20);     //the 960 s checkpoint
+		Block(ma, 4200, 0);
+		t += BLOCK_MS;
+		q += ma * BLOCK_MS;
+		if(t == BLOCK_MS * 30010)
+		{
+			Reset();
+			printf("B: resumed at %lu ms\n", (unsigned long)Capacity_Get()->ms);
+			Host_Check(Capacity_Get()->ms == 900000, "B: resumed from the torn checkpoint");
+			q -= 1000.0 * (t - 900000);      //the time since the 900 s checkpoint is lost
+		}
+		if(Capacity_Get()->state == CAPACITY_STATE_DONE || t > 20000000)
+			break;
+	}
+	printf("B: %.1f/%.1f mAh, reason %u\n", Mah(), q / 3.6e6, Capacity_Get()->reason);
+	Host_Check(Capacity_Get()->reason == CAPACITY_END_CURRENT, "B: reason %u", Capacity_Get()->reason);
+	Host_Check(fabs(Mah() - q / 3.6e6) <= 0.5, "B: charge");
+}
+
+int main(void)
+{
+	uint32_t t;
+
+	Flash_Erase();
+	Capacity_Init();
+	PowerBank();
+	Taper();
+	Capacity_Command("start 50 4000 60 2");
+	Poll();
+	for(t = 0; t < 200000 && Capacity_Get()->state != CAPACITY_STATE_DONE; t += BLOCK_MS)
+		Block(500, 5000, 0);
+	Host_Check(Capacity_Get()->reason == CAPACITY_END_TIMEOUT && Capacity_Get()->ms / 1000 == 120,
+	           "C: reason %u after %lu ms", Capacity_Get()->reason, (unsigned long)Capacity_Get()->ms);
+	Capacity_Command("start");
+	Poll();
+	Block(10, 5000, 0);
+	Capacity_Command("stop");
+	Host_Check(Capacity_Get()->reason == CAPACITY_END_STOP, "D: reason %u", Capacity_Get()->reason);
+	printf("flash: %lu erases, %lu programs\n", (unsigned long)flash_stat.erases, (unsigned long)flash_stat.progs);
+	Host_Check(!flash_stat.overruns, "%lu programs crossed a page", (unsigned long)flash_stat.overruns);
+	return Host_Done("capacity");
+}
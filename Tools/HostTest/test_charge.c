@@ -0,0 +1,116 @@
+//User/Charge on a synthetic Uin trace: attach at 5 V, fixed-level steps
+//with slew, a PPS level with four 20 mV steps, a long stretch of noise
+//and the detach. Every step must log one LOG_EVT_VSTEP dated at most one
+//block before the change and one LOG_EVT_PLATEAU with the new level and
+//class; the noise must log nothing.
+#include "charge.h"
+#include "log.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef struct
+{
+	int32_t mv;                     //new level
+	double noise;                   //block noise, mV rms
+	double slew;                    //mV per block
+	uint16_t blocks;
+	uint8_t cls;                    //expected class, 0xFF: no step
+} segment_t;
+
+typedef struct
+{
+	uint8_t type;
+	uint32_t ms;
+	uint16_t a, b;
+} event_t;
+
+static const segment_t trace[] = {
+	{5050, 3, 2000, 60, CHARGE_CLS_5V},
+	{9020, 3, 800, 60, CHARGE_CLS_9V},
+	{20100, 4, 1500, 60, CHARGE_CLS_20V},
+	{3300, 3, 3000, 60, CHARGE_CLS_VAR},
+	{3320, 3, 2000, 40, CHARGE_CLS_VAR},
+	{3340, 3, 2000, 40, CHARGE_CLS_VAR},
+	{3360, 3, 2000, 40, CHARGE_CLS_VAR},
+	{3380, 3, 2000, 40, CHARGE_CLS_VAR},
+	{3380, 3, 2000, 2000, 0xFF},    //64 s of noise
+	{0, 1, 3000, 40, CHARGE_CLS_OFF},
+};
+
+static uint32_t now_ms = 1000000;
+static event_t ev[8];
+static uint8_t evs;
+
+//====================stubs for the modules around====================//
+void TS_Now(ts_t *ts)
+{
+	ts->sec = now_ms / 1000;
+	ts->usec = now_ms % 1000 * 1000;
+}
+
+void Log_Event(uint8_t type, const ts_t *ts, uint16_t a, uint16_t b)
+{
+	if(evs < sizeof(ev) / sizeof(ev[0]))
+		ev[evs] = (event_t){type, ts->sec * 1000 + ts->usec / 1000, a, b};
+	evs++;
+}
+//==========================end of stubs============================//
+
+int main(void)
+{
+	acq_block_t b = {0};
+	double cur = 0, d;
+	int32_t from = 0;
+	uint32_t start;
+	uint16_t i;
+	uint8_t s, k, steps;
+
+	Host_Seed(2);
+	for(s = 0; s < sizeof(trace) / sizeof(trace[0]); s++)
+	{
+		const segment_t *t = &trace[s];
+
+		evs = 0;
+		start = now_ms;
+		for(i = 0; i < t->blocks; i++)
+		{
+			d = t->mv - cur;
+			if(fabs(d) > t->slew)
+				d = d > 0 ? t->slew : -t->slew;
+			cur += d;
+			b.val[ACQ_CH_UIN] = (int32_t)lrint(cur + t->noise * Host_Gauss());
+			Charge_Block(&b);
+			b.seq++;
+			now_ms += CHARGE_BLOCK_MS;
+		}
+		printf("%5ld mV:", (long)t->mv);
+		for(k = 0; k < evs && k < sizeof(ev) / sizeof(ev[0]); k++)
+			printf(" %s at %+ld ms %u/%u", ev[k].type == LOG_EVT_VSTEP ? "step" : "plateau",
+			       (long)(int32_t)(ev[k].ms - start), ev[k].a, ev[k].b);
+		printf("\n");
+		if(t->cls == 0xFF)
+		{
+			Host_Check(evs == 0, "%ld mV: %u events on noise", (long)t->mv, evs);
+			continue;
+		}
+		steps = s ? 1 : 0;      //the attach only logs the plateau
+		Host_Check(evs == steps + 1, "%ld mV: %u events", (long)t->mv, evs);
+		if(evs != steps + 1)
+			continue;
+		if(steps)
+		{
+			Host_Check(ev[0].type == LOG_EVT_VSTEP, "%ld mV: no step event", (long)t->mv);
+			Host_Check(ev[0].ms <= start && ev[0].ms + CHARGE_BLOCK_MS >= start, "%ld mV: step dated %+ld ms",
+			           (long)t->mv, (long)(int32_t)(ev[0].ms - start));
+			Host_Check(abs(ev[0].a - from) <= 10, "%ld mV: step from %u mV", (long)t->mv, ev[0].a);
+		}
+		Host_Check(ev[steps].type == LOG_EVT_PLATEAU, "%ld mV: no plateau event", (long)t->mv);
+		Host_Check(abs(ev[steps].a - t->mv) <= 10, "%ld mV: plateau at %u mV", (long)t->mv, ev[steps].a);
+		Host_Check(ev[steps].b == t->cls, "%ld mV: class %u", (long)t->mv, ev[steps].b);
+		from = t->mv;
+	}
+	Charge_Report();
+	return Host_Done("charge");
+}
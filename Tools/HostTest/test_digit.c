@@ -0,0 +1,128 @@
+//User/LCD/digit.c: readouts of every size and point position show random
+//values, small steps and out of range ones. The cells must read as
+//sprintf() formats the value (leading blanks, the sign in the last blank
+//cell, minus signs when it does not fit), every pixel must be the glyph
+//coverage through the blended palette, and Digit_Show() must send one
+//window per changed cell and nothing else.
+#include "main.h"
+#include "lcd.h"
+#include "digit.h"
+#include "digitfont.h"
+#include "emu.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VALUES              400     //per readout
+#define FG                  0xFFE0
+#define BG                  0x0010
+
+
+//the glyph of each cell from sprintf(), DIGIT_BLANK before the digits
+static void Expect(const digit_t *d, int32_t v, u8 *g)
+{
+	char s[16];
+	int len, k;
+
+	len = sprintf(s, "%0*lu", d->frac + 1, labs((long)v));
+	if(len > d->cells || (v < 0 && len == d->cells))
+	{
+		memset(g, DIGIT_MINUS, d->cells);
+		return;
+	}
+	memset(g, DIGIT_BLANK, d->cells);
+	for(k = 0; k < len; k++)
+		g[d->cells - len + k] = s[k] - '0';
+	if(v < 0)
+		g[d->cells - len - 1] = DIGIT_MINUS;
+}
+
+//pixels of one cell: 2 bpp coverage through the palette, or background;
+//a digit glyph (bits NULL, glyph not DIGIT_BLANK) is read through the row
+//numbers of digitfont.h
+static uint32_t Cell(const digit_t *d, u16 x0, u16 w, const u8 *bits, u8 glyph)
+{
+	uint32_t bad = 0;
+	const u8 *row;
+	u16 x, y;
+	u8 i;
+
+	for(y = 0; y < DIGIT_H; y++)
+		for(x = 0; x < w; x++)
+		{
+			if(bits)
+				row = &bits[y * (w / 4)];
+			else
+				row = glyph == DIGIT_BLANK ? NULL : digit_rows[digit_font[glyph][y / 2] >> (y % 2 ? 0 : 4) & 15];
+			i = row ? row[x / 4] >> (6 - x % 4 * 2) & 3 : 0;
+			bad += Emu_Pixel(x0 + x, d->y + y) != TILE_PX(d->clut[i]);
+		}
+	return bad;
+}
+
+static void Readout(u8 cells, u8 frac)
+{
+	digit_t d;
+	u8 g[DIGIT_CELLS], i, changed, sent;
+	uint32_t n, windows, bad;
+	int32_t v = 0, top = 1;
+	u16 x;
+
+	for(i = 0; i < cells; i++)
+		top *= 10;
+	Digit_Init(&d, Host_Rand() % 8, Host_Rand() % (lcddev.height - DIGIT_H), cells, frac, FG, BG);
+	Host_Check(d.clut[0] == TILE_PX(BG) && d.clut[3] == TILE_PX(FG), "%u.%u: palette ends", cells, frac);
+	Host_Check(Digit_Width(&d) + d.x <= lcddev.width, "%u.%u: wider than the panel", cells, frac);
+	for(n = 0; n < VALUES && !host_fails; n++)
+	{
+		switch(Host_Rand() % 4)
+		{
+		case 0:
+			v = (int32_t)((Host_Rand() << 15 | Host_Rand()) % (2 * (uint32_t)top + 1)) - top;  //includes the edges
+			break;
+		case 1:
+			v += (int32_t)(Host_Rand() % 5) - 2;                //most cells stay
+			break;
+		case 2:
+			v = (int32_t)(Host_Rand() % 200) - 100;
+			break;
+		default:
+			v = Host_Rand() % 2 ? top - 1 - Host_Rand() % 3 : -(top / 10) + Host_Rand() % 3;
+			break;
+		}
+		Expect(&d, v, g);
+		for(changed = 0, i = 0; i < cells; i++)
+			changed += g[i] != d.shown[i];
+		windows = emu_stat.windows;
+		sent = Digit_Show(&d, v);
+		Host_Check(sent == changed && emu_stat.windows - windows == changed + (n == 0 && frac),
+		           "%u.%u: %ld sent %u cells in %lu windows, %u changed", cells, frac, (long)v, sent,
+		           (unsigned long)(emu_stat.windows - windows), changed);
+		Host_Check(!memcmp(g, d.shown, cells), "%u.%u: %ld shows the wrong glyphs", cells, frac, (long)v);
+		for(bad = 0, x = d.x, i = 0; i < cells; i++, x += DIGIT_W)
+		{
+			if(frac && i == cells - frac)
+			{
+				bad += Cell(&d, x, DIGIT_POINT_W, digit_point, 0);
+				x += DIGIT_POINT_W;
+			}
+			bad += Cell(&d, x, DIGIT_W, NULL, g[i]);
+		}
+		Host_Check(!bad, "%u.%u: %ld: %lu pixels differ", cells, frac, (long)v, (unsigned long)bad);
+	}
+}
+
+int main(void)
+{
+	u8 cells, frac;
+
+	Host_Seed(13);
+	Host_Panel(1);          //landscape, a 9 cell readout is 152 px
+	LCD_Clear(BG);
+	for(cells = 1; cells <= DIGIT_CELLS; cells++)
+		for(frac = 0; frac < cells; frac++)
+			Readout(cells, frac);
+	printf("digit: %u readouts, %u values each\n", DIGIT_CELLS * (DIGIT_CELLS + 1) / 2, VALUES);
+	return Host_Done("digit");
+}
@@ -0,0 +1,308 @@
+//User/LCD/GUI.c primitives in both orientations against a frame buffer
+//drawn by the pixel-by-pixel versions they replaced (ported below from
+//the original GUI.c): lines, rectangles, outline and filled circles,
+//outline and filled triangles. GUI_FillPolygon() is checked against an
+//even-odd point-in-polygon test on pixel centres, polygons running off
+//the panel included, and GUI_FillRoundRect() against four corner discs
+//and two rectangles.
+#include "main.h"
+#include "lcd.h"
+#include "gui.h"
+#include "emu.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SHAPES              400     //per kind and orientation
+#define POLY_MAX            8
+
+static u16 fb[EMU_ROWS][EMU_COLS];
+
+static int Pick(int a, int b)
+{
+	return a + (int)(Host_Rand() % (b - a + 1));
+}
+
+//====================the original pixel-by-pixel primitives====================//
+static void Ref_Point(int x, int y, u16 c)
+{
+	if(x >= 0 && y >= 0 && x < lcddev.width && y < lcddev.height)
+		fb[y][x] = c;
+}
+
+static void Ref_Fill(int sx, int sy, int ex, int ey, u16 c)
+{
+	int x, y;
+
+	for(y = sy; y <= ey; y++)
+		for(x = sx; x <= ex; x++)
+			Ref_Point(x, y, c);
+}
+
+//one point past the end, as it always did
+static void Ref_Line(int x1, int y1, int x2, int y2)
+{
+	int t, xerr = 0, yerr = 0, dx = x2 - x1, dy = y2 - y1, distance, incx, incy, x = x1, y = y1;
+
+	incx = dx > 0 ? 1 : dx == 0 ? 0 : -1;
+	incy = dy > 0 ? 1 : dy == 0 ? 0 : -1;
+	dx = dx < 0 ? -dx : dx;
+	dy = dy < 0 ? -dy : dy;
+	distance = dx > dy ? dx : dy;
+	for(t = 0; t <= distance + 1; t++)
+	{
+		Ref_Point(x, y, POINT_COLOR);
+		xerr += dx;
+		yerr += dy;
+		if(xerr > distance)
+		{
+			xerr -= distance;
+			x += incx;
+		}
+		if(yerr > distance)
+		{
+			yerr -= distance;
+			y += incy;
+		}
+	}
+}
+
+static void Ref_Circle8(int xc, int yc, int x, int y, u16 c)
+{
+	Ref_Point(xc + x, yc + y, c);
+	Ref_Point(xc - x, yc + y, c);
+	Ref_Point(xc + x, yc - y, c);
+	Ref_Point(xc - x, yc - y, c);
+	Ref_Point(xc + y, yc + x, c);
+	Ref_Point(xc - y, yc + x, c);
+	Ref_Point(xc + y, yc - x, c);
+	Ref_Point(xc - y, yc - x, c);
+}
+
+static void Ref_Circle(int xc, int yc, u16 c, int r, int fill)
+{
+	int x = 0, y = r, yi, d = 3 - 2 * r;
+
+	while(x <= y)
+	{
+		if(fill)
+			for(yi = x; yi <= y; yi++)
+				Ref_Circle8(xc, yc, x, yi, c);
+		else
+			Ref_Circle8(xc, yc, x, y, c);
+		if(d < 0)
+			d = d + 4 * x + 6;
+		else
+		{
+			d = d + 4 * (x - y) + 10;
+			y--;
+		}
+		x++;
+	}
+}
+
+static void Swap(int *a, int *b)
+{
+	int t = *a;
+
+	*a = *b;
+	*b = t;
+}
+
+static void Ref_FillTriangle(int x0, int y0, int x1, int y1, int x2, int y2)
+{
+	int a, b, y, last, dx01, dy01, dx02, dy02, dx12, dy12;
+	long sa = 0, sb = 0;
+
+	if(y0 > y1)
+		Swap(&y0, &y1), Swap(&x0, &x1);
+	if(y1 > y2)
+		Swap(&y2, &y1), Swap(&x2, &x1);
+	if(y0 > y1)
+		Swap(&y0, &y1), Swap(&x0, &x1);
+	if(y0 == y2)
+	{
+		a = b = x0;
+		if(x1 < a)
+			a = x1;
+		else if(x1 > b)
+			b = x1;
+		if(x2 < a)
+			a = x2;
+		else if(x2 > b)
+			b = x2;
+		Ref_Fill(a, y0, b, y0, POINT_COLOR);
+		return;
+	}
+	dx01 = x1 - x0, dy01 = y1 - y0;
+	dx02 = x2 - x0, dy02 = y2 - y0;
+	dx12 = x2 - x1, dy12 = y2 - y1;
+	last = y1 == y2 ? y1 : y1 - 1;
+	for(y = y0; y <= last; y++)
+	{
+		a = x0 + sa / dy01;
+		b = x0 + sb / dy02;
+		sa += dx01;
+		sb += dx02;
+		if(a > b)
+			Swap(&a, &b);
+		Ref_Fill(a, y, b, y, POINT_COLOR);
+	}
+	sa = dx12 * (y - y1);
+	sb = dx02 * (y - y0);
+	for(; y <= y2; y++)
+	{
+		a = x1 + sa / dy12;
+		b = x0 + sb / dy02;
+		sa += dx12;
+		sb += dx02;
+		if(a > b)
+			Swap(&a, &b);
+		Ref_Fill(a, y, b, y, POINT_COLOR);
+	}
+}
+//==========================end of the originals============================//
+
+//even-odd on the pixel centre x + 0.5, y + 0.5; a centre on an edge is
+//right of it, so of two polygons sharing an edge exactly one fills it
+static void Ref_Polygon(const gui_point_t *p, u8 n, u16 c)
+{
+	double cx, cy, xe;
+	const gui_point_t *a, *b;
+	int x, y, in;
+	u8 i;
+
+	for(y = 0; y < lcddev.height; y++)
+		for(x = 0; x < lcddev.width; x++)
+		{
+			cx = x + 0.5;
+			cy = y + 0.5;
+			for(in = 0, i = 0; i < n; i++)
+			{
+				a = &p[i];
+				b = &p[(i + 1) % n];
+				if((a->y > cy) == (b->y > cy))
+					continue;
+				xe = a->x + (cy - a->y) * (b->x - a->x) / (b->y - a->y);
+				in ^= cx >= xe;
+			}
+			if(in)
+				fb[y][x] = c;
+		}
+}
+
+static void Ref_RoundRect(int x0, int y0, int x1, int y1, int r, u16 c)
+{
+	if(x0 > x1)
+		Swap(&x0, &x1);
+	if(y0 > y1)
+		Swap(&y0, &y1);
+	if(2 * r > x1 - x0)
+		r = (x1 - x0) / 2;
+	if(2 * r > y1 - y0)
+		r = (y1 - y0) / 2;
+	Ref_Fill(x0 + r, y0, x1 - r, y1, c);
+	Ref_Fill(x0, y0 + r, x1, y1 - r, c);
+	Ref_Circle(x0 + r, y0 + r, c, r, 1);
+	Ref_Circle(x1 - r, y0 + r, c, r, 1);
+	Ref_Circle(x0 + r, y1 - r, c, r, 1);
+	Ref_Circle(x1 - r, y1 - r, c, r, 1);
+}
+
+static void Compare(const char *kind, u8 dir, u16 n)
+{
+	uint32_t bad = 0;
+	u16 x, y;
+
+	for(y = 0; y < lcddev.height; y++)
+		for(x = 0; x < lcddev.width; x++)
+			bad += Emu_Pixel(x, y) != fb[y][x];
+	Host_Check(!bad, "%s %u in rotation %u: %lu pixels differ", kind, n, dir, (unsigned long)bad);
+}
+
+static void Shape(u8 kind, u8 dir, u16 n)
+{
+	static const char *name[] = {"line", "rectangle", "circle", "filled circle", "triangle", "filled triangle",
+	                             "polygon", "rounded rectangle"};
+	int w = lcddev.width, h = lcddev.height, x[3], y[3], r, i;
+	gui_point_t p[POLY_MAX];
+	u16 c = Host_Rand() * 2 + 1;
+	u8 m;
+
+	POINT_COLOR = c;
+	for(i = 0; i < 3; i++)
+	{
+		x[i] = Pick(1, w - 2);      //the line's extra point stays on the panel
+		y[i] = Pick(1, h - 2);
+	}
+	r = Pick(0, (w < h ? w : h) / 2 - 1);
+	switch(kind)
+	{
+	case 0:
+		if(Host_Rand() % 4 == 0)
+			y[1] = y[0];        //the single-window cases
+		else if(Host_Rand() % 3 == 0)
+			x[1] = x[0];
+		LCD_DrawLine(x[0], y[0], x[1], y[1]);
+		Ref_Line(x[0], y[0], x[1], y[1]);
+		break;
+	case 1:
+		LCD_DrawRectangle(x[0], y[0], x[1], y[1]);
+		Ref_Line(x[0], y[0], x[1], y[0]);
+		Ref_Line(x[0], y[0], x[0], y[1]);
+		Ref_Line(x[0], y[1], x[1], y[1]);
+		Ref_Line(x[1], y[0], x[1], y[1]);
+		break;
+	case 2:
+	case 3:
+		x[0] = Pick(r, w - 1 - r);
+		y[0] = Pick(r, h - 1 - r);
+		gui_circle(x[0], y[0], c, r, kind == 3);
+		Ref_Circle(x[0], y[0], c, r, kind == 3);
+		break;
+	case 4:
+		Draw_Triangel(x[0], y[0], x[1], y[1], x[2], y[2]);
+		for(i = 0; i < 3; i++)
+			Ref_Line(x[i], y[i], x[(i + 1) % 3], y[(i + 1) % 3]);
+		break;
+	case 5:
+		if(Host_Rand() % 8 == 0)
+			y[1] = y[0];
+		Fill_Triangel(x[0], y[0], x[1], y[1], x[2], y[2]);
+		Ref_FillTriangle(x[0], y[0], x[1], y[1], x[2], y[2]);
+		break;
+	case 6:
+		m = 3 + Host_Rand() % (POLY_MAX - 2);
+		for(i = 0; i < m; i++)
+			p[i] = (gui_point_t){Pick(-20, w + 20), Pick(-20, h + 20)};
+		GUI_FillPolygon(p, m, c);
+		Ref_Polygon(p, m, c);
+		break;
+	default:
+		r = Pick(0, 30);
+		GUI_FillRoundRect(x[0], y[0], x[1], y[1], r, c);
+		Ref_RoundRect(x[0], y[0], x[1], y[1], r, c);
+		break;
+	}
+	Compare(name[kind], dir, n);
+}
+
+int main(void)
+{
+	u16 n;
+	u8 dir, kind;
+
+	Host_Seed(17);
+	Host_Panel(0);
+	for(dir = 0; dir < 2; dir++)
+	{
+		LCD_direction(dir);
+		LCD_Clear(BLACK);
+		memset(fb, 0, sizeof(fb));
+		for(kind = 0; kind < 8; kind++)
+			for(n = 0; n < SHAPES && !host_fails; n++)
+				Shape(kind, dir, n);
+	}
+	printf("gui: %u shapes of 8 kinds in 2 orientations\n", SHAPES);
+	return Host_Done("gui");
+}
@@ -0,0 +1,330 @@
+//User/I2C_Bus on the I2C1 model (i2cdev.h), serviced by a bus task that
+//runs I2C_Bus_Process() as App_BusTask() does. Covered: DMA for reads of
+//I2C_BUS_DMA_MIN bytes or more and interrupts for one-byte reads and all
+//writes, with the data through the slave and the sleep lock held only
+//while the bus is busy; a NACK from a missing or busy slave failing with
+//AF and no bus recovery, and a retry from the completion callback; a bus
+//error, a slave holding SDA low (once within the nine recovery clocks,
+//once past them) and a BUSY flag stuck at init or before a start, each
+//ending in the watchdog or the errata recovery with the bus usable after;
+//callbacks submitting follow-ups, served in queue order without waiting
+//for the watchdog tick.
+#include "i2c_bus.h"
+#include "host.h"
+#include "i2cdev.h"
+#include "lpm.h"
+#include <stdio.h>
+#include <string.h>
+
+#define RTC_DEV             0xA2
+#define NO_DEV              0xD0
+#define XFERS               8
+#define LOG_LEN             32
+
+typedef struct
+{
+	uint8_t x;
+	uint8_t status;
+	uint32_t error;
+	uint32_t ms;
+} done_t;
+
+static uint8_t mem[256];
+static i2cdev_t rtc = {.dev = RTC_DEV};
+static i2c_xfer_t xf[XFERS];
+static uint8_t buf[XFERS][16];
+static done_t log_[LOG_LEN];
+static uint8_t nlog;
+static uint8_t tries[XFERS];
+static uint8_t follow[XFERS];       //the callback of xf[i] submits xf[follow[i]], 0 for none
+static sched_timer_t bus_timer;
+static uint8_t locks;
+
+//====================stubs for the modules around====================//
+uint32_t TS_LocalUs(void)
+{
+	return HAL_GetTick() * 1000;
+}
+
+void LPM_Lock(uint8_t lock)
+{
+	locks |= lock;
+}
+
+void LPM_Unlock(uint8_t lock)
+{
+	locks &= ~lock;
+}
+
+void LPM_Idle(uint32_t ms)
+{
+	(void)ms;
+}
+//==========================end of stubs============================//
+
+static void MemRead(uint8_t reg, uint8_t *b, uint8_t len)
+{
+	while(len--)
+		*b++ = mem[reg++];
+}
+
+static void MemWrite(uint8_t reg, const uint8_t *b, uint8_t len)
+{
+	while(len--)
+		mem[reg++] = *b++;
+}
+
+static void BusTask(uint8_t sig, uint32_t arg)
+{
+	(void)sig;
+	(void)arg;
+	I2C_Bus_Process();
+	if(!I2C_Bus_Idle())
+		Sched_TimerStart(&bus_timer, SCHED_TASK_BUS, I2C_BUS_SIG, I2C_BUS_TIMEOUT_MS, 0);
+	else
+		Sched_TimerStop(&bus_timer);
+}
+
+//logs the completion, retries a failed transfer up to tries[], submits the follow-up
+static void Done(i2c_xfer_t *x)
+{
+	uint8_t i = x - xf;
+
+	if(nlog < LOG_LEN)
+		log_[nlog++] = (done_t){i, x->status, x->error, HAL_GetTick()};
+	if(x->status == I2C_XFER_ERROR && tries[i])
+	{
+		tries[i]--;
+		Host_Check(I2C_Bus_Submit(x) == HAL_OK, "xfer %u: retry refused", i);
+	}
+	else if(follow[i])
+		Host_Check(I2C_Bus_Submit(&xf[follow[i]]) == HAL_OK, "xfer %u: follow-up refused", i);
+}
+
+static void Drain(void)
+{
+	while(Sched_Dispatch())
+		;
+}
+
+//run the bus in 0.1 ms steps until idle, the ms it took
+static uint32_t Settle(const char *what)
+{
+	uint32_t t0 = HAL_GetTick();
+
+	Drain();
+	while(!I2C_Bus_Idle() || I2cDev_Busy())
+	{
+		if(HAL_GetTick() - t0 > 100)
+		{
+			Host_Check(0, "%s: the bus did not settle", what);
+			break;
+		}
+		if(!I2cDev_Run())
+			Host_Advance(100000);
+		Drain();
+	}
+	Host_Check(!(locks & LPM_LOCK_I2C), "%s: sleep still locked on an idle bus", what);
+	return HAL_GetTick() - t0;
+}
+
+static void Submit(uint8_t i, uint8_t dev, uint8_t dir, uint8_t reg, uint8_t len)
+{
+	I2C_Bus_Setup(&xf[i], dev, dir, reg, buf[i], len, Done);
+	Host_Check(I2C_Bus_Submit(&xf[i]) == HAL_OK, "xfer %u: submit refused", i);
+}
+
+static void Expect(const char *what, const done_t *want, uint8_t n)
+{
+	uint8_t i;
+
+	Host_Check(nlog == n, "%s: %u callbacks, expected %u", what, nlog, n);
+	for(i = 0; i < n && i < nlog; i++)
+		Host_Check(log_[i].x == want[i].x && log_[i].status == want[i].status && log_[i].error == want[i].error,
+		           "%s: callback %u is xfer %u status %u error 0x%lx, expected %u/%u/0x%lx", what, i, log_[i].x,
+		           log_[i].status, (unsigned long)log_[i].error, want[i].x, want[i].status,
+		           (unsigned long)want[i].error);
+	nlog = 0;
+}
+
+static void Selection(void)
+{
+	i2cdev_stat_t s;
+	uint8_t len, dir, k;
+
+	for(dir = 0; dir < 2; dir++)
+		for(len = 1; len <= 16; len++)
+		{
+			s = i2cdev_stat;
+			for(k = 0; k < len; k++)
+				buf[0][k] = Host_Rand();
+			Submit(0, RTC_DEV, dir, 0x10 * (len - 1), len);
+			Host_Check(locks & LPM_LOCK_I2C, "%u-byte %s: sleep not locked with a transfer on the bus", len,
+			           dir ? "read" : "write");
+			Settle("selection");
+			Host_Check(nlog == 1 && log_[0].status == I2C_XFER_DONE, "%u-byte %s: did not complete", len,
+			           dir ? "read" : "write");
+			nlog = 0;
+			Host_Check(!memcmp(buf[0], &mem[0x10 * (len - 1)], len), "%u-byte %s: data differ", len,
+			           dir ? "read" : "write");
+			if(dir == I2C_XFER_READ && len >= I2C_BUS_DMA_MIN)
+				Host_Check(i2cdev_stat.dma == s.dma + 1, "%u-byte read: not DMA", len);
+			else
+				Host_Check(i2cdev_stat.it == s.it + 1, "%u-byte %s: not interrupt driven", len,
+				           dir ? "read" : "write");
+		}
+	Host_Check(!i2cdev_stat.dma_single, "%lu one-byte DMA reads", (unsigned long)i2cdev_stat.dma_single);
+	printf("i2c: %lu DMA, %lu interrupt transfers\n", (unsigned long)i2cdev_stat.dma, (unsigned long)i2cdev_stat.it);
+}
+
+static void Nack(void)
+{
+	static const done_t want[] = {
+		{0, I2C_XFER_ERROR, HAL_I2C_ERROR_AF}, {1, I2C_XFER_DONE, 0},
+		{2, I2C_XFER_ERROR, HAL_I2C_ERROR_AF}, {2, I2C_XFER_ERROR, HAL_I2C_ERROR_AF}, {2, I2C_XFER_DONE, 0},
+	};
+	uint32_t recoveries = i2c_bus_stats.recoveries, inits = i2cdev_stat.inits;
+
+	Submit(0, NO_DEV, I2C_XFER_READ, 0, 4);
+	Submit(1, RTC_DEV, I2C_XFER_READ, 0, 4);            //queued behind the NACK
+	Settle("nack");
+	rtc.fail = 2;
+	rtc.error = HAL_I2C_ERROR_AF;
+	tries[2] = 3;
+	Submit(2, RTC_DEV, I2C_XFER_WRITE, 0x40, 3);
+	Settle("nack retry");
+	Expect("nack", want, sizeof(want) / sizeof(want[0]));
+	Host_Check(tries[2] == 1, "nack: %u retries, expected 2", 3 - tries[2]);
+	Host_Check(i2c_bus_stats.recoveries == recoveries && i2cdev_stat.inits == inits,
+	           "nack: a NACK recovered the bus");
+	tries[2] = 0;
+}
+
+static void Faults(void)
+{
+	static const done_t want[] = {
+		{0, I2C_XFER_ERROR, HAL_I2C_ERROR_BERR}, {1, I2C_XFER_DONE, 0},
+		{0, I2C_XFER_ERROR, HAL_I2C_ERROR_TIMEOUT}, {1, I2C_XFER_DONE, 0},
+		{0, I2C_XFER_ERROR, HAL_I2C_ERROR_TIMEOUT}, {1, I2C_XFER_ERROR, HAL_I2C_ERROR_TIMEOUT}, {1, I2C_XFER_DONE, 0},
+		{2, I2C_XFER_ERROR, HAL_I2C_ERROR_TIMEOUT}, {2, I2C_XFER_DONE, 0},
+	};
+	i2c_bus_stats_t b = i2c_bus_stats;
+	i2cdev_stat_t s = i2cdev_stat;
+	uint32_t t0, ms;
+
+	//bus error: recovered at once, SDA is free so only the STOP is clocked
+	rtc.fail = 1;
+	rtc.error = HAL_I2C_ERROR_BERR;
+	Submit(0, RTC_DEV, I2C_XFER_READ, 0, 8);
+	Submit(1, RTC_DEV, I2C_XFER_READ, 0, 8);
+	Settle("bus error");
+	Host_Check(i2c_bus_stats.recoveries == b.recoveries + 1 && !i2c_bus_stats.timeouts,
+	           "bus error: %lu recoveries, %lu timeouts", (unsigned long)(i2c_bus_stats.recoveries - b.recoveries),
+	           (unsigned long)i2c_bus_stats.timeouts);
+	Host_Check(i2cdev_stat.clocks == s.clocks + 1 && i2cdev_stat.stops == s.stops + 1,
+	           "bus error: %lu clocks, %lu stops", (unsigned long)(i2cdev_stat.clocks - s.clocks),
+	           (unsigned long)(i2cdev_stat.stops - s.stops));
+
+	//SDA held for 5 clocks: the watchdog fires, the recovery frees it
+	s = i2cdev_stat;
+	rtc.hang = 5;
+	t0 = HAL_GetTick();
+	Submit(0, RTC_DEV, I2C_XFER_READ, 0, 8);
+	Submit(1, RTC_DEV, I2C_XFER_READ, 0, 8);
+	ms = Settle("hang");
+	Host_Check(i2c_bus_stats.timeouts == 1, "hang: %lu watchdog timeouts", (unsigned long)i2c_bus_stats.timeouts);
+	Host_Check(log_[2].ms - t0 > I2C_BUS_TIMEOUT_MS && log_[2].ms - t0 <= 2 * I2C_BUS_TIMEOUT_MS + 1,
+	           "hang: timed out after %lu ms", (unsigned long)(log_[2].ms - t0));
+	Host_Check(i2cdev_stat.clocks == s.clocks + 5 + 1 && i2cdev_stat.stops == s.stops + 1,
+	           "hang: %lu clocks, %lu stops", (unsigned long)(i2cdev_stat.clocks - s.clocks),
+	           (unsigned long)(i2cdev_stat.stops - s.stops));
+	printf("i2c: SDA held 5 clocks, bus back after %lu ms\n", (unsigned long)ms);
+
+	//SDA held past the nine clocks: BUSY stays, the next start is refused
+	//and recovers again; the refused transfer retries
+	s = i2cdev_stat;
+	b = i2c_bus_stats;
+	rtc.hang = 12;
+	tries[1] = 1;
+	Submit(0, RTC_DEV, I2C_XFER_READ, 0, 8);
+	Submit(1, RTC_DEV, I2C_XFER_READ, 0, 8);
+	Settle("long hang");
+	Host_Check(i2c_bus_stats.recoveries == b.recoveries + 2 && i2cdev_stat.refused == s.refused + 1,
+	           "long hang: %lu recoveries, %lu refused starts", (unsigned long)(i2c_bus_stats.recoveries - b.recoveries),
+	           (unsigned long)(i2cdev_stat.refused - s.refused));
+	Host_Check(HAL_GPIO_ReadPin(RTC_SDA_GPIO_Port, RTC_SDA_Pin) == GPIO_PIN_SET, "long hang: SDA still low");
+
+	//BUSY stuck before a start: refused, recovered, the retry goes through
+	b = i2c_bus_stats;
+	I2cDev_StuckBusy();
+	tries[2] = 1;
+	Submit(2, RTC_DEV, I2C_XFER_WRITE, 0x80, 2);
+	Settle("stuck busy");
+	Host_Check(i2c_bus_stats.recoveries == b.recoveries + 1, "stuck busy: %lu recoveries",
+	           (unsigned long)(i2c_bus_stats.recoveries - b.recoveries));
+	Expect("faults", want, sizeof(want) / sizeof(want[0]));
+
+	//BUSY stuck at power-on: I2C_Bus_Init() recovers
+	b = i2c_bus_stats;
+	I2cDev_StuckBusy();
+	I2C_Bus_Init();
+	Host_Check(i2c_bus_stats.recoveries == b.recoveries + 1 && !__HAL_I2C_GET_FLAG(&hi2c1, I2C_FLAG_BUSY),
+	           "stuck busy at init: not recovered");
+	Submit(0, RTC_DEV, I2C_XFER_READ, 0, 1);
+	Settle("after init");
+	Host_Check(nlog == 1 && log_[0].status == I2C_XFER_DONE, "after init: the read failed");
+	nlog = 0;
+}
+
+static void Chain(void)
+{
+	static const done_t want[] = {
+		{0, I2C_XFER_DONE, 0}, {1, I2C_XFER_DONE, 0}, {2, I2C_XFER_DONE, 0}, {3, I2C_XFER_DONE, 0},
+		{4, I2C_XFER_DONE, 0}, {5, I2C_XFER_DONE, 0}, {6, I2C_XFER_DONE, 0}, {7, I2C_XFER_DONE, 0},
+	};
+	uint32_t ms;
+	uint8_t i;
+
+	//0 -> 3 -> 4 -> 5 -> 6 -> 7, with 1 and 2 queued from the start
+	follow[0] = 3;
+	follow[3] = 4;
+	follow[4] = 5;
+	follow[5] = 6;
+	follow[6] = 7;
+	for(i = 3; i < XFERS; i++)
+		I2C_Bus_Setup(&xf[i], RTC_DEV, i % 2, 0x20 + i, buf[i], 1 + i, Done);
+	Submit(0, RTC_DEV, I2C_XFER_READ, 0x20, 4);
+	Submit(1, RTC_DEV, I2C_XFER_WRITE, 0x30, 1);
+	Host_Check(I2C_Bus_Submit(&xf[0]) == HAL_BUSY, "chain: an in-flight descriptor was queued again");
+	Submit(2, RTC_DEV, I2C_XFER_READ, 0x40, 2);
+	ms = Settle("chain");
+	Expect("chain", want, sizeof(want) / sizeof(want[0]));
+	Host_Check(ms < I2C_BUS_TIMEOUT_MS, "chain: took %lu ms", (unsigned long)ms);
+	memset(follow, 0, sizeof(follow));
+}
+
+int main(void)
+{
+	uint16_t i;
+
+	Host_Seed(27);
+	for(i = 0; i < sizeof(mem); i++)
+		mem[i] = Host_Rand();
+	rtc.read = MemRead;
+	rtc.write = MemWrite;
+	I2cDev_Attach(&rtc);
+	Host_Pin(RTC_SDA_GPIO_Port, RTC_SDA_Pin | RTC_SCL_Pin, 1);
+	Sched_Init();
+	Sched_Register(SCHED_TASK_BUS, "bus", BusTask);
+	HAL_I2C_Init(&hi2c1);
+	I2C_Bus_Init();
+	Selection();
+	Nack();
+	Faults();
+	Chain();
+	printf("i2c: %lu done, %lu errors, %lu timeouts, %lu recoveries, %lu recovery clocks\n",
+	       (unsigned long)i2c_bus_stats.done, (unsigned long)i2c_bus_stats.errors,
+	       (unsigned long)i2c_bus_stats.timeouts, (unsigned long)i2c_bus_stats.recoveries,
+	       (unsigned long)i2cdev_stat.clocks);
+	return Host_Done("i2c");
+}
@@ -0,0 +1,173 @@
+//User/Key on scripted edge traces, replayed through Key_Edge() and
+//Key_Timeout() as Key_Process() does: the deadlines are served only when
+//Key_Timeout() asked for them. The pins follow the trace, so the level
+//re-read after a lockout is the settled one. Covered: a key held at
+//power-on, bounces and a glitch inside the debounce window, click, long
+//press, auto-repeat on up/down only, two- and three-key chords and two
+//presses too far apart to be one. Then random clicks with bounce trains
+//on both edges must each give exactly PRESS, CLICK and RELEASE.
+#include "key.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CLICKS              300
+#define NEVER               0xFFFFFFFF
+
+typedef struct
+{
+	uint32_t ms;
+	uint8_t key;
+	uint8_t down;
+} edge_t;
+
+#define U                   KEY_UP
+#define D                   KEY_DOWN
+#define E                   KEY_ENTER
+#define MU                  KEY_MASK_UP
+#define MD                  KEY_MASK_DOWN
+#define ME                  KEY_MASK_ENTER
+
+static const edge_t trace[] = {
+	{300, U, 1}, {500, U, 0},                                       //click while enter is still held from power-on
+	{1500, E, 0}, {1502, E, 1}, {1504, E, 0},                       //power-on press released, with bounce
+	{2000, U, 1}, {2003, U, 0}, {2006, U, 1}, {2009, U, 0}, {2012, U, 1},
+	{2400, U, 0}, {2401, U, 1}, {2403, U, 0},                       //bouncy click
+	{3000, D, 1}, {3006, D, 0},                                     //glitch
+	{4000, U, 1}, {5300, U, 0},                                     //long press, repeats
+	{6000, E, 1}, {7000, E, 0},                                     //long press, enter does not repeat
+	{8000, U, 1}, {8050, D, 1}, {9000, U, 0}, {9030, D, 0},         //chord, held past the long press
+	{10000, U, 1}, {10200, D, 1}, {10300, D, 0}, {10400, U, 0},     //too far apart for a chord
+	{11000, U, 1}, {11040, D, 1}, {11500, E, 1},                    //enter joins the chord
+	{12000, U, 0}, {12010, D, 0}, {12020, E, 0},
+};
+
+static const key_event_t want[] = {
+	{KEY_EV_PRESS, MU, 300}, {KEY_EV_CLICK, MU, 500}, {KEY_EV_RELEASE, MU, 500},
+	{KEY_EV_RELEASE, ME, 1500},
+	{KEY_EV_PRESS, MU, 2000}, {KEY_EV_CLICK, MU, 2400}, {KEY_EV_RELEASE, MU, 2400},
+	{KEY_EV_PRESS, MD, 3000}, {KEY_EV_RELEASE, MD, 3020},
+	{KEY_EV_PRESS, MU, 4000}, {KEY_EV_LONG, MU, 4800}, {KEY_EV_REPEAT, MU, 4920}, {KEY_EV_REPEAT, MU, 5040},
+	{KEY_EV_REPEAT, MU, 5160}, {KEY_EV_REPEAT, MU, 5280}, {KEY_EV_RELEASE, MU, 5300},
+	{KEY_EV_PRESS, ME, 6000}, {KEY_EV_LONG, ME, 6800}, {KEY_EV_RELEASE, ME, 7000},
+	{KEY_EV_PRESS, MU, 8000}, {KEY_EV_PRESS, MD, 8050}, {KEY_EV_CHORD, MU | MD, 8050},
+	{KEY_EV_RELEASE, MU, 9000}, {KEY_EV_RELEASE, MD, 9030},
+	{KEY_EV_PRESS, MU, 10000}, {KEY_EV_PRESS, MD, 10200}, {KEY_EV_CLICK, MD, 10300}, {KEY_EV_RELEASE, MD, 10300},
+	{KEY_EV_CLICK, MU, 10400}, {KEY_EV_RELEASE, MU, 10400},
+	{KEY_EV_PRESS, MU, 11000}, {KEY_EV_PRESS, MD, 11040}, {KEY_EV_CHORD, MU | MD, 11040},
+	{KEY_EV_PRESS, ME, 11500}, {KEY_EV_CHORD, MU | MD | ME, 11500},
+	{KEY_EV_RELEASE, MU, 12000}, {KEY_EV_RELEASE, MD, 12010}, {KEY_EV_RELEASE, ME, 12020},
+};
+
+static const char *ev_name[] = {"press", "release", "click", "long", "repeat", "chord"};
+static key_event_t got[CLICKS * 3 + 8];
+static uint16_t ngot;
+static edge_t clicks[CLICKS * 12];
+
+//====================stubs for the modules around====================//
+void LPM_Idle(uint32_t ms)
+{
+	(void)ms;
+}
+//==========================end of stubs============================//
+
+static void Pin(uint8_t key, uint8_t down)
+{
+	static GPIO_TypeDef *const port[KEY_NUM] = {Key_up_GPIO_Port, Key_down_GPIO_Port, Key_enter_Det_GPIO_Port};
+	static const uint16_t pin[KEY_NUM] = {Key_up_Pin, Key_down_Pin, Key_enter_Det_Pin};
+
+	Host_Pin(port[key], pin[key], !down);      //the keys pull the line low
+}
+
+//the edges at their times, the deadlines only when Key_Timeout() asked for them
+static void Replay(const edge_t *e, uint16_t n, uint32_t from, uint32_t to)
+{
+	uint32_t now, next = NEVER, d;
+	uint16_t i = 0;
+	uint8_t woken;
+
+	ngot = 0;
+	for(now = from; now <= to; now++)
+	{
+		for(woken = 0; i < n && e[i].ms == now; i++, woken = 1)
+		{
+			Pin(e[i].key, e[i].down);
+			Key_Edge(e[i].key, e[i].down, now);
+		}
+		if(woken || now == next)
+		{
+			d = Key_Timeout(now);
+			next = d == NEVER ? NEVER : now + d;
+		}
+		while(ngot < sizeof(got) / sizeof(got[0]) && Key_GetEvent(&got[ngot]))
+			ngot++;
+	}
+	Host_Check(next == NEVER, "a deadline is still pending at %lu ms", (unsigned long)to);
+}
+
+static void Compare(const char *what, const key_event_t *w, uint16_t n)
+{
+	uint16_t i;
+
+	for(i = 0; i < n || i < ngot; i++)
+	{
+		if(i < n && i < ngot && got[i].type == w[i].type && got[i].keys == w[i].keys && got[i].ms == w[i].ms)
+			continue;
+		Host_Check(0, "%s: event %u is %s %u at %lu ms, expected %s %u at %lu ms", what, i,
+		           i < ngot ? ev_name[got[i].type] : "none", i < ngot ? got[i].keys : 0,
+		           (unsigned long)(i < ngot ? got[i].ms : 0), i < n ? ev_name[w[i].type] : "none",
+		           i < n ? w[i].keys : 0, (unsigned long)(i < n ? w[i].ms : 0));
+		return;
+	}
+}
+
+//an odd number of edges ending on the level 'down', all inside the lockout
+static uint16_t Bounce(edge_t *e, uint32_t ms, uint8_t key, uint8_t down)
+{
+	uint8_t i, n = 2 * (Host_Rand() % 5) + 1;
+
+	for(i = 0; i < n; i++)
+	{
+		e[i] = (edge_t){ms, key, i % 2 ? !down : down};
+		ms += 1 + Host_Rand() % (KEY_DEBOUNCE_MS / n);
+	}
+	return n;
+}
+
+static void Clicks(void)
+{
+	static key_event_t w[CLICKS * 3];
+	uint32_t ms = 20000, held;
+	uint16_t n = 0, k;
+	uint8_t key;
+
+	for(k = 0; k < CLICKS; k++)
+	{
+		key = Host_Rand() % KEY_NUM;
+		held = KEY_DEBOUNCE_MS + 1 + Host_Rand() % (KEY_LONG_MS - KEY_DEBOUNCE_MS - 2);
+		w[3 * k] = (key_event_t){KEY_EV_PRESS, 1 << key, ms};
+		n += Bounce(&clicks[n], ms, key, 1);
+		ms += held;
+		w[3 * k + 1] = (key_event_t){KEY_EV_CLICK, 1 << key, ms};
+		w[3 * k + 2] = (key_event_t){KEY_EV_RELEASE, 1 << key, ms};
+		n += Bounce(&clicks[n], ms, key, 0);
+		ms += KEY_DEBOUNCE_MS + 1 + Host_Rand() % 300;
+	}
+	Replay(clicks, n, 20000, ms + KEY_LONG_MS);
+	Compare("random clicks", w, CLICKS * 3);
+	printf("key: %u random clicks, %u edges\n", CLICKS, n);
+}
+
+int main(void)
+{
+	Host_Seed(29);
+	Pin(KEY_UP, 0);
+	Pin(KEY_DOWN, 0);
+	Pin(KEY_ENTER, 1);                      //held at power-on
+	Key_Init();
+	Replay(trace, sizeof(trace) / sizeof(trace[0]), 0, 13000);
+	Compare("trace", want, sizeof(want) / sizeof(want[0]));
+	printf("key: %u edges, %u events\n", (unsigned)(sizeof(trace) / sizeof(trace[0])), ngot);
+	Clicks();
+	return Host_Done("key");
+}
@@ -0,0 +1,161 @@
+//User/LCD/layer.c at 2, 4 and 8 bpp: random layers take random fills,
+//pixels, text (with bytes not in the font) and palette changes, mirrored
+//into a plain index array. Over a background rectangle the tiled layer
+//must show the palette colour of every reference index, and the
+//background where the index is the transparent key. Layer_Flush() must
+//send exactly the box the drawing touched, and nothing once the layer is
+//clean.
+#include "main.h"
+#include "lcd.h"
+#include "gui.h"
+#include "layer.h"
+#include "emu.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LAYERS              300
+#define OPS                 12      //drawing calls between flushes
+#define MAX_W               LCD_W
+#define MAX_H               60
+#define BG                  0x4208
+#define CLEAR               0x1234  //not in any palette
+
+static const char *text[] = {"12.5 mA", "Uin", "\xc9\xee\xdb\xda" "V", "gj|"};
+static u8 bits[LAYER_BYTES(MAX_W, MAX_H, 8)];
+static u16 clut[256], color[256];
+static u8 ref[MAX_H][MAX_W];
+static int box[4];                  //reference dirty box, empty when box[0] > box[2]
+
+static void Touch(int x0, int y0, int x1, int y1)
+{
+	if(box[0] > box[2])
+	{
+		box[0] = x0, box[1] = y0, box[2] = x1, box[3] = y1;
+		return;
+	}
+	box[0] = x0 < box[0] ? x0 : box[0];
+	box[1] = y0 < box[1] ? y0 : box[1];
+	box[2] = x1 > box[2] ? x1 : box[2];
+	box[3] = y1 > box[3] ? y1 : box[3];
+}
+
+//one random drawing call on the layer and the reference
+static void Op(layer_t *l)
+{
+	const u8 *s, *g;
+	u16 x0 = Host_Rand() % (l->w + 8), y0 = Host_Rand() % (l->h + 8), x1 = x0 + Host_Rand() % 40, y1 = y0 + Host_Rand() % 20, x, y, r, c;
+	u8 i = Host_Rand() % (1 << l->bpp);
+
+	switch(Host_Rand() % 8)
+	{
+	case 0:
+	case 1:
+	case 2:
+		Layer_Fill(l, x0, y0, x1, y1, i);
+		x1 = x1 < l->w ? x1 : l->w - 1;
+		y1 = y1 < l->h ? y1 : l->h - 1;
+		if(x0 > x1 || y0 > y1)
+			break;
+		for(y = y0; y <= y1; y++)
+			for(x = x0; x <= x1; x++)
+				ref[y][x] = i;
+		Touch(x0, y0, x1, y1);
+		break;
+	case 3:
+	case 4:
+		Layer_Pixel(l, x0, y0, i);
+		if(x0 >= l->w || y0 >= l->h)
+			break;
+		ref[y0][x0] = i;
+		Touch(x0, y0, x0, y0);
+		break;
+	case 5:
+	case 6:
+		s = (const u8 *)text[Host_Rand() % (sizeof(text) / sizeof(text[0]))];
+		Host_Check(Layer_Text(l, x0, y0, (const char *)s, i) >= x0, "text went backwards");
+		for(x = x0; *s && x < l->w; s++, x += 8)
+		{
+			g = GUI_Glyph16(*s);
+			for(r = 0; g && r < 16 && y0 + r < l->h; r++)
+				for(c = 0; c < 8 && x + c < l->w; c++)
+					if(g[r] >> c & 1)       //glyph rows are LSB first
+						ref[y0 + r][x + c] = i;
+		}
+		if(x > x0 && y0 < l->h)
+			Touch(x0, y0, (x < l->w ? x : l->w) - 1, y0 + 15 < l->h ? y0 + 15 : l->h - 1);
+		break;
+	default:
+		color[i] = Host_Rand() * 2 + (Host_Rand() & 1);
+		if(color[i] == CLEAR || color[i] == BG)
+			color[i]++;
+		Layer_Color(l, i, color[i]);
+		Touch(0, 0, l->w - 1, l->h - 1);
+		break;
+	}
+}
+
+//the panel over the layer against the reference, CLEAR outside the box
+static void Compare(const layer_t *l, const int *b, const char *when, u16 n)
+{
+	uint32_t bad = 0;
+	u16 x, y, want;
+	u8 i;
+
+	for(y = 0; y < l->h; y++)
+		for(x = 0; x < l->w; x++)
+		{
+			i = ref[y][x];
+			want = x < b[0] || x > b[2] || y < b[1] || y > b[3] ? CLEAR : i == l->key ? BG : color[i];
+			bad += Emu_Pixel(l->x + x, l->y + y) != want;
+		}
+	Host_Check(!bad, "layer %u %ux%u at %u bpp, %s: %lu pixels differ", n, l->w, l->h, l->bpp, when,
+	           (unsigned long)bad);
+}
+
+int main(void)
+{
+	static const u8 bpp[] = {2, 4, 8};
+	const int all[4] = {0, 0, MAX_W, MAX_H};
+	tile_item_t item[2];
+	layer_t l;
+	uint32_t bytes;
+	u16 n, k, j;
+
+	Host_Seed(9);
+	Host_Panel(0);
+	for(n = 0; n < LAYERS && !host_fails; n++)
+	{
+		Layer_Init(&l, 0, 0, 1 + Host_Rand() % MAX_W, 1 + Host_Rand() % MAX_H, bpp[n % 3], bits, clut);
+		l.x = Host_Rand() % (lcddev.width - l.w + 1);
+		l.y = Host_Rand() % (lcddev.height - l.h + 1);
+		l.key = Host_Rand() % 2 ? LAYER_OPAQUE : Host_Rand() % (1 << l.bpp);
+		for(j = 0; j < 1 << l.bpp; j++)
+			Layer_Color(&l, j, color[j] = j * 0x0841 + 1);
+		Layer_Fill(&l, 0, 0, l.w - 1, l.h - 1, 0);
+		memset(ref, 0, sizeof(ref));
+		item[0] = (tile_item_t){TILE_RECT, l.x, l.y, l.x + l.w - 1, l.y + l.h - 1, BG, NULL};
+		item[1] = (tile_item_t){TILE_LAYER, 0, 0, 0, 0, 0, &l};
+		box[0] = 0, box[1] = 0, box[2] = l.w - 1, box[3] = l.h - 1;      //all dirty since Layer_Init()
+		for(k = 0; k < 4; k++)
+		{
+			for(j = Host_Rand() % OPS; j; j--)
+				Op(&l);
+			Host_Check(box[0] > box[2] ? l.dx0 > l.dx1 : l.dx0 == box[0] && l.dy0 == box[1] && l.dx1 == box[2] &&
+			           l.dy1 == box[3], "layer %u: dirty box %u,%u-%u,%u", n, l.dx0, l.dy0, l.dx1, l.dy1);
+			LCD_Fill(l.x, l.y, l.x + l.w - 1, l.y + l.h - 1, CLEAR);
+			Layer_Flush(&l, item, 2);
+			Compare(&l, box, "flush", n);
+			bytes = emu_stat.bytes;
+			Layer_Flush(&l, item, 2);
+			Host_Check(emu_stat.bytes == bytes, "layer %u: a clean flush sent %lu bytes", n,
+			           (unsigned long)(emu_stat.bytes - bytes));
+			box[0] = 1;
+			box[2] = 0;
+		}
+		Tile_Render(l.x, l.y, l.x + l.w - 1, l.y + l.h - 1, item, 2);
+		Compare(&l, all, "whole", n);
+	}
+	printf("layer: %u layers, %u flushes each\n", LAYERS, k);
+	return Host_Done("layer");
+}
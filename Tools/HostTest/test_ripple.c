@@ -0,0 +1,167 @@
+//User/Ripple: the Q15 real FFT against a double precision DFT for every
+//block size, then a whole analysis (Ripple_Start() to Ripple_Get()) of a
+//synthetic capture with two tones and noise against the known rms, tone
+//frequencies and amplitudes.
+#include "ripple.h"
+#include "clock.h"
+#include "tile.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define RATE_HZ             176470  //Acq_BurstRate() at the full profile
+#define MV_PER_COUNT        (3300.0 * 11 / 4096)
+
+static uint32_t tile_buf[TILE_PIXELS];
+static double tone_hz[2], tone_counts[2], noise;
+static double capture_rms;          //AC rms of the last capture, counts
+
+//====================stubs for the modules around====================//
+int32_t Cal_Apply(uint8_t ch, uint16_t raw)
+{
+	(void)ch;
+	return (int32_t)lrint(raw * MV_PER_COUNT);
+}
+
+uint8_t Clock_GetProfile(void)
+{
+	return CLOCK_FULL;
+}
+
+void Clock_Require(uint8_t user, uint8_t profile)
+{
+	(void)user;
+	(void)profile;
+}
+
+void Sched_TimerStart(sched_timer_t *t, uint8_t task, uint8_t sig, uint32_t delay, uint32_t period)
+{
+	(void)t;
+	(void)task;
+	(void)sig;
+	(void)delay;
+	(void)period;
+}
+
+void *Tile_Lend(void)
+{
+	return tile_buf;
+}
+
+void Tile_Return(void)
+{
+}
+
+uint32_t Acq_BurstRate(void)
+{
+	return RATE_HZ;
+}
+
+//the capture: mid-scale, two tones and uniform noise of rms "noise"
+HAL_StatusTypeDef Acq_Burst(uint8_t ch, uint16_t *buf, uint16_t n, uint8_t task, uint8_t sig)
+{
+	double v, mean = 0, ms = 0;
+	uint16_t i;
+
+	(void)ch;
+	(void)task;
+	(void)sig;
+	for(i = 0; i < n; i++)
+	{
+		v = 2000 + tone_counts[0] * sin(2 * M_PI * tone_hz[0] * i / RATE_HZ) +
+		    tone_counts[1] * sin(2 * M_PI * tone_hz[1] * i / RATE_HZ + 1) +
+		    noise * (Host_Rand() / 16384.0 - 1) * sqrt(3);
+		buf[i] = (uint16_t)lrint(v);
+		mean += buf[i];
+	}
+	mean /= n;
+	for(i = 0; i < n; i++)
+		ms += (buf[i] - mean) * (buf[i] - mean);
+	capture_rms = sqrt(ms / n);
+	return HAL_OK;
+}
+//==========================end of stubs============================//
+
+//relative rms error of the bin magnitudes against the DFT
+static void Fft(uint16_t n, double amp, double noise_counts, double limit)
+{
+	static int16_t x[FFT_N_MAX] __attribute__((aligned(4)));
+	static double xd[FFT_N_MAX];
+	uint32_t *p = (uint32_t *)x;
+	double re, im, pr, pf, err = 0, ref = 0, v;
+	uint16_t i, k;
+	uint8_t e;
+
+	for(i = 0; i < n; i++)
+	{
+		v = amp * sin(2 * M_PI * (n / 7.3) * i / n + 0.3) + noise_counts * (Host_Rand() / 16384.0 - 1);
+		x[i] = (int16_t)lrint(v > 32767 ? 32767 : v);
+	}
+	Fft_Hann(x, n);
+	for(i = 0; i < n; i++)
+		xd[i] = x[i];
+	e = Fft_Real(x, n);
+	for(k = 0; k < n / 2; k++)
+	{
+		re = im = 0;
+		for(i = 0; i < n; i++)
+		{
+			re += xd[i] * cos(2 * M_PI * k * i / n);
+			im -= xd[i] * sin(2 * M_PI * k * i / n);
+		}
+		pr = (re * re + im * im) / 4;
+		pf = p[k] * pow(4, e);
+		err += (sqrt(pf) - sqrt(pr)) * (sqrt(pf) - sqrt(pr));
+		ref += pr;
+	}
+	err = sqrt(err / ref);
+	printf("fft n %4u amplitude %5.0f: exponent %u, rel rms error %.2e\n", n, amp, e, err);
+	Host_Check(err < limit, "fft n %u amplitude %.0f: error above %.0e", n, amp, limit);
+}
+
+static void Analysis(uint16_t n)
+{
+	ripple_result_t r;
+	double v;
+	uint8_t k;
+
+	tone_hz[0] = 2500;             //above RIPPLE_SKIP_BINS at both sizes
+	tone_counts[0] = 20;
+	tone_hz[1] = 12000;
+	tone_counts[1] = 5;
+	noise = 2;
+	Ripple_Start(ACQ_CH_UIN, n);
+	Ripple_Process(RIPPLE_SIG_WAIT, 0);        //captures through the stub
+	Ripple_Process(RIPPLE_SIG_DONE, 1);
+	Host_Check(Ripple_Get(&r), "ripple n %u: no result", n);
+	v = capture_rms * MV_PER_COUNT;
+	printf("ripple n %4u: rms %ld/%.1f mV, pp %ld mV", n, (long)r.rms, v, (long)r.pp);
+	for(k = 0; k < r.peaks; k++)
+		printf(", %lu Hz %ld mV", (unsigned long)r.peak[k].hz, (long)r.peak[k].amp);
+	printf("\n");
+	Host_Check(fabs(r.rms - v) <= v * 0.02 + 1, "ripple n %u: rms", n);
+	Host_Check(r.peaks >= 2, "ripple n %u: %u peaks", n, r.peaks);
+	for(k = 0; k < 2 && k < r.peaks; k++)
+	{
+		v = tone_counts[k] * MV_PER_COUNT;
+		Host_Check(fabs((double)r.peak[k].hz - tone_hz[k]) <= tone_hz[k] * 0.01, "ripple n %u: tone %u frequency", n, k);
+		Host_Check(fabs(r.peak[k].amp - v) <= MV_PER_COUNT, "ripple n %u: tone %u amplitude", n, k);
+	}
+}
+
+int main(void)
+{
+	uint16_t n;
+
+	Host_Seed(1);
+	for(n = FFT_N_MIN; n <= FFT_N_MAX; n *= 2)
+	{
+		Fft(n, 20000, 100, 2e-3);
+		Fft(n, 200, 100, 3e-3);
+		Fft(n, 3, 0, 0.2);          //a few counts: rounding dominates
+	}
+	Analysis(1024);
+	Analysis(512);
+	return Host_Done("ripple");
+}
@@ -0,0 +1,200 @@
+//User/LCD/rle.c: random flat, dithered, gradient and noise images are
+//packed with the encoder of Tools/rleconv.py (re-checked on gImage_qq) and
+//decoded whole and in random pieces with skips. Pages of three images,
+//one more than TILE_STREAMS, over a background are then tiled on random
+//areas and compared with a reference composite, and Rle_Draw() puts an
+//image where it belongs. Prints the compression of each kind of image.
+#include "main.h"
+#include "lcd.h"
+#include "rle.h"
+#include "pic.h"
+#include "emu.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_W               LCD_W
+#define MAX_H               80
+#define IMAGES              3
+#define PAGES               200
+#define AREAS               4
+#define BG                  0x4208
+#define CLEAR               0x1234
+
+enum {FLAT, DITHER, GRADIENT, NOISE, KINDS};
+
+static const char *kind_name[KINDS] = {"flat", "dithered", "gradient", "noise"};
+static u16 px[IMAGES][MAX_W * MAX_H];       //panel byte order
+static u8 data[IMAGES][MAX_W * MAX_H * 2 + MAX_W * MAX_H / RLE_LIT_MAX + 8];
+static rle_image_t img[IMAGES];
+static u32 size[IMAGES];              //stream bytes
+static u32 raw_bytes[KINDS], packed_bytes[KINDS];
+static u16 page[EMU_ROWS][EMU_COLS];
+
+//literals p[end - lit] to p[end - 1]
+static u32 Literal(const u16 *p, u32 end, u32 lit, u8 *out)
+{
+	u32 len = 0;
+
+	if(!lit)
+		return 0;
+	out[len++] = lit - 1;
+	memcpy(out + len, p + end - lit, lit * 2);
+	return len + lit * 2;
+}
+
+//rleconv.py encode(): a run from RLE_RUN_MIN equal pixels, literals otherwise
+static u32 Encode(const u16 *p, u32 n, u8 *out)
+{
+	u32 i = 0, r, lit = 0, len = 0;
+
+	while(i < n)
+	{
+		for(r = 1; i + r < n && r < 0x7F + RLE_RUN_MIN && p[i + r] == p[i]; r++)
+			;
+		if(r >= RLE_RUN_MIN)
+		{
+			len += Literal(p, i, lit, out + len);
+			lit = 0;
+			out[len++] = 0x80 | (r - RLE_RUN_MIN);
+			memcpy(out + len, &p[i], 2);
+			len += 2;
+			i += r;
+			continue;
+		}
+		lit++;
+		i++;
+		if(lit == RLE_LIT_MAX)
+		{
+			len += Literal(p, i, lit, out + len);
+			lit = 0;
+		}
+	}
+	return len + Literal(p, i, lit, out + len);
+}
+
+static u16 Rgb(u8 r, u8 g, u8 b)
+{
+	return TILE_PX((r >> 3) << 11 | (g >> 2) << 5 | b >> 3);
+}
+
+static void Image(u8 k)
+{
+	u16 w = 1 + Host_Rand() % MAX_W, h = 1 + Host_Rand() % MAX_H, x, y, i, c[4];
+	u8 kind = Host_Rand() % KINDS;
+	u32 n = (u32)w * h;
+
+	for(i = 0; i < 4; i++)
+		c[i] = Host_Rand() * 2 + (Host_Rand() & 1);
+	for(y = 0; y < h; y++)
+		for(x = 0; x < w; x++)
+			px[k][y * w + x] = kind == FLAT ? c[(x / 17 + y / 9) % 3] : kind == DITHER ? c[(x ^ y) & 3] :
+			                   kind == GRADIENT ? Rgb(x * 255 / w, y * 255 / h, 128) : (u16)(Host_Rand() * 2 + x);
+	img[k].w = w;
+	img[k].h = h;
+	img[k].data = data[k];
+	raw_bytes[kind] += n * 2;
+	size[k] = Encode(px[k], n, data[k]);
+	packed_bytes[kind] += size[k];
+}
+
+//the whole image, then in random pieces with skips, against the pixels
+static void Decode(u8 k)
+{
+	static u16 out[MAX_W * MAX_H];
+	u32 n = (u32)img[k].w * img[k].h, i, m;
+	rle_dec_t d;
+
+	memset(out, 0, sizeof(out));
+	Rle_Begin(&d, &img[k]);
+	Rle_Read(&d, out, n);
+	Host_Check(!memcmp(out, px[k], n * 2), "image %ux%u: decoded pixels differ", img[k].w, img[k].h);
+	Host_Check(d.n == 0 && d.p == data[k] + size[k], "image %ux%u: stream not used up",
+	           img[k].w, img[k].h);
+	memset(out, 0, sizeof(out));
+	Rle_Begin(&d, &img[k]);
+	for(i = 0; i < n; i += m)
+	{
+		m = 1 + Host_Rand() % 300;
+		m = m < n - i ? m : n - i;
+		Rle_Read(&d, Host_Rand() % 3 ? out + i : NULL, m);
+	}
+	for(i = 0; i < n && (!out[i] || out[i] == px[k][i]); i++)
+		;
+	Host_Check(i == n, "image %ux%u: piecewise decode differs at %lu", img[k].w, img[k].h, (unsigned long)i);
+}
+
+static void Page(u16 number)
+{
+	tile_item_t item[IMAGES + 1];
+	u16 x, y, x0, y0, x1, y1, w = lcddev.width, h = lcddev.height;
+	uint32_t bad;
+	u8 k, a;
+
+	item[0] = (tile_item_t){TILE_RECT, 0, 0, w - 1, h - 1, BG, NULL};
+	for(y = 0; y < h; y++)
+		for(x = 0; x < w; x++)
+			page[y][x] = BG;
+	for(k = 0; k < IMAGES; k++)
+	{
+		Image(k);
+		Decode(k);
+		x0 = Host_Rand() % (w - img[k].w + 1);
+		y0 = Host_Rand() % (h - img[k].h + 1);
+		item[k + 1] = (tile_item_t){TILE_IMAGE, x0, y0, x0 + img[k].w - 1, y0 + img[k].h - 1, 0, &img[k]};
+		for(y = 0; y < img[k].h; y++)
+			for(x = 0; x < img[k].w; x++)
+				page[y0 + y][x0 + x] = TILE_PX(px[k][y * img[k].w + x]);
+	}
+	for(a = 0; a <= AREAS; a++)
+	{
+		x0 = a ? Host_Rand() % w : 0;
+		y0 = a ? Host_Rand() % h : 0;
+		x1 = a ? x0 + Host_Rand() % (w - x0) : w - 1;
+		y1 = a ? y0 + Host_Rand() % (h - y0) : h - 1;
+		LCD_Clear(CLEAR);
+		Tile_Render(x0, y0, x1, y1, item, IMAGES + 1);
+		for(bad = 0, y = 0; y < h; y++)
+			for(x = 0; x < w; x++)
+				bad += Emu_Pixel(x, y) != (x >= x0 && x <= x1 && y >= y0 && y <= y1 ? page[y][x] : CLEAR);
+		Host_Check(!bad, "page %u area %u,%u-%u,%u: %lu pixels differ", number, x0, y0, x1, y1, (unsigned long)bad);
+	}
+	k = Host_Rand() % IMAGES;
+	LCD_Clear(CLEAR);
+	Rle_Draw(item[k + 1].x0, item[k + 1].y0, &img[k]);
+	for(bad = 0, y = 0; y < img[k].h; y++)
+		for(x = 0; x < img[k].w; x++)
+			bad += Emu_Pixel(item[k + 1].x0 + x, item[k + 1].y0 + y) != TILE_PX(px[k][y * img[k].w + x]);
+	Host_Check(!bad, "page %u: Rle_Draw() %lu pixels differ", number, (unsigned long)bad);
+}
+
+//the shipped image decodes from exactly its bytes and packs back the same
+static void Shipped(void)
+{
+	static u16 out[40 * 40];
+	static u8 again[sizeof(gImage_qq_rle)];
+	rle_dec_t d;
+
+	Rle_Begin(&d, &gImage_qq);
+	Rle_Read(&d, out, 40 * 40);
+	Host_Check(d.p == gImage_qq_rle + sizeof(gImage_qq_rle) && !d.n, "gImage_qq: stream not used up");
+	Host_Check(Encode(out, 40 * 40, again) == sizeof(again) && !memcmp(again, gImage_qq_rle, sizeof(again)),
+	           "gImage_qq: the encoder here does not match rleconv.py");
+	printf("rle: gImage_qq 3200 -> %u bytes\n", (unsigned)sizeof(gImage_qq_rle));
+}
+
+int main(void)
+{
+	u16 n;
+	u8 k;
+
+	Host_Seed(11);
+	Host_Panel(0);
+	Shipped();
+	for(n = 0; n < PAGES && !host_fails; n++)
+		Page(n);
+	for(k = 0; k < KINDS; k++)
+		printf("rle: %-8s %7lu -> %7lu bytes, %3.0f %%\n", kind_name[k], (unsigned long)raw_bytes[k],
+		       (unsigned long)packed_bytes[k], raw_bytes[k] ? 100.0 * packed_bytes[k] / raw_bytes[k] : 0);
+	return Host_Done("rle");
+}
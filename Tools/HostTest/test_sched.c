@@ -0,0 +1,259 @@
+//User/Sched: dispatch order (the lowest ready task first, signals before
+//messages, a signal raised by a handler taking over at once), signal
+//coalescing, Sched_Post() on a full queue, then the timer wheel against
+//a reference list: one-shot and periodic timers with delays well past the
+//32 slots, started, restarted and stopped at random while the tick runs
+//in 1 ms steps and in gaps longer than the wheel, across the 32-bit tick
+//wrap. Each timer must fire on the first dispatch at or after its expiry,
+//an overrun periodic timer once, with its missed periods dropped, and
+//Sched_NextTimeout() must name the earliest one.
+#include "sched.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TIMERS              64      //tasks 0 and 1, one signal each
+#define STEPS               200000
+#define MAX_DELAY           150
+
+typedef struct
+{
+	uint8_t task, sig;
+	uint32_t arg;
+} run_t;
+
+typedef struct
+{
+	uint32_t expire, period;
+	uint8_t armed;
+} ref_t;
+
+static run_t runs[64];
+static uint8_t nruns;
+static uint16_t fired[TIMERS];
+static sched_timer_t timer[TIMERS];
+static ref_t ref[TIMERS];
+static uint8_t chain;               //task 5 signals task 0 from its handler this many times
+
+//====================stubs for the modules around====================//
+void LPM_Idle(uint32_t ms)
+{
+	(void)ms;
+}
+//==========================end of stubs============================//
+
+static void Record(uint8_t task, uint8_t sig, uint32_t arg)
+{
+	if(nruns < sizeof(runs) / sizeof(runs[0]))
+		runs[nruns] = (run_t){task, sig, arg};
+	nruns++;
+}
+
+#define TASK(n)                                                 \
+	static void Task##n(uint8_t sig, uint32_t arg)              \
+	{                                                           \
+		if(n < 2 && arg == 0 && sig < 32)                       \
+			fired[n * 32 + sig]++;                              \
+		Record(n, sig, arg);                                    \
+		if(n == 5 && chain && chain--)                          \
+			Sched_Signal(0, 7);                                 \
+	}
+TASK(0)
+TASK(1)
+TASK(2)
+TASK(3)
+TASK(4)
+TASK(5)
+
+static void Drain(void)
+{
+	while(Sched_Dispatch())
+		;
+}
+
+static void Expect(const char *what, const run_t *want, uint8_t n)
+{
+	uint8_t i;
+
+	Host_Check(nruns == n, "%s: %u runs, expected %u", what, nruns, n);
+	for(i = 0; i < n && i < nruns; i++)
+		Host_Check(runs[i].task == want[i].task && runs[i].sig == want[i].sig && runs[i].arg == want[i].arg,
+		           "%s: run %u is task %u sig %u arg %lu, expected %u/%u/%lu", what, i, runs[i].task,
+		           runs[i].sig, (unsigned long)runs[i].arg, want[i].task, want[i].sig, (unsigned long)want[i].arg);
+	nruns = 0;
+}
+
+static void Order(void)
+{
+	static const run_t want[] = {
+		{0, 2, 0}, {1, 30, 0}, {1, 4, 100}, {3, 1, 300}, {3, 2, 301},
+		{4, 0, 0}, {4, 9, 0}, {5, 6, 500}, {0, 7, 0}, {5, 6, 501}, {0, 7, 0}, {5, 6, 502},
+	};
+
+	Sched_Post(5, 6, 500);
+	Sched_Post(5, 6, 501);
+	Sched_Post(5, 6, 502);
+	Sched_Signal(4, 9);
+	Sched_Post(3, 1, 300);
+	Sched_Post(3, 2, 301);
+	Sched_Signal(4, 0);
+	Sched_Post(1, 4, 100);
+	Sched_Signal(1, 30);
+	Sched_Signal(0, 2);
+	chain = 2;
+	Drain();
+	Expect("priority order", want, sizeof(want) / sizeof(want[0]));
+}
+
+static void Coalesce(void)
+{
+	static const run_t want[] = {{2, 0, 0}, {2, 3, 0}, {2, 31, 0}};
+	uint8_t i;
+
+	for(i = 0; i < 5; i++)
+	{
+		Sched_Signal(2, 3);
+		Sched_Signal(2, 31);
+		Sched_Signal(2, 0);
+	}
+	Drain();
+	Expect("coalescing", want, sizeof(want) / sizeof(want[0]));
+	Host_Check(!Sched_Dispatch(), "coalescing: still ready");
+}
+
+static void Overflow(void)
+{
+	run_t want[SCHED_QUEUE_LEN];
+	uint8_t i, ok = 0;
+
+	for(i = 0; i < SCHED_QUEUE_LEN + 3; i++)
+	{
+		if(Sched_Post(3, 1, 1000 + i) != HAL_OK)
+			continue;
+		want[ok] = (run_t){3, 1, 1000 + i};
+		ok++;
+	}
+	Host_Check(ok == SCHED_QUEUE_LEN - 1, "overflow: %u of %u posted", ok, SCHED_QUEUE_LEN + 3);
+	Drain();
+	Expect("overflow", want, ok);
+	Host_Check(Sched_Post(3, 1, 2000) == HAL_OK, "overflow: the queue did not empty");
+	Drain();
+	nruns = 0;
+}
+
+static void Start(uint8_t i, uint32_t delay, uint32_t period)
+{
+	Sched_TimerStart(&timer[i], i / 32, i % 32, delay, period);
+	ref[i].expire = HAL_GetTick() + (delay ? delay : 1);
+	ref[i].period = period;
+	ref[i].armed = 1;
+}
+
+//fire every due reference timer once; the wheel gives the same signals
+static void Due(uint32_t now, uint16_t *want)
+{
+	uint8_t i;
+
+	for(i = 0; i < TIMERS; i++)
+	{
+		if(!ref[i].armed || (int32_t)(now - ref[i].expire) < 0)
+			continue;
+		want[i]++;
+		if(!ref[i].period)
+		{
+			ref[i].armed = 0;
+			continue;
+		}
+		ref[i].expire += ref[i].period;
+		if((int32_t)(now - ref[i].expire) >= 0)
+			ref[i].expire = now + ref[i].period;
+	}
+}
+
+static uint32_t Next(uint32_t now)
+{
+	uint32_t best = 0xFFFFFFFF;
+	uint8_t i;
+
+	for(i = 0; i < TIMERS; i++)
+	{
+		if(!ref[i].armed)
+			continue;
+		if((int32_t)(ref[i].expire - now) <= 0)
+			return 0;
+		if(ref[i].expire - now < best)
+			best = ref[i].expire - now;
+	}
+	return best;
+}
+
+static void Wheel(void)
+{
+	static uint16_t want[TIMERS];
+	uint32_t k, now, gaps = 0, overruns = 0, late = 0;
+	uint8_t i;
+
+	memset(fired, 0, sizeof(fired));
+	for(k = 0; k < STEPS && !host_fails; k++)
+	{
+		if(Host_Rand() % 8 == 0)
+		{
+			i = Host_Rand() % TIMERS;
+			switch(Host_Rand() % 4)
+			{
+			case 0:
+				Sched_TimerStop(&timer[i]);
+				ref[i].armed = 0;
+				break;
+			case 1:
+				Start(i, Host_Rand() % MAX_DELAY, 1 + Host_Rand() % 70);
+				break;
+			default:
+				Start(i, Host_Rand() % 4 ? Host_Rand() % MAX_DELAY : 32 * (1 + Host_Rand() % 4), 0);
+				break;
+			}
+		}
+		if(Host_Rand() % 200 == 0)
+		{
+			Host_Advance((uint64_t)(1 + Host_Rand() % 120) * 1000000);
+			gaps++;
+		}
+		else
+			Host_Advance(1000000);
+		now = HAL_GetTick();
+		for(i = 0; i < TIMERS; i++)
+		{
+			overruns += ref[i].armed && ref[i].period && (int32_t)(now - ref[i].expire - ref[i].period) >= 0;
+			late += ref[i].armed && (int32_t)(now - ref[i].expire) > 0;
+		}
+		Host_Check(Sched_NextTimeout() == Next(now), "tick %lu: next timeout %lu before the dispatch, expected %lu",
+		           (unsigned long)now, (unsigned long)Sched_NextTimeout(), (unsigned long)Next(now));
+		Due(now, want);
+		Drain();
+		Host_Check(!memcmp(fired, want, sizeof(want)), "tick %lu: the wheel fired other timers than the reference",
+		           (unsigned long)now);
+		Host_Check(Sched_NextTimeout() == Next(now), "tick %lu: next timeout %lu, expected %lu", (unsigned long)now,
+		           (unsigned long)Sched_NextTimeout(), (unsigned long)Next(now));
+		nruns = 0;
+	}
+	printf("sched: %lu ticks to %lu, %lu gaps, %lu late expiries, %lu periodic overruns\n", (unsigned long)k,
+	       (unsigned long)HAL_GetTick(), (unsigned long)gaps, (unsigned long)late, (unsigned long)overruns);
+}
+
+int main(void)
+{
+	Host_Seed(23);
+	Host_Advance((uint64_t)(0xFFFFFFFF - 60000) * 1000000);    //the tick wraps during the wheel run
+	Sched_Init();
+	Sched_Register(0, "t0", Task0);
+	Sched_Register(1, "t1", Task1);
+	Sched_Register(2, "t2", Task2);
+	Sched_Register(3, "t3", Task3);
+	Sched_Register(4, "t4", Task4);
+	Sched_Register(5, "t5", Task5);
+	Order();
+	Coalesce();
+	Overflow();
+	Wheel();
+	return Host_Done("sched");
+}
@@ -0,0 +1,128 @@
+//User/Stats against exact two-pass statistics over the same frames:
+//count, min, max, mean and the summed squared deviations of the session,
+//the histogram counts and the P2 quantiles against the sorted samples.
+//The bat channel steps its mean by 1 mV per window with little noise, so
+//the session variance is mostly the between-window term of the merge.
+#include "stats.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define WINDOWS             5
+#define FRAMES              (STATS_WINDOW_N * WINDOWS + 1234)   //the open window is not in the session
+#define CLOSED              (STATS_WINDOW_N * WINDOWS)
+
+static uint16_t frame[FRAMES][ACQ_CH_NUM];
+static int32_t cur[FRAMES];
+
+//stub: a plain gain per channel
+int32_t Cal_Apply(uint8_t ch, uint16_t raw)
+{
+	static const int32_t gain[ACQ_CH_NUM] = {1, 25, 9, 1};
+
+	return raw * gain[ch];
+}
+
+static int Cmp(const void *a, const void *b)
+{
+	int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void Frames(void)
+{
+	int32_t r;
+	uint32_t i;
+
+	for(i = 0; i < FRAMES; i++)
+	{
+		r = 1500 + (int32_t)(Host_Gauss() * 300);
+		if(Host_Rand() % 100 == 0)
+			r += 2000;          //load steps into the 4 A range
+		r = r < 0 ? 0 : r > 4095 ? 4095 : r;
+		frame[i][ACQ_CH_I4A] = r / 4;
+		frame[i][ACQ_CH_I100MA] = r;
+		frame[i][ACQ_CH_UIN] = 2000 + Host_Rand() % 50;
+		frame[i][ACQ_CH_BAT] = 1800 + i / STATS_WINDOW_N + (Host_Rand() % 4 == 0);
+		cur[i] = r < STATS_RANGE_RAW ? Cal_Apply(ACQ_CH_I100MA, r) : Cal_Apply(ACQ_CH_I4A, r / 4) * 1000;
+	}
+}
+
+static void Moments(void)
+{
+	stats_acc_t a;
+	double sum, m2, mean, v;
+	int32_t mn, mx;
+	uint32_t i;
+	uint8_t ch;
+
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+	{
+		sum = 0;
+		mn = INT32_MAX;
+		mx = INT32_MIN;
+		for(i = 0; i < CLOSED; i++)
+		{
+			v = Cal_Apply(ch, frame[i][ch]);
+			sum += v;
+			mn = v < mn ? v : mn;
+			mx = v > mx ? v : mx;
+		}
+		mean = sum / CLOSED;
+		m2 = 0;
+		for(i = 0; i < CLOSED; i++)
+		{
+			v = Cal_Apply(ch, frame[i][ch]) - mean;
+			m2 += v * v;
+		}
+		Stats_Get(ch, STATS_SESSION, &a);
+		printf("ch%u n %lu mean %.4f/%.4f m2 %.0f/%.0f sd %lu/%.2f min %ld/%ld max %ld/%ld\n", ch,
+		       (unsigned long)a.n, a.mean / 65536.0, mean, (double)a.m2, m2, (unsigned long)Stats_Std(&a),
+		       sqrt(m2 / (CLOSED - 1)), (long)a.min, (long)mn, (long)a.max, (long)mx);
+		Host_Check(a.n == CLOSED, "ch%u: %lu samples in the session", ch, (unsigned long)a.n);
+		Host_Check(a.min == mn && a.max == mx, "ch%u: min/max", ch);
+		Host_Check(fabs(a.mean / 65536.0 - mean) < 0.01, "ch%u: mean", ch);
+		Host_Check(fabs(a.m2 - m2) <= m2 * 0.001 + 1, "ch%u: squared deviations", ch);
+	}
+}
+
+static void Quantiles(void)
+{
+	static const double p[STATS_Q_NUM] = {0.50, 0.95, 0.99};
+	int32_t q, ref;
+	uint32_t n, i;
+	uint8_t k;
+
+	for(k = 0; k < STATS_HIST_BINS; k++)
+	{
+		for(n = 0, i = 0; i < FRAMES; i++)
+			n += (uint32_t)cur[i] >= Stats_HistLow(k) &&
+			     (k == STATS_HIST_BINS - 1 || (uint32_t)cur[i] < Stats_HistLow(k + 1));
+		Host_Check(Stats_HistBin(k) == n, "bin %u from %lu uA: %lu, expected %lu", k,
+		           (unsigned long)Stats_HistLow(k), (unsigned long)Stats_HistBin(k), (unsigned long)n);
+	}
+	qsort(cur, FRAMES, sizeof(cur[0]), Cmp);
+	for(k = 0; k < STATS_Q_NUM; k++)
+	{
+		q = Stats_Quantile(k);
+		ref = cur[(uint32_t)(FRAMES * p[k])];
+		printf("p%.0f %ld/%ld uA\n", p[k] * 100, (long)q, (long)ref);
+		Host_Check(labs(q - ref) <= ref / 100, "p%.0f off by more than 1 %%", p[k] * 100);
+	}
+}
+
+int main(void)
+{
+	uint32_t i;
+
+	Host_Seed(7);
+	Frames();
+	Stats_Init();
+	for(i = 0; i < FRAMES; i += ACQ_BLOCK)
+		Stats_Block(&frame[i], FRAMES - i < ACQ_BLOCK ? FRAMES - i : ACQ_BLOCK);
+	Moments();
+	Quantiles();
+	return Host_Done("stats");
+}
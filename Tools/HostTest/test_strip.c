@@ -0,0 +1,154 @@
+//User/LCD/strip.c on the panel model, built into this file to reach its
+//history and scale. 60000 blocks of a wandering load with steps and a
+//9 V stretch go through Strip_Block() with Strip_Draw() at random; after
+//every draw each scrolling line on the panel must match a reference line
+//rendered from the history, and a draw without a rescale must send only
+//the new lines. Strip_Hide() must leave the normal, unscrolled display.
+#include "../../User/LCD/strip.c"
+#include "emu.h"
+#include "host.h"
+#include <math.h>
+
+#define BLOCKS              60000
+
+static u16 ref[LCD_W];
+
+static int Ref_X(uint8_t t, int32_t v)
+{
+	int64_t d = (int64_t)v - lo[t];
+
+	if(d < 0)
+		return 0;
+	if(d > (int64_t)per_div[t] * STRIP_DIVS)
+		return LCD_W - 1;
+	return (int)(d * gain[t] >> 16);
+}
+
+static int In_History(int64_t s)
+{
+	return s >= 0 && s < lines && lines - s <= count;
+}
+
+//chart line s as strip.h describes it
+static void Ref_Line(int64_t s)
+{
+	strip_env_t e, p;
+	int x, a, b;
+	uint8_t t, i;
+
+	for(x = 0; x < LCD_W; x++)
+		ref[x] = BLACK;
+	if(In_History(s) && s % STRIP_GRID_LINES == 0)
+		for(x = 0; x < LCD_W; x += 2)
+			ref[x] = GRAY2;
+	else if(!(s & 1))
+		for(i = 0; i <= STRIP_DIVS; i++)
+			ref[i * (LCD_W - 1) / STRIP_DIVS] = GRAY2;
+	if(!In_History(s))
+		return;
+	for(t = 0; t < STRIP_TRACES; t++)
+	{
+		e = env[s % STRIP_HIST][t];
+		a = Ref_X(t, e.min);
+		b = Ref_X(t, e.max);
+		if(In_History(s - 1))
+		{
+			p = env[(s - 1) % STRIP_HIST][t];
+			a = Ref_X(t, p.max) < a ? Ref_X(t, p.max) : a;
+			b = Ref_X(t, p.min) > b ? Ref_X(t, p.min) : b;
+		}
+		for(x = a; x <= b; x++)
+			ref[x] = (trace[t].color >> 1) & 0x7BEF;
+		ref[Ref_X(t, e.min)] = trace[t].color;
+		ref[Ref_X(t, e.max)] = trace[t].color;
+	}
+}
+
+//the scrolling area against the reference, oldest line at the top
+static void Compare(const char *when, uint32_t block)
+{
+	uint32_t bad = 0;
+	u16 j, x, first = 0, at = 0;
+
+	for(j = 0; j < STRIP_LINES; j++)
+	{
+		Ref_Line((int64_t)lines - STRIP_LINES + j);
+		for(x = 0; x < LCD_W; x++)
+			if(Emu_Pixel(x, STRIP_TOP + j) != ref[x] && !bad++)
+				first = j, at = x;
+	}
+	Host_Check(!bad, "%s at block %lu: %lu pixels differ, first at line %u x %u", when, (unsigned long)block,
+	           (unsigned long)bad, first, at);
+}
+
+//a row drawn after Strip_Hide() must show where it was drawn
+static void Unscrolled(void)
+{
+	static const u16 y[] = {0, STRIP_TOP, STRIP_TOP + STRIP_LINES / 2, LCD_H - 1};
+	uint8_t i;
+
+	LCD_Clear(BLACK);
+	for(i = 0; i < sizeof(y) / sizeof(y[0]); i++)
+	{
+		LCD_Fill(0, y[i], LCD_W - 1, y[i], RED);
+		Host_Check(Emu_Pixel(LCD_W / 2, y[i]) == RED && Emu_Pixel(LCD_W / 2, y[i] + 1) != RED,
+		           "row %u is not where it was drawn after the hide", y[i]);
+	}
+}
+
+int main(void)
+{
+	acq_block_t b = {0};
+	double ma = 500, mv;
+	uint32_t k, draws = 0, paints = 0, fresh, pixels;
+	uint8_t repaint;
+
+	Host_Seed(3);
+	Host_Panel(0);
+	for(k = 0; k < STRIP_BLOCKS * STRIP_LINES * 2; k++)
+	{
+		b.load_ua = 500000;
+		b.val[ACQ_CH_UIN] = 5100;
+		Strip_Block(&b);
+	}
+	Strip_Show();
+	Compare("show", 0);
+	for(k = 0; k < BLOCKS && !host_fails; k++)
+	{
+		ma += ((int)(Host_Rand() % 21) - 10) * 0.5;
+		if(Host_Rand() % 500 == 0)
+			ma += (int)(Host_Rand() % 1500) - 700;
+		ma = ma < 0 ? 0 : ma > 3900 ? 3900 : ma;
+		mv = (k > 30000 && k < 30500 ? 9000 : 5100) - ma * 0.2 + (int)(Host_Rand() % 7) - 3;
+		b.load_ua = (int32_t)lrint(ma * 1000);
+		b.val[ACQ_CH_UIN] = (int32_t)lrint(mv);
+		Strip_Block(&b);
+		if(k == 45000)
+		{
+			Strip_Hide();
+			Unscrolled();
+		}
+		if(k == 47000)
+		{
+			Strip_Show();
+			Compare("show again", k);
+		}
+		if(Host_Rand() % (k < 20000 ? 4 : 40) || !visible)
+			continue;
+		repaint = redraw || lines - shown >= STRIP_LINES;
+		fresh = lines - shown;
+		pixels = emu_stat.pixels;
+		Strip_Draw();
+		draws++;
+		if(repaint)
+			paints++;
+		else
+			Host_Check(emu_stat.pixels - pixels == fresh * LCD_W, "block %lu: %lu pixels for %lu new lines",
+			           (unsigned long)k, (unsigned long)(emu_stat.pixels - pixels), (unsigned long)fresh);
+		Compare("draw", k);
+	}
+	printf("strip: %lu draws, %lu repaints; I %ld..%ld mA, U %ld..%ld mV\n", (unsigned long)draws,
+	       (unsigned long)paints, (long)lo[0], (long)(lo[0] + per_div[0] * STRIP_DIVS), (long)lo[1],
+	       (long)(lo[1] + per_div[1] * STRIP_DIVS));
+	return Host_Done("strip");
+}
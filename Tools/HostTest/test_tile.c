@@ -0,0 +1,157 @@
+//User/LCD/tile.c on the panel model: random pages of rectangles, frames,
+//left and centred 16 px text (with bytes not in the font) and column
+//charts, in all four rotations. Each page is drawn once directly with the
+//GUI.c calls, then through Tile_Page() and through Tile_Render() on
+//random areas over a cleared panel; the tiled pixels must match the
+//direct ones inside the area and leave the rest alone. Every area must go
+//out in one window.
+#include "main.h"
+#include "lcd.h"
+#include "gui.h"
+#include "tile.h"
+#include "emu.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PAGES               40      //per rotation
+#define ITEMS               14
+#define AREAS               6       //per page
+#define CLEAR               0x1234  //not produced by any item
+
+static const char *text[] = {"Tile 12.5 mA", "Uin 5.012 V", "\xc9\xee\xdb\xda" " 3", "gj", "0123456789ABCDEF"};
+static u16 direct[EMU_ROWS][EMU_COLS];
+static tile_item_t item[ITEMS];
+static u8 bars[ITEMS][EMU_ROWS];
+
+static u16 Pick(u16 a, u16 b)
+{
+	return a + Host_Rand() % (b - a + 1);
+}
+
+static u16 Color(void)
+{
+	static const u16 c[] = {WHITE, RED, GREEN, BLUE, YELLOW, GRAY, BROWN, 0x8410, 0x07FF};
+
+	return c[Host_Rand() % (sizeof(c) / sizeof(c[0]))];
+}
+
+//a random draw list on a background rectangle, text kept on the panel
+static void Page(void)
+{
+	u16 w = lcddev.width, h = lcddev.height, len, j;
+	tile_item_t *it;
+
+	item[0] = (tile_item_t){TILE_RECT, 0, 0, w - 1, h - 1, Color(), NULL};
+	for(it = item + 1; it < item + ITEMS; it++)
+	{
+		it->type = Host_Rand() % 5 == 0 ? TILE_BARS : Host_Rand() % 4;
+		it->color = Color();
+		it->x0 = Pick(0, w - 1);
+		it->y0 = Pick(0, h - 1);
+		it->x1 = Pick(it->x0, w - 1);
+		it->y1 = Pick(it->y0, h - 1);
+		if(it->type == TILE_BARS)
+		{
+			for(j = 0; j <= it->x1 - it->x0; j++)
+				bars[it - item][j] = Host_Rand() % (it->y1 - it->y0 + 40);
+			it->data = bars[it - item];
+			continue;
+		}
+		if(it->type != TILE_TEXT && it->type != TILE_TEXT_CENTER)
+			continue;
+		it->data = text[Host_Rand() % (sizeof(text) / sizeof(text[0]))];
+		len = strlen(it->data) * 8;
+		it->x0 = Pick(0, w - len);
+		it->x1 = Pick(it->x0, w - 1);
+		it->y0 = Pick(0, h - 16);
+	}
+}
+
+//the page with the GUI.c calls, read back from the panel
+static void Direct(void)
+{
+	const tile_item_t *it;
+	u16 x, y, len, j, hh;
+
+	for(it = item; it < item + ITEMS; it++)
+		switch(it->type)
+		{
+		case TILE_RECT:
+			LCD_Fill(it->x0, it->y0, it->x1, it->y1, it->color);
+			break;
+		case TILE_FRAME:
+			POINT_COLOR = it->color;
+			LCD_DrawRectangle(it->x0, it->y0, it->x1, it->y1);
+			break;
+		case TILE_TEXT:
+		case TILE_TEXT_CENTER:
+			x = it->x0;
+			len = strlen(it->data) * 8;
+			if(it->type == TILE_TEXT_CENTER && len < it->x1 - it->x0 + 1)
+				x += (it->x1 - it->x0 + 1 - len) / 2;
+			Show_Str(x, it->y0, it->color, BLACK, (u8 *)it->data, 16, 1);
+			break;
+		case TILE_BARS:
+			for(j = 0; j <= it->x1 - it->x0; j++)
+			{
+				hh = ((const u8 *)it->data)[j];
+				if(hh > it->y1 - it->y0 + 1)
+					hh = it->y1 - it->y0 + 1;
+				if(hh)
+					LCD_Fill(it->x0 + j, it->y1 - hh + 1, it->x0 + j, it->y1, it->color);
+			}
+			break;
+		}
+	for(y = 0; y < lcddev.height; y++)
+		for(x = 0; x < lcddev.width; x++)
+			direct[y][x] = Emu_Pixel(x, y);
+}
+
+static void Tiled(u8 dir, u16 page, u16 x0, u16 y0, u16 x1, u16 y1)
+{
+	uint32_t bad = 0, windows;
+	u16 x, y, want;
+
+	LCD_Clear(CLEAR);
+	windows = emu_stat.windows;
+	Tile_Render(x0, y0, x1, y1, item, ITEMS);
+	Host_Check(emu_stat.windows - windows == 1, "rotation %u page %u: %lu windows for one area", dir, page,
+	           (unsigned long)(emu_stat.windows - windows));
+	for(y = 0; y < lcddev.height; y++)
+		for(x = 0; x < lcddev.width; x++)
+		{
+			want = x >= x0 && x <= x1 && y >= y0 && y <= y1 ? direct[y][x] : CLEAR;
+			bad += Emu_Pixel(x, y) != want;
+		}
+	Host_Check(!bad, "rotation %u page %u area %u,%u-%u,%u: %lu pixels differ", dir, page, x0, y0, x1, y1,
+	           (unsigned long)bad);
+}
+
+int main(void)
+{
+	u16 page, k, x0, y0;
+	u8 dir;
+
+	Host_Seed(5);
+	Host_Panel(0);
+	for(dir = 0; dir < 4; dir++)
+	{
+		LCD_direction(dir);
+		for(page = 0; page < PAGES && !host_fails; page++)
+		{
+			Page();
+			Direct();
+			Tiled(dir, page, 0, 0, lcddev.width - 1, lcddev.height - 1);
+			for(k = 0; k < AREAS; k++)
+			{
+				x0 = Pick(0, lcddev.width - 1);
+				y0 = Pick(0, lcddev.height - 1);
+				Tiled(dir, page, x0, y0, Pick(x0, lcddev.width - 1), Pick(y0, lcddev.height - 1));
+			}
+		}
+	}
+	Host_Check(!emu_stat.stray, "%lu bytes sent with CS high", (unsigned long)emu_stat.stray);
+	printf("tile: %u pages in 4 rotations, %u areas each\n", PAGES, AREAS + 1);
+	return Host_Done("tile");
+}
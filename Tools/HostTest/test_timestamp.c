@@ -0,0 +1,257 @@
+//User/RTC/timestamp.c against a simulated PCF8563 on the I2C1 model: the
+//RTC runs 20 ppm slow and the local clock (HAL tick and SysTick) 120 ppm
+//fast, so the drift to measure is 140 ppm, until the RTC warms up to
+//10 ppm fast and it becomes 110 ppm. The bus task runs
+//I2C_Bus_Process() and TS_Process() as App_BusTask() does and the time
+//jumps from one timer to the next, as LPM_Idle() would sleep. Covered: an
+//RTC that lost its time at power-on staying unset without being polled,
+//the console 'time' command rejecting bad dates and setting the RTC, the
+//lock on the next seconds edge, hours of resyncs with the drift converging
+//and TS_Now() following the RTC between them, 'time sync', and an RTC
+//that stops answering and comes back.
+#include "timestamp.h"
+#include "host.h"
+#include "i2cdev.h"
+#include "lpm.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RTC_PPM             -20.0
+#define RTC_WARM_PPM        10.0
+#define LOCAL_PPM           120.0
+#define DRIFT_PPM(rtc)      ((1 + LOCAL_PPM * 1e-6) / (1 + (rtc) * 1e-6) * 1e6 - 1e6)
+#define HOURS               4       //for each RTC rate
+
+static struct
+{
+	uint64_t base_ns;               //host time at which the RTC read base
+	double base;
+	double ppm;
+	uint8_t vl;
+	uint8_t ctrl[16];
+	uint32_t reads, writes;
+} rtc_sim;
+
+static i2cdev_t rtc = {.dev = PCF8563_ADDR};
+static sched_timer_t bus_timer;
+
+//====================stubs for the modules around====================//
+void LPM_Lock(uint8_t lock)
+{
+	(void)lock;
+}
+
+void LPM_Unlock(uint8_t lock)
+{
+	(void)lock;
+}
+
+void LPM_Idle(uint32_t ms)
+{
+	(void)ms;
+}
+//==========================end of stubs============================//
+
+//the RTC's own time, in seconds: the local clock is the host time
+static double Rtc(void)
+{
+	return rtc_sim.base + (Host_Ns() - rtc_sim.base_ns) * 1e-9 * (1 + rtc_sim.ppm * 1e-6) / (1 + LOCAL_PPM * 1e-6);
+}
+
+static void RtcRate(double ppm)
+{
+	rtc_sim.base = Rtc();
+	rtc_sim.base_ns = Host_Ns();
+	rtc_sim.ppm = ppm;
+}
+
+static void RtcRead(uint8_t reg, uint8_t *buf, uint8_t len)
+{
+	uint8_t regs[16];
+	rtc_time_t t;
+
+	memcpy(regs, rtc_sim.ctrl, sizeof(regs));
+	RTC_FromEpoch((uint32_t)Rtc(), &t);
+	PCF8563_Encode(&t, &regs[PCF8563_REG_SECONDS]);
+	regs[PCF8563_REG_SECONDS] |= rtc_sim.vl ? PCF8563_VL : 0;
+	memcpy(buf, &regs[reg], len);
+	rtc_sim.reads++;
+}
+
+//writing the seconds restarts the second
+static void RtcWrite(uint8_t reg, const uint8_t *buf, uint8_t len)
+{
+	rtc_time_t t;
+
+	memcpy(&rtc_sim.ctrl[reg], buf, len);
+	if(reg != PCF8563_REG_SECONDS)
+		return;
+	PCF8563_Decode(buf, &t);
+	rtc_sim.base = RTC_ToEpoch(&t);
+	rtc_sim.base_ns = Host_Ns();
+	rtc_sim.vl = 0;
+	rtc_sim.writes++;
+}
+
+static void BusTask(uint8_t sig, uint32_t arg)
+{
+	uint32_t due;
+
+	(void)sig;
+	(void)arg;
+	I2C_Bus_Process();
+	due = TS_Process();
+	if(!I2C_Bus_Idle() && due > I2C_BUS_TIMEOUT_MS)
+		due = I2C_BUS_TIMEOUT_MS;
+	Sched_TimerStart(&bus_timer, SCHED_TASK_BUS, I2C_BUS_SIG, due, 0);
+}
+
+static void Drain(void)
+{
+	while(Sched_Dispatch())
+		;
+}
+
+//TS_Now() minus the RTC, in ms
+static double Error(void)
+{
+	ts_t now;
+
+	TS_Now(&now);
+	return (now.sec + now.usec * 1e-6 - Rtc()) * 1000;
+}
+
+//run for ms, from timer to timer with a little wake-up latency; the
+//largest timestamp error on the way
+static double Run(uint32_t ms)
+{
+	uint32_t end = HAL_GetTick() + ms, d;
+	double worst = 0;
+
+	while((int32_t)(HAL_GetTick() - end) < 0)
+	{
+		Drain();
+		if(I2cDev_Run())
+			continue;
+		if(fabs(Error()) > fabs(worst))
+			worst = Error();
+		d = Sched_NextTimeout();
+		if(d > end - HAL_GetTick())
+			d = end - HAL_GetTick();
+		Host_Advance((uint64_t)d * 1000000 + Host_Rand() % 200 * 1000);
+	}
+	Drain();
+	return worst;
+}
+
+static void Unset(void)
+{
+	ts_t now;
+
+	Run(20000);
+	TS_Now(&now);
+	Host_Check(TS_GetFlags() == TS_FLAG_RTC_LOST, "lost rtc: flags 0x%02x", TS_GetFlags());
+	Host_Check(now.sec < 100, "lost rtc: timestamp %lu s before the time was set", (unsigned long)now.sec);
+	Host_Check(rtc_sim.reads == 1, "lost rtc: read %lu times, expected only at boot", (unsigned long)rtc_sim.reads);
+}
+
+static void Set(void)
+{
+	TS_Command("2026-02-29 12:00:00");
+	TS_Command("2026-10-19 24:00:00");
+	TS_Command("2026-10-19 12:00");
+	Run(100);
+	Host_Check(!rtc_sim.writes, "set: %lu RTC writes for bad dates", (unsigned long)rtc_sim.writes);
+	TS_Command("2026-10-19 12:00:00");
+	Run(3000);
+	Host_Check(rtc_sim.writes == 1 && rtc_sim.base == 1792411200, "set: RTC at %.0f after %lu writes", rtc_sim.base,
+	           (unsigned long)rtc_sim.writes);
+	Host_Check(TS_GetFlags() == (TS_FLAG_VALID | TS_FLAG_FINE), "set: flags 0x%02x", TS_GetFlags());
+	Host_Check(fabs(Error()) < 10, "set: %.1f ms off the RTC", Error());
+	TS_Command("");
+}
+
+//the first hour settles, the rest must stay within 10 ms of the RTC
+static void Discipline(double ppm)
+{
+	double worst = 0, err;
+	uint8_t h;
+
+	RtcRate(ppm);
+	for(h = 0; h < HOURS; h++)
+	{
+		err = Run(3600000);
+		if(h && fabs(err) > fabs(worst))
+			worst = err;
+		printf("timestamp: RTC %+.0f ppm, hour %u, drift %ld ppm, worst error %.1f ms\n", ppm, h + 1,
+		       (long)TS_GetDriftPpm(), err);
+	}
+	Host_Check(TS_GetFlags() == (TS_FLAG_VALID | TS_FLAG_FINE | TS_FLAG_DRIFT), "discipline: flags 0x%02x",
+	           TS_GetFlags());
+	Host_Check(fabs(TS_GetDriftPpm() - DRIFT_PPM(ppm)) <= 5, "discipline: drift %ld ppm, expected %.1f",
+	           (long)TS_GetDriftPpm(), DRIFT_PPM(ppm));
+	Host_Check(fabs(worst) < 10, "discipline: TS_Now() %.1f ms off the RTC", worst);
+}
+
+static void Resync(void)
+{
+	uint32_t reads;
+
+	Run(200000);                            //the periodic resync is minutes away
+	reads = rtc_sim.reads;
+	TS_Command("sync");
+	Run(2000);
+	Host_Check(rtc_sim.reads > reads + 1 && rtc_sim.reads < reads + 1500 / TS_HUNT_STEP_MS,
+	           "sync: %lu RTC reads", (unsigned long)(rtc_sim.reads - reads));
+	Host_Check(TS_GetFlags() == (TS_FLAG_VALID | TS_FLAG_FINE | TS_FLAG_DRIFT), "sync: flags 0x%02x", TS_GetFlags());
+}
+
+static void Lost(void)
+{
+	double worst;
+
+	rtc.fail = 255;
+	rtc.error = HAL_I2C_ERROR_AF;
+	Run(200000);
+	TS_Command("sync");
+	worst = Run(3 * TS_RETRY_MS);
+	Host_Check(TS_GetFlags() & TS_FLAG_RTC_LOST && TS_GetFlags() & TS_FLAG_VALID, "no answer: flags 0x%02x",
+	           TS_GetFlags());
+	Host_Check(fabs(worst) < 10, "no answer: TS_Now() %.1f ms off the RTC", worst);
+	Host_Check(255 - rtc.fail <= 5, "no answer: %u tries in %u ms", 255 - rtc.fail, 3 * TS_RETRY_MS);
+	rtc.fail = 0;
+	Run(TS_RETRY_MS + 2000);
+	Host_Check(TS_GetFlags() == (TS_FLAG_VALID | TS_FLAG_FINE | TS_FLAG_DRIFT), "answering again: flags 0x%02x",
+	           TS_GetFlags());
+}
+
+int main(void)
+{
+	rtc_time_t t = {2000, 1, 1, 0, 0, 0, 6, 1};
+
+	Host_Seed(26);
+	rtc_sim.base = RTC_ToEpoch(&t);
+	rtc_sim.ppm = RTC_PPM;
+	rtc_sim.vl = 1;
+	rtc.read = RtcRead;
+	rtc.write = RtcWrite;
+	I2cDev_Attach(&rtc);
+	Host_Pin(RTC_SDA_GPIO_Port, RTC_SDA_Pin | RTC_SCL_Pin, 1);
+	Sched_Init();
+	Sched_Register(SCHED_TASK_BUS, "bus", BusTask);
+	Host_Advance(300000000);                //the boot so far
+	HAL_I2C_Init(&hi2c1);
+	I2C_Bus_Init();
+	TS_Init();
+	Unset();
+	Set();
+	Discipline(RTC_PPM);
+	Discipline(RTC_WARM_PPM);
+	TS_Command("");
+	Resync();
+	Lost();
+	printf("timestamp: drift %ld ppm (true %.1f), %lu RTC reads\n", (long)TS_GetDriftPpm(), DRIFT_PPM(rtc_sim.ppm),
+	       (unsigned long)rtc_sim.reads);
+	return Host_Done("timestamp");
+}
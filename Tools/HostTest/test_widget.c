@@ -0,0 +1,146 @@
+//User/LCD/widget.c on the load panel screen of test.c plus a label, the
+//whole pool. 3000 random rounds of values, bar fills, menu rows, chart
+//samples, label texts and hiding go through Widget_Update(); after each
+//one a forced redraw of the whole screen must not change a pixel and a
+//label must be as wide as its text. The value texts must read as printf()
+//formats them, an update without a change must send nothing, and one new
+//value only the box of its readout.
+#include "main.h"
+#include "lcd.h"
+#include "widget.h"
+#include "emu.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROUNDS              3000
+#define CHART_H             40
+
+static const char *panel_rows[] = {"Wait", "Run", "Done", "Fail"};
+static const char *labels[] = {"Load", "Loads", "Load panel", "", "PD 20 V", "Cable 183 mOhm"};
+static widget_value_t val[3] = {{"mV", 0, ""}, {"mA", 1, ""}, {"mW", 2, ""}};
+static widget_t *root, *value[3], *bar, *chart, *menu, *label;
+static u8 samples[EMU_COLS];
+static u16 shot[EMU_ROWS][EMU_COLS];
+
+static void Shot(void)
+{
+	u16 x, y;
+
+	for(y = 0; y < lcddev.height; y++)
+		for(x = 0; x < lcddev.width; x++)
+			shot[y][x] = Emu_Pixel(x, y);
+}
+
+static uint32_t Changed(void)
+{
+	uint32_t n = 0;
+	u16 x, y;
+
+	for(y = 0; y < lcddev.height; y++)
+		for(x = 0; x < lcddev.width; x++)
+			n += Emu_Pixel(x, y) != shot[y][x];
+	return n;
+}
+
+//the value text as printf() writes it, the number right aligned before the unit
+static void Text(const widget_value_t *v, int32_t x)
+{
+	char num[16], want[32];
+	long p = 1;
+	u8 i;
+
+	for(i = 0; i < v->frac; i++)
+		p *= 10;
+	if(v->frac)
+		sprintf(num, "%s%ld.%0*ld", x < 0 ? "-" : "", labs((long)x) / p, v->frac, labs((long)x) % p);
+	else
+		sprintf(num, "%ld", (long)x);
+	sprintf(want, "%*s %s", (int)(WIDGET_VALUE_LEN - 2 - strlen(v->unit)), num, v->unit);
+	Host_Check(!strcmp(v->text, want), "value %ld: \"%s\", expected \"%s\"", (long)x, v->text, want);
+}
+
+static void Screen(void)
+{
+	widget_t *row, *col;
+	u8 i;
+
+	root = Widget_Root(0, 21, lcddev.width - 1, lcddev.height - 21, WHITE);
+	row = Widget_Box(root, WIDGET_HBOX, WHITE);
+	col = Widget_Box(row, WIDGET_VBOX, WHITE);
+	for(i = 0; i < 3; i++)
+		value[i] = Widget_Value(col, &val[i], BLUE, WHITE);
+	menu = Widget_Menu(row, panel_rows, 4, BLUE, WHITE);
+	bar = Widget_Bar(root, lcddev.width - 2 * WIDGET_PAD - 1, 10, RED, WHITE);
+	chart = Widget_Chart(root, samples, lcddev.width - 2 * WIDGET_PAD - 1, CHART_H, GRAY1, WHITE);
+	label = Widget_Label(root, labels[0], BLACK, YELLOW);
+	Host_Check(label != NULL && Widget_Label(root, "x", 0, 0) == NULL, "the pool is not WIDGET_MAX widgets");
+}
+
+int main(void)
+{
+	widget_t *w;
+	uint32_t bytes, windows, pixels, k, n;
+	int32_t v;
+
+	Host_Seed(19);
+	Host_Panel(0);
+	Screen();
+	Widget_Update();
+	for(k = 0; k < ROUNDS && !host_fails; k++)
+	{
+		for(n = Host_Rand() % 4; n; n--)
+			switch(Host_Rand() % 8)
+			{
+			case 0:
+			case 1:
+				w = value[Host_Rand() % 3];
+				v = Host_Rand() % 4 ? (int32_t)(Host_Rand() % 20000) - 2000 : w->value;
+				Widget_SetValue(w, v);
+				Text(w->data, v);
+				break;
+			case 2:
+				Widget_SetValue(bar, (int32_t)(Host_Rand() % 1400) - 200);
+				break;
+			case 3:
+				Widget_SetValue(menu, Host_Rand() % 4);
+				break;
+			case 4:
+			case 5:
+				Widget_ChartPush(chart, (int32_t)(Host_Rand() % 1400) - 200);
+				break;
+			case 6:
+				Widget_SetText(label, labels[Host_Rand() % (sizeof(labels) / sizeof(labels[0]))]);
+				break;
+			default:
+				Widget_Show(Host_Rand() % 2 ? chart : label, Host_Rand() % 4 != 0);
+				break;
+			}
+		Widget_Update();
+		Shot();
+		bytes = emu_stat.bytes;
+		Widget_Update();
+		Host_Check(emu_stat.bytes == bytes, "round %lu: an idle update sent %lu bytes", (unsigned long)k,
+		           (unsigned long)(emu_stat.bytes - bytes));
+		Widget_Invalidate(root);
+		Widget_Update();
+		n = Changed();
+		Host_Check(!n, "round %lu: %lu pixels differ from a full redraw", (unsigned long)k, (unsigned long)n);
+		Host_Check((label->flags & WIDGET_HIDDEN) || label->x1 - label->x0 + 1 >= (int)strlen(label->data) * 8,
+		           "round %lu: \"%s\" cut to %u px", (unsigned long)k, (const char *)label->data, label->x1 - label->x0 + 1);
+	}
+	//one new reading: the box of its readout and nothing else
+	w = value[1];
+	windows = emu_stat.windows;
+	pixels = emu_stat.pixels;
+	Widget_SetValue(w, w->value + 1);
+	Widget_Update();
+	printf("widget: one value sends %lu window(s), %lu pixels, box %ux%u\n",
+	       (unsigned long)(emu_stat.windows - windows), (unsigned long)(emu_stat.pixels - pixels),
+	       w->x1 - w->x0 + 1, w->y1 - w->y0 + 1);
+	Host_Check(emu_stat.windows - windows == 1 &&
+	           emu_stat.pixels - pixels == (uint32_t)(w->x1 - w->x0 + 1) * (w->y1 - w->y0 + 1),
+	           "one value: not just its box");
+	return Host_Done("widget");
+}
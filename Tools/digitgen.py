@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Generate the large digit font for digit.h (User/LCD).
+
+Seven-segment style digits with bevelled segments, rendered with 4 x 4
+supersampling at 2 bits per pixel (coverage 0..3), packed MSB first.
+Segments make the same rows over and over, so the digit glyphs ('0'..'9',
+'-') are stored as the distinct DIGIT_W rows, at most 16, and a row number
+per glyph row, two to a byte, high nibble first: 232 bytes instead of
+1408. Digit_Glyph() unpacks them. The narrow decimal point is stored
+as is.
+
+    digitgen.py > User/LCD/digitfont.h   (then convert to CRLF)
+"""
+W, H, PW = 16, 32, 8        # DIGIT_W, DIGIT_H, DIGIT_POINT_W
+T = 3.0                     # segment thickness
+GAP = 0.6                   # gap between segment tips
+SS = 4                      # supersampling per axis
+
+L, R = 2.5, W - 2.5         # centre lines of the vertical segments
+TOP, MID, BOT = 2.5, H / 2.0 - 0.5, H - 2.5
+
+# segment: (horizontal, centre, from, to)
+SEG = {
+    'a': (1, TOP, L, R), 'g': (1, MID, L, R), 'd': (1, BOT, L, R),
+    'f': (0, L, TOP, MID), 'b': (0, R, TOP, MID),
+    'e': (0, L, MID, BOT), 'c': (0, R, MID, BOT),
+}
+GLYPH = ['abcdef', 'bc', 'abdeg', 'abcdg', 'bcfg', 'acdfg', 'acdefg', 'abc',
+         'abcdefg', 'abcdfg', 'g']
+
+
+def inside(seg, x, y):
+    hor, c, a, b = SEG[seg]
+    u, v = (x, y) if hor else (y, x)
+    dv = abs(v - c)
+    return dv <= T / 2 and a + GAP + dv <= u <= b - GAP - dv
+
+
+def dot(x, y):
+    return PW / 2.0 - T / 2 <= x <= PW / 2.0 + T / 2 and BOT - T / 2 <= y <= BOT + T / 2
+
+
+def render(w, test):
+    rows = []
+    for py in range(H):
+        row = []
+        for px in range(w):
+            n = sum(test(px + (i + 0.5) / SS, py + (j + 0.5) / SS)
+                    for i in range(SS) for j in range(SS))
+            row.append((n * 3 + SS * SS // 2) // (SS * SS))
+        rows.append(row)
+    out = []
+    for row in rows:
+        for i in range(0, w, 4):
+            q = row[i:i + 4]
+            out.append(q[0] << 6 | q[1] << 4 | q[2] << 2 | q[3])
+    return out
+
+
+def emit(data, n):
+    for i in range(0, len(data), n):
+        print('\t' + ''.join('0x%02X,' % b for b in data[i:i + n]))
+
+
+def main():
+    stride = W // 4
+    rows, glyphs = [], []
+    for segs in GLYPH:
+        bits = render(W, lambda x, y: any(inside(s, x, y) for s in segs))
+        nums = []
+        for i in range(0, len(bits), stride):
+            row = bits[i:i + stride]
+            if row not in rows:
+                rows.append(row)
+            nums.append(rows.index(row))
+        glyphs.append(nums)
+    assert len(rows) <= 16, 'row numbers are 4 bits'
+    print('//Large digit font for digit.c, generated by Tools/digitgen.py.')
+    print('//%dx%d, 2 bpp coverage, MSB first: the distinct rows of 0..9 and the' % (W, H))
+    print('//minus sign, the row numbers of each glyph two to a byte, high nibble')
+    print('//first, then the %d px wide decimal point.' % PW)
+    print('#ifndef __DIGITFONT_H')
+    print('#define __DIGITFONT_H')
+    print('')
+    print('static const u8 digit_rows[%d][LAYER_STRIDE(DIGIT_W, 2)] = {' % len(rows))
+    emit(sum(rows, []), stride * 4)
+    print('};')
+    print('')
+    print('static const u8 digit_font[DIGIT_GLYPHS][DIGIT_H / 2] = {')
+    for k, nums in enumerate(glyphs):
+        print('\t{' + ''.join('0x%X%X,' % (nums[i], nums[i + 1]) for i in range(0, H, 2)) + '},   //%s'
+              % "'%s'" % '0123456789-'[k])
+    print('};')
+    print('')
+    print('static const u8 digit_point[LAYER_BYTES(DIGIT_POINT_W, DIGIT_H, 2)] = {')
+    emit(render(PW, dot), 16)
+    print('};')
+    print('')
+    print('#endif')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""Estimate the flash and RAM footprint of the Keil build without Keil.
+
+Compiles the sources of the uVision project with the host gcc in 32-bit
+mode, links them with unused sections removed (what armlink does) and
+reads the sizes back from the GNU ld map. Pointers and ints are 4 bytes
+on both sides, so constant tables, strings and RAM come out as on the
+target; only the code differs, and it is scaled by CODE_RATIO, the Thumb-2
+to i386 ratio measured on the Keil map of the baseline build (the objects
+and .map under MDK-ARM/), separately for the HAL under Drivers/ and for
+the rest: armlink and gcc disagree more on the application code. Library
+code the firmware calls (microlib printf, string functions, 64-bit
+division) is added from LIBRARY.
+
+    footprint.py                   per object and per section sizes
+    footprint.py --top 30          and the 30 biggest functions and tables
+    footprint.py --calibrate REV   measure CODE_RATIO on the tree at REV,
+                                   against the Keil map checked in there
+
+Needs gcc that can emit i386 (-m32), no 32-bit C library. The ratio of
+single objects spreads from 0.58 to 1.14, so expect a few percent of
+error on the code; the budget below keeps margin for it.
+"""
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ASM = re.compile(r'\b(?:__ASM|__asm__|__asm)\s*(?:volatile\s*|__volatile__\s*)?'
+                 r'\((?:[^()]|\((?:[^()]|\([^()]*\))*\))*\)')
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+PROJECT = 'MDK-ARM/STM32 USB-Flash Power Recorder.uvprojx'
+KEIL_MAP = 'MDK-ARM/STM32 USB-Flash Power Recorder/STM32 USB-Flash Power Recorder.map'
+STARTUP = 'MDK-ARM/startup_stm32f103xb.s'
+
+IROM = 0x10000                  # STM32F103C8
+IRAM = 0x5000
+BUDGET = 0xF800                 # 62 KB: 2 KB kept for the error of the estimate
+CODE_RATIO = {'hal': 0.82, 'app': 0.66}    # Keil Thumb-2 code / gcc -m32 -Os code, see --calibrate
+VECTORS = 0x130                 # vector table, startup code
+
+# microlib members, bytes of code, for the symbols left undefined
+LIBRARY = {
+    'printf': 1100, 'sprintf': 40, 'snprintf': 60, 'vsnprintf': 60, 'putchar': 20, 'puts': 40,
+    'memcpy': 60, 'memmove': 80, 'memset': 40, 'memcmp': 30, 'strlen': 16, 'strcmp': 30, 'strncmp': 40,
+    'strchr': 30, 'strrchr': 30, 'strstr': 50, 'strtol': 160, 'strtoul': 140, 'atoi': 30,
+    'abs': 8, 'labs': 8, 'qsort': 200,
+    '__udivdi3': 200, '__divdi3': 60, '__umoddi3': 40, '__moddi3': 60, '__udivmoddi4': 0, '__divmoddi4': 0,
+}
+LIBRARY_DEFAULT = 100
+LIBRARY_SHARED = {'sprintf', 'snprintf', 'vsnprintf'}   # on top of the printf core
+
+
+def project(root):
+    text = open(os.path.join(root, PROJECT), encoding='latin-1').read()
+    files = [f.replace('\\', '/') for f in re.findall(r'<FilePath>([^<]*)</FilePath>', text)]
+    inc = re.search(r'<IncludePath>([^<]+)</IncludePath>', text).group(1)
+    inc = [i.strip().replace('\\', '/') for i in inc.split(';') if i.strip()]
+    defs = re.search(r'<Define>([^<]+)</Define>', text).group(1).split(',')
+    mdk = os.path.join(root, 'MDK-ARM')
+    norm = lambda p: os.path.normpath(os.path.join(mdk, p))
+    return [norm(f) for f in files if f.endswith('.c')], [norm(i) for i in inc], [d.strip() for d in defs]
+
+
+def shim(root, srcs, inc, out):
+    """Headers the target compiler would find: CMSIS intrinsics without ARM
+    assembly, and the file names the sources spell in another case. The C
+    library headers are the 64-bit ones, enough for declarations."""
+    os.mkdir(os.path.join(out, 'gnu'))
+    open(os.path.join(out, 'gnu', 'stubs-32.h'), 'w').close()
+    cmsis = os.path.join(root, 'Drivers/CMSIS/Include')
+    for f in os.listdir(cmsis):
+        text = open(os.path.join(cmsis, f), encoding='latin-1').read()
+        if f == 'cmsis_gcc.h':
+            text = ASM.sub('((void)0)', text)
+        open(os.path.join(out, f), 'w', encoding='latin-1').write(text)
+    have = {}
+    for d in inc:
+        for f in os.listdir(d) if os.path.isdir(d) else []:
+            if os.path.isfile(os.path.join(d, f)):
+                have.setdefault(f.lower(), os.path.join(d, f))
+    wanted = set()
+    for f in srcs + list(have.values()):
+        wanted.update(re.findall(r'#\s*include\s+"([^"]+)"', open(f, encoding='latin-1').read()))
+    for w in wanted:
+        if w.lower() in have and os.path.basename(have[w.lower()]) != w:
+            os.symlink(have[w.lower()], os.path.join(out, w))
+
+
+def build(root, tmp):
+    srcs, inc, defs = project(root)
+    sh = os.path.join(tmp, 'inc')
+    os.mkdir(sh)
+    shim(root, srcs, inc, sh)
+    flags = ['-m32', '-std=gnu99', '-Os', '-ffunction-sections', '-fdata-sections', '-fno-pic', '-fno-common',
+             '-fno-asynchronous-unwind-tables', '-fno-stack-protector', '-fno-builtin', '-w', '-I' + sh]
+    flags += ['-I' + i for i in inc] + ['-D' + d for d in defs]
+    arch = subprocess.run(['gcc', '-print-multiarch'], capture_output=True, text=True).stdout.strip()
+    flags += ['-idirafter', os.path.join('/usr/include', arch)]
+    objs = []
+    hal = set()
+    for s in srcs:
+        base = os.path.splitext(os.path.basename(s))[0].lower()
+        o = os.path.join(tmp, base + '.o')
+        c = os.path.join(tmp, base + '.c')         # without its ARM assembly
+        open(c, 'w', encoding='latin-1').write(ASM.sub('((void)0)', open(s, encoding='latin-1').read()))
+        r = subprocess.run(['gcc'] + flags + ['-iquote', os.path.dirname(s), '-c', c, '-o', o],
+                           capture_output=True, text=True)
+        if r.returncode:
+            sys.exit('%s:\n%s' % (s, r.stderr))
+        objs.append(o)
+        if os.path.relpath(s, root).startswith('Drivers'):
+            hal.add(os.path.basename(o))
+    # every handler in the vector table is a root, as in armlink
+    vec = re.findall(r'^\s*DCD\s+(\w+)', open(os.path.join(root, STARTUP), encoding='latin-1').read(), re.M)
+    keep = ['-Wl,-u,' + v for v in vec if v not in ('__initial_sp', '0')]
+    exe = os.path.join(tmp, 'fw.elf')
+    mp = os.path.join(tmp, 'fw.map')
+    r = subprocess.run(['gcc', '-m32', '-nostdlib', '-static', '-no-pie', '-Wl,--gc-sections', '-Wl,-e,main',
+                        '-Wl,--unresolved-symbols=ignore-all', '-Wl,-Map=' + mp, '-o', exe] + keep + objs,
+                       capture_output=True, text=True)
+    if r.returncode:
+        sys.exit(r.stderr)
+    undef = subprocess.run(['nm', '-u', exe], capture_output=True, text=True).stdout.split()
+    # the weak default handlers are in the startup code
+    return parse(mp), sorted(u for u in undef if u != 'U' and not u.endswith('Handler')), hal
+
+
+def parse(mp):
+    """(object, kind, name, size) of every input section kept in the map"""
+    kinds = {'.text': 'code', '.rodata': 'rodata', '.data': 'data', '.bss': 'bss'}
+    out = []
+    lines = open(mp).read().split('Linker script and memory map', 1)[1].splitlines()
+    kind = None
+    pending = None
+    for ln in lines:
+        m = re.match(r'^(\.\w+)', ln)
+        if m:
+            kind = kinds.get(m.group(1))
+            continue
+        m = re.match(r'^ (\.\S+|COMMON)\s*$', ln)
+        if m:
+            pending = m.group(1)
+            continue
+        m = re.match(r'^ (\.\S+|COMMON)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+\.o)$', ln)
+        if m and kind:
+            name = m.group(1) or pending
+            size = int(m.group(3), 16)
+            if size:
+                out.append((os.path.basename(m.group(4)), kind, name, size))
+        pending = None
+    return out
+
+
+def library(undef):
+    total = 0
+    printf = False
+    for u in undef:
+        total += LIBRARY.get(u, LIBRARY_DEFAULT)
+        printf |= u in LIBRARY_SHARED
+    if printf and 'printf' not in undef:
+        total += LIBRARY['printf']
+    return total
+
+
+def keil_code(root):
+    """Code column of the Keil map, per object"""
+    text = open(os.path.join(root, KEIL_MAP), encoding='latin-1').read()
+    text = text[text.index('Image component sizes'):]
+    return {m.group(2): int(m.group(1)) for m in re.finditer(r'^\s+(\d+)\s+\d+\s+\d+\s+\d+\s+\d+\s+\d+\s+(\S+\.o)$',
+                                                             text, re.M)}
+
+
+def calibrate(rev):
+    with tempfile.TemporaryDirectory() as tmp:
+        tree = os.path.join(tmp, 'tree')
+        os.mkdir(tree)
+        subprocess.run('git -C "%s" archive %s | tar -x -C "%s"' % (ROOT, rev, tree), shell=True, check=True)
+        secs, _, hal = build(tree, tmp)
+        keil = keil_code(tree)
+    gcc = {}
+    for obj, kind, _, size in secs:
+        if kind == 'code':
+            gcc[obj] = gcc.get(obj, 0) + size
+    both = sorted(o for o in keil if o in gcc)
+    for o in both:
+        print('%-28s keil %6d  gcc %6d  %.2f' % (o, keil[o], gcc[o], keil[o] / gcc[o]))
+    for cls in sorted(CODE_RATIO):
+        part = [o for o in both if (o in hal) == (cls == 'hal')]
+        k = sum(keil[o] for o in part)
+        g = sum(gcc[o] for o in part)
+        print('%-28s keil %6d  gcc %6d  CODE_RATIO %.2f' % (cls, k, g, k / g))
+
+
+def report(top):
+    with tempfile.TemporaryDirectory() as tmp:
+        secs, undef, hal = build(ROOT, tmp)
+    ratio = lambda obj: CODE_RATIO['hal' if obj in hal else 'app']
+    per = {}
+    for obj, kind, _, size in secs:
+        per.setdefault(obj, {'code': 0, 'rodata': 0, 'data': 0, 'bss': 0})[kind] += size
+    print('%-24s %7s %7s %7s %7s %7s' % ('object', 'code', 'est.', 'rodata', 'data', 'bss'))
+    flash = VECTORS
+    ram = 0
+    for obj, s in sorted(per.items(), key=lambda i: -(i[1]['code'] * ratio(i[0]) + i[1]['rodata'] + i[1]['data'])):
+        est = int(s['code'] * ratio(obj))
+        print('%-24s %7d %7d %7d %7d %7d' % (obj, s['code'], est, s['rodata'], s['data'], s['bss']))
+        flash += est + s['rodata'] + s['data']
+        ram += s['data'] + s['bss']
+    lib = library(undef)
+    flash += lib
+    stack = sum(int(v, 16) for v in re.findall(r'^(?:Stack|Heap)_Size\s+EQU\s+0x([0-9A-Fa-f]+)',
+                                                open(os.path.join(ROOT, STARTUP)).read(), re.M))
+    ram += stack
+    print('library (%s): %d' % (' '.join(undef), lib))
+    print('flash %6d of %d (%.0f%%), budget %d, %s' % (flash, IROM, 100.0 * flash / IROM, BUDGET,
+          'within' if flash <= BUDGET else 'OVER by %d' % (flash - BUDGET)))
+    print('ram   %6d of %d (%.0f%%) with %d of stack and heap' % (ram, IRAM, 100.0 * ram / IRAM, stack))
+    if top:
+        big = sorted(secs, key=lambda s: -(s[3] * (ratio(s[0]) if s[1] == 'code' else 1)))[:top]
+        for obj, kind, name, size in big:
+            print('  %7d  %-6s %-16s %s' % (int(size * (ratio(obj) if kind == 'code' else 1)), kind, obj, name))
+    return flash <= BUDGET
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--top', type=int, default=0, help='list the biggest sections')
+    ap.add_argument('--calibrate', metavar='REV', help='measure CODE_RATIO on the tree at REV')
+    a = ap.parse_args()
+    if a.calibrate:
+        calibrate(a.calibrate)
+        return 0
+    return 0 if report(a.top) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
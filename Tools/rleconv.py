@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Compress RGB565 images for rle.h and 8x16 fonts for FONT.H (User/LCD).
+
+Reads an Image2LCD C array (16 bit, horizontal scan, low byte first, no
+header) or a raw .bin of RGB565 pixels and writes a C array in the PackBits
+format the strip renderer decodes:
+
+    c < 0x80    c + 1 literal pixels follow
+    c >= 0x80   one pixel follows, repeated (c & 0x7F) + 2 times
+
+Pixels are stored high byte first (panel byte order) so literals are copied
+into the strip as they are. Runs may cross lines.
+
+    rleconv.py -w 40 -n gImage_qq qq.c > qq_rle.h
+    rleconv.py -w 240 --be -n splash splash.bin > splash.h
+
+With --font the input is a table of 8x16 glyphs, 16 row bytes each, and
+every glyph is packed by rows instead: runs of blank rows at the top and
+the bottom are dropped and a row that repeats the one above is stored once
+
+    top << 4 | bottom       rows top..bottom hold all the set pixels
+    mask, 2 bytes LE        bit r: row top + r repeats the row above;
+                            only if it makes the glyph shorter
+    rows                    the rows not repeated
+
+A blank glyph is no bytes at all. The offsets table (one entry per glyph
+and the end) gives where each glyph starts, and by the next entry its
+length, which tells whether the mask is there.
+
+    rleconv.py --font -n asc2_1608 FONT.H > asc2_1608.h
+"""
+import argparse
+import re
+import sys
+
+GLYPH_H = 16
+LIT_MAX = 128
+RUN_MIN = 2
+RUN_MAX = 0x7F + RUN_MIN
+
+
+def load(path, be):
+    data = open(path, 'rb').read()
+    if not path.endswith('.bin'):
+        text = data.decode('latin-1')
+        text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+        text = re.sub(r'//[^\n]*', '', text)
+        text = text[text.index('{') + 1:text.index('}')]
+        data = bytes(int(v, 0) for v in re.findall(r'0[xX][0-9a-fA-F]+|\d+', text))
+    if len(data) % 2:
+        sys.exit('odd number of bytes')
+    order = 'big' if be else 'little'
+    return [int.from_bytes(data[i:i + 2], order) for i in range(0, len(data), 2)]
+
+
+def encode(px):
+    out = bytearray()
+    lit = []
+
+    def flush():
+        if lit:
+            out.append(len(lit) - 1)
+            for p in lit:
+                out.extend(p.to_bytes(2, 'big'))
+            del lit[:]
+
+    i = 0
+    while i < len(px):
+        r = 1
+        while i + r < len(px) and r < RUN_MAX and px[i + r] == px[i]:
+            r += 1
+        if r >= RUN_MIN:
+            flush()
+            out.append(0x80 | (r - RUN_MIN))
+            out += px[i].to_bytes(2, 'big')
+            i += r
+        else:
+            lit.append(px[i])
+            if len(lit) == LIT_MAX:
+                flush()
+            i += 1
+    flush()
+    return bytes(out)
+
+
+def decode(data, n):
+    px = []
+    i = 0
+    while len(px) < n:
+        c = data[i]
+        i += 1
+        if c & 0x80:
+            px += [int.from_bytes(data[i:i + 2], 'big')] * ((c & 0x7F) + RUN_MIN)
+            i += 2
+        else:
+            px += [int.from_bytes(data[j:j + 2], 'big') for j in range(i, i + 2 * (c + 1), 2)]
+            i += 2 * (c + 1)
+    return px
+
+
+def load_font(path, name):
+    text = open(path, 'rb').read().decode('latin-1')
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    text = re.sub(r'//[^\n]*', '', text)
+    m = re.search(r'\b%s\s*\[[^=]*=\s*\{(.*?)\}\s*;' % re.escape(name), text, re.S)
+    if not m:
+        sys.exit('no table %s in %s' % (name, path))
+    data = [int(v, 0) for v in re.findall(r'0[xX][0-9a-fA-F]+', m.group(1))]
+    if len(data) % GLYPH_H:
+        sys.exit('%d bytes is not a multiple of %d' % (len(data), GLYPH_H))
+    return [data[i:i + GLYPH_H] for i in range(0, len(data), GLYPH_H)]
+
+
+def encode_glyph(rows):
+    used = [r for r in range(GLYPH_H) if rows[r]]
+    if not used:
+        return b''
+    top, bottom = used[0], used[-1]
+    out = bytearray([top << 4 | bottom])
+    mask = 0
+    kept = []
+    for r in range(top, bottom + 1):
+        if r > top and rows[r] == rows[r - 1]:
+            mask |= 1 << (r - top)
+        else:
+            kept.append(rows[r])
+    if len(kept) + 2 < bottom - top + 1:
+        out += mask.to_bytes(2, 'little') + bytes(kept)
+    else:
+        out += bytes(rows[top:bottom + 1])
+    return bytes(out)
+
+
+def decode_glyph(data):
+    rows = [0] * GLYPH_H
+    if not data:
+        return rows
+    top, bottom = data[0] >> 4, data[0] & 15
+    i, mask = 1, 0
+    if len(data) - 1 < bottom - top + 1:
+        mask = int.from_bytes(data[1:3], 'little')
+        i = 3
+    for r in range(top, bottom + 1):
+        if mask >> (r - top) & 1:
+            rows[r] = rows[r - 1]
+        else:
+            rows[r] = data[i]
+            i += 1
+    return rows
+
+
+def font(a):
+    glyphs = load_font(a.input, a.name)
+    packed = [encode_glyph(g) for g in glyphs]
+    if [decode_glyph(p) for p in packed] != glyphs:
+        sys.exit('round trip failed')
+    data = b''.join(packed)
+    off = [0]
+    for p in packed:
+        off.append(off[-1] + len(p))
+    raw = GLYPH_H * len(glyphs)
+    size = len(data) + 2 * len(off)
+
+    print('//%s: %d glyphs 8x16, %d -> %d bytes with the offsets (%.2fx)'
+          % (a.name, len(glyphs), raw, size, float(raw) / size))
+    print('const unsigned char %s_rle[%d]={' % (a.name, len(data)))
+    for i in range(0, len(data), 16):
+        print(''.join('0x%02X,' % b for b in data[i:i + 16]))
+    print('};')
+    print('const unsigned short %s_off[%d]={' % (a.name, len(off)))
+    for i in range(0, len(off), 12):
+        print(''.join('%d,' % v for v in off[i:i + 12]))
+    print('};')
+    sys.stderr.write('%s: %d -> %d bytes, %.2fx\n' % (a.name, raw, size, float(raw) / size))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    ap.add_argument('input', help='Image2LCD C array, or .bin; with --font the C file with the glyph table')
+    ap.add_argument('-w', '--width', type=int)
+    ap.add_argument('-n', '--name', required=True, help='name of the rle_image_t, or of the glyph table')
+    ap.add_argument('--be', action='store_true', help='input is high byte first')
+    ap.add_argument('--font', action='store_true', help='pack an 8x16 glyph table')
+    a = ap.parse_args()
+    if a.font:
+        return font(a)
+    if not a.width:
+        ap.error('the image width is needed')
+
+    px = load(a.input, a.be)
+    if len(px) % a.width:
+        sys.exit('%d pixels is not a multiple of the width' % len(px))
+    h = len(px) // a.width
+    data = encode(px)
+    if decode(data, len(px)) != px:
+        sys.exit('round trip failed')
+
+    print('//%s: %dx%d RGB565, %d -> %d bytes (%.2fx)'
+          % (a.name, a.width, h, 2 * len(px), len(data), 2.0 * len(px) / len(data)))
+    print('static const unsigned char %s_rle[%d] = {' % (a.name, len(data)))
+    for i in range(0, len(data), 16):
+        print(''.join('0X%02X,' % b for b in data[i:i + 16]))
+    print('};')
+    print('const rle_image_t %s = {%d, %d, %s_rle};' % (a.name, a.width, h, a.name))
+    sys.stderr.write('%s: %d -> %d bytes, %.2fx\n'
+                     % (a.name, 2 * len(px), len(data), 2.0 * len(px) / len(data)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,258 @@
+#include "acq.h"
+#include "lpm.h"
+#include "clock.h"
+#include "cal.h"
+#include "cap.h"
+#include "stats.h"
+#include "charge.h"
+#include "capacity.h"
+#include "cable.h"
+#include "strip.h"
+#include "frame.h"
+
+acq_block_t acq_last;
+uint32_t acq_overruns;          //blocks lost because ACQ_TASK fell behind
+
+static uint16_t acq_buf[2][ACQ_BLOCK][ACQ_CH_NUM];
+static const uint8_t acq_chan[ACQ_CH_NUM] = {ADC_CHANNEL_1, ADC_CHANNEL_2, ADC_CHANNEL_7, ADC_CHANNEL_5};
+static uint32_t acq_saved[4];   //CR1, CR2, SQR1, SQR3 of the scan setup during a burst
+static volatile uint8_t acq_burst;
+static acq_stream_fn volatile acq_stream;  //a burst without end, fed from acq_buf
+static uint8_t burst_task, burst_sig;
+
+static HAL_StatusTypeDef Acq_Run(void)
+{
+	HAL_StatusTypeDef st;
+
+	st = HAL_ADC_Start_DMA(&ACQ_ADC, (uint32_t *)acq_buf, sizeof(acq_buf) / sizeof(uint16_t));
+	if(st == HAL_OK)
+		st = HAL_TIM_Base_Start(&ACQ_TIM);
+	return st;
+}
+
+static void Acq_BurstRestore(void)
+{
+	ACQ_ADC.Instance->CR1 = acq_saved[0];
+	ACQ_ADC.Instance->CR2 = acq_saved[1];
+	ACQ_ADC.Instance->SQR1 = acq_saved[2];
+	ACQ_ADC.Instance->SQR3 = acq_saved[3];
+	SET_BIT(ACQ_ADC.DMA_Handle->Instance->CCR, DMA_CCR_CIRC);
+	acq_burst = 0;
+	acq_stream = NULL;
+}
+
+//pause the scan, ADC1 converts channel ch back to back from now on
+static void Acq_Single(uint8_t ch, uint8_t task, uint8_t sig)
+{
+	HAL_TIM_Base_Stop(&ACQ_TIM);
+	HAL_ADC_Stop_DMA(&ACQ_ADC);
+	burst_task = task;
+	burst_sig = sig;
+	acq_saved[0] = ACQ_ADC.Instance->CR1;
+	acq_saved[1] = ACQ_ADC.Instance->CR2;
+	acq_saved[2] = ACQ_ADC.Instance->SQR1;
+	acq_saved[3] = ACQ_ADC.Instance->SQR3;
+	acq_burst = 1;
+	CLEAR_BIT(ACQ_ADC.Instance->CR1, ADC_CR1_SCAN);
+	ACQ_ADC.Instance->SQR1 = 0;                     //one conversion
+	ACQ_ADC.Instance->SQR3 = acq_chan[ch];
+	MODIFY_REG(ACQ_ADC.Instance->CR2, ADC_CR2_EXTSEL, ADC_SOFTWARE_START);
+	SET_BIT(ACQ_ADC.Instance->CR2, ADC_CR2_CONT);
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef Acq_Start(void)
+ * @date       :2026-10-19
+ * @function   :Start continuous sampling. Holds the Stop-mode lock, the
+                ADC, TIM3 and DMA need their clocks.
+ * @parameters :None
+ * @retvalue   :HAL status of the ADC/TIM start
+******************************************************************************/
+HAL_StatusTypeDef Acq_Start(void)
+{
+	HAL_StatusTypeDef st;
+
+	LPM_Lock(LPM_LOCK_ACQ);
+	Clock_Require(CLOCK_USER_ACQ, CLOCK_LOG);
+	st = Acq_Run();
+	if(st != HAL_OK)
+		Acq_Stop();
+	return st;
+}
+
+void Acq_Stop(void)
+{
+	HAL_TIM_Base_Stop(&ACQ_TIM);
+	HAL_ADC_Stop_DMA(&ACQ_ADC);
+	if(acq_burst)
+	{
+		Acq_BurstRestore();
+		Sched_Post(burst_task, burst_sig, 0);
+	}
+	LPM_Unlock(LPM_LOCK_ACQ);
+	Clock_Require(CLOCK_USER_ACQ, CLOCK_IDLE);
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef Acq_Burst(uint8_t ch, uint16_t *buf, uint16_t n, uint8_t task, uint8_t sig)
+ * @date       :2026-10-19
+ * @function   :Sample one input back to back at the full ADC rate. The
+                scan is paused, ADC1 converts the channel continuously
+                and the DMA makes a single pass over buf; then the scan
+                setup is restored and sampling resumes. Completion is
+                posted to task as sig with arg 1 (arg 0: sampling was
+                stopped first). The scan blocks are lost for the duration.
+ * @parameters :ch:ACQ_CH_x
+                buf:destination
+                n:number of samples
+                task, sig:completion message
+ * @retvalue   :HAL_BUSY while a burst runs or sampling is stopped,
+                else the HAL status of the ADC start
+******************************************************************************/
+HAL_StatusTypeDef Acq_Burst(uint8_t ch, uint16_t *buf, uint16_t n, uint8_t task, uint8_t sig)
+{
+	HAL_StatusTypeDef st;
+
+	if(acq_burst || !(LPM_Locks() & LPM_LOCK_ACQ))
+		return HAL_BUSY;
+	Acq_Single(ch, task, sig);
+	CLEAR_BIT(ACQ_ADC.DMA_Handle->Instance->CCR, DMA_CCR_CIRC);   //stop after one pass
+	st = HAL_ADC_Start_DMA(&ACQ_ADC, (uint32_t *)buf, n);
+	if(st != HAL_OK)
+	{
+		Acq_BurstRestore();
+		Acq_Run();
+	}
+	return st;
+}
+
+/*****************************************************************************
+ * @name       :void Acq_BurstDone(void)
+ * @date       :2026-10-19
+ * @function   :End of the burst DMA pass: restore the scan, resume
+                sampling and notify the requester. Call from ACQ_TASK on
+                ACQ_SIG_BURST.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Acq_BurstDone(void)
+{
+	if(!acq_burst)
+		return;
+	HAL_ADC_Stop_DMA(&ACQ_ADC);
+	Acq_BurstRestore();
+	Acq_Run();
+	Sched_Post(burst_task, burst_sig, 1);
+}
+
+uint32_t Acq_BurstRate(void)
+{
+	return HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_ADC) * 2 / ACQ_BURST_HALF_CYCLES;
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef Acq_Stream(uint8_t ch, acq_stream_fn fn, uint8_t task, uint8_t sig)
+ * @date       :2026-10-19
+ * @function   :Sample one input back to back at the full ADC rate until
+                Acq_StreamStop(). The DMA runs circular over acq_buf and
+                each half, ACQ_STREAM_HALF samples, goes to fn from the DMA
+                interrupt; fn must be done with it within 0.7 ms. The scan
+                blocks are lost while the stream runs. Stopping the
+                sampling ends the stream and posts sig with arg 0 to task.
+ * @parameters :ch:ACQ_CH_x
+                fn:consumer of the samples, interrupt context
+                task, sig:notified when Acq_Stop() ends the stream
+ * @retvalue   :HAL_BUSY while a burst or stream runs or sampling is
+                stopped, else the HAL status of the ADC start
+******************************************************************************/
+HAL_StatusTypeDef Acq_Stream(uint8_t ch, acq_stream_fn fn, uint8_t task, uint8_t sig)
+{
+	HAL_StatusTypeDef st;
+
+	if(acq_burst || !(LPM_Locks() & LPM_LOCK_ACQ))
+		return HAL_BUSY;
+	Acq_Single(ch, task, sig);
+	acq_stream = fn;
+	st = HAL_ADC_Start_DMA(&ACQ_ADC, (uint32_t *)acq_buf, sizeof(acq_buf) / sizeof(uint16_t));
+	if(st != HAL_OK)
+	{
+		Acq_BurstRestore();
+		Acq_Run();
+	}
+	return st;
+}
+
+//back to the scan; task context, HAL_ADC calls are not reentrant
+void Acq_StreamStop(void)
+{
+	if(!acq_stream)
+		return;
+	HAL_ADC_Stop_DMA(&ACQ_ADC);
+	Acq_BurstRestore();
+	Acq_Run();
+}
+
+uint8_t Acq_Streaming(void)
+{
+	return acq_stream != NULL;
+}
+
+/*****************************************************************************
+ * @name       :void Acq_Process(uint8_t half)
+ * @date       :2026-10-19
+ * @function   :Reduce one block to per-channel averages, call from ACQ_TASK
+                on ACQ_SIG_BLOCK. The DMA is filling the other half meanwhile.
+ * @parameters :half:buffer half that just completed
+ * @retvalue   :None
+******************************************************************************/
+void Acq_Process(uint8_t half)
+{
+	uint32_t sum[ACQ_CH_NUM] = {0};
+	uint16_t (*f)[ACQ_CH_NUM] = acq_buf[half];
+	uint16_t top = 0;
+	uint8_t i, ch;
+
+	if(acq_stream)
+		return;                     //posted before the stream took acq_buf over
+	for(i = 0; i < ACQ_BLOCK; i++)
+	{
+		for(ch = 0; ch < ACQ_CH_NUM; ch++)
+			sum[ch] += f[i][ch];
+		if(f[i][ACQ_CH_I100MA] > top)
+			top = f[i][ACQ_CH_I100MA];
+	}
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+		acq_last.avg[ch] = sum[ch] >> ACQ_BLOCK_SHIFT;
+	Cal_Block(&acq_last);
+	acq_last.load_ua = top < ACQ_RANGE_RAW ? acq_last.val[ACQ_CH_I100MA] : acq_last.val[ACQ_CH_I4A] * 1000;
+	Charge_Block(&acq_last);
+	Capacity_Block(&acq_last);
+	Cable_Block(&acq_last);
+	Strip_Block(&acq_last);
+	Cap_Block(f, ACQ_BLOCK);
+	Stats_Block(f, ACQ_BLOCK);
+	acq_last.seq++;
+	Frame_Publish(&acq_last);
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	if(hadc != &ACQ_ADC)
+		return;
+	if(acq_stream)
+		acq_stream(acq_buf[0][0], ACQ_STREAM_HALF);
+	else if(!acq_burst && Sched_Post(ACQ_TASK, ACQ_SIG_BLOCK, 0) != HAL_OK)
+		acq_overruns++;
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	if(hadc != &ACQ_ADC)
+		return;
+	if(acq_stream)
+		acq_stream(acq_buf[1][0], ACQ_STREAM_HALF);
+	else if(acq_burst)
+		Sched_Signal(ACQ_TASK, ACQ_SIG_BURST);    //restore in task context, HAL_ADC calls are not reentrant
+	else if(Sched_Post(ACQ_TASK, ACQ_SIG_BLOCK, 1) != HAL_OK)
+		acq_overruns++;
+}
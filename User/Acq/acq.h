@@ -0,0 +1,57 @@
+#ifndef __ACQ_H
+#define __ACQ_H
+#include "main.h"
+#include "adc.h"
+#include "tim.h"
+#include "sched.h"
+
+//Sampling: TIM3 triggers an ADC1 scan of all four inputs at ACQ_RATE_HZ,
+//DMA1 channel 1 writes the frames into a circular buffer. Each half of the
+//buffer is handed to ACQ_TASK as one block, so the CPU wakes once per
+//ACQ_BLOCK frames instead of once per sample. Acq_Burst() pauses the scan
+//for a single-channel capture at the full ADC conversion rate; Acq_Stream()
+//does the same without end, passing the samples through the scan buffer in
+//halves of ACQ_STREAM_HALF to a callback in the DMA interrupt.
+#define ACQ_ADC             hadc1
+#define ACQ_TIM             htim3
+#define ACQ_TASK            SCHED_TASK_ACQ
+#define ACQ_SIG_BLOCK       0       //message, arg = buffer half (0/1)
+#define ACQ_SIG_BURST       1       //burst DMA pass complete
+
+#define ACQ_CH_I4A          0       //scan rank order, see MX_ADC1_Init()
+#define ACQ_CH_I100MA       1
+#define ACQ_CH_UIN          2
+#define ACQ_CH_BAT          3
+#define ACQ_CH_NUM          4
+
+#define ACQ_RATE_HZ         1000    //TIM3: 72 MHz / 72 / 1000
+#define ACQ_BLOCK           32      //frames per half buffer, power of two
+#define ACQ_BLOCK_SHIFT     5
+#define ACQ_BURST_HALF_CYCLES   136 //(55.5 sampling + 12.5) ADC clocks per conversion, x2
+#define ACQ_RANGE_RAW       3900    //I_100mA counts above which the I_4A range is used
+#define ACQ_STREAM_HALF     (ACQ_BLOCK * ACQ_CH_NUM)    //samples per stream callback, 0.7 ms
+
+typedef struct
+{
+	uint16_t avg[ACQ_CH_NUM];       //raw ADC counts averaged over one block
+	int32_t val[ACQ_CH_NUM];        //calibrated: mA, uA, mV, mV (see cal.h)
+	int32_t load_ua;                //autoranged load current: I_100mA unless a frame neared its full scale
+	uint32_t seq;                   //block counter
+} acq_block_t;
+
+typedef void (*acq_stream_fn)(const uint16_t *s, uint16_t n);
+
+extern acq_block_t acq_last;
+extern uint32_t acq_overruns;
+
+HAL_StatusTypeDef Acq_Start(void);
+void Acq_Stop(void);
+void Acq_Process(uint8_t half);
+HAL_StatusTypeDef Acq_Burst(uint8_t ch, uint16_t *buf, uint16_t n, uint8_t task, uint8_t sig);
+void Acq_BurstDone(void);
+uint32_t Acq_BurstRate(void);
+HAL_StatusTypeDef Acq_Stream(uint8_t ch, acq_stream_fn fn, uint8_t task, uint8_t sig);
+void Acq_StreamStop(void);
+uint8_t Acq_Streaming(void);
+
+#endif
@@ -0,0 +1,154 @@
+#include "boot.h"
+#include "Power_SW.h"
+#include "acq.h"
+#include "log.h"
+#include "lcd.h"
+#include "tile.h"
+#include "backlight.h"
+#include "timestamp.h"
+#include "clock.h"
+#include "cal.h"
+#include "cap.h"
+#include "stats.h"
+#include "capacity.h"
+#include <stdio.h>
+
+#define BOOT_STEP_RESET     0       //RES held low
+#define BOOT_STEP_WAKE      1       //reset recovery
+#define BOOT_STEP_RAM       2       //sleep-out, RAM writable soon
+#define BOOT_STEP_ON        3       //sleep-out settling
+#define BOOT_STEP_RTC       4       //display up, waiting for the clock
+#define BOOT_STEP_DONE      5
+
+static uint8_t step;
+static uint32_t slpout_ms;
+static uint32_t mark_us[BOOT_PH_NUM];
+static uint8_t marked;              //bit per phase
+static sched_timer_t boot_timer;
+
+static void Boot_Mark(uint8_t ph)
+{
+	mark_us[ph] = TS_LocalUs();
+	marked |= 1 << ph;
+}
+
+static void Boot_After(uint32_t ms)
+{
+	Sched_TimerStart(&boot_timer, BOOT_TASK, BOOT_SIG_STEP, ms, 0);
+}
+
+/*****************************************************************************
+ * @name       :void Boot_Start(void)
+ * @date       :2026-10-19
+ * @function   :Latch the supply and start every boot phase that does not
+                need to wait. Call once after the scheduler, console, I2C
+                queue and TS_Init() are up.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Boot_Start(void)
+{
+	PWR_On;
+	Boot_Mark(BOOT_PH_POWER);
+	LCD_ResetStart();
+	Tile_Init();
+	Cal_Init();
+	Stats_Init();
+	Acq_Start();
+	Boot_Mark(BOOT_PH_ADC);
+	Log_Init();                 //flash scan runs while RES is held low
+	Cal_Load();
+	Cap_Init();
+	Capacity_Init();
+	Boot_Mark(BOOT_PH_FLASH);
+	step = BOOT_STEP_RESET;
+	Boot_After(BOOT_LCD_RESET_MS);
+}
+
+/*****************************************************************************
+ * @name       :uint8_t Boot_Process(void)
+ * @date       :2026-10-19
+ * @function   :Next panel bring-up step, call from BOOT_TASK on
+                BOOT_SIG_STEP
+ * @parameters :None
+ * @retvalue   :1 once, when the display has just been switched on
+******************************************************************************/
+uint8_t Boot_Process(void)
+{
+	uint32_t el;
+
+	if(!(marked & (1 << BOOT_PH_RTC)) && (TS_GetFlags() & (TS_FLAG_VALID | TS_FLAG_RTC_LOST)))
+		Boot_Mark(BOOT_PH_RTC);
+	switch(step)
+	{
+		case BOOT_STEP_RESET:
+			LCD_ResetEnd();
+			step = BOOT_STEP_WAKE;
+			//after a reset with the panel still awake it needs the full recovery time
+			Boot_After(__HAL_RCC_GET_FLAG(RCC_FLAG_PORRST) ? BOOT_LCD_WAKE_MS : BOOT_LCD_WARM_MS);
+			break;
+		case BOOT_STEP_WAKE:
+			LCD_InitRegs();
+			slpout_ms = HAL_GetTick();
+			Boot_Mark(BOOT_PH_LCD_REGS);
+			step = BOOT_STEP_RAM;
+			Boot_After(BOOT_LCD_RAM_MS);
+			break;
+		case BOOT_STEP_RAM:
+			LCD_direction(USE_HORIZONTAL);
+			LCD_Clear(BLACK);
+			Boot_Mark(BOOT_PH_LCD_RAM);
+			step = BOOT_STEP_ON;
+			el = HAL_GetTick() - slpout_ms;
+			Boot_After(el < BOOT_LCD_ON_MS ? BOOT_LCD_ON_MS - el : 1);
+			break;
+		case BOOT_STEP_ON:
+			LCD_DisplayOn();
+			Backlight_Init();
+			Boot_Mark(BOOT_PH_LCD_ON);
+			step = BOOT_STEP_RTC;
+			Boot_After(1);
+			return 1;
+		case BOOT_STEP_RTC:
+			if(!(marked & (1 << BOOT_PH_RTC)) && HAL_GetTick() - slpout_ms < BOOT_LCD_ON_MS + BOOT_RTC_MAX_MS)
+			{
+				Boot_After(BOOT_RTC_POLL_MS);
+				break;
+			}
+			step = BOOT_STEP_DONE;
+			__HAL_RCC_CLEAR_RESET_FLAGS();
+			Boot_Report();
+			Clock_Require(CLOCK_USER_BOOT, CLOCK_IDLE);
+			break;
+		default:
+			break;
+	}
+	return 0;
+}
+
+uint8_t Boot_DisplayReady(void)
+{
+	return step > BOOT_STEP_ON;
+}
+
+/*****************************************************************************
+ * @name       :void Boot_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the time of each boot phase since HAL_Init()
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Boot_Report(void)
+{
+	static const char * const name[BOOT_PH_NUM] = {"power", "adc", "flash", "lcd regs", "lcd ram", "lcd on", "rtc"};
+	uint8_t i;
+
+	for(i = 0; i < BOOT_PH_NUM; i++)
+	{
+		if(marked & (1 << i))
+			printf("boot %-8s %4lu.%03lu ms\r\n", name[i], (unsigned long)(mark_us[i] / 1000),
+			       (unsigned long)(mark_us[i] % 1000));
+		else
+			printf("boot %-8s  --\r\n", name[i]);
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef __BOOT_H
+#define __BOOT_H
+#include "main.h"
+#include "sched.h"
+
+//Staged cold boot. Everything that only needs a pin level or a short bus
+//transaction runs at once: supply latch, ADC calibration and sampling, the
+//flash ID probe / log resume and the async RTC read. The panel's reset
+//pulse, reset recovery and sleep-out time are timer deadlines on BOOT_TASK,
+//the panel RAM is cleared inside the sleep-out wait. Each phase is
+//time-stamped and reported over the console once the display is up.
+#define BOOT_TASK           SCHED_TASK_POWER
+#define BOOT_SIG_STEP       2
+
+#define BOOT_LCD_RESET_MS   1       //RES low pulse, ST7789 needs 10 us
+#define BOOT_LCD_WAKE_MS    5       //RES high to the first command (sleep-in)
+#define BOOT_LCD_WARM_MS    120     //same after a reset without power cycle (panel was awake)
+#define BOOT_LCD_RAM_MS     5       //Sleep Out to the first RAM write
+#define BOOT_LCD_ON_MS      120     //Sleep Out to Display On
+#define BOOT_RTC_POLL_MS    5
+#define BOOT_RTC_MAX_MS     100     //stop waiting for the boot-time RTC read
+
+#define BOOT_PH_POWER       0       //PWR_EN latched
+#define BOOT_PH_ADC         1       //calibrated, sampling
+#define BOOT_PH_FLASH       2       //ID probed, log resumed: recording
+#define BOOT_PH_LCD_REGS    3
+#define BOOT_PH_LCD_RAM     4
+#define BOOT_PH_LCD_ON      5
+#define BOOT_PH_RTC         6       //wall clock read (or given up)
+#define BOOT_PH_NUM         7
+
+void Boot_Start(void);
+uint8_t Boot_Process(void);
+uint8_t Boot_DisplayReady(void);
+void Boot_Report(void);
+
+#endif
@@ -0,0 +1,208 @@
+#include "cable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CABLE_STATE_FLAT    0
+#define CABLE_STATE_STEP    1       //waiting for the new level to settle
+
+static int32_t ring_ua[CABLE_AVG], ring_mv[CABLE_AVG];
+static uint8_t pos;
+static int32_t prev_ua, prev_mv;
+static uint8_t flat;                //consecutive flat block-to-block changes
+static int32_t pre_ua, pre_mv;      //level before the step
+static uint8_t have_pre;
+static uint8_t state;
+static uint8_t wait;
+
+static cable_pair_t pair[CABLE_PAIRS];
+static uint8_t head;
+static cable_est_t est;
+
+void Cable_Reset(void)
+{
+	flat = have_pre = 0;
+	state = CABLE_STATE_FLAT;
+	head = 0;
+	memset(&est, 0, sizeof(est));
+}
+
+static void Cable_Sort(int32_t *v, uint8_t n)
+{
+	int32_t x;
+	uint8_t i, j;
+
+	for(i = 1; i < n; i++)
+	{
+		x = v[i];
+		for(j = i; j > 0 && v[j - 1] > x; j--)
+			v[j] = v[j - 1];
+		v[j] = x;
+	}
+}
+
+static int32_t Cable_Median(int32_t *v, uint8_t n)
+{
+	Cable_Sort(v, n);
+	return n & 1 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+/*****************************************************************************
+ * @name       :static void Cable_Estimate(void)
+ * @date       :2026-10-19
+ * @function   :Median and MAD of the kept pairs, then the least-squares
+                slope through the origin over the pairs inside the trim band
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Cable_Estimate(void)
+{
+	int32_t v[CABLE_PAIRS], band;
+	int64_t sxy = 0, sxx = 0;
+	uint8_t i, n = est.pairs;
+
+	for(i = 0; i < n; i++)
+		v[i] = pair[i].r_mohm;
+	est.median_mohm = Cable_Median(v, n);
+	for(i = 0; i < n; i++)
+		v[i] = abs(pair[i].r_mohm - est.median_mohm);
+	est.mad_mohm = Cable_Median(v, n);
+	band = CABLE_TRIM * (est.mad_mohm > CABLE_MAD_MIN_MOHM ? est.mad_mohm : CABLE_MAD_MIN_MOHM);
+	est.used = 0;
+	for(i = 0; i < n; i++)
+	{
+		if(abs(pair[i].r_mohm - est.median_mohm) > band)
+			continue;
+		sxy += (int64_t)pair[i].du_mv * pair[i].di_ma;
+		sxx += (int64_t)pair[i].di_ma * pair[i].di_ma;
+		est.used++;
+	}
+	est.r_mohm = sxx ? (int32_t)(-sxy * 1000 / sxx) : est.median_mohm;
+}
+
+static void Cable_Pair(int32_t ua, int32_t mv)
+{
+	cable_pair_t *p;
+	int32_t di = ua - pre_ua, du = mv - pre_mv, r;
+
+	est.steps++;
+	if(abs(di) < CABLE_STEP_MA * 1000)  //the load went back before it settled
+	{
+		est.rejected++;
+		return;
+	}
+	r = (int32_t)(-(int64_t)du * 1000000 / di);
+	if(r < -CABLE_MAD_MIN_MOHM || r > CABLE_R_MAX_MOHM)
+	{
+		est.rejected++;
+		return;
+	}
+	p = &pair[head];
+	p->di_ma = di / 1000;
+	p->du_mv = du;
+	p->r_mohm = r;
+	head = (head + 1) % CABLE_PAIRS;
+	if(est.pairs < CABLE_PAIRS)
+		est.pairs++;
+	Cable_Estimate();
+}
+
+/*****************************************************************************
+ * @name       :void Cable_Block(const acq_block_t *b)
+ * @date       :2026-10-19
+ * @function   :Follow the load level and pair each settled step with the
+                Uin change, called by Acq_Process()
+ * @parameters :b:calibrated block
+ * @retvalue   :None
+******************************************************************************/
+void Cable_Block(const acq_block_t *b)
+{
+	int32_t ua = b->load_ua, mv = b->val[ACQ_CH_UIN], mean_ua = 0, mean_mv = 0;
+	uint8_t i;
+
+	ring_ua[pos] = ua;
+	ring_mv[pos] = mv;
+	pos = (pos + 1) & (CABLE_AVG - 1);
+	if(abs(ua - prev_ua) < CABLE_FLAT_MA * 1000 && abs(mv - prev_mv) < CABLE_FLAT_MV)
+	{
+		if(flat < CABLE_AVG)
+			flat++;
+	}
+	else
+		flat = 0;
+	prev_ua = ua;
+	prev_mv = mv;
+	if(flat >= CABLE_AVG - 1)
+	{
+		for(i = 0; i < CABLE_AVG; i++)
+		{
+			mean_ua += ring_ua[i];
+			mean_mv += ring_mv[i];
+		}
+		mean_ua >>= CABLE_AVG_SHIFT;
+		mean_mv >>= CABLE_AVG_SHIFT;
+	}
+	if(state == CABLE_STATE_STEP)
+	{
+		if(flat >= CABLE_AVG - 1)
+		{
+			Cable_Pair(mean_ua, mean_mv);
+			pre_ua = mean_ua;
+			pre_mv = mean_mv;
+			state = CABLE_STATE_FLAT;
+		}
+		else if(++wait > CABLE_SETTLE_MAX)
+		{
+			est.steps++;
+			est.rejected++;
+			have_pre = 0;
+			state = CABLE_STATE_FLAT;
+		}
+	}
+	else if(flat >= CABLE_AVG - 1)
+	{
+		pre_ua = mean_ua;           //follows slow drift of the level
+		pre_mv = mean_mv;
+		have_pre = 1;
+	}
+	else if(have_pre && abs(ua - pre_ua) >= CABLE_STEP_MA * 1000)
+	{
+		state = CABLE_STATE_STEP;
+		wait = 0;
+	}
+}
+
+uint8_t Cable_Get(cable_est_t *e)
+{
+	*e = est;
+	return est.pairs;
+}
+
+void Cable_Command(const char *args)
+{
+	if(strcmp(args, "reset") == 0)
+		Cable_Reset();
+	Cable_Report();
+}
+
+/*****************************************************************************
+ * @name       :void Cable_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the estimate and the newest pairs
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Cable_Report(void)
+{
+	const cable_pair_t *p;
+	uint8_t i;
+
+	printf("cable %ld mOhm  median %ld mad %ld  pairs %u/%u  steps %lu rejected %lu\r\n", (long)est.r_mohm,
+	       (long)est.median_mohm, (long)est.mad_mohm, est.used, est.pairs, (unsigned long)est.steps,
+	       (unsigned long)est.rejected);
+	for(i = 1; i <= est.pairs && i <= 4; i++)
+	{
+		p = &pair[(head + CABLE_PAIRS - i) % CABLE_PAIRS];
+		printf("  %+ld mA %+ld mV  %ld mOhm\r\n", (long)p->di_ma, (long)p->du_mv, (long)p->r_mohm);
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef __CABLE_H
+#define __CABLE_H
+#include "main.h"
+#include "acq.h"
+
+//Series resistance of the supply path (source output, cable and connector
+//up to the Uin divider) from the load's own steps. A step is a change of
+//the autoranged load current by CABLE_STEP_MA against the flat level
+//before it; once the new level is flat again, the two CABLE_AVG block means
+//give one pair dU/dI. Pairs whose ratio is negative or above CABLE_R_MAX
+//are the source moving, not the load (fast-charge negotiation), and are
+//dropped. The estimate over the last CABLE_PAIRS pairs is the median, the
+//median absolute deviation, and a least-squares fit through the origin over
+//the pairs within CABLE_TRIM MADs of the median: large steps weigh more,
+//outliers none. Cost per block: a few compares; a sort of 16 values per step.
+#define CABLE_STEP_MA       100     //load change that counts as a step
+#define CABLE_FLAT_MA       20      //block-to-block change that still counts as flat
+#define CABLE_FLAT_MV       10
+#define CABLE_AVG           4       //flat blocks averaged on each side, power of two
+#define CABLE_AVG_SHIFT     2
+#define CABLE_SETTLE_MAX    16      //blocks for the new level to settle (~0.5 s)
+#define CABLE_R_MAX_MOHM    2000
+#define CABLE_PAIRS         16
+#define CABLE_TRIM          3
+#define CABLE_MAD_MIN_MOHM  5       //floor of the trim band, the pairs are quantised
+
+typedef struct
+{
+	int32_t di_ma;
+	int32_t du_mv;
+	int32_t r_mohm;                 //-du / di
+} cable_pair_t;
+
+typedef struct
+{
+	int32_t r_mohm;                 //trimmed least-squares fit
+	int32_t median_mohm;
+	int32_t mad_mohm;
+	uint8_t pairs;                  //pairs kept
+	uint8_t used;                   //pairs inside the trim band
+	uint32_t steps;                 //steps seen since reset
+	uint32_t rejected;              //steps dropped (no settle, ratio out of range)
+} cable_est_t;
+
+void Cable_Reset(void);
+void Cable_Block(const acq_block_t *b);
+uint8_t Cable_Get(cable_est_t *e);
+void Cable_Command(const char *args);
+void Cable_Report(void);
+
+#endif
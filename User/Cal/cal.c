@@ -0,0 +1,449 @@
+#include "cal.h"
+#include "log.h"
+#include "w25qxx.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAL_STATE_IDLE      0
+#define CAL_STATE_WAIT      1       //flash busy with the log
+#define CAL_STATE_ERASE     2
+#define CAL_STATE_PROG      3
+
+#define CAL_SECTOR          (w25qxx.SectorCount - 1)
+
+static const char * const cal_name[ACQ_CH_NUM] = {"i4a", "i100m", "uin", "bat"};
+static const char * const cal_unit[ACQ_CH_NUM] = {"mA", "uA", "mV", "mV"};
+
+static cal_table_t table;
+static cal_table_t readback;        //flash copy, Cal_Load() and the verify
+static int32_t seg_gain[ACQ_CH_NUM][CAL_POINTS - 1];   //units per count, Q16
+static int32_t tfac[ACQ_CH_NUM];                        //temperature factor, Q16
+static uint8_t saved;               //table matches the flash
+static uint8_t state;
+
+static int16_t temp;                //0.1 C
+static uint8_t temp_ok;
+static sched_timer_t temp_timer;
+static sched_timer_t poll_timer;
+
+static uint8_t cap_ch;
+static uint8_t cap_left;            //blocks still to sum, 0 = no capture running
+static int32_t cap_val;
+static uint32_t cap_sum;
+
+static void Cal_Nominal(uint8_t ch)
+{
+	static const int32_t fs[ACQ_CH_NUM] =
+	{
+		CAL_I4A_FS_MA, CAL_I100MA_FS_UA,
+		4095 * CAL_ADC_MV * CAL_UIN_DIV >> 12, 4095 * CAL_ADC_MV * CAL_BAT_DIV >> 12,
+	};
+	cal_ch_t *c = &table.ch[ch];
+
+	memset(c, 0, sizeof(*c));
+	c->n = 2;
+	c->raw[1] = 4095;
+	c->val[1] = fs[ch];
+}
+
+static void Cal_Factor(uint8_t ch)
+{
+	const cal_ch_t *c = &table.ch[ch];
+
+	tfac[ch] = 65536;
+	if(temp_ok && c->tc)
+		tfac[ch] += (int32_t)((int64_t)c->tc * (temp - c->tref) * 65536 / 10000000);
+}
+
+/*****************************************************************************
+ * @name       :static void Cal_Segments(uint8_t ch)
+ * @date       :2026-10-19
+ * @function   :Precompute the slope of every segment and the temperature
+                factor, so Cal_Apply() needs no division
+ * @parameters :ch:channel
+ * @retvalue   :None
+******************************************************************************/
+static void Cal_Segments(uint8_t ch)
+{
+	cal_ch_t *c = &table.ch[ch];
+	uint8_t i;
+
+	for(i = 0; i + 1 < c->n; i++)
+		seg_gain[ch][i] = (int32_t)(((int64_t)(c->val[i + 1] - c->val[i]) << 16) / (c->raw[i + 1] - c->raw[i]));
+	Cal_Factor(ch);
+}
+
+static uint8_t Cal_Valid(const cal_ch_t *c)
+{
+	uint8_t i;
+
+	if(c->n < 2 || c->n > CAL_POINTS)
+		return 0;
+	for(i = 0; i + 1 < c->n; i++)
+		if(c->raw[i] >= c->raw[i + 1])
+			return 0;
+	return 1;
+}
+
+/*****************************************************************************
+ * @name       :void Cal_Init(void)
+ * @date       :2026-10-19
+ * @function   :ADC self-calibration, temperature sensor on the ADC1
+                injected group and the nominal table. Call before Acq_Start().
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Cal_Init(void)
+{
+	uint8_t ch;
+
+	HAL_ADCEx_Calibration_Start(&ACQ_ADC);
+	//the sensor alone in the injected group, started by software; the
+	//registers directly, HAL_ADCEx_InjectedConfigChannel() is 0.5 KB of flash
+	ACQ_ADC.Instance->JSQR = ADC_CHANNEL_TEMPSENSOR << ADC_JSQR_JSQ4_Pos;
+	SET_BIT(ACQ_ADC.Instance->SMPR1, ADC_SMPR1_SMP16);         //239.5 cycles, the sensor needs 17.1 us
+	SET_BIT(ACQ_ADC.Instance->CR2, ADC_CR2_TSVREFE | ADC_CR2_JEXTSEL | ADC_CR2_JEXTTRIG);
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+	{
+		Cal_Nominal(ch);
+		Cal_Segments(ch);
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Cal_Load(void)
+ * @date       :2026-10-19
+ * @function   :Read the table from the flash and start the temperature
+                timer. Call after Log_Init() has probed the chip; a missing
+                chip or a bad CRC leaves the nominal table in use.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Cal_Load(void)
+{
+	cal_table_t *t = &readback;
+	uint8_t ch;
+
+	Sched_TimerStart(&temp_timer, CAL_TASK, CAL_SIG_TEMP, 1, CAL_TEMP_MS);
+	if(w25qxx.SectorCount == 0)
+		return;
+	W25qxx_ReadBytesNow((uint8_t *)t, CAL_SECTOR * w25qxx.SectorSize, sizeof(*t));
+	if(t->magic != CAL_MAGIC || t->crc != Log_Crc(t, offsetof(cal_table_t, crc)))
+		return;
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+		if(!Cal_Valid(&t->ch[ch]))
+			return;
+	table = *t;
+	saved = 1;
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+		Cal_Segments(ch);
+}
+
+/*****************************************************************************
+ * @name       :int32_t Cal_Apply(uint8_t ch, uint16_t raw)
+ * @date       :2026-10-19
+ * @function   :Raw counts to channel units, outside the table the end
+                segments are extended
+ * @parameters :ch:channel
+                raw:ADC counts
+ * @retvalue   :calibrated value in channel units
+******************************************************************************/
+int32_t Cal_Apply(uint8_t ch, uint16_t raw)
+{
+	const cal_ch_t *c = &table.ch[ch];
+	int32_t v;
+	uint8_t i = 0;
+
+	while(i + 2 < c->n && raw >= c->raw[i + 1])
+		i++;
+	v = c->val[i] + (int32_t)(((int64_t)seg_gain[ch][i] * ((int32_t)raw - c->raw[i])) >> 16);
+	return (int32_t)(((int64_t)v * tfac[ch]) >> 16);
+}
+
+/*****************************************************************************
+ * @name       :static void Cal_Insert(uint8_t ch, uint16_t raw, int32_t val)
+ * @date       :2026-10-19
+ * @function   :Add a captured point in raw order. The first user point
+                replaces the nominal table and is paired with the origin
+                (gain only), the second one replaces the origin.
+ * @parameters :ch:channel
+                raw:averaged counts
+                val:reference in channel units
+ * @retvalue   :None
+******************************************************************************/
+static void Cal_Insert(uint8_t ch, uint16_t raw, int32_t val)
+{
+	cal_ch_t *c = &table.ch[ch];
+	cal_ch_t old = *c;
+	uint8_t i, j;
+
+	if(!(c->flags & CAL_F_USER))
+	{
+		memset(c, 0, sizeof(*c));
+		c->flags = CAL_F_USER;
+	}
+	else if(c->flags & CAL_F_ZERO)
+	{
+		c->n--;
+		memmove(&c->raw[0], &c->raw[1], c->n * sizeof(c->raw[0]));
+		memmove(&c->val[0], &c->val[1], c->n * sizeof(c->val[0]));
+		c->flags &= ~CAL_F_ZERO;
+	}
+	for(i = 0; i < c->n && c->raw[i] + CAL_MERGE_COUNTS < raw; i++);
+	if(i == c->n || c->raw[i] > raw + CAL_MERGE_COUNTS)
+	{
+		if(c->n == CAL_POINTS)
+		{
+			printf("cal %s: table full, 'cal %s reset' to start over\r\n", cal_name[ch], cal_name[ch]);
+			Cal_Segments(ch);
+			return;
+		}
+		for(j = c->n; j > i; j--)
+		{
+			c->raw[j] = c->raw[j - 1];
+			c->val[j] = c->val[j - 1];
+		}
+		c->n++;
+	}
+	c->raw[i] = raw;                    //new point, or replaces the one it is close to
+	c->val[i] = val;
+	c->tref = temp;
+	saved = 0;
+	if(c->n == 1)
+	{
+		if(raw == 0)
+		{
+			Cal_Reset(ch);
+			printf("cal %s: a single point needs a non-zero reading\r\n", cal_name[ch]);
+			return;
+		}
+		//gain through zero until a second point arrives
+		c->raw[1] = raw;
+		c->val[1] = val;
+		c->raw[0] = 0;
+		c->val[0] = 0;
+		c->n = 2;
+		c->flags |= CAL_F_ZERO;
+	}
+	if(!Cal_Valid(c))
+	{
+		*c = old;
+		printf("cal %s: raw %u too close to another point\r\n", cal_name[ch], raw);
+		return;
+	}
+	Cal_Segments(ch);
+	printf("cal %s: raw %u -> %ld %s, %u point(s), next reference then 'cal %s <value>' or 'cal save'\r\n",
+	       cal_name[ch], raw, (long)val, cal_unit[ch], c->n - ((c->flags & CAL_F_ZERO) ? 1 : 0), cal_name[ch]);
+}
+
+/*****************************************************************************
+ * @name       :void Cal_Block(acq_block_t *b)
+ * @date       :2026-10-19
+ * @function   :Fill in the calibrated values of a new block and feed a
+                running capture. Called by Acq_Process().
+ * @parameters :b:block with the raw averages
+ * @retvalue   :None
+******************************************************************************/
+void Cal_Block(acq_block_t *b)
+{
+	uint8_t ch;
+
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+		b->val[ch] = Cal_Apply(ch, b->avg[ch]);
+	if(cap_left == 0)
+		return;
+	cap_sum += b->avg[cap_ch];
+	if(--cap_left == 0)
+		Cal_Insert(cap_ch, (cap_sum + (CAL_CAPTURE_BLOCKS >> 1)) >> CAL_CAPTURE_SHIFT, cap_val);
+}
+
+void Cal_Capture(uint8_t ch, int32_t val)
+{
+	cap_ch = ch;
+	cap_val = val;
+	cap_sum = 0;
+	cap_left = CAL_CAPTURE_BLOCKS;
+}
+
+void Cal_Reset(uint8_t ch)
+{
+	Cal_Nominal(ch);
+	Cal_Segments(ch);
+	saved = 0;
+}
+
+void Cal_SetTc(uint8_t ch, int16_t tc)
+{
+	table.ch[ch].tc = tc;
+	Cal_Factor(ch);
+	saved = 0;
+}
+
+/*****************************************************************************
+ * @name       :void Cal_Save(void)
+ * @date       :2026-10-19
+ * @function   :Seal the table with its CRC and write it to the flash. The
+                erase and program are polled from CAL_TASK, they start once
+                the chip is done with the log.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Cal_Save(void)
+{
+	if(w25qxx.SectorCount == 0 || state != CAL_STATE_IDLE)
+	{
+		printf("cal: %s\r\n", state != CAL_STATE_IDLE ? "save running" : "no flash");
+		return;
+	}
+	table.magic = CAL_MAGIC;
+	table.crc = Log_Crc(&table, offsetof(cal_table_t, crc));
+	state = CAL_STATE_WAIT;
+	Sched_Signal(CAL_TASK, CAL_SIG_POLL);
+}
+
+static void Cal_Poll(void)
+{
+	if(W25qxx_IsBusy())
+	{
+		Sched_TimerStart(&poll_timer, CAL_TASK, CAL_SIG_POLL, CAL_POLL_MS, 0);
+		return;
+	}
+	switch(state)
+	{
+		case CAL_STATE_WAIT:
+			W25qxx_EraseSectorStart(CAL_SECTOR);
+			state = CAL_STATE_ERASE;
+			Sched_TimerStart(&poll_timer, CAL_TASK, CAL_SIG_POLL, CAL_POLL_MS, 0);
+			break;
+		case CAL_STATE_ERASE:
+			W25qxx_WritePageStart((uint8_t *)&table, W25qxx_SectorToPage(CAL_SECTOR), 0, sizeof(table));
+			state = CAL_STATE_PROG;
+			Sched_TimerStart(&poll_timer, CAL_TASK, CAL_SIG_POLL, 1, 0);
+			break;
+		case CAL_STATE_PROG:
+			W25qxx_ReadBytesNow((uint8_t *)&readback, CAL_SECTOR * w25qxx.SectorSize, sizeof(readback));
+			saved = memcmp(&readback, &table, sizeof(readback)) == 0;
+			printf("cal: %s\r\n", saved ? "saved" : "verify failed");
+			state = CAL_STATE_IDLE;
+			break;
+		default:
+			break;
+	}
+}
+
+/*****************************************************************************
+ * @name       :static void Cal_Temp(void)
+ * @date       :2026-10-19
+ * @function   :Read the last sensor conversion, start the next one and
+                update the temperature factors
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Cal_Temp(void)
+{
+	int32_t mv, t;
+	uint8_t ch;
+
+	if(__HAL_ADC_GET_FLAG(&ACQ_ADC, ADC_FLAG_JEOC))
+	{
+		mv = ACQ_ADC.Instance->JDR1 * CAL_ADC_MV >> 12;
+		t = 250 + ((CAL_TS_V25_MV - mv) * CAL_TS_SLOPE_Q10 >> 10);
+		if(temp_ok)
+			temp += (t - temp) >> 2;
+		else
+			temp = t;
+		temp_ok = 1;
+		for(ch = 0; ch < ACQ_CH_NUM; ch++)
+			Cal_Factor(ch);
+	}
+	__HAL_ADC_CLEAR_FLAG(&ACQ_ADC, ADC_FLAG_JEOC);
+	SET_BIT(ACQ_ADC.Instance->CR2, ADC_CR2_JSWSTART);
+}
+
+void Cal_Process(uint8_t sig)
+{
+	if(sig == CAL_SIG_TEMP)
+		Cal_Temp();
+	else if(sig == CAL_SIG_POLL)
+		Cal_Poll();
+}
+
+int16_t Cal_GetTemp(void)
+{
+	return temp;
+}
+
+/*****************************************************************************
+ * @name       :void Cal_Command(const char *args)
+ * @date       :2026-10-19
+ * @function   :Console front end: "<ch> <value>" captures a point,
+                "<ch> reset", "<ch> tc <ppm/K>", "save", nothing prints
+                the table
+ * @parameters :args:text after the command name
+ * @retvalue   :None
+******************************************************************************/
+void Cal_Command(const char *args)
+{
+	const char *p;
+	uint8_t ch;
+
+	if(strcmp(args, "save") == 0)
+	{
+		Cal_Save();
+		return;
+	}
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+	{
+		p = args + strlen(cal_name[ch]);
+		if(strncmp(args, cal_name[ch], p - args) == 0 && *p == ' ')
+			break;
+	}
+	if(ch == ACQ_CH_NUM)
+	{
+		Cal_Report();
+		return;
+	}
+	p++;
+	if(strcmp(p, "reset") == 0)
+	{
+		Cal_Reset(ch);
+		printf("cal %s: nominal, apply a reference then 'cal %s <value in %s>'\r\n", cal_name[ch],
+		       cal_name[ch], cal_unit[ch]);
+	}
+	else if(strncmp(p, "tc ", 3) == 0)
+		Cal_SetTc(ch, (int16_t)strtol(p + 3, NULL, 10));
+	else
+	{
+		Cal_Capture(ch, strtol(p, NULL, 10));
+		printf("cal %s: averaging %u blocks...\r\n", cal_name[ch], CAL_CAPTURE_BLOCKS);
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Cal_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the table, the live readings and the temperature
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Cal_Report(void)
+{
+	const cal_ch_t *c;
+	uint8_t ch, i;
+
+	printf("cal %s  temp %s%d.%d C%s\r\n", saved ? "saved" : "not saved", temp < 0 ? "-" : "",
+	       abs(temp) / 10, abs(temp) % 10, temp_ok ? "" : " (no reading)");
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+	{
+		c = &table.ch[ch];
+		printf("%-5s %-7s raw %4u = %ld %s  tc %d ppm/K @ %d C\r\n", cal_name[ch],
+		       (c->flags & CAL_F_USER) ? "user" : "nominal", acq_last.avg[ch], (long)acq_last.val[ch],
+		       cal_unit[ch], c->tc, c->tref / 10);
+		printf("     ");
+		for(i = 0; i < c->n; i++)
+			printf(" %u:%ld", c->raw[i], (long)c->val[i]);
+		printf("\r\n");
+	}
+}
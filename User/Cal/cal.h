@@ -0,0 +1,74 @@
+#ifndef __CAL_H
+#define __CAL_H
+#include "main.h"
+#include "sched.h"
+#include "acq.h"
+
+//Calibration of the four inputs. The ADC runs its self-calibration at boot;
+//each channel then maps raw counts to channel units through a piecewise
+//linear table of up to CAL_POINTS user points, captured against reference
+//loads from the console. A gain temperature coefficient per channel is
+//applied against the MCU's internal sensor (sampled as an ADC1 injected
+//conversion). Only the difference to the capture temperature is used, so
+//the sensor's large part-to-part offset cancels out.
+//Segment slopes and the temperature factor are precomputed, the block path
+//is a compare, two multiplies and shifts per channel: no divisions.
+//The table lives in the top sector of the W25Qxx (kept out of the log ring)
+//and is protected by the hardware CRC unit.
+#define CAL_TASK            SCHED_TASK_LOG
+#define CAL_SIG_TEMP        3       //temperature sensor timer
+#define CAL_SIG_POLL        4       //flash busy poll while saving
+
+#define CAL_POINTS          5
+#define CAL_CAPTURE_BLOCKS  32      //blocks averaged per captured point, power of two
+#define CAL_CAPTURE_SHIFT   5
+#define CAL_MERGE_COUNTS    8       //a capture this close to a point replaces it
+#define CAL_TEMP_MS         1000
+#define CAL_POLL_MS         10
+#define CAL_MAGIC           0x314C4143  //"CAL1"
+
+//nominal scaling until a channel is calibrated
+#define CAL_ADC_MV          3300
+#define CAL_BAT_DIV         2       //Bat_sample: 100k/100k
+#define CAL_UIN_DIV         11      //Uin_sample: 100k/10k, up to 20 V fast charge
+#define CAL_I4A_FS_MA       4000    //full scale of the I_4A range
+#define CAL_I100MA_FS_UA    100000  //full scale of the I_100mA range
+
+//STM32F103 internal sensor: V25 1.43 V, 4.3 mV/K
+#define CAL_TS_V25_MV       1430
+#define CAL_TS_SLOPE_Q10    2381    //0.1 K per mV, x1024
+
+#define CAL_F_USER          0x01    //points come from a user calibration
+#define CAL_F_ZERO          0x02    //point 0 is the origin added to a single user point
+
+typedef struct
+{
+	uint16_t raw[CAL_POINTS];       //ADC counts, strictly ascending
+	uint8_t n;                      //points in use, 2..CAL_POINTS
+	uint8_t flags;                  //CAL_F_x
+	int16_t tref;                   //sensor reading at capture, 0.1 C
+	int16_t tc;                     //gain drift, ppm/K
+	int32_t val[CAL_POINTS];        //reference at raw[i], channel units
+} cal_ch_t;
+
+typedef struct
+{
+	uint32_t magic;
+	cal_ch_t ch[ACQ_CH_NUM];
+	uint32_t crc;                   //CRC-32 (STM32 CRC unit) of everything above
+} cal_table_t;
+
+void Cal_Init(void);
+void Cal_Load(void);
+void Cal_Block(acq_block_t *b);
+int32_t Cal_Apply(uint8_t ch, uint16_t raw);
+void Cal_Capture(uint8_t ch, int32_t val);
+void Cal_Reset(uint8_t ch);
+void Cal_SetTc(uint8_t ch, int16_t tc);
+void Cal_Save(void);
+void Cal_Process(uint8_t sig);
+int16_t Cal_GetTemp(void);
+void Cal_Command(const char *args);
+void Cal_Report(void);
+
+#endif
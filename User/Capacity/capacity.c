@@ -0,0 +1,377 @@
+#include "capacity.h"
+#include "cap.h"
+#include "log.h"
+#include "w25qxx.h"
+#include "timestamp.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPACITY_W_IDLE     0
+#define CAPACITY_W_WAIT     1       //flash busy with the log or a capture
+#define CAPACITY_W_ERASE    2
+#define CAPACITY_W_PROG     3
+
+#define CAPACITY_FIRST_SECTOR (w25qxx.SectorCount - 1 - CAP_SECTORS - CAPACITY_SECTORS)
+#define CAPACITY_PER_SECTOR (w25qxx.SectorSize / CAPACITY_REC_SIZE)
+#define CAPACITY_BLOCK_MS   (ACQ_BLOCK * 1000 / ACQ_RATE_HZ)
+#define CAPACITY_X10_DIV    360000000   //uA x ms (uW x ms) per 0.1 mAh (0.1 mWh)
+
+static capacity_rec_t cur;          //live accumulators
+static capacity_rec_t out;          //sealed copy being written
+static uint32_t tick;               //HAL tick of the last block
+static uint32_t below_ms;           //current below imin
+static uint32_t low_ms;             //Uin below umin
+static uint32_t next_cp;            //test time of the next checkpoint
+static uint32_t next_seq;
+static uint32_t slot;               //next record slot over both sectors
+static uint8_t erase;               //slot starts a sector that must be erased first
+static uint8_t again;               //checkpoint requested while writing
+static uint8_t wstate;
+static sched_timer_t poll_timer;
+
+static void Capacity_Read(capacity_rec_t *r, uint32_t i)
+{
+	W25qxx_ReadBytesNow((uint8_t *)r, (CAPACITY_FIRST_SECTOR + i / CAPACITY_PER_SECTOR) * w25qxx.SectorSize +
+	                    (i % CAPACITY_PER_SECTOR) * CAPACITY_REC_SIZE, sizeof(*r));
+}
+
+static uint8_t Capacity_Erased(const capacity_rec_t *r)
+{
+	const uint32_t *w = (const uint32_t *)r;
+	uint8_t i;
+
+	for(i = 0; i < sizeof(*r) / 4; i++)
+		if(w[i] != 0xFFFFFFFF)
+			return 0;
+	return 1;
+}
+
+/*****************************************************************************
+ * @name       :void Capacity_Init(void)
+ * @date       :2026-10-19
+ * @function   :Find the newest valid checkpoint, place the next one after
+                it and resume a test that was still running. Call after
+                Log_Init() has probed the chip.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Capacity_Init(void)
+{
+	static capacity_rec_t t;
+	uint32_t i, n, best = 0;
+	uint8_t found = 0;
+
+	erase = 1;
+	slot = 0;
+	if(w25qxx.SectorCount == 0)
+		return;
+	n = CAPACITY_SECTORS * CAPACITY_PER_SECTOR;
+	for(i = 0; i < n; i++)
+	{
+		Capacity_Read(&t, i);
+		if(t.magic != CAPACITY_MAGIC || t.crc != Log_Crc(&t, offsetof(capacity_rec_t, crc)))
+			continue;
+		if(!found || t.seq > cur.seq)
+		{
+			cur = t;
+			best = i;
+			found = 1;
+		}
+	}
+	if(!found)
+	{
+		memset(&cur, 0, sizeof(cur));
+		return;
+	}
+	next_seq = cur.seq + 1;
+	slot = (best + 1) % n;
+	erase = slot % CAPACITY_PER_SECTOR == 0;
+	if(!erase)
+	{
+		Capacity_Read(&t, slot);
+		if(!Capacity_Erased(&t))        //torn write after the newest: go on in the other sector
+		{
+			slot = (slot / CAPACITY_PER_SECTOR + 1) % CAPACITY_SECTORS * CAPACITY_PER_SECTOR;
+			erase = 1;
+		}
+	}
+	if(cur.state == CAPACITY_STATE_WAIT || cur.state == CAPACITY_STATE_RUN)
+	{
+		tick = HAL_GetTick();
+		below_ms = low_ms = 0;
+		next_cp = cur.ms + CAPACITY_CHECKPOINT_MS;
+		printf("capacity: resumed at %lu s\r\n", (unsigned long)(cur.ms / 1000));
+	}
+}
+
+//seal the live accumulators and hand them to CAPACITY_TASK
+static void Capacity_Write(void)
+{
+	if(w25qxx.SectorCount == 0)
+		return;
+	if(wstate != CAPACITY_W_IDLE)
+	{
+		again = 1;
+		return;
+	}
+	out = cur;
+	out.magic = CAPACITY_MAGIC;
+	out.seq = next_seq++;
+	out.crc = Log_Crc(&out, offsetof(capacity_rec_t, crc));
+	wstate = CAPACITY_W_WAIT;
+	Sched_Signal(CAPACITY_TASK, CAPACITY_SIG_POLL);
+}
+
+/*****************************************************************************
+ * @name       :void Capacity_Start(uint16_t imin_ma, uint16_t umin_mv, uint16_t hold_s, uint16_t timeout_min)
+ * @date       :2026-10-19
+ * @function   :Clear the accumulators and start a test, the first record
+                is written right away
+ * @parameters :imin_ma:end-of-charge current
+                umin_mv:collapse voltage
+                hold_s:time below imin that ends the test
+                timeout_min:longest test
+ * @retvalue   :None
+******************************************************************************/
+void Capacity_Start(uint16_t imin_ma, uint16_t umin_mv, uint16_t hold_s, uint16_t timeout_min)
+{
+	ts_t ts;
+
+	if(cur.state == CAPACITY_STATE_WAIT || cur.state == CAPACITY_STATE_RUN)
+	{
+		printf("capacity: already running\r\n");
+		return;
+	}
+	memset(&cur, 0, sizeof(cur));
+	TS_Now(&ts);
+	cur.start = (TS_GetFlags() & TS_FLAG_VALID) ? ts.sec : 0;
+	cur.imin_ma = imin_ma;
+	cur.umin_mv = umin_mv;
+	cur.hold_s = hold_s;
+	cur.timeout_min = timeout_min;
+	cur.min_mv = 0xFFFF;
+	cur.state = CAPACITY_STATE_WAIT;
+	tick = HAL_GetTick();
+	below_ms = low_ms = 0;
+	next_cp = CAPACITY_CHECKPOINT_MS;
+	Capacity_Write();
+}
+
+static void Capacity_End(uint8_t reason)
+{
+	ts_t ts;
+	uint32_t mah = Capacity_MahX10(&cur) / 10;
+
+	cur.state = CAPACITY_STATE_DONE;
+	cur.reason = reason;
+	Capacity_Write();
+	TS_Now(&ts);
+	Log_Event(LOG_EVT_CAPACITY, &ts, mah > 0xFFFF ? 0xFFFF : mah, reason);
+	Capacity_Report();
+}
+
+void Capacity_Stop(void)
+{
+	if(cur.state == CAPACITY_STATE_WAIT || cur.state == CAPACITY_STATE_RUN)
+		Capacity_End(CAPACITY_END_STOP);
+}
+
+/*****************************************************************************
+ * @name       :void Capacity_Block(const acq_block_t *b)
+ * @date       :2026-10-19
+ * @function   :Integrate one calibrated block and test the end criteria,
+                called by Acq_Process()
+ * @parameters :b:calibrated block
+ * @retvalue   :None
+******************************************************************************/
+void Capacity_Block(const acq_block_t *b)
+{
+	uint32_t now, dt;
+	int32_t ua = b->load_ua, mv = b->val[ACQ_CH_UIN];
+
+	if(cur.state != CAPACITY_STATE_WAIT && cur.state != CAPACITY_STATE_RUN)
+		return;
+	now = HAL_GetTick();
+	dt = now - tick;
+	tick = now;
+	if(dt > CAPACITY_GAP_MS)
+		dt = CAPACITY_BLOCK_MS;
+	cur.ms += dt;
+	cur.q += (int64_t)ua * dt;
+	cur.e += (int64_t)ua * mv / 1000 * dt;
+	if(ua > (int32_t)cur.peak_ua)
+		cur.peak_ua = ua;
+	if(cur.state == CAPACITY_STATE_WAIT && ua >= cur.imin_ma * 1000)
+		cur.state = CAPACITY_STATE_RUN;
+	if(cur.state == CAPACITY_STATE_RUN)
+	{
+		if(mv < cur.min_mv)
+			cur.min_mv = mv < 0 ? 0 : mv;
+		below_ms = ua < cur.imin_ma * 1000 ? below_ms + dt : 0;
+		low_ms = mv < cur.umin_mv ? low_ms + dt : 0;
+		if(below_ms >= cur.hold_s * 1000UL)
+		{
+			Capacity_End(CAPACITY_END_CURRENT);
+			return;
+		}
+		if(low_ms >= CAPACITY_COLLAPSE_MS)
+		{
+			Capacity_End(CAPACITY_END_VOLTAGE);
+			return;
+		}
+	}
+	if(cur.ms >= cur.timeout_min * 60000UL)
+		Capacity_End(CAPACITY_END_TIMEOUT);
+	else if(cur.ms >= next_cp)
+	{
+		next_cp += CAPACITY_CHECKPOINT_MS;
+		Capacity_Write();
+	}
+}
+
+//take a checkpoint now (shutdown), nothing if no test is running
+void Capacity_Checkpoint(void)
+{
+	if(cur.state == CAPACITY_STATE_WAIT || cur.state == CAPACITY_STATE_RUN)
+		Capacity_Write();
+}
+
+/*****************************************************************************
+ * @name       :static void Capacity_Poll(void)
+ * @date       :2026-10-19
+ * @function   :Write the sealed record to its slot, erasing the sector
+                first when the slot starts one. Every step waits until the
+                chip is done with the log, calibration or a capture.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Capacity_Poll(void)
+{
+	static capacity_rec_t t;
+	uint32_t sector = CAPACITY_FIRST_SECTOR + slot / CAPACITY_PER_SECTOR;
+	uint32_t addr = (slot % CAPACITY_PER_SECTOR) * CAPACITY_REC_SIZE;
+
+	if(wstate == CAPACITY_W_IDLE)
+		return;
+	if(W25qxx_IsBusy())
+	{
+		Sched_TimerStart(&poll_timer, CAPACITY_TASK, CAPACITY_SIG_POLL, wstate == CAPACITY_W_PROG ? 1 : CAPACITY_POLL_MS, 0);
+		return;
+	}
+	if(wstate == CAPACITY_W_WAIT && erase)
+	{
+		W25qxx_EraseSectorStart(sector);
+		wstate = CAPACITY_W_ERASE;
+		Sched_TimerStart(&poll_timer, CAPACITY_TASK, CAPACITY_SIG_POLL, CAPACITY_POLL_MS, 0);
+	}
+	else if(wstate != CAPACITY_W_PROG)
+	{
+		erase = 0;
+		W25qxx_WritePageStart((uint8_t *)&out, W25qxx_SectorToPage(sector) + addr / w25qxx.PageSize,
+		                      addr % w25qxx.PageSize, sizeof(out));
+		wstate = CAPACITY_W_PROG;
+		Sched_TimerStart(&poll_timer, CAPACITY_TASK, CAPACITY_SIG_POLL, 1, 0);
+	}
+	else
+	{
+		W25qxx_ReadBytesNow((uint8_t *)&t, sector * w25qxx.SectorSize + addr, sizeof(t));
+		if(memcmp(&t, &out, sizeof(t)) != 0)
+			printf("capacity: checkpoint %lu verify failed\r\n", (unsigned long)out.seq);
+		slot = (slot + 1) % (CAPACITY_SECTORS * CAPACITY_PER_SECTOR);
+		erase = slot % CAPACITY_PER_SECTOR == 0;
+		wstate = CAPACITY_W_IDLE;
+		if(again)
+		{
+			again = 0;
+			Capacity_Write();
+		}
+	}
+}
+
+void Capacity_Process(uint8_t sig)
+{
+	if(sig == CAPACITY_SIG_POLL)
+		Capacity_Poll();
+}
+
+uint8_t Capacity_Pending(void)
+{
+	return wstate != CAPACITY_W_IDLE || again;
+}
+
+const capacity_rec_t *Capacity_Get(void)
+{
+	return &cur;
+}
+
+uint32_t Capacity_MahX10(const capacity_rec_t *r)
+{
+	return r->q > 0 ? (uint32_t)(r->q / CAPACITY_X10_DIV) : 0;
+}
+
+uint32_t Capacity_MwhX10(const capacity_rec_t *r)
+{
+	return r->e > 0 ? (uint32_t)(r->e / CAPACITY_X10_DIV) : 0;
+}
+
+/*****************************************************************************
+ * @name       :void Capacity_Command(const char *args)
+ * @date       :2026-10-19
+ * @function   :Console front end: "start [imin_mA [umin_mV [hold_s
+                [timeout_min]]]]" (missing or 0 = default), "stop", nothing
+                prints the status
+ * @parameters :args:text after the command name
+ * @retvalue   :None
+******************************************************************************/
+void Capacity_Command(const char *args)
+{
+	static const uint16_t def[4] = {CAPACITY_IMIN_MA, CAPACITY_UMIN_MV, CAPACITY_HOLD_S, CAPACITY_TIMEOUT_MIN};
+	uint16_t v[4];
+	char *p;
+	uint8_t i;
+
+	if(strncmp(args, "start", 5) == 0 && (args[5] == ' ' || args[5] == 0))
+	{
+		p = (char *)args + 5;
+		for(i = 0; i < 4; i++)
+		{
+			v[i] = (uint16_t)strtol(p, &p, 10);
+			if(v[i] == 0)
+				v[i] = def[i];
+		}
+		Capacity_Start(v[0], v[1], v[2], v[3]);
+	}
+	else if(strcmp(args, "stop") == 0)
+	{
+		Capacity_Stop();
+		return;                         //Capacity_End() printed the summary
+	}
+	Capacity_Report();
+}
+
+/*****************************************************************************
+ * @name       :void Capacity_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the running test or the summary of the last one
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Capacity_Report(void)
+{
+	static const char * const sname[] = {"off", "wait", "run", "done"};
+	static const char * const rname[CAPACITY_END_NUM] = {"-", "current", "voltage", "timeout", "stop"};
+	uint32_t mah = Capacity_MahX10(&cur), mwh = Capacity_MwhX10(&cur), s = cur.ms / 1000;
+
+	printf("capacity %s  %lu:%02lu:%02lu  %lu.%lu mAh  %lu.%lu mWh  avg %ld mA\r\n", sname[cur.state & 3],
+	       (unsigned long)(s / 3600), (unsigned long)(s / 60 % 60), (unsigned long)(s % 60),
+	       (unsigned long)(mah / 10), (unsigned long)(mah % 10), (unsigned long)(mwh / 10), (unsigned long)(mwh % 10),
+	       (long)(cur.ms ? cur.q / cur.ms / 1000 : 0));
+	if(cur.state == CAPACITY_STATE_OFF)
+		return;
+	printf("peak %lu mA  min %u mV  end %s  (imin %u mA/%u s  umin %u mV  timeout %u min)  start %lu\r\n",
+	       (unsigned long)(cur.peak_ua / 1000), cur.min_mv == 0xFFFF ? 0 : cur.min_mv,
+	       rname[cur.reason < CAPACITY_END_NUM ? cur.reason : 0], cur.imin_ma, cur.hold_s, cur.umin_mv,
+	       cur.timeout_min, (unsigned long)cur.start);
+}
@@ -0,0 +1,79 @@
+#ifndef __CAPACITY_H
+#define __CAPACITY_H
+#include "main.h"
+#include "sched.h"
+#include "acq.h"
+
+//Capacity test: integrates the autoranged load current and the power drawn
+//from Uin over every acquisition block until the source is done. The test
+//ends when the current stays below imin for hold_s (end of charge / the
+//bank switched off), when Uin stays below umin for CAPACITY_COLLAPSE_MS,
+//on the timeout or on "capacity stop". The hold only starts counting once
+//the current has been above imin, so a test can be started before the load
+//is connected. Time is taken from the tick, so blocks dropped by a burst or
+//a clock switch are still weighted in; longer gaps pause the test.
+//The accumulators are appended to a pair of sectors below the event ring
+//every CAPACITY_CHECKPOINT_MS and on shutdown; at boot a running test
+//resumes from the newest valid record, losing at most one checkpoint
+//period. The final record (state DONE with the reason) is the summary.
+#define CAPACITY_TASK       SCHED_TASK_LOG
+#define CAPACITY_SIG_POLL   7       //checkpoint write, flash busy poll
+
+#define CAPACITY_IMIN_MA    50
+#define CAPACITY_UMIN_MV    4000
+#define CAPACITY_HOLD_S     60
+#define CAPACITY_TIMEOUT_MIN 1440
+#define CAPACITY_COLLAPSE_MS 1000
+#define CAPACITY_GAP_MS     1000    //longer without a block: the test was paused
+#define CAPACITY_CHECKPOINT_MS 60000
+#define CAPACITY_SECTORS    2       //checkpoint sectors below the event ring (cap.h)
+#define CAPACITY_REC_SIZE   64
+#define CAPACITY_POLL_MS    10
+#define CAPACITY_MAGIC      0x31504143  //"CAP1"
+
+#define CAPACITY_STATE_OFF  0
+#define CAPACITY_STATE_WAIT 1       //started, current not above imin yet
+#define CAPACITY_STATE_RUN  2
+#define CAPACITY_STATE_DONE 3
+
+#define CAPACITY_END_NONE   0
+#define CAPACITY_END_CURRENT 1      //below imin for hold_s
+#define CAPACITY_END_VOLTAGE 2      //Uin collapsed
+#define CAPACITY_END_TIMEOUT 3
+#define CAPACITY_END_STOP   4
+#define CAPACITY_END_NUM    5
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t seq;                   //checkpoint number, the highest valid one is current
+	uint32_t start;                 //Unix seconds at the start (0 = clock unknown)
+	uint32_t ms;                    //test time
+	int64_t q;                      //uA x ms
+	int64_t e;                      //uW x ms
+	uint32_t peak_ua;
+	uint16_t imin_ma;
+	uint16_t umin_mv;
+	uint16_t hold_s;
+	uint16_t timeout_min;
+	uint16_t min_mv;                //lowest Uin block while running
+	uint8_t state;                  //CAPACITY_STATE_x
+	uint8_t reason;                 //CAPACITY_END_x
+	uint32_t spare[3];              //pads the record to CAPACITY_REC_SIZE
+	uint32_t crc;                   //CRC-32 (STM32 CRC unit) of everything above
+} capacity_rec_t;
+
+void Capacity_Init(void);
+void Capacity_Start(uint16_t imin_ma, uint16_t umin_mv, uint16_t hold_s, uint16_t timeout_min);
+void Capacity_Stop(void);
+void Capacity_Block(const acq_block_t *b);
+void Capacity_Checkpoint(void);
+void Capacity_Process(uint8_t sig);
+uint8_t Capacity_Pending(void);
+const capacity_rec_t *Capacity_Get(void);
+uint32_t Capacity_MahX10(const capacity_rec_t *r);
+uint32_t Capacity_MwhX10(const capacity_rec_t *r);
+void Capacity_Command(const char *args);
+void Capacity_Report(void);
+
+#endif
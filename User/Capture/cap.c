@@ -0,0 +1,475 @@
+#include "cap.h"
+#include "cal.h"
+#include "capacity.h"
+#include "log.h"
+#include "w25qxx.h"
+#include "timestamp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if CAPACITY_SECTORS + CAP_SECTORS + 1 != LOG_RESERVED_SECTORS
+#error "log ring must leave out the checkpoint, event and calibration sectors"
+#endif
+
+#define CAP_STATE_OFF       0
+#define CAP_STATE_ARMED     1
+#define CAP_STATE_POST      2       //triggered, collecting post-trigger units
+#define CAP_STATE_WAIT      3       //frozen, waiting for the flash
+#define CAP_STATE_ERASE     4
+#define CAP_STATE_PROG      5
+
+#define CAP_FIRST_SECTOR    (w25qxx.SectorCount - 1 - CAP_SECTORS)
+#define CAP_RING_SAMPLES    (CAP_RING * ACQ_CH_NUM)
+
+//a unit is a frame, or a single sample on the fast path
+static union
+{
+	uint16_t frame[CAP_RING][ACQ_CH_NUM];
+	uint16_t sample[CAP_RING_SAMPLES];
+} ring;
+static uint32_t head;               //units written since arming
+static uint32_t start;              //first unit of the frozen window
+static uint16_t filled;             //pre-trigger units available
+static uint16_t left;               //post-trigger units still to collect
+static uint16_t total = CAP_FRAMES; //units in the window
+static uint16_t pre = CAP_PRE_DEFAULT;
+static uint16_t pre_set = CAP_PRE_DEFAULT;  //from Cap_SetPre(), taken at the next arming
+static uint8_t fast;
+static uint8_t fast_set;            //from Cap_SetFast(), taken at the next arming
+static uint8_t ch;                  //trigger channel, the one streamed on the fast path
+static uint16_t lag = 1;            //units in 1 ms, for the slope
+static uint32_t rate = ACQ_RATE_HZ;  //units per second
+static volatile uint8_t manual;     //set by Cap_Trigger()
+static volatile uint8_t state;
+static uint8_t trig;
+static int32_t level;               //in channel units, for the report
+static uint16_t thr;                //level as raw counts
+
+static cap_hdr_t hdr;               //event being written / last written
+static uint8_t stored;              //last event is on the flash
+static uint8_t page_buf[LOG_PAGE_SIZE];
+static uint8_t page;
+static uint8_t pages;
+static uint8_t slot;                //next sector of the event ring
+static uint32_t next_id;
+static uint32_t events;             //valid events on the flash
+static sched_timer_t poll_timer;
+
+static void Cap_Stream(const uint16_t *s, uint16_t n);
+
+/*****************************************************************************
+ * @name       :void Cap_Init(void)
+ * @date       :2026-10-19
+ * @function   :Find the newest event in the flash ring so the next one goes
+                after it. Call after Log_Init() has probed the chip.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Cap_Init(void)
+{
+	uint32_t h[2], best = 0;
+	uint8_t s;
+
+	events = 0;
+	if(w25qxx.SectorCount == 0)
+		return;
+	for(s = 0; s < CAP_SECTORS; s++)
+	{
+		W25qxx_ReadBytesNow((uint8_t *)h, (CAP_FIRST_SECTOR + s) * w25qxx.SectorSize, sizeof(h));
+		if(h[0] != CAP_MAGIC)
+			continue;
+		if(events++ == 0 || h[1] >= best)
+		{
+			best = h[1];
+			slot = (s + 1) % CAP_SECTORS;
+			next_id = h[1] + 1;
+		}
+	}
+}
+
+static uint16_t Cap_Raw(uint8_t c, int32_t v)
+{
+	uint16_t lo = 0, hi = 4095, mid;
+
+	//first count reading at least v, calibration tables are monotonic
+	while(lo < hi)
+	{
+		mid = (lo + hi) >> 1;
+		if(Cal_Apply(c, mid) < v)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static uint16_t *Cap_Unit(uint32_t n)
+{
+	if(fast)
+		return &ring.sample[n & (CAP_RING_SAMPLES - 1)];
+	return ring.frame[n & (CAP_RING - 1)];
+}
+
+//trigger channel in unit n
+static uint16_t Cap_Value(uint32_t n)
+{
+	return fast ? ring.sample[n & (CAP_RING_SAMPLES - 1)] : ring.frame[n & (CAP_RING - 1)][ch];
+}
+
+/*****************************************************************************
+ * @name       :void Cap_Arm(uint8_t t, int32_t lv)
+ * @date       :2026-10-19
+ * @function   :Start filling the ring and wait for the trigger. Arming
+                while an event is being written takes effect afterwards.
+                On the fast path the stream is (re)started here.
+ * @parameters :t:CAP_TRIG_x, CAP_TRIG_OFF stops capturing
+                lv:trigger level in the trigger channel's units
+ * @retvalue   :None
+******************************************************************************/
+void Cap_Arm(uint8_t t, int32_t lv)
+{
+	trig = t;
+	level = lv;
+	if(t == CAP_TRIG_OVER)
+		thr = Cap_Raw(ACQ_CH_I4A, lv);
+	else if(t == CAP_TRIG_SLOPE)
+		thr = Cap_Raw(ACQ_CH_I4A, Cal_Apply(ACQ_CH_I4A, 0) + lv);
+	else if(t == CAP_TRIG_DROP)
+		thr = Cap_Raw(ACQ_CH_UIN, lv);
+	if(state >= CAP_STATE_WAIT)
+		return;
+	Acq_StreamStop();
+	fast = fast_set;
+	pre = pre_set;
+	total = fast ? CAP_SAMPLES : CAP_FRAMES;
+	rate = fast ? Acq_BurstRate() : ACQ_RATE_HZ;
+	lag = rate / ACQ_RATE_HZ;
+	ch = t == CAP_TRIG_DROP ? ACQ_CH_UIN : ACQ_CH_I4A;
+	head = 0;
+	filled = 0;
+	manual = 0;
+	state = t == CAP_TRIG_OFF ? CAP_STATE_OFF : CAP_STATE_ARMED;
+	if(state == CAP_STATE_ARMED && fast && Acq_Stream(ch, Cap_Stream, CAP_TASK, CAP_SIG_POLL) != HAL_OK)
+		Sched_TimerStart(&poll_timer, CAP_TASK, CAP_SIG_POLL, CAP_RETRY_MS, 0);
+}
+
+//a window already frozen keeps the split it was captured with
+void Cap_SetPre(uint16_t n)
+{
+	uint16_t max = fast_set ? CAP_SAMPLES : CAP_FRAMES;
+
+	pre_set = n < max ? n : max - 1;
+	Cap_Arm(trig, level);
+}
+
+//pre keeps its time span across the switch
+void Cap_SetFast(uint8_t on)
+{
+	on = on != 0;
+	if(on != fast_set)
+		pre_set = on ? pre_set * ACQ_CH_NUM : pre_set / ACQ_CH_NUM;
+	fast_set = on;
+	Cap_Arm(trig, level);
+}
+
+void Cap_Trigger(void)
+{
+	manual = 1;
+}
+
+//trigger test on unit n, the one just written
+static uint8_t Cap_Fired(uint32_t n)
+{
+	uint16_t v = Cap_Value(n), p;
+
+	if(trig == CAP_TRIG_OVER)
+		return v >= thr;
+	if(trig == CAP_TRIG_SLOPE)
+	{
+		if(n < lag)
+			return 0;
+		p = Cap_Value(n - lag);
+		return v > p && v - p >= thr;
+	}
+	if(trig == CAP_TRIG_DROP)
+		return v < thr;
+	return 0;
+}
+
+//the unit just written triggered, 'later' units of the block came after it
+static void Cap_Fire(uint16_t later)
+{
+	ts_t ts;
+	uint32_t us = (uint32_t)((uint64_t)later * 1000000 / rate);
+
+	TS_Now(&ts);
+	if(ts.usec < us)                //back to the trigger unit
+	{
+		ts.usec += 1000000;
+		ts.sec--;
+	}
+	hdr.sec = (TS_GetFlags() & TS_FLAG_VALID) ? ts.sec : 0;
+	hdr.us = ts.usec - us;
+	hdr.log_seq = Log_GetSeq();
+	hdr.trig = manual ? CAP_TRIG_KEY : trig;
+	manual = 0;
+	start = head - 1 - pre;
+	left = total - pre;
+	state = CAP_STATE_POST;
+}
+
+/*****************************************************************************
+ * @name       :void Cap_Block(uint16_t (*f)[ACQ_CH_NUM], uint8_t n)
+ * @date       :2026-10-19
+ * @function   :Copy a block of frames into the ring and test the trigger on
+                each one. Called by Acq_Process() with the DMA half that
+                just completed, ignored on the fast path.
+ * @parameters :f:frames
+                n:number of frames
+ * @retvalue   :None
+******************************************************************************/
+void Cap_Block(uint16_t (*f)[ACQ_CH_NUM], uint8_t n)
+{
+	uint8_t i;
+
+	if(fast)
+		return;
+	for(i = 0; i < n; i++)
+	{
+		if(state != CAP_STATE_ARMED && state != CAP_STATE_POST)
+			return;
+		memcpy(ring.frame[head & (CAP_RING - 1)], f[i], sizeof(ring.frame[0]));
+		head++;
+		if(state == CAP_STATE_ARMED)
+		{
+			//the pre-trigger part must be full before a trigger counts
+			if(filled < pre)
+			{
+				filled++;
+				continue;
+			}
+			if(!(Cap_Fired(head - 1) || manual))
+				continue;
+			Cap_Fire(n - 1 - i);
+		}
+		if(--left == 0)
+		{
+			state = CAP_STATE_WAIT;
+			Sched_Signal(CAP_TASK, CAP_SIG_POLL);
+		}
+	}
+}
+
+//the fast path's Cap_Block(), in the DMA interrupt every 0.7 ms
+static void Cap_Stream(const uint16_t *s, uint16_t n)
+{
+	uint16_t i;
+
+	for(i = 0; i < n; i++)
+	{
+		if(state != CAP_STATE_ARMED && state != CAP_STATE_POST)
+			return;
+		ring.sample[head & (CAP_RING_SAMPLES - 1)] = s[i];
+		head++;
+		if(state == CAP_STATE_ARMED)
+		{
+			if(filled < pre)
+			{
+				filled++;
+				continue;
+			}
+			if(!(Cap_Fired(head - 1) || manual))
+				continue;
+			Cap_Fire(n - 1 - i);
+		}
+		if(--left == 0)
+		{
+			state = CAP_STATE_WAIT;
+			Sched_Signal(CAP_TASK, CAP_SIG_POLL);
+		}
+	}
+}
+
+static void Cap_Header(void)
+{
+	uint16_t j, v, *fr;
+
+	hdr.magic = CAP_MAGIC;
+	hdr.id = next_id;
+	hdr.rate_hz = rate;
+	hdr.ch = fast ? ch : CAP_CH_ALL;
+	hdr.pre = pre;
+	hdr.peak = 0;
+	hdr.min = 0xFFFF;
+	for(j = 0; j < total; j++)
+	{
+		fr = Cap_Unit(start + j);
+		v = fast ? fr[0] : fr[ACQ_CH_I4A];
+		if(v > hdr.peak)
+			hdr.peak = v;
+		v = fast ? fr[0] : fr[ACQ_CH_UIN];
+		if(v < hdr.min)
+			hdr.min = v;
+	}
+	stored = 0;
+	page = 0;
+	pages = (sizeof(hdr) + total * (fast ? sizeof(ring.sample[0]) : sizeof(ring.frame[0])) + sizeof(page_buf) - 1) /
+	        sizeof(page_buf);
+}
+
+/*****************************************************************************
+ * @name       :static void Cap_Page(void)
+ * @date       :2026-10-19
+ * @function   :Assemble one flash page of the event (header, then units
+                unrolled from the ring) and start programming it
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Cap_Page(void)
+{
+	uint8_t size = fast ? sizeof(ring.sample[0]) : sizeof(ring.frame[0]);
+	uint16_t j, k = 0;
+
+	if(page == 0)
+	{
+		memcpy(page_buf, &hdr, sizeof(hdr));
+		k = sizeof(hdr);
+	}
+	j = (page * sizeof(page_buf) + k - sizeof(hdr)) / size;
+	for(; k < sizeof(page_buf) && j < total; j++, k += size)
+		memcpy(&page_buf[k], Cap_Unit(start + j), size);
+	W25qxx_WritePageStart(page_buf, W25qxx_SectorToPage(CAP_FIRST_SECTOR + slot) + page, 0, k);
+}
+
+/*****************************************************************************
+ * @name       :static void Cap_Poll(void)
+ * @date       :2026-10-19
+ * @function   :Write the frozen window: erase the event sector, program
+                its pages, then re-arm. Every step waits until the chip is
+                done with the log or calibration. The fast path hands the
+                ADC back to the scan for the write and restarts the stream
+                when Acq_Stop() or a Ripple burst kept it off.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Cap_Poll(void)
+{
+	if(state < CAP_STATE_WAIT)
+	{
+		if(state != CAP_STATE_OFF && fast && !Acq_Streaming())
+			Cap_Arm(trig, level);
+		return;
+	}
+	Acq_StreamStop();
+	if(w25qxx.SectorCount == 0)
+	{
+		state = CAP_STATE_ARMED;        //no flash: keep the window in RAM only
+		Cap_Header();
+		Cap_Arm(trig, level);
+		return;
+	}
+	if(W25qxx_IsBusy())
+	{
+		Sched_TimerStart(&poll_timer, CAP_TASK, CAP_SIG_POLL, state == CAP_STATE_PROG ? 1 : CAP_POLL_MS, 0);
+		return;
+	}
+	switch(state)
+	{
+		case CAP_STATE_WAIT:
+			Cap_Header();
+			W25qxx_EraseSectorStart(CAP_FIRST_SECTOR + slot);
+			state = CAP_STATE_ERASE;
+			Sched_TimerStart(&poll_timer, CAP_TASK, CAP_SIG_POLL, CAP_POLL_MS, 0);
+			return;
+		case CAP_STATE_ERASE:
+			Cap_Page();
+			state = CAP_STATE_PROG;
+			break;
+		default:
+			if(++page < pages)
+			{
+				Cap_Page();
+				break;
+			}
+			stored = 1;
+			if(events < CAP_SECTORS)
+				events++;
+			next_id++;
+			slot = (slot + 1) % CAP_SECTORS;
+			printf("cap: event %lu stored\r\n", (unsigned long)hdr.id);
+			state = CAP_STATE_ARMED;
+			Cap_Arm(trig, level);
+			return;
+	}
+	Sched_TimerStart(&poll_timer, CAP_TASK, CAP_SIG_POLL, 1, 0);
+}
+
+void Cap_Process(uint8_t sig)
+{
+	if(sig == CAP_SIG_POLL)
+		Cap_Poll();
+}
+
+uint8_t Cap_Pending(void)
+{
+	return state >= CAP_STATE_WAIT;
+}
+
+/*****************************************************************************
+ * @name       :void Cap_Command(const char *args)
+ * @date       :2026-10-19
+ * @function   :Console front end: "over|slope <mA>", "drop <mV>", "key",
+                "pre <units>", "fast", "frames", "off", nothing prints the
+                status
+ * @parameters :args:text after the command name
+ * @retvalue   :None
+******************************************************************************/
+void Cap_Command(const char *args)
+{
+	static const char * const name[CAP_TRIG_NUM] = {"off", "over", "slope", "drop", "key"};
+	const char *p = strchr(args, ' ');
+	size_t len = p ? (size_t)(p - args) : strlen(args);
+	uint8_t t;
+
+	if(strncmp(args, "pre ", 4) == 0)
+		Cap_SetPre((uint16_t)strtol(args + 4, NULL, 10));
+	else if(strcmp(args, "fast") == 0 || strcmp(args, "frames") == 0)
+		Cap_SetFast(strcmp(args, "fast") == 0);
+	for(t = 0; t < CAP_TRIG_NUM; t++)
+		if(len && strlen(name[t]) == len && strncmp(args, name[t], len) == 0)
+			Cap_Arm(t, p ? strtol(p + 1, NULL, 10) : 0);
+	Cap_Report();
+}
+
+/*****************************************************************************
+ * @name       :void Cap_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the trigger setup and the last event over stdout
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Cap_Report(void)
+{
+	static const char * const sname[] = {"off", "armed", "post", "wait", "erase", "prog"};
+	static const char * const tname[CAP_TRIG_NUM] = {"off", "over", "slope", "drop", "key"};
+
+	printf("cap %s  trig %s %ld  pre %u post %u  events %lu/%u\r\n", sname[state], tname[trig], (long)level,
+	       pre, total - pre, (unsigned long)events, CAP_SECTORS);
+	if(fast)
+		printf("fast: %s alone at %lu Hz, %lu us window%s, no scan while armed\r\n",
+		       ch == ACQ_CH_UIN ? "Uin" : "I_4A", (unsigned long)rate,
+		       (unsigned long)((uint64_t)total * 1000000 / rate), Acq_Streaming() ? "" : ", stream stopped");
+	else
+		printf("frames: all inputs at %u Hz%s\r\n", ACQ_RATE_HZ, fast_set ? ", fast from the next arming" : "");
+	if(hdr.magic != CAP_MAGIC)
+		return;
+	printf("last #%lu %s  sec %lu.%06lu  log %lu  %lu Hz  ", (unsigned long)hdr.id, tname[hdr.trig],
+	       (unsigned long)hdr.sec, (unsigned long)hdr.us, (unsigned long)hdr.log_seq, (unsigned long)hdr.rate_hz);
+	if(hdr.ch == CAP_CH_ALL)
+		printf("peak %ld mA  min %ld mV", (long)Cal_Apply(ACQ_CH_I4A, hdr.peak), (long)Cal_Apply(ACQ_CH_UIN, hdr.min));
+	else
+		printf("%s %ld..%ld %s", hdr.ch == ACQ_CH_UIN ? "Uin" : "I_4A", (long)Cal_Apply(hdr.ch, hdr.min),
+		       (long)Cal_Apply(hdr.ch, hdr.peak), hdr.ch == ACQ_CH_UIN ? "mV" : "mA");
+	printf("%s\r\n", stored ? "" : "  (not on flash)");
+}
@@ -0,0 +1,69 @@
+#ifndef __CAP_H
+#define __CAP_H
+#include "main.h"
+#include "sched.h"
+#include "acq.h"
+
+//Transient capture. While armed every acquisition frame (all four inputs
+//at ACQ_RATE_HZ) is copied into a RAM ring. When the trigger fires, the
+//ring keeps filling for the post-trigger frames and then freezes with
+//pre + post frames around the trigger; the frozen window is written to one
+//flash sector as an event record and the capture re-arms. The header holds
+//the slow log's record number at the trigger so events can be placed in
+//the log. Trigger levels are given in calibrated units and converted to
+//raw counts when arming, the per-frame test is a plain compare.
+//
+//The fast path (Cap_SetFast) fills the same ring from Acq_Stream() with
+//the trigger channel alone at the full ADC rate, about 176 kHz: the window
+//is CAP_SAMPLES samples, 11.5 ms, and the slope is taken over 1 ms as on
+//the frame path. The ring is filled and the trigger tested in the DMA
+//interrupt. While it is armed the scan is paused, so the slow log, the
+//statistics and the live pages see no new blocks and Ripple cannot run;
+//they resume from the moment the window is frozen until it is written.
+#define CAP_TASK            SCHED_TASK_LOG
+#define CAP_SIG_POLL        5       //event write, flash busy poll, fast path restart
+
+#define CAP_TRIG_OFF        0
+#define CAP_TRIG_OVER       1       //I_4A above the level (mA)
+#define CAP_TRIG_SLOPE      2       //I_4A rise within 1 ms above the level (mA)
+#define CAP_TRIG_DROP       3       //Uin below the level (mV)
+#define CAP_TRIG_KEY        4       //only Cap_Trigger() (key chord)
+#define CAP_TRIG_NUM        5
+
+#define CAP_RING            512     //frames, power of two
+#define CAP_FRAMES          508     //pre + post, one sector with the header
+#define CAP_SAMPLES         (CAP_FRAMES * ACQ_CH_NUM)   //the same on the fast path
+#define CAP_PRE_DEFAULT     128     //frames, x ACQ_CH_NUM samples on the fast path
+#define CAP_SECTORS         16      //event ring below the calibration sector
+#define CAP_POLL_MS         10
+#define CAP_RETRY_MS        100     //fast path: ADC held by a Ripple burst
+#define CAP_CH_ALL          0xFF    //cap_hdr_t.ch of a frame record
+#define CAP_MAGIC           0x32544E45  //"ENT2"
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t id;                    //event number, the highest one is the newest
+	uint32_t sec;                   //trigger time, Unix seconds (0 = clock unknown)
+	uint32_t us;
+	uint32_t log_seq;               //slow log record being collected at the trigger
+	uint32_t rate_hz;               //frames or samples per second
+	uint8_t trig;                   //CAP_TRIG_x that fired, CAP_TRIG_KEY for Cap_Trigger()
+	uint8_t ch;                     //ACQ_CH_x of a sample record, CAP_CH_ALL for frames
+	uint16_t pre;                   //units before the trigger one, the rest is the trigger one and after
+	uint16_t peak;                  //highest I_4A in the window, raw (sample record: of its channel)
+	uint16_t min;                   //lowest Uin in the window, raw (sample record: of its channel)
+} cap_hdr_t;                        //followed by CAP_FRAMES frames of ACQ_CH_NUM raw samples or CAP_SAMPLES samples
+
+void Cap_Init(void);
+void Cap_Arm(uint8_t trig, int32_t level);
+void Cap_SetPre(uint16_t pre);
+void Cap_SetFast(uint8_t on);
+void Cap_Block(uint16_t (*f)[ACQ_CH_NUM], uint8_t n);
+void Cap_Trigger(void);
+void Cap_Process(uint8_t sig);
+uint8_t Cap_Pending(void);
+void Cap_Command(const char *args);
+void Cap_Report(void);
+
+#endif
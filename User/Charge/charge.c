@@ -0,0 +1,179 @@
+#include "charge.h"
+#include "log.h"
+#include <stdio.h>
+
+#define CHARGE_START        0       //first block
+#define CHARGE_SETTLE       1       //following a step
+#define CHARGE_STABLE       2       //on a plateau, CUSUM armed
+
+static const uint16_t charge_nominal[CHARGE_CLS_VAR] = {0, 5000, 9000, 12000, 15000, 20000};
+static const char * const charge_name[CHARGE_CLS_NUM] = {"off", "5V", "9V", "12V", "15V", "20V", "var"};
+
+static uint8_t state, flat, cls;
+static int32_t ref_q4;              //plateau reference, mV x16
+static int32_t gp, gn;              //CUSUM up / down, mV
+static uint32_t gp_zero, gn_zero;   //last block where each sum was zero
+static int32_t prev, sum;
+static int32_t back[CHARGE_BACK];   //recent blocks, by seq
+static charge_step_t step;          //the one being followed
+static charge_step_t hist[CHARGE_HISTORY];
+static uint32_t steps;
+
+uint8_t Charge_Class(int32_t mv)
+{
+	uint8_t c;
+
+	if(mv < CHARGE_OFF_MV)
+		return CHARGE_CLS_OFF;
+	for(c = CHARGE_CLS_5V; c < CHARGE_CLS_VAR; c++)
+		if(mv * CHARGE_TOL_DIV >= charge_nominal[c] * (CHARGE_TOL_DIV - 1) &&
+		   mv * CHARGE_TOL_DIV <= charge_nominal[c] * (CHARGE_TOL_DIV + 1))
+			return c;
+	return CHARGE_CLS_VAR;
+}
+
+//time of a block that ended n blocks before the current one
+static void Charge_Back(ts_t *ts, uint32_t n)
+{
+	uint32_t us = n * CHARGE_BLOCK_MS * 1000;
+
+	TS_Now(ts);
+	ts->sec -= us / 1000000;
+	us %= 1000000;
+	if(ts->usec < us)
+	{
+		ts->sec--;
+		ts->usec += 1000000;
+	}
+	ts->usec -= us;
+}
+
+static uint32_t Charge_SpanMs(const ts_t *a, const ts_t *b)
+{
+	return (b->sec - a->sec) * 1000 + b->usec / 1000 - a->usec / 1000;
+}
+
+//the flat run of sum / (flat + 1) blocks ending at b is the new plateau
+static void Charge_Plateau(const acq_block_t *b)
+{
+	int32_t x = sum / (flat + 1);
+	uint32_t ms;
+	ts_t ts;
+
+	ref_q4 = x * 16;
+	gp = gn = 0;
+	gp_zero = gn_zero = b->seq;
+	state = CHARGE_STABLE;
+	cls = Charge_Class(x);
+	Charge_Back(&ts, flat + 1);
+	Log_Event(LOG_EVT_PLATEAU, &ts, x, cls);
+	ms = Charge_SpanMs(&step.start, &ts);
+	step.to_mv = x;
+	step.settle_ms = (int32_t)ms < 0 ? 0 : ms > 0xFFFF ? 0xFFFF : ms;
+	step.cls = cls;
+	hist[steps++ % CHARGE_HISTORY] = step;
+}
+
+/*****************************************************************************
+ * @name       :void Charge_Block(const acq_block_t *b)
+ * @date       :2026-10-19
+ * @function   :Feed one calibrated block. Called by Acq_Process() after
+                Cal_Block().
+ * @parameters :b:block
+ * @retvalue   :None
+******************************************************************************/
+void Charge_Block(const acq_block_t *b)
+{
+	int32_t x = b->val[ACQ_CH_UIN] > 0 ? b->val[ACQ_CH_UIN] : 0, d, v;
+	uint32_t start, i;
+
+	back[b->seq & (CHARGE_BACK - 1)] = x;
+	if(state == CHARGE_START)
+	{
+		TS_Now(&step.start);        //the first plateau counts as a step from 0 V
+		prev = sum = x;
+		state = CHARGE_SETTLE;
+		return;
+	}
+	if(state == CHARGE_SETTLE)
+	{
+		d = x - prev;
+		prev = x;
+		if(d > CHARGE_SETTLE_MV || d < -CHARGE_SETTLE_MV)
+		{
+			flat = 0;
+			sum = x;
+		}
+		else
+		{
+			sum += x;
+			if(++flat >= CHARGE_SETTLE_BLOCKS)
+				Charge_Plateau(b);
+		}
+		return;
+	}
+
+	d = x - (ref_q4 >> 4);
+	gp += d - CHARGE_K_MV;
+	if(gp <= 0)
+	{
+		gp = 0;
+		gp_zero = b->seq;
+	}
+	gn += -d - CHARGE_K_MV;
+	if(gn <= 0)
+	{
+		gn = 0;
+		gn_zero = b->seq;
+	}
+	if(gp > CHARGE_H_MV || gn > CHARGE_H_MV)
+	{
+		start = gp > CHARGE_H_MV ? gp_zero : gn_zero;
+		Charge_Back(&step.start, b->seq - start);
+		step.from_mv = ref_q4 >> 4;
+		Log_Event(LOG_EVT_VSTEP, &step.start, step.from_mv, x);
+		state = CHARGE_SETTLE;
+		//a small step is already flat by the time the sum crosses H:
+		//count the flat blocks since the step from the history
+		flat = 0;
+		prev = sum = x;
+		for(i = 1; i < b->seq - start && i < CHARGE_BACK; i++)
+		{
+			v = back[(b->seq - i) & (CHARGE_BACK - 1)];
+			if(v - prev > CHARGE_SETTLE_MV || prev - v > CHARGE_SETTLE_MV)
+				break;
+			prev = v;
+			sum += v;
+			flat++;
+		}
+		prev = x;
+		if(flat >= CHARGE_SETTLE_BLOCKS)
+			Charge_Plateau(b);
+	}
+	else if(gp < CHARGE_H_MV / 2 && gn < CHARGE_H_MV / 2)
+		ref_q4 += x - (ref_q4 >> 4);    //follow slow drift, 1/16 per block
+}
+
+/*****************************************************************************
+ * @name       :void Charge_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the current plateau and the last steps over stdout
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Charge_Report(void)
+{
+	const charge_step_t *s;
+	uint32_t i;
+
+	if(state == CHARGE_STABLE)
+		printf("uin %ld mV %s  steps %lu\r\n", (long)(ref_q4 >> 4), charge_name[cls], (unsigned long)steps);
+	else
+		printf("uin %ld mV settling  steps %lu\r\n", (long)prev, (unsigned long)steps);
+	for(i = steps > CHARGE_HISTORY ? steps - CHARGE_HISTORY : 0; i < steps; i++)
+	{
+		s = &hist[i % CHARGE_HISTORY];
+		printf("%lu.%03lu  %u -> %u mV %s  in %u ms\r\n", (unsigned long)s->start.sec,
+		       (unsigned long)(s->start.usec / 1000), s->from_mv, s->to_mv, charge_name[s->cls], s->settle_ms);
+	}
+}
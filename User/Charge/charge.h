@@ -0,0 +1,48 @@
+#ifndef __CHARGE_H
+#define __CHARGE_H
+#include "main.h"
+#include "acq.h"
+#include "timestamp.h"
+
+//Fast-charge negotiation tracking on the calibrated Uin block averages.
+//A two-sided CUSUM against the current plateau detects a step within a few
+//blocks of its start (20 mV PPS steps included) and locates it at the last
+//block where the sum was zero. The input is then followed until it stays
+//flat for CHARGE_SETTLE_BLOCKS (counted from the step start for small steps
+//that settled before the detection); the new plateau is classified against
+//the fixed USB levels. Step start and new plateau go to the log as events
+//(LOG_EVT_VSTEP, LOG_EVT_PLATEAU), so a negotiation's duration is the
+//distance between the two. Cost per block: a few adds and compares.
+#define CHARGE_K_MV         10      //CUSUM allowance per block, ~3x the block noise
+#define CHARGE_H_MV         60      //CUSUM decision level
+#define CHARGE_SETTLE_MV    15      //block-to-block change that still counts as flat
+#define CHARGE_SETTLE_BLOCKS 4      //flat blocks to confirm a plateau (~130 ms)
+#define CHARGE_OFF_MV       2500    //below: no supply
+#define CHARGE_TOL_DIV      20      //fixed levels +-5 %
+#define CHARGE_HISTORY      4
+#define CHARGE_BACK         16      //blocks kept to date the start of a plateau, power of two
+#define CHARGE_BLOCK_MS     (ACQ_BLOCK * 1000 / ACQ_RATE_HZ)
+
+#define CHARGE_CLS_OFF      0
+#define CHARGE_CLS_5V       1
+#define CHARGE_CLS_9V       2
+#define CHARGE_CLS_12V      3
+#define CHARGE_CLS_15V      4
+#define CHARGE_CLS_20V      5
+#define CHARGE_CLS_VAR      6       //between the fixed levels: PPS / QC3 steps
+#define CHARGE_CLS_NUM      7
+
+typedef struct
+{
+	ts_t start;                     //step start
+	uint16_t from_mv;
+	uint16_t to_mv;
+	uint16_t settle_ms;             //step start to flat
+	uint8_t cls;                    //CHARGE_CLS_x of the new plateau
+} charge_step_t;
+
+void Charge_Block(const acq_block_t *b);
+uint8_t Charge_Class(int32_t mv);
+void Charge_Report(void);
+
+#endif
@@ -0,0 +1,252 @@
+#include "clock.h"
+#include "adc.h"
+#include "i2c.h"
+#include "spi.h"
+#include "tim.h"
+#include "usart.h"
+#include "lpm.h"
+#include "backlight.h"
+#include <stdio.h>
+
+typedef struct
+{
+	const char *name;
+	uint32_t pll_mul;               //RCC_PLL_MULx, 0 = SYSCLK from HSI
+	uint32_t apb1_div;              //PCLK1 must stay <= 36 MHz
+	uint32_t adc_div;
+	uint32_t latency;
+	uint32_t ua_run;                //STM32F103 datasheet, peripherals enabled
+	uint32_t ua_sleep;
+} clock_profile_t;
+
+static const clock_profile_t profiles[CLOCK_NUM] =
+{
+	{"idle",  0,              RCC_HCLK_DIV1, RCC_ADCPCLK2_DIV2, FLASH_LATENCY_0,  5500,  2100},
+	{"log",   RCC_PLL_MUL3,   RCC_HCLK_DIV1, RCC_ADCPCLK2_DIV2, FLASH_LATENCY_0, 12900,  5300},
+	{"full",  RCC_PLL_MUL9,   RCC_HCLK_DIV2, RCC_ADCPCLK2_DIV6, FLASH_LATENCY_2, 36000, 14400},
+};
+
+static uint8_t cur = CLOCK_FULL;        //SystemClock_Config() leaves the core at 72 MHz
+static uint8_t req[CLOCK_USER_NUM];
+static uint8_t forced = CLOCK_AUTO;
+static uint32_t switches;
+static sched_timer_t retry_timer;
+
+/*****************************************************************************
+ * @name       :static HAL_StatusTypeDef Clock_Oscillators(const clock_profile_t *p)
+ * @date       :2026-10-19
+ * @function   :Set up SYSCLK and the bus dividers for a profile. Runs from
+                HSI while the PLL is reprogrammed, HSE and PLL are left off
+                when the profile does not use them.
+ * @parameters :p:profile
+ * @retvalue   :HAL status, on error the core stays on HSI
+******************************************************************************/
+static HAL_StatusTypeDef Clock_Oscillators(const clock_profile_t *p)
+{
+	RCC_OscInitTypeDef osc = {0};
+	RCC_ClkInitTypeDef clk = {0};
+
+	clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+	clk.AHBCLKDivider = RCC_SYSCLK_DIV1;
+	clk.APB1CLKDivider = RCC_HCLK_DIV1;
+	clk.APB2CLKDivider = RCC_HCLK_DIV1;
+	if(__HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_HSI &&
+	   HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_0) != HAL_OK)
+		return HAL_ERROR;
+
+	osc.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+	osc.PLL.PLLState = RCC_PLL_OFF;
+	if(HAL_RCC_OscConfig(&osc) != HAL_OK)
+		return HAL_ERROR;
+	osc.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+	if(p->pll_mul == 0)
+	{
+		osc.HSEState = RCC_HSE_OFF;
+		if(HAL_RCC_OscConfig(&osc) != HAL_OK)
+			return HAL_ERROR;
+		return HAL_RCC_ClockConfig(&clk, p->latency);
+	}
+	osc.HSEState = RCC_HSE_ON;
+	osc.HSEPredivValue = RCC_HSE_PREDIV_DIV1;
+	osc.PLL.PLLState = RCC_PLL_ON;
+	osc.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+	osc.PLL.PLLMUL = p->pll_mul;
+	if(HAL_RCC_OscConfig(&osc) != HAL_OK)
+		return HAL_ERROR;
+	clk.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+	clk.APB1CLKDivider = p->apb1_div;
+	return HAL_RCC_ClockConfig(&clk, p->latency);
+}
+
+static uint32_t Clock_SpiPrescaler(uint32_t pclk)
+{
+	uint32_t br = 0;
+
+	while(br < 7 && (pclk >> (br + 1)) > CLOCK_SPI_MAX_HZ)
+		br++;
+	return br << SPI_CR1_BR_Pos;
+}
+
+/*****************************************************************************
+ * @name       :static void Clock_Peripherals(const clock_profile_t *p)
+ * @date       :2026-10-19
+ * @function   :Recompute every prescaler derived from the bus clocks so
+                sample rate, SPI speed, baud rate, I2C timing and the
+                backlight PWM rate hold
+ * @parameters :p:profile now running
+ * @retvalue   :None
+******************************************************************************/
+static void Clock_Peripherals(const clock_profile_t *p)
+{
+	RCC_PeriphCLKInitTypeDef adc = {0};
+	uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+	uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+	uint32_t timclk = p->apb1_div == RCC_HCLK_DIV1 ? pclk1 : 2 * pclk1;
+
+	//TIM3: load the new prescaler at once, the period in progress restarts
+	//and gives one early sample instead of a whole period at the old rate
+	htim3.Init.Prescaler = timclk / CLOCK_TIM_HZ - 1;
+	__HAL_TIM_SET_PRESCALER(&htim3, htim3.Init.Prescaler);
+	htim3.Instance->EGR = TIM_EGR_UG;
+
+	adc.PeriphClockSelection = RCC_PERIPHCLK_ADC;
+	adc.AdcClockSelection = p->adc_div;
+	HAL_RCCEx_PeriphCLKConfig(&adc);
+
+	__HAL_SPI_DISABLE(&hspi1);          //re-enabled by the next HAL transfer
+	hspi1.Init.BaudRatePrescaler = Clock_SpiPrescaler(pclk2);
+	MODIFY_REG(hspi1.Instance->CR1, SPI_CR1_BR, hspi1.Init.BaudRatePrescaler);
+	__HAL_SPI_DISABLE(&hspi2);
+	hspi2.Init.BaudRatePrescaler = Clock_SpiPrescaler(pclk1);
+	MODIFY_REG(hspi2.Instance->CR1, SPI_CR1_BR, hspi2.Init.BaudRatePrescaler);
+
+	huart1.Instance->BRR = UART_BRR_SAMPLING16(pclk2, huart1.Init.BaudRate);
+
+	HAL_I2C_Init(&hi2c1);               //FREQ, CCR and TRISE follow PCLK1
+
+	Backlight_Clock();                  //TIM2 backlight PWM
+}
+
+/*****************************************************************************
+ * @name       :static void Clock_Update(void)
+ * @date       :2026-10-19
+ * @function   :Switch to the profile asked for, or retry shortly when a
+                transfer that depends on the current bus clocks is running
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Clock_Update(void)
+{
+	uint8_t want = CLOCK_IDLE, i;
+
+	if(forced != CLOCK_AUTO)
+		want = forced;
+	else
+		for(i = 0; i < CLOCK_USER_NUM; i++)
+			if(req[i] > want)
+				want = req[i];
+	if(want == cur)
+		return;
+	if(LPM_Locks() & (LPM_LOCK_I2C | LPM_LOCK_UART | LPM_LOCK_LCD))
+	{
+		Sched_TimerStart(&retry_timer, CLOCK_TASK, CLOCK_SIG_RETRY, CLOCK_RETRY_MS, 0);
+		return;
+	}
+	if(Clock_Oscillators(&profiles[want]) != HAL_OK)
+	{
+		//stuck on HSI (e.g. HSE did not start): run the idle profile
+		want = CLOCK_IDLE;
+		Clock_Oscillators(&profiles[want]);
+	}
+	cur = want;
+	switches++;
+	Clock_Peripherals(&profiles[cur]);
+}
+
+void Clock_Init(void)
+{
+	uint8_t i;
+
+	for(i = 0; i < CLOCK_USER_NUM; i++)
+		req[i] = CLOCK_IDLE;
+	req[CLOCK_USER_BOOT] = CLOCK_FULL;
+	cur = CLOCK_FULL;
+}
+
+/*****************************************************************************
+ * @name       :void Clock_Require(uint8_t user, uint8_t profile)
+ * @date       :2026-10-19
+ * @function   :State the slowest profile a user can live with. Task context
+                only, the switch runs before the call returns unless a
+                transfer is in flight.
+ * @parameters :user:CLOCK_USER_x
+                profile:CLOCK_IDLE when the user needs nothing
+ * @retvalue   :None
+******************************************************************************/
+void Clock_Require(uint8_t user, uint8_t profile)
+{
+	req[user] = profile;
+	Clock_Update();
+}
+
+void Clock_Force(uint8_t profile)
+{
+	forced = profile;
+	Clock_Update();
+}
+
+void Clock_Process(uint8_t sig)
+{
+	if(sig == CLOCK_SIG_RETRY)
+		Clock_Update();
+}
+
+/*****************************************************************************
+ * @name       :void Clock_Restore(void)
+ * @date       :2026-10-19
+ * @function   :Bring the oscillators back after Stop mode (which leaves the
+                core on HSI). The bus dividers are the same as before, the
+                peripherals need no update.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Clock_Restore(void)
+{
+	Clock_Oscillators(&profiles[cur]);
+}
+
+uint8_t Clock_GetProfile(void)
+{
+	return cur;
+}
+
+uint32_t Clock_GetUa(uint8_t sleep)
+{
+	return sleep ? profiles[cur].ua_sleep : profiles[cur].ua_run;
+}
+
+/*****************************************************************************
+ * @name       :void Clock_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the running profile, the resulting peripheral clocks
+                and the estimated MCU current over stdout
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Clock_Report(void)
+{
+	uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+	uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+	uint32_t adc = HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_ADC);
+
+	printf("clock %s%s  sys %lu MHz  pclk1 %lu  pclk2 %lu  adc %lu kHz\r\n", profiles[cur].name,
+	       forced == CLOCK_AUTO ? "" : " (forced)", (unsigned long)(SystemCoreClock / 1000000),
+	       (unsigned long)(pclk1 / 1000000), (unsigned long)(pclk2 / 1000000), (unsigned long)(adc / 1000));
+	printf("spi1 %lu kHz  spi2 %lu kHz  uart %lu Bd  i2c %lu Hz\r\n",
+	       (unsigned long)((pclk2 >> (((hspi1.Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos) + 1)) / 1000),
+	       (unsigned long)((pclk1 >> (((hspi2.Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos) + 1)) / 1000),
+	       (unsigned long)(pclk2 / huart1.Instance->BRR), (unsigned long)hi2c1.Init.ClockSpeed);
+	printf("est. MCU current run %lu uA  sleep %lu uA  switches %lu\r\n", (unsigned long)profiles[cur].ua_run,
+	       (unsigned long)profiles[cur].ua_sleep, (unsigned long)switches);
+}
@@ -0,0 +1,42 @@
+#ifndef __CLOCK_H
+#define __CLOCK_H
+#include "main.h"
+#include "sched.h"
+
+//Clock profiles. Every user states the profile it needs, the fastest one
+//wins. A switch steps SYSCLK down to HSI, reprograms HSE/PLL and the bus
+//dividers, then recomputes everything derived from the bus clocks: TIM3
+//(ADC trigger), ADC prescaler, SPI1 (panel), SPI2 (flash), USART1 baud,
+//I2C1 timing and the TIM2 backlight PWM. The switch is postponed while an
+//I2C transfer, console DMA or panel strip DMA is running.
+#define CLOCK_IDLE          0       //HSI 8 MHz, HSE and PLL off
+#define CLOCK_LOG           1       //HSE x3 = 24 MHz, steady sampling and logging
+#define CLOCK_FULL          2       //HSE x9 = 72 MHz, redraw and bulk transfers
+#define CLOCK_NUM           3
+#define CLOCK_AUTO          0xFF    //Clock_Force(): back to the requests
+
+#define CLOCK_USER_BOOT     0
+#define CLOCK_USER_ACQ      1
+#define CLOCK_USER_UI       2
+#define CLOCK_USER_RIPPLE   3
+#define CLOCK_USER_PAGE     4       //a live page is up, held until it is left
+#define CLOCK_USER_NUM      5
+
+#define CLOCK_TASK          SCHED_TASK_POWER
+#define CLOCK_SIG_RETRY     3
+#define CLOCK_RETRY_MS      2
+
+#define CLOCK_SPI_MAX_HZ    18000000    //SPI1/SPI2 limit on the F103
+#define CLOCK_ADC_MAX_HZ    14000000
+#define CLOCK_TIM_HZ        1000000     //TIM3 counter rate, ARR sets the sample rate
+
+void Clock_Init(void);
+void Clock_Require(uint8_t user, uint8_t profile);
+void Clock_Force(uint8_t profile);
+void Clock_Process(uint8_t sig);
+void Clock_Restore(void);
+uint8_t Clock_GetProfile(void);
+uint32_t Clock_GetUa(uint8_t sleep);
+void Clock_Report(void);
+
+#endif
@@ -0,0 +1,248 @@
+#include "console.h"
+#include "lpm.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+	const char *name;
+	console_cmd_fn fn;
+	const char *help;
+} console_cmd_t;
+
+static char tx_buf[CONSOLE_TX_SIZE];
+static volatile uint16_t tx_head;       //written by Console_Write
+static volatile uint16_t tx_tail;       //advanced when a DMA chunk completes
+static volatile uint16_t tx_chunk;      //length of the chunk on DMA, 0 = idle
+static uint32_t tx_dropped;
+
+static char rx_line[CONSOLE_LINE_MAX];
+static uint8_t rx_len;
+static volatile uint8_t rx_ready;       //rx_line holds a full line for the task
+
+static console_cmd_t cmds[CONSOLE_CMD_MAX];
+static uint8_t cmd_num;
+
+static void Console_TxDma(DMA_HandleTypeDef *hdma);
+static void Console_TxError(DMA_HandleTypeDef *hdma);
+
+/*****************************************************************************
+ * @name       :static void Console_Kick(void)
+ * @date       :2026-10-19
+ * @function   :Start DMA on the next contiguous run of queued text.
+                Called with IRQs masked or from the UART/DMA interrupt.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Console_Kick(void)
+{
+	DMA_HandleTypeDef *dma = CONSOLE_UART.hdmatx;
+	uint16_t head = tx_head;
+	uint16_t len;
+
+	if(tx_chunk)
+		return;
+	if(head == tx_tail)
+	{
+		LPM_Unlock(LPM_LOCK_UART);
+		return;
+	}
+	if(head > tx_tail)
+		len = head - tx_tail;
+	else
+		len = CONSOLE_TX_SIZE - tx_tail;    //up to the end, the rest follows
+	tx_chunk = len;
+	LPM_Lock(LPM_LOCK_UART);
+	dma->XferCpltCallback = Console_TxDma;
+	dma->XferHalfCpltCallback = NULL;
+	dma->XferErrorCallback = Console_TxError;
+	if(HAL_DMA_Start_IT(dma, (uint32_t)&tx_buf[tx_tail], (uint32_t)&CONSOLE_UART.Instance->DR, len) != HAL_OK)
+	{
+		tx_chunk = 0;
+		LPM_Unlock(LPM_LOCK_UART);
+		return;
+	}
+	__HAL_UART_CLEAR_FLAG(&CONSOLE_UART, UART_FLAG_TC);
+	SET_BIT(CONSOLE_UART.Instance->CR3, USART_CR3_DMAT);
+}
+
+static void Console_TxDone(void)
+{
+	tx_tail = (tx_tail + tx_chunk) & (CONSOLE_TX_SIZE - 1);
+	tx_chunk = 0;
+	Console_Kick();
+}
+
+//the chunk is in the UART, it is out with the last stop bit, on TC
+static void Console_TxDma(DMA_HandleTypeDef *hdma)
+{
+	CLEAR_BIT(CONSOLE_UART.Instance->CR3, USART_CR3_DMAT);
+	SET_BIT(CONSOLE_UART.Instance->CR1, USART_CR1_TCIE);
+}
+
+//a DMA error ends the transmission: drop the chunk in flight and go on
+static void Console_TxError(DMA_HandleTypeDef *hdma)
+{
+	CLEAR_BIT(CONSOLE_UART.Instance->CR3, USART_CR3_DMAT);
+	Console_TxDone();
+}
+
+/*****************************************************************************
+ * @name       :uint16_t Console_Write(const char *s, uint16_t len)
+ * @date       :2026-10-19
+ * @function   :Queue text for transmission, never waits for the UART
+ * @parameters :s:text
+                len:number of bytes
+ * @retvalue   :number of bytes queued
+******************************************************************************/
+uint16_t Console_Write(const char *s, uint16_t len)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint16_t n = 0;
+	uint16_t head;
+
+	__disable_irq();
+	head = tx_head;
+	while(n < len && ((head + 1) & (CONSOLE_TX_SIZE - 1)) != tx_tail)
+	{
+		tx_buf[head] = s[n++];
+		head = (head + 1) & (CONSOLE_TX_SIZE - 1);
+	}
+	tx_head = head;
+	tx_dropped += len - n;
+	Console_Kick();
+	__set_PRIMASK(primask);
+	return n;
+}
+
+uint8_t Console_TxIdle(void)
+{
+	return tx_chunk == 0 && tx_head == tx_tail;
+}
+
+//MicroLIB printf() backend
+int fputc(int ch, FILE *f)
+{
+	char c = ch;
+
+	Console_Write(&c, 1);
+	return ch;
+}
+
+HAL_StatusTypeDef Console_Register(const char *name, console_cmd_fn fn, const char *help)
+{
+	if(cmd_num >= CONSOLE_CMD_MAX)
+		return HAL_ERROR;
+	cmds[cmd_num].name = name;
+	cmds[cmd_num].fn = fn;
+	cmds[cmd_num].help = help;
+	cmd_num++;
+	return HAL_OK;
+}
+
+static void Console_Help(const char *args)
+{
+	uint8_t i;
+
+	for(i = 0; i < cmd_num; i++)
+		printf("%-8s %s\r\n", cmds[i].name, cmds[i].help);
+	if(tx_dropped)
+		printf("tx dropped %lu\r\n", (unsigned long)tx_dropped);
+}
+
+/*****************************************************************************
+ * @name       :void Console_Init(void)
+ * @date       :2026-10-19
+ * @function   :Register the built-in commands and start reception
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Console_Init(void)
+{
+	tx_head = tx_tail = tx_chunk = 0;
+	rx_len = 0;
+	rx_ready = 0;
+	Console_Register("help", Console_Help, "list commands");
+	SET_BIT(CONSOLE_UART.Instance->CR1, USART_CR1_RXNEIE);
+}
+
+/*****************************************************************************
+ * @name       :void Console_Process(void)
+ * @date       :2026-10-19
+ * @function   :Execute a received command line, call from CONSOLE_TASK on
+                CONSOLE_SIG_LINE. The first word selects the command, the
+                rest of the line is passed to it.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Console_Process(void)
+{
+	char *args;
+	uint8_t i;
+
+	if(!rx_ready)
+		return;
+	args = strchr(rx_line, ' ');
+	if(args)
+		*args++ = '\0';
+	else
+		args = rx_line + strlen(rx_line);
+	for(i = 0; i < cmd_num; i++)
+	{
+		if(strcmp(rx_line, cmds[i].name) == 0)
+		{
+			cmds[i].fn(args);
+			break;
+		}
+	}
+	if(i == cmd_num)
+		printf("? %s\r\n", rx_line);
+	rx_len = 0;
+	rx_ready = 0;
+}
+
+static void Console_Rx(char c)
+{
+	if(rx_ready)        //bytes arriving while a line is pending are dropped
+		return;
+	if(c == '\r' || c == '\n')
+	{
+		if(rx_len)
+		{
+			rx_line[rx_len] = '\0';
+			rx_ready = 1;
+			Sched_Signal(CONSOLE_TASK, CONSOLE_SIG_LINE);
+		}
+	}
+	else if(c == '\b' || c == 0x7F)
+	{
+		if(rx_len)
+			rx_len--;
+	}
+	else if(rx_len < CONSOLE_LINE_MAX - 1)
+		rx_line[rx_len++] = c;
+}
+
+/*****************************************************************************
+ * @name       :void Console_IRQHandler(void)
+ * @date       :2026-10-19
+ * @function   :USART interrupt, on the registers: the HAL UART interrupt
+                and DMA paths are 1 KB of flash for one byte in and the
+                end of a DMA chunk out. Reading DR also clears an overrun,
+                the bytes lost with it are not noticed.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Console_IRQHandler(void)
+{
+	USART_TypeDef *u = CONSOLE_UART.Instance;
+	uint32_t sr = u->SR;
+
+	if(sr & USART_SR_RXNE)
+		Console_Rx(u->DR);
+	if(sr & USART_SR_TC && u->CR1 & USART_CR1_TCIE)
+	{
+		CLEAR_BIT(u->CR1, USART_CR1_TCIE);
+		Console_TxDone();
+	}
+}
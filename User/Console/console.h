@@ -0,0 +1,27 @@
+#ifndef __CONSOLE_H
+#define __CONSOLE_H
+#include "main.h"
+#include "usart.h"
+#include "sched.h"
+
+//Text console on USART1 (Bluetooth module). printf() output is queued in a
+//ring buffer and drained by DMA, it never blocks: text that does not fit is
+//dropped and counted. Received lines are handed to the telemetry task and
+//matched against the registered command table.
+#define CONSOLE_UART         huart1
+#define CONSOLE_TASK         SCHED_TASK_TELEM
+#define CONSOLE_SIG_LINE     0
+#define CONSOLE_TX_SIZE      512      //power of two
+#define CONSOLE_LINE_MAX     32
+#define CONSOLE_CMD_MAX      16
+
+typedef void (*console_cmd_fn)(const char *args);
+
+void Console_Init(void);
+void Console_IRQHandler(void);
+uint16_t Console_Write(const char *s, uint16_t len);
+HAL_StatusTypeDef Console_Register(const char *name, console_cmd_fn fn, const char *help);
+void Console_Process(void);
+uint8_t Console_TxIdle(void);
+
+#endif
@@ -0,0 +1,308 @@
+#include "i2c_bus.h"
+#include "timestamp.h"
+#include "lpm.h"
+
+i2c_bus_stats_t i2c_bus_stats;
+
+static i2c_xfer_t *q_head, *q_tail;     //pending, q_head is on the bus while bus_busy
+static i2c_xfer_t *d_head, *d_tail;     //finished, waiting for I2C_Bus_Process()
+static volatile uint8_t bus_busy;
+static volatile uint8_t bus_fault;      //BERR/ARLO/stuck BUSY: recover before next start
+static uint32_t bus_start_ms;
+
+static void I2C_Bus_Delay(void)
+{
+	volatile uint32_t i = 40;           //~5 us at 72 MHz, recovery clocks at ~100 kHz
+
+	while(i--);
+}
+
+/*****************************************************************************
+ * @name       :static void I2C_Bus_Complete(uint8_t status, uint32_t error)
+ * @date       :2026-10-19
+ * @function   :Retire the transfer on the bus into the completed list.
+                Called from the I2C/DMA interrupts or with IRQs masked.
+ * @parameters :status:I2C_XFER_DONE or I2C_XFER_ERROR
+                error:HAL_I2C_ERROR_xxx
+ * @retvalue   :None
+******************************************************************************/
+static void I2C_Bus_Complete(uint8_t status, uint32_t error)
+{
+	i2c_xfer_t *x = q_head;
+
+	bus_busy = 0;
+	if(x == NULL)
+		return;
+	q_head = x->next;
+	if(q_head == NULL)
+		q_tail = NULL;
+	x->next = NULL;
+	x->error = error;
+	x->status = status;
+	x->cb_pending = 1;
+	if(d_tail)
+		d_tail->next = x;
+	else
+		d_head = x;
+	d_tail = x;
+	Sched_Signal(I2C_BUS_TASK, I2C_BUS_SIG);
+	if(status == I2C_XFER_DONE)
+		i2c_bus_stats.done++;
+	else
+		i2c_bus_stats.errors++;
+}
+
+/*****************************************************************************
+ * @name       :static void I2C_Bus_Kick(void)
+ * @date       :2026-10-19
+ * @function   :Put the queue head on the bus if the bus is free. Reads of two
+                bytes or more use DMA, the rest is interrupt driven.
+                Called from the I2C/DMA interrupts or with IRQs masked.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void I2C_Bus_Kick(void)
+{
+	i2c_xfer_t *x;
+	HAL_StatusTypeDef st;
+
+	while(!bus_busy && !bus_fault && (x = q_head) != NULL)
+	{
+		x->status = I2C_XFER_BUSY;
+		x->t_start = TS_LocalUs();
+		bus_busy = 1;
+		bus_start_ms = HAL_GetTick();
+		if(x->dir == I2C_XFER_READ)
+		{
+			if(x->len >= I2C_BUS_DMA_MIN)
+				st = HAL_I2C_Mem_Read_DMA(&I2C_BUS, x->dev, x->reg, I2C_MEMADD_SIZE_8BIT, x->buf, x->len);
+			else
+				st = HAL_I2C_Mem_Read_IT(&I2C_BUS, x->dev, x->reg, I2C_MEMADD_SIZE_8BIT, x->buf, x->len);
+		}
+		else
+			st = HAL_I2C_Mem_Write_IT(&I2C_BUS, x->dev, x->reg, I2C_MEMADD_SIZE_8BIT, x->buf, x->len);
+		if(st != HAL_OK)
+		{
+			if(st == HAL_BUSY)
+				bus_fault = 1;          //BUSY flag stuck, F1 errata 2.13.7
+			I2C_Bus_Complete(I2C_XFER_ERROR, I2C_BUS.ErrorCode);
+		}
+	}
+	if(bus_busy)
+		LPM_Lock(LPM_LOCK_I2C);
+	else
+		LPM_Unlock(LPM_LOCK_I2C);
+}
+
+/*****************************************************************************
+ * @name       :void I2C_Bus_Setup(i2c_xfer_t *x, uint8_t dev, uint8_t dir, uint8_t reg,
+                                   uint8_t *buf, uint8_t len, i2c_done_cb done)
+ * @date       :2026-10-19
+ * @function   :Fill in a transfer descriptor
+ * @parameters :x:descriptor, must stay valid until its callback has run
+                dev:8-bit device address
+                dir:I2C_XFER_READ or I2C_XFER_WRITE
+                reg:register address
+                buf,len:data buffer
+                done:completion callback, NULL for fire-and-forget
+ * @retvalue   :None
+******************************************************************************/
+void I2C_Bus_Setup(i2c_xfer_t *x, uint8_t dev, uint8_t dir, uint8_t reg,
+                   uint8_t *buf, uint8_t len, i2c_done_cb done)
+{
+	x->dev = dev;
+	x->dir = dir;
+	x->reg = reg;
+	x->buf = buf;
+	x->len = len;
+	x->done = done;
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef I2C_Bus_Submit(i2c_xfer_t *x)
+ * @date       :2026-10-19
+ * @function   :Queue a transfer, never blocks
+ * @parameters :x:descriptor prepared with I2C_Bus_Setup()
+ * @retvalue   :HAL_BUSY if the descriptor is still queued or its callback
+                has not run yet, HAL_OK otherwise
+******************************************************************************/
+HAL_StatusTypeDef I2C_Bus_Submit(i2c_xfer_t *x)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if(I2C_Bus_InFlight(x))
+	{
+		__set_PRIMASK(primask);
+		return HAL_BUSY;
+	}
+	x->status = I2C_XFER_QUEUED;
+	x->error = 0;
+	x->next = NULL;
+	if(q_tail)
+		q_tail->next = x;
+	else
+		q_head = x;
+	q_tail = x;
+	I2C_Bus_Kick();
+	__set_PRIMASK(primask);
+	Sched_Signal(I2C_BUS_TASK, I2C_BUS_SIG);    //arms the transfer watchdog
+	return HAL_OK;
+}
+
+uint8_t I2C_Bus_InFlight(const i2c_xfer_t *x)
+{
+	return x->status == I2C_XFER_QUEUED || x->status == I2C_XFER_BUSY || x->cb_pending;
+}
+
+uint8_t I2C_Bus_Idle(void)
+{
+	return !bus_busy && q_head == NULL && d_head == NULL;
+}
+
+/*****************************************************************************
+ * @name       :void I2C_Bus_Recover(void)
+ * @date       :2026-10-19
+ * @function   :Bus recovery: clock out a slave stuck holding SDA, send STOP,
+                then software-reset the peripheral to clear a stuck BUSY flag
+                (STM32F10xx8/B errata 2.13.7) and re-initialise it
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void I2C_Bus_Recover(void)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	uint32_t primask;
+	uint8_t i;
+
+	HAL_I2C_DeInit(&I2C_BUS);           //also stops DMA and masks the I2C IRQs
+
+	HAL_GPIO_WritePin(GPIOB, RTC_SCL_Pin|RTC_SDA_Pin, GPIO_PIN_SET);
+	GPIO_InitStruct.Pin = RTC_SCL_Pin|RTC_SDA_Pin;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+	I2C_Bus_Delay();
+
+	for(i = 0; i < 9 && HAL_GPIO_ReadPin(RTC_SDA_GPIO_Port, RTC_SDA_Pin) == GPIO_PIN_RESET; i++)
+	{
+		HAL_GPIO_WritePin(RTC_SCL_GPIO_Port, RTC_SCL_Pin, GPIO_PIN_RESET);
+		I2C_Bus_Delay();
+		HAL_GPIO_WritePin(RTC_SCL_GPIO_Port, RTC_SCL_Pin, GPIO_PIN_SET);
+		I2C_Bus_Delay();
+	}
+	//STOP: SDA rises while SCL is high
+	HAL_GPIO_WritePin(RTC_SCL_GPIO_Port, RTC_SCL_Pin, GPIO_PIN_RESET);
+	I2C_Bus_Delay();
+	HAL_GPIO_WritePin(RTC_SDA_GPIO_Port, RTC_SDA_Pin, GPIO_PIN_RESET);
+	I2C_Bus_Delay();
+	HAL_GPIO_WritePin(RTC_SCL_GPIO_Port, RTC_SCL_Pin, GPIO_PIN_SET);
+	I2C_Bus_Delay();
+	HAL_GPIO_WritePin(RTC_SDA_GPIO_Port, RTC_SDA_Pin, GPIO_PIN_SET);
+	I2C_Bus_Delay();
+
+	__HAL_RCC_I2C1_CLK_ENABLE();
+	I2C_BUS.Instance->CR1 |= I2C_CR1_SWRST;
+	I2C_BUS.Instance->CR1 &= ~I2C_CR1_SWRST;
+	if(HAL_I2C_Init(&I2C_BUS) != HAL_OK)  //MspInit puts the pins back on AF_OD
+		Error_Handler();
+	i2c_bus_stats.recoveries++;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if(bus_busy)
+		I2C_Bus_Complete(I2C_XFER_ERROR, HAL_I2C_ERROR_TIMEOUT);
+	bus_fault = 0;
+	I2C_Bus_Kick();
+	__set_PRIMASK(primask);
+}
+
+/*****************************************************************************
+ * @name       :void I2C_Bus_Init(void)
+ * @date       :2026-10-19
+ * @function   :Reset the queue; recover the bus if BUSY is stuck after reset
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void I2C_Bus_Init(void)
+{
+	q_head = q_tail = NULL;
+	d_head = d_tail = NULL;
+	bus_busy = 0;
+	bus_fault = 0;
+	if(__HAL_I2C_GET_FLAG(&I2C_BUS, I2C_FLAG_BUSY))
+		I2C_Bus_Recover();
+}
+
+/*****************************************************************************
+ * @name       :void I2C_Bus_Process(void)
+ * @date       :2026-10-19
+ * @function   :Task-context service: transfer watchdog, bus recovery and
+                completion callbacks. Run on I2C_BUS_SIG and, while the bus
+                is not idle, at least every I2C_BUS_TIMEOUT_MS.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void I2C_Bus_Process(void)
+{
+	i2c_xfer_t *x;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if(bus_busy && (uint32_t)(HAL_GetTick() - bus_start_ms) > I2C_BUS_TIMEOUT_MS)
+	{
+		i2c_bus_stats.timeouts++;
+		bus_fault = 1;                  //recovery below retires the stuck transfer
+	}
+	__set_PRIMASK(primask);
+	if(bus_fault)
+		I2C_Bus_Recover();
+
+	for(;;)
+	{
+		__disable_irq();
+		x = d_head;
+		if(x)
+		{
+			d_head = x->next;
+			if(d_head == NULL)
+				d_tail = NULL;
+			x->next = NULL;
+			x->cb_pending = 0;
+		}
+		__set_PRIMASK(primask);
+		if(x == NULL)
+			break;
+		if(x->done)
+			x->done(x);
+	}
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	if(hi2c != &I2C_BUS)
+		return;
+	I2C_Bus_Complete(I2C_XFER_DONE, 0);
+	I2C_Bus_Kick();
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	if(hi2c != &I2C_BUS)
+		return;
+	I2C_Bus_Complete(I2C_XFER_DONE, 0);
+	I2C_Bus_Kick();
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	uint32_t err = hi2c->ErrorCode;
+
+	if(hi2c != &I2C_BUS)
+		return;
+	if(err & (HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_ARLO | HAL_I2C_ERROR_TIMEOUT))
+		bus_fault = 1;                  //NACK (AF) needs no recovery, HAL already sent STOP
+	I2C_Bus_Complete(I2C_XFER_ERROR, err);
+	I2C_Bus_Kick();
+}
@@ -0,0 +1,62 @@
+#ifndef __I2C_BUS_H
+#define __I2C_BUS_H
+#include "main.h"
+#include "i2c.h"
+#include "sched.h"
+
+//Asynchronous transaction queue on I2C1. Transfers are started from the
+//I2C/DMA interrupts back to back, completion callbacks run from
+//I2C_Bus_Process() in I2C_BUS_TASK so they may submit follow-ups.
+#define I2C_BUS              hi2c1
+#define I2C_BUS_TASK         SCHED_TASK_BUS
+#define I2C_BUS_SIG          0        //raised on submit and on completion
+#define I2C_BUS_TIMEOUT_MS   5        //a 16-byte transfer at 400 kHz takes ~0.5 ms
+#define I2C_BUS_DMA_MIN      2        //F1 errata: DMA reception of a single byte is unreliable
+
+#define I2C_XFER_WRITE       0
+#define I2C_XFER_READ        1
+
+#define I2C_XFER_IDLE        0
+#define I2C_XFER_QUEUED      1
+#define I2C_XFER_BUSY        2
+#define I2C_XFER_DONE        3
+#define I2C_XFER_ERROR       4
+
+struct i2c_xfer;
+typedef void (*i2c_done_cb)(struct i2c_xfer *x);
+
+typedef struct i2c_xfer
+{
+	uint8_t  dev;                //8-bit device address
+	uint8_t  reg;                //register / memory address
+	uint8_t  dir;                //I2C_XFER_READ or I2C_XFER_WRITE
+	uint8_t  len;
+	uint8_t *buf;
+	i2c_done_cb done;            //may be NULL
+	volatile uint8_t status;     //I2C_XFER_xxx
+	volatile uint8_t cb_pending; //finished, callback not run yet
+	uint32_t error;              //HAL_I2C_ERROR_xxx when status is I2C_XFER_ERROR
+	uint32_t t_start;            //TS_LocalUs() when the transfer hit the bus
+	struct i2c_xfer *next;
+} i2c_xfer_t;
+
+typedef struct
+{
+	uint32_t done;
+	uint32_t errors;
+	uint32_t timeouts;
+	uint32_t recoveries;
+} i2c_bus_stats_t;
+
+extern i2c_bus_stats_t i2c_bus_stats;
+
+void I2C_Bus_Init(void);
+HAL_StatusTypeDef I2C_Bus_Submit(i2c_xfer_t *x);
+void I2C_Bus_Setup(i2c_xfer_t *x, uint8_t dev, uint8_t dir, uint8_t reg,
+                   uint8_t *buf, uint8_t len, i2c_done_cb done);
+void I2C_Bus_Process(void);
+uint8_t I2C_Bus_InFlight(const i2c_xfer_t *x);
+uint8_t I2C_Bus_Idle(void);
+void I2C_Bus_Recover(void);
+
+#endif
@@ -0,0 +1,300 @@
+#include "key.h"
+
+#define KEY_ACTIVE          GPIO_PIN_RESET  //keys pull the line low
+
+#define KEY_F_LOCK          0x01    //debounce lockout running
+#define KEY_F_LONG          0x02    //KEY_EV_LONG sent for this press
+#define KEY_F_MUTE          0x04    //chord member or held at start-up (with KEY_F_LONG): no click/long/repeat
+
+#define KEY_NONE            0xFFFFFFFF
+
+typedef struct
+{
+	GPIO_TypeDef *port;
+	uint16_t pin;
+	uint8_t repeat;                 //auto-repeat after the long press
+} key_cfg_t;
+
+typedef struct
+{
+	uint8_t down;                   //debounced state
+	uint8_t flags;
+	uint32_t press_ms;
+	uint32_t lock_ms;               //end of the debounce lockout
+	uint32_t next_ms;               //long-press / repeat deadline
+} key_state_t;
+
+typedef struct
+{
+	uint32_t ms;
+	uint8_t key;
+	uint8_t down;
+} key_edge_t;
+
+static const key_cfg_t key_cfg[KEY_NUM] =
+{
+	{Key_up_GPIO_Port, Key_up_Pin, 1},
+	{Key_down_GPIO_Port, Key_down_Pin, 1},
+	{Key_enter_Det_GPIO_Port, Key_enter_Det_Pin, 0},
+};
+
+static key_state_t keys[KEY_NUM];
+
+static key_edge_t edges[KEY_EDGE_QUEUE];
+static volatile uint8_t edge_head;      //written by the EXTI interrupt
+static volatile uint8_t edge_tail;
+static volatile uint8_t edge_lost;      //ring overflowed, resample all keys
+
+static key_event_t events[KEY_EVENT_QUEUE];
+static uint8_t ev_head, ev_tail;
+static uint32_t ev_dropped;
+
+static sched_timer_t key_timer;
+
+static uint8_t Key_Read(uint8_t k)
+{
+	return HAL_GPIO_ReadPin(key_cfg[k].port, key_cfg[k].pin) == KEY_ACTIVE;
+}
+
+static void Key_Emit(uint8_t type, uint8_t mask, uint32_t ms)
+{
+	key_event_t *ev;
+
+	if((uint8_t)(ev_head - ev_tail) >= KEY_EVENT_QUEUE)
+	{
+		ev_dropped++;
+		return;
+	}
+	ev = &events[ev_head & (KEY_EVENT_QUEUE - 1)];
+	ev->type = type;
+	ev->keys = mask;
+	ev->ms = ms;
+	ev_head++;
+}
+
+uint8_t Key_GetEvent(key_event_t *ev)
+{
+	if(ev_head == ev_tail)
+		return 0;
+	*ev = events[ev_tail & (KEY_EVENT_QUEUE - 1)];
+	ev_tail++;
+	return 1;
+}
+
+static uint8_t Key_DownMask(void)
+{
+	uint8_t k, mask = 0;
+
+	for(k = 0; k < KEY_NUM; k++)
+		if(keys[k].down)
+			mask |= 1 << k;
+	return mask;
+}
+
+/*****************************************************************************
+ * @name       :static void Key_Press(uint8_t k, uint32_t ms)
+ * @date       :2026-10-19
+ * @function   :Debounced press. A key that goes down while another one is
+                still fresh (pressed within KEY_CHORD_MS, no long press yet)
+                or already part of a chord forms a chord with it.
+ * @parameters :k:key index
+                ms:time of the press
+ * @retvalue   :None
+******************************************************************************/
+static void Key_Press(uint8_t k, uint32_t ms)
+{
+	key_state_t *s = &keys[k];
+	uint8_t j, chord = 0;
+
+	s->press_ms = ms;
+	s->next_ms = ms + KEY_LONG_MS;
+	s->flags &= ~(KEY_F_LONG | KEY_F_MUTE);
+	Key_Emit(KEY_EV_PRESS, 1 << k, ms);
+	for(j = 0; j < KEY_NUM; j++)
+	{
+		if(j == k || !keys[j].down)
+			continue;
+		if((keys[j].flags & (KEY_F_MUTE | KEY_F_LONG)) == KEY_F_MUTE ||
+		   (!(keys[j].flags & KEY_F_LONG) && ms - keys[j].press_ms <= KEY_CHORD_MS))
+			chord = 1;
+	}
+	if(!chord)
+		return;
+	for(j = 0; j < KEY_NUM; j++)
+		if(keys[j].down)
+			keys[j].flags |= KEY_F_MUTE;
+	Key_Emit(KEY_EV_CHORD, Key_DownMask(), ms);
+}
+
+static void Key_Release(uint8_t k, uint32_t ms)
+{
+	//a press that did not outlast its lockout was a glitch, not a click
+	if(!(keys[k].flags & (KEY_F_LONG | KEY_F_MUTE)) && ms - keys[k].press_ms > KEY_DEBOUNCE_MS)
+		Key_Emit(KEY_EV_CLICK, 1 << k, ms);
+	Key_Emit(KEY_EV_RELEASE, 1 << k, ms);
+}
+
+static void Key_Set(uint8_t k, uint8_t down, uint32_t ms)
+{
+	key_state_t *s = &keys[k];
+
+	if(down == s->down)
+		return;
+	s->down = down;
+	s->flags |= KEY_F_LOCK;
+	s->lock_ms = ms + KEY_DEBOUNCE_MS;
+	if(down)
+		Key_Press(k, ms);
+	else
+		Key_Release(k, ms);
+}
+
+/*****************************************************************************
+ * @name       :void Key_Edge(uint8_t key, uint8_t down, uint32_t ms)
+ * @date       :2026-10-19
+ * @function   :Feed one raw edge. Edges inside the lockout are ignored, the
+                level is re-read when it ends. Hardware independent, so key
+                traces can be replayed together with Key_Timeout().
+ * @parameters :key:key index
+                down:1 = key pressed after the edge
+                ms:edge timestamp
+ * @retvalue   :None
+******************************************************************************/
+void Key_Edge(uint8_t key, uint8_t down, uint32_t ms)
+{
+	if(key >= KEY_NUM || (keys[key].flags & KEY_F_LOCK))
+		return;
+	Key_Set(key, down, ms);
+}
+
+/*****************************************************************************
+ * @name       :uint32_t Key_Timeout(uint32_t now)
+ * @date       :2026-10-19
+ * @function   :Serve expired lockouts, long-press and repeat deadlines
+ * @parameters :now:current HAL tick
+ * @retvalue   :ms until the next deadline, KEY_NONE if there is none
+******************************************************************************/
+uint32_t Key_Timeout(uint32_t now)
+{
+	key_state_t *s;
+	uint32_t next = KEY_NONE, d;
+	uint8_t k;
+
+	for(k = 0; k < KEY_NUM; k++)
+	{
+		s = &keys[k];
+		if((s->flags & KEY_F_LOCK) && (int32_t)(now - s->lock_ms) >= 0)
+		{
+			s->flags &= ~KEY_F_LOCK;
+			Key_Set(k, Key_Read(k), now);       //settled level after the bounce
+		}
+		if(s->down && !(s->flags & KEY_F_MUTE) && (int32_t)(now - s->next_ms) >= 0 &&
+		   (!(s->flags & KEY_F_LONG) || key_cfg[k].repeat))
+		{
+			Key_Emit(s->flags & KEY_F_LONG ? KEY_EV_REPEAT : KEY_EV_LONG, 1 << k, now);
+			s->flags |= KEY_F_LONG;
+			s->next_ms += KEY_REPEAT_MS;
+			if((int32_t)(now - s->next_ms) >= 0)
+				s->next_ms = now + KEY_REPEAT_MS;   //fell behind, do not burst
+		}
+		if(s->flags & KEY_F_LOCK)
+		{
+			d = s->lock_ms - now;
+			if(d < next)
+				next = d;
+		}
+		if(s->down && !(s->flags & KEY_F_MUTE) && (!(s->flags & KEY_F_LONG) || key_cfg[k].repeat))
+		{
+			d = s->next_ms - now;
+			if(d < next)
+				next = d;
+		}
+	}
+	return next;
+}
+
+/*****************************************************************************
+ * @name       :void Key_Init(void)
+ * @date       :2026-10-19
+ * @function   :Take the current key levels as the initial state. A key held
+                at start-up (the power-on press) is muted until released.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Key_Init(void)
+{
+	uint8_t k;
+
+	for(k = 0; k < KEY_NUM; k++)
+	{
+		keys[k].down = Key_Read(k);
+		keys[k].flags = keys[k].down ? KEY_F_MUTE | KEY_F_LONG : 0;
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Key_EdgeIRQ(uint16_t pin)
+ * @date       :2026-10-19
+ * @function   :EXTI side: timestamp the edge into the ring and wake the task
+ * @parameters :pin:GPIO pin of the EXTI line
+ * @retvalue   :None
+******************************************************************************/
+void Key_EdgeIRQ(uint16_t pin)
+{
+	key_edge_t *e;
+	uint8_t k;
+
+	for(k = 0; k < KEY_NUM && key_cfg[k].pin != pin; k++);
+	if(k == KEY_NUM)
+		return;
+	if((uint8_t)(edge_head - edge_tail) >= KEY_EDGE_QUEUE)
+		edge_lost = 1;
+	else
+	{
+		e = &edges[edge_head & (KEY_EDGE_QUEUE - 1)];
+		e->ms = HAL_GetTick();
+		e->key = k;
+		e->down = Key_Read(k);
+		edge_head++;
+	}
+	Sched_Signal(KEY_TASK, KEY_SIG_EDGE);
+}
+
+/*****************************************************************************
+ * @name       :void Key_Process(uint8_t sig)
+ * @date       :2026-10-19
+ * @function   :KEY_TASK side: consume the edges, run the deadlines and arm
+                the timer for the next one. Events are then read with
+                Key_GetEvent().
+ * @parameters :sig:KEY_SIG_EDGE or KEY_SIG_TIMER
+ * @retvalue   :None
+******************************************************************************/
+void Key_Process(uint8_t sig)
+{
+	key_edge_t *e;
+	uint32_t next;
+	uint8_t k;
+
+	while(edge_tail != edge_head)
+	{
+		e = &edges[edge_tail & (KEY_EDGE_QUEUE - 1)];
+		Key_Edge(e->key, e->down, e->ms);
+		edge_tail++;
+	}
+	if(edge_lost)
+	{
+		edge_lost = 0;
+		for(k = 0; k < KEY_NUM; k++)
+			Key_Edge(k, Key_Read(k), HAL_GetTick());
+	}
+	next = Key_Timeout(HAL_GetTick());
+	if(next == KEY_NONE)
+		Sched_TimerStop(&key_timer);
+	else
+		Sched_TimerStart(&key_timer, KEY_TASK, KEY_SIG_TIMER, next, 0);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	Key_EdgeIRQ(GPIO_Pin);
+}
@@ -0,0 +1,55 @@
+#ifndef __KEY_H
+#define __KEY_H
+#include "main.h"
+#include "sched.h"
+
+//Key input. The EXTI interrupt only timestamps the edge into a ring and
+//signals KEY_TASK; debouncing and gesture detection run in the task on
+//timers, so nothing is polled and the CPU sleeps between presses.
+//Debounce is leading edge: the first edge is taken at once and the key is
+//re-read when the lockout ends. Bounces never reach the UI, a glitch shorter
+//than the lockout shows up as PRESS/RELEASE without a CLICK.
+//Single-key actions should use KEY_EV_CLICK, KEY_EV_PRESS is meant for
+//immediate feedback only (the key may still become part of a chord).
+#define KEY_TASK            SCHED_TASK_UI
+#define KEY_SIG_EDGE        1       //edge ring not empty
+#define KEY_SIG_TIMER       2       //debounce / long-press deadline
+
+#define KEY_UP              0
+#define KEY_DOWN            1
+#define KEY_ENTER           2
+#define KEY_NUM             3
+
+#define KEY_MASK_UP         (1 << KEY_UP)
+#define KEY_MASK_DOWN       (1 << KEY_DOWN)
+#define KEY_MASK_ENTER      (1 << KEY_ENTER)
+
+#define KEY_EV_PRESS        0       //debounced down
+#define KEY_EV_RELEASE      1
+#define KEY_EV_CLICK        2       //released before KEY_LONG_MS, not in a chord
+#define KEY_EV_LONG         3       //held for KEY_LONG_MS
+#define KEY_EV_REPEAT       4       //every KEY_REPEAT_MS after KEY_EV_LONG (up/down only)
+#define KEY_EV_CHORD        5       //keys pressed within KEY_CHORD_MS of each other
+
+#define KEY_DEBOUNCE_MS     20
+#define KEY_LONG_MS         800
+#define KEY_REPEAT_MS       120
+#define KEY_CHORD_MS        80
+#define KEY_EDGE_QUEUE      16      //power of two
+#define KEY_EVENT_QUEUE     8       //power of two
+
+typedef struct
+{
+	uint8_t type;                   //KEY_EV_x
+	uint8_t keys;                   //KEY_MASK_x, several bits for a chord
+	uint32_t ms;                    //HAL tick of the edge / deadline
+} key_event_t;
+
+void Key_Init(void);
+void Key_EdgeIRQ(uint16_t pin);
+void Key_Edge(uint8_t key, uint8_t down, uint32_t ms);
+uint32_t Key_Timeout(uint32_t now);
+void Key_Process(uint8_t sig);
+uint8_t Key_GetEvent(key_event_t *ev);
+
+#endif
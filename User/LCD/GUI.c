@@ -65,6 +65,33 @@ void GUI_DrawPoint(u16 x,u16 y,u16 color)
 	Lcd_WriteData_16Bit(color); 
 }
 
+/*******************************************************************
+ * @name       :static void GUI_Span(int x0, int y0, int x1, int y1, u16 color)
+ * @date       :2026-10-19
+ * @function   :Fill a rectangle clipped to the screen as one window and a
+                single burst of pixel data, the window is left as it is
+ * @parameters :x0,y0:top left, may be off screen
+                x1,y1:bottom right, inclusive, empty when left of or above
+                x0,y0
+                color:fill colour
+ * @retvalue   :None
+********************************************************************/
+static void GUI_Span(int x0, int y0, int x1, int y1, u16 color)
+{
+	if(x0 < 0)
+		x0 = 0;
+	if(y0 < 0)
+		y0 = 0;
+	if(x1 >= lcddev.width)
+		x1 = lcddev.width - 1;
+	if(y1 >= lcddev.height)
+		y1 = lcddev.height - 1;
+	if(x0 > x1 || y0 > y1)
+		return;
+	LCD_SetWindows(x0, y0, x1, y1);
+	LCD_PushColor(color, (u32)(x1 - x0 + 1) * (y1 - y0 + 1));
+}
+
 /*******************************************************************
  * @name       :void LCD_Fill(u16 sx,u16 sy,u16 ex,u16 ey,u16 color)
  * @date       :2018-08-09 
@@ -78,22 +105,16 @@ void GUI_DrawPoint(u16 x,u16 y,u16 color)
 ********************************************************************/
 void LCD_Fill(u16 sx,u16 sy,u16 ex,u16 ey,u16 color)
 {  	
-	u16 i,j;			
-	u16 width=ex-sx+1; 		//õĿ
-	u16 height=ey-sy+1;		//߶
-	LCD_SetWindows(sx,sy,ex,ey);//ʾ
-	for(i=0;i<height;i++)
-	{
-		for(j=0;j<width;j++)
-		Lcd_WriteData_16Bit(color);	//д 	 
-	}
+	GUI_Span(sx,sy,ex,ey,color);
 	LCD_SetWindows(0,0,lcddev.width-1,lcddev.height-1);//ָΪȫ
 }
 
 /*******************************************************************
  * @name       :void LCD_DrawLine(u16 x1, u16 y1, u16 x2, u16 y2)
  * @date       :2018-08-09 
- * @function   :Draw a line between two points
+ * @function   :Draw a line between two points. Pixels in a row along the
+                major axis go out as one span, so horizontal and vertical
+                lines are a single window.
  * @parameters :x1:the bebinning x coordinate of the line
                 y1:the bebinning y coordinate of the line
 								x2:the ending x coordinate of the line
@@ -104,7 +125,7 @@ void LCD_DrawLine(u16 x1, u16 y1, u16 x2, u16 y2)
 {
 	u16 t; 
 	int xerr=0,yerr=0,delta_x,delta_y,distance; 
-	int incx,incy,uRow,uCol; 
+	int incx,incy,uRow,uCol,sRow,sCol,pRow,pCol; 
 
 	delta_x=x2-x1; // 
 	delta_y=y2-y1; 
@@ -118,9 +139,18 @@ void LCD_DrawLine(u16 x1, u16 y1, u16 x2, u16 y2)
 	else{incy=-1;delta_y=-delta_y;} 
 	if( delta_x>delta_y)distance=delta_x; //ѡȡ 
 	else distance=delta_y; 
+	sRow=pRow=uRow;
+	sCol=pCol=uCol;
 	for(t=0;t<=distance+1;t++ )// 
 	{  
-		LCD_DrawPoint(uRow,uCol);// 
+		if(delta_x>=delta_y ? uCol!=sCol : uRow!=sRow)	//the run along the major axis ends
+		{
+			GUI_Span(sRow<pRow?sRow:pRow,sCol<pCol?sCol:pCol,sRow<pRow?pRow:sRow,sCol<pCol?pCol:sCol,POINT_COLOR);
+			sRow=uRow;
+			sCol=uCol;
+		}
+		pRow=uRow;
+		pCol=uCol;
 		xerr+=delta_x ; 
 		yerr+=delta_y ; 
 		if(xerr>distance) 
@@ -134,12 +164,13 @@ void LCD_DrawLine(u16 x1, u16 y1, u16 x2, u16 y2)
 			uCol+=incy; 
 		} 
 	}  
+	GUI_Span(sRow<pRow?sRow:pRow,sCol<pCol?sCol:pCol,sRow<pRow?pRow:sRow,sCol<pCol?pCol:sCol,POINT_COLOR);
 } 
 
 /*****************************************************************************
  * @name       :void LCD_DrawRectangle(u16 x1, u16 y1, u16 x2, u16 y2)
  * @date       :2018-08-09 
- * @function   :Draw a rectangle
+ * @function   :Draw a rectangle, one span per side
  * @parameters :x1:the bebinning x coordinate of the rectangle
                 y1:the bebinning y coordinate of the rectangle
 								x2:the ending x coordinate of the rectangle
@@ -148,10 +179,12 @@ void LCD_DrawLine(u16 x1, u16 y1, u16 x2, u16 y2)
 ******************************************************************************/
 void LCD_DrawRectangle(u16 x1, u16 y1, u16 x2, u16 y2)
 {
-	LCD_DrawLine(x1,y1,x2,y1);
-	LCD_DrawLine(x1,y1,x1,y2);
-	LCD_DrawLine(x1,y2,x2,y2);
-	LCD_DrawLine(x2,y1,x2,y2);
+	u16 xa=x1<x2?x1:x2,xb=x1<x2?x2:x1,ya=y1<y2?y1:y2,yb=y1<y2?y2:y1;
+
+	GUI_Span(xa,ya,xb,ya,POINT_COLOR);
+	GUI_Span(xa,yb,xb,yb,POINT_COLOR);
+	GUI_Span(xa,ya,xa,yb,POINT_COLOR);
+	GUI_Span(xb,ya,xb,yb,POINT_COLOR);
 }  
 
 /*****************************************************************************
@@ -170,39 +203,81 @@ void LCD_DrawFillRectangle(u16 x1, u16 y1, u16 x2, u16 y2)
 }
  
 /*****************************************************************************
- * @name       :void _draw_circle_8(int xc, int yc, int x, int y, u16 c)
- * @date       :2018-08-09 
- * @function   :8 symmetry circle drawing algorithm (internal call)
- * @parameters :xc:the x coordinate of the Circular center 
-                yc:the y coordinate of the Circular center 
-								x:the x coordinate relative to the Circular center 
-								y:the y coordinate relative to the Circular center 
-								c:the color value of the circle
+ * @name       :static void GUI_Arc8(int xc, int yc, int a, int b, int y, u16 c)
+ * @date       :2026-10-19
+ * @function   :Draw a run of the circle outline in all 8 octants as spans
+                (internal call)
+ * @parameters :xc,yc:centre
+                a,b:first and last offset along the run
+                y:distance of the run from the centre
+                c:the color value of the circle
  * @retvalue   :None
 ******************************************************************************/  
-void _draw_circle_8(int xc, int yc, int x, int y, u16 c)
+static void GUI_Arc8(int xc, int yc, int a, int b, int y, u16 c)
 {
-	GUI_DrawPoint(xc + x, yc + y, c);
-
-	GUI_DrawPoint(xc - x, yc + y, c);
-
-	GUI_DrawPoint(xc + x, yc - y, c);
-
-	GUI_DrawPoint(xc - x, yc - y, c);
-
-	GUI_DrawPoint(xc + y, yc + x, c);
-
-	GUI_DrawPoint(xc - y, yc + x, c);
+	if(a == 0)
+	{
+		GUI_Span(xc - b, yc + y, xc + b, yc + y, c);
+		GUI_Span(xc - b, yc - y, xc + b, yc - y, c);
+		GUI_Span(xc + y, yc - b, xc + y, yc + b, c);
+		GUI_Span(xc - y, yc - b, xc - y, yc + b, c);
+		return;
+	}
+	GUI_Span(xc + a, yc + y, xc + b, yc + y, c);
+	GUI_Span(xc - b, yc + y, xc - a, yc + y, c);
+	GUI_Span(xc + a, yc - y, xc + b, yc - y, c);
+	GUI_Span(xc - b, yc - y, xc - a, yc - y, c);
+	GUI_Span(xc + y, yc + a, xc + y, yc + b, c);
+	GUI_Span(xc - y, yc + a, xc - y, yc + b, c);
+	GUI_Span(xc + y, yc - b, xc + y, yc - a, c);
+	GUI_Span(xc - y, yc - b, xc - y, yc - a, c);
+}
 
-	GUI_DrawPoint(xc + y, yc - x, c);
+//the two rows k above yt and below yb, from w left of xl to w right of xr
+static void GUI_FillRows(int xl, int yt, int xr, int yb, int k, int w, u16 c)
+{
+	GUI_Span(xl - w, yt - k, xr + w, yt - k, c);
+	GUI_Span(xl - w, yb + k, xr + w, yb + k, c);
+}
 
-	GUI_DrawPoint(xc - y, yc - x, c);
+/*****************************************************************************
+ * @name       :static void GUI_FillRound(int xl, int yt, int xr, int yb, int r, u16 c)
+ * @date       :2026-10-19
+ * @function   :Fill a disc of radius r stretched between two centres, one
+                span per row and one window for the rows between the
+                centres (internal call)
+ * @parameters :xl,yt:top left centre
+                xr,yb:bottom right centre
+                r:radius
+                c:fill colour
+ * @retvalue   :None
+******************************************************************************/  
+static void GUI_FillRound(int xl, int yt, int xr, int yb, int r, u16 c)
+{
+	int x = 0, y = r, d = 3 - 2 * r;
+
+	GUI_Span(xl - r, yt, xr + r, yb, c);
+	while (x <= y) {
+		if (x)
+			GUI_FillRows(xl, yt, xr, yb, x, y, c);
+		if (d < 0) {
+			d = d + 4 * x + 6;
+		} else {
+			if (y > x)
+				GUI_FillRows(xl, yt, xr, yb, y, x, c);	//widest x before the row moves in
+			d = d + 4 * (x - y) + 10;
+			y--;
+		}
+		x++;
+	}
 }
 
 /*****************************************************************************
  * @name       :void gui_circle(int xc, int yc,u16 c,int r, int fill)
  * @date       :2018-08-09 
- * @function   :Draw a circle of specified size at a specified location
+ * @function   :Draw a circle of specified size at a specified location.
+                A filled circle goes out as one span per row, the outline
+                as runs of pixels on the same row or column.
  * @parameters :xc:the x coordinate of the Circular center 
                 yc:the y coordinate of the Circular center 
 								r:Circular radius
@@ -211,39 +286,28 @@ void _draw_circle_8(int xc, int yc, int x, int y, u16 c)
 ******************************************************************************/  
 void gui_circle(int xc, int yc,u16 c,int r, int fill)
 {
-	int x = 0, y = r, yi, d;
-
-	d = 3 - 2 * r;
-
+	int x = 0, y = r, xs = 0, d, ny;
 
 	if (fill) 
 	{
-		// 䣨ʵԲ
-		while (x <= y) {
-			for (yi = x; yi <= y; yi++)
-				_draw_circle_8(xc, yc, x, yi, c);
-
-			if (d < 0) {
-				d = d + 4 * x + 6;
-			} else {
-				d = d + 4 * (x - y) + 10;
-				y--;
-			}
-			x++;
+		GUI_FillRound(xc, yc, xc, yc, r, c);
+		return;
+	}
+	d = 3 - 2 * r;
+	while (x <= y) {
+		ny = y;
+		if (d < 0) {
+			d = d + 4 * x + 6;
+		} else {
+			d = d + 4 * (x - y) + 10;
+			ny--;
 		}
-	} else 
-	{
-		// 䣨Բ
-		while (x <= y) {
-			_draw_circle_8(xc, yc, x, y, c);
-			if (d < 0) {
-				d = d + 4 * x + 6;
-			} else {
-				d = d + 4 * (x - y) + 10;
-				y--;
-			}
-			x++;
+		if (ny != y || x + 1 > ny) {
+			GUI_Arc8(xc, yc, xs, x, y, c);	//the run at distance y ends here
+			xs = x + 1;
 		}
+		y = ny;
+		x++;
 	}
 }
 
@@ -326,7 +390,7 @@ void Fill_Triangel(u16 x0,u16 y0,u16 x1,u16 y1,u16 x2,u16 y2)
     {
 			b = x2;
     }
-		LCD_Fill(a,y0,b,y0,POINT_COLOR);
+		GUI_Span(a,y0,b,y0,POINT_COLOR);
     return;
 	}
 	dx01 = x1 - x0;
@@ -354,7 +418,7 @@ void Fill_Triangel(u16 x0,u16 y0,u16 x1,u16 y1,u16 x2,u16 y2)
     {
 			_swap(&a,&b);
 		}
-		LCD_Fill(a,y,b,y,POINT_COLOR);
+		GUI_Span(a,y,b,y,POINT_COLOR);
 	}
 	sa = dx12 * (y - y1);
 	sb = dx02 * (y - y0);
@@ -368,8 +432,109 @@ void Fill_Triangel(u16 x0,u16 y0,u16 x1,u16 y1,u16 x2,u16 y2)
 		{
 			_swap(&a,&b);
 		}
-		LCD_Fill(a,y,b,y,POINT_COLOR);
+		GUI_Span(a,y,b,y,POINT_COLOR);
+	}
+}
+
+/*****************************************************************************
+ * @name       :void GUI_FillRoundRect(u16 x0, u16 y0, u16 x1, u16 y1, u16 r, u16 color)
+ * @date       :2026-10-19
+ * @function   :Fill a rectangle with rounded corners, clipped to the screen
+ * @parameters :x0,y0,x1,y1:corners, inclusive
+                r:corner radius, limited to half the shorter side
+                color:fill colour
+ * @retvalue   :None
+******************************************************************************/
+void GUI_FillRoundRect(u16 x0, u16 y0, u16 x1, u16 y1, u16 r, u16 color)
+{
+	if(x0 > x1)
+		_swap(&x0, &x1);
+	if(y0 > y1)
+		_swap(&y0, &y1);
+	if(2 * r > x1 - x0)
+		r = (x1 - x0) / 2;
+	if(2 * r > y1 - y0)
+		r = (y1 - y0) / 2;
+	GUI_FillRound(x0 + r, y0 + r, x1 - r, y1 - r, r, color);
+}
+
+//a / b rounded up, b > 0
+static int GUI_CeilDiv(int a, int b)
+{
+	return a >= 0 ? (a + b - 1) / b : -(-a / b);
+}
+
+/*****************************************************************************
+ * @name       :void GUI_FillPolygon(const gui_point_t *p, u8 n, u16 color)
+ * @date       :2026-10-19
+ * @function   :Fill a polygon by scanlines, clipped to the screen. Vertices
+                lie on pixel corners and a pixel is filled when its centre
+                is inside (even-odd rule), so shapes sharing an edge neither
+                overlap nor leave a gap. Rows with the same single span as
+                the row above are merged into one window.
+ * @parameters :p:vertices, within +-4096 of the screen
+                n:number of vertices, the last one joins the first
+                color:fill colour
+ * @retvalue   :None
+******************************************************************************/
+void GUI_FillPolygon(const gui_point_t *p, u8 n, u16 color)
+{
+	int cross[GUI_POLY_CROSS], y, ymin, ymax, dy, c, sy = -1, sa = 0, sb = 0;
+	const gui_point_t *a, *b, *t;
+	u8 i, k, m;
+
+	if(n < 3)
+		return;
+	ymin = ymax = p[0].y;
+	for(i = 1; i < n; i++)
+	{
+		if(p[i].y < ymin)
+			ymin = p[i].y;
+		if(p[i].y > ymax)
+			ymax = p[i].y;
+	}
+	if(ymin < 0)
+		ymin = 0;
+	if(ymax > lcddev.height)
+		ymax = lcddev.height;
+	for(y = ymin; y < ymax; y++)
+	{
+		for(i = 0, m = 0; i < n && m < GUI_POLY_CROSS; i++)
+		{
+			a = &p[i];
+			b = &p[i + 1 < n ? i + 1 : 0];
+			if(a->y > b->y)
+			{
+				t = a;
+				a = b;
+				b = t;
+			}
+			if(y < a->y || y >= b->y)
+				continue;
+			//first pixel whose centre is right of the edge at y + 0.5
+			dy = b->y - a->y;
+			c = GUI_CeilDiv(2 * a->x * dy + (2 * (y - a->y) + 1) * (b->x - a->x) - dy, 2 * dy);
+			for(k = m++; k && cross[k - 1] > c; k--)
+				cross[k] = cross[k - 1];
+			cross[k] = c;
+		}
+		if(m == 2 && sy >= 0 && cross[0] == sa && cross[1] == sb)
+			continue;
+		if(sy >= 0)
+			GUI_Span(sa, sy, sb - 1, y - 1, color);
+		sy = -1;
+		if(m == 2)
+		{
+			sy = y;
+			sa = cross[0];
+			sb = cross[1];
+			continue;
+		}
+		for(k = 0; k + 1 < m; k += 2)
+			GUI_Span(cross[k], y, cross[k + 1] - 1, y, color);
 	}
+	if(sy >= 0)
+		GUI_Span(sa, sy, sb - 1, ymax - 1, color);
 }
 
 /*****************************************************************************
@@ -381,7 +546,7 @@ void Fill_Triangel(u16 x0,u16 y0,u16 x1,u16 y1,u16 x2,u16 y2)
 								fc:the color value of display character
 								bc:the background color of display character
 								num:the ascii code of display character(0~94)
-								size:the size of display character
+								size:the size of display character, 16 only (8x16 is the only font)
 								mode:0-no overlying,1-overlying
  * @retvalue   :None
 ******************************************************************************/ 
@@ -390,15 +555,17 @@ void LCD_ShowChar(u16 x,u16 y,u16 fc, u16 bc, u8 num,u8 size,u8 mode)
     u8 temp;
     u8 pos,t;
 	u16 colortemp=POINT_COLOR;      
+	const u8 *g=GUI_Glyph16(num);
 		   
-	num=num-' ';//õƫƺֵ
+	if(!g)
+		return;
+	size=16;
 	LCD_SetWindows(x,y,x+size/2-1,y+size-1);//õʾ
 	if(!mode) //ǵӷʽ
 	{		
 		for(pos=0;pos<size;pos++)
 		{
-			if(size==12)temp=asc2_1206[num][pos];//1206
-			else temp=asc2_1608[num][pos];		 //1608
+			temp=g[pos];
 			for(t=0;t<size/2;t++)
 		    {                 
 		        if(temp&0x01)Lcd_WriteData_16Bit(fc); 
@@ -412,8 +579,7 @@ void LCD_ShowChar(u16 x,u16 y,u16 fc, u16 bc, u8 num,u8 size,u8 mode)
 	{
 		for(pos=0;pos<size;pos++)
 		{
-			if(size==12)temp=asc2_1206[num][pos];//1206
-			else temp=asc2_1608[num][pos];		 //1608
+			temp=g[pos];
 			for(t=0;t<size/2;t++)
 		    {   
 				POINT_COLOR=fc;              
@@ -496,238 +662,76 @@ void LCD_ShowNum(u16 x,u16 y,u32 num,u8 len,u8 size)
 } 
 
 /*****************************************************************************
- * @name       :void GUI_DrawFont16(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode)
- * @date       :2018-08-09 
- * @function   :Display a single 16x16 Chinese character
- * @parameters :x:the bebinning x coordinate of the Chinese character
-                y:the bebinning y coordinate of the Chinese character
-								fc:the color value of Chinese character
-								bc:the background color of Chinese character
-								s:the start address of the Chinese character
-								mode:0-no overlying,1-overlying
- * @retvalue   :None
-******************************************************************************/ 
-void GUI_DrawFont16(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode)
+ * @name       :const u8 *GUI_Glyph16(u8 c)
+ * @date       :2026-10-19
+ * @function   :Unpack the 8x16 glyph of an ASCII character from asc2_1608_rle
+                (format in Tools/rleconv.py): the blank rows around it and
+                the rows that repeat the one above are not stored
+ * @parameters :c:character
+ * @retvalue   :bitmap, 16 rows of one byte with the leftmost pixel in bit 0,
+                valid until the next call; NULL for a character not in the
+                font
+******************************************************************************/
+const u8 *GUI_Glyph16(u8 c)
 {
-	u8 i,j;
-	u16 k;
-	u16 HZnum;
-	u16 x0=x;
-	HZnum=sizeof(tfont16)/sizeof(typFNT_GB16);	//ԶͳƺĿ
-	
-			
-	for (k=0;k<HZnum;k++) 
+	static u8 rows[16];
+	const u8 *p;
+	u16 n, mask = 0;
+	u8 r, bottom;
+
+	if(c < ' ' || c - ' ' >= 95)
+		return 0;
+	p = asc2_1608_rle + asc2_1608_off[c - ' '];
+	n = asc2_1608_off[c - ' ' + 1] - asc2_1608_off[c - ' '];
+	memset(rows, 0, sizeof(rows));
+	if(!n)
+		return rows;                    //blank
+	r = *p >> 4;
+	bottom = *p++ & 15;
+	if(n - 1 < bottom - r + 1)
 	{
-	  if ((tfont16[k].Index[0]==*(s))&&(tfont16[k].Index[1]==*(s+1)))
-	  { 	LCD_SetWindows(x,y,x+16-1,y+16-1);
-		    for(i=0;i<16*2;i++)
-		    {
-				for(j=0;j<8;j++)
-		    	{	
-					if(!mode) //ǵӷʽ
-					{
-						if(tfont16[k].Msk[i]&(0x80>>j))	Lcd_WriteData_16Bit(fc);
-						else Lcd_WriteData_16Bit(bc);
-					}
-					else
-					{
-						POINT_COLOR=fc;
-						if(tfont16[k].Msk[i]&(0x80>>j))	LCD_DrawPoint(x,y);//һ
-						x++;
-						if((x-x0)==16)
-						{
-							x=x0;
-							y++;
-							break;
-						}
-					}
-
-				}
-				
-			}
-			
-			
-		}				  	
-		continue;  //ҵӦֿ˳ֹظȡģӰ
+		mask = p[0] | p[1] << 8;
+		p += 2;
 	}
-
-	LCD_SetWindows(0,0,lcddev.width-1,lcddev.height-1);//ָΪȫ  
-} 
-
-/*****************************************************************************
- * @name       :void GUI_DrawFont24(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode)
- * @date       :2018-08-09 
- * @function   :Display a single 24x24 Chinese character
- * @parameters :x:the bebinning x coordinate of the Chinese character
-                y:the bebinning y coordinate of the Chinese character
-								fc:the color value of Chinese character
-								bc:the background color of Chinese character
-								s:the start address of the Chinese character
-								mode:0-no overlying,1-overlying
- * @retvalue   :None
-******************************************************************************/ 
-void GUI_DrawFont24(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode)
-{
-	u8 i,j;
-	u16 k;
-	u16 HZnum;
-	u16 x0=x;
-	HZnum=sizeof(tfont24)/sizeof(typFNT_GB24);	//ԶͳƺĿ
-		
-			for (k=0;k<HZnum;k++) 
-			{
-			  if ((tfont24[k].Index[0]==*(s))&&(tfont24[k].Index[1]==*(s+1)))
-			  { 	LCD_SetWindows(x,y,x+24-1,y+24-1);
-				    for(i=0;i<24*3;i++)
-				    {
-							for(j=0;j<8;j++)
-							{
-								if(!mode) //ǵӷʽ
-								{
-									if(tfont24[k].Msk[i]&(0x80>>j))	Lcd_WriteData_16Bit(fc);
-									else Lcd_WriteData_16Bit(bc);
-								}
-							else
-							{
-								POINT_COLOR=fc;
-								if(tfont24[k].Msk[i]&(0x80>>j))	LCD_DrawPoint(x,y);//һ
-								x++;
-								if((x-x0)==24)
-								{
-									x=x0;
-									y++;
-									break;
-								}
-							}
-						}
-					}
-					
-					
-				}				  	
-				continue;  //ҵӦֿ˳ֹظȡģӰ
-			}
-
-	LCD_SetWindows(0,0,lcddev.width-1,lcddev.height-1);//ָΪȫ  
+	for(; r <= bottom; r++, mask >>= 1)
+		rows[r] = mask & 1 ? rows[r - 1] : *p++;
+	return rows;
 }
 
-/*****************************************************************************
- * @name       :void GUI_DrawFont32(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode)
- * @date       :2018-08-09 
- * @function   :Display a single 32x32 Chinese character
- * @parameters :x:the bebinning x coordinate of the Chinese character
-                y:the bebinning y coordinate of the Chinese character
-								fc:the color value of Chinese character
-								bc:the background color of Chinese character
-								s:the start address of the Chinese character
-								mode:0-no overlying,1-overlying
- * @retvalue   :None
-******************************************************************************/ 
-void GUI_DrawFont32(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode)
-{
-	u8 i,j;
-	u16 k;
-	u16 HZnum;
-	u16 x0=x;
-	HZnum=sizeof(tfont32)/sizeof(typFNT_GB32);	//ԶͳƺĿ
-	for (k=0;k<HZnum;k++) 
-			{
-			  if ((tfont32[k].Index[0]==*(s))&&(tfont32[k].Index[1]==*(s+1)))
-			  { 	LCD_SetWindows(x,y,x+32-1,y+32-1);
-				    for(i=0;i<32*4;i++)
-				    {
-						for(j=0;j<8;j++)
-				    	{
-							if(!mode) //ǵӷʽ
-							{
-								if(tfont32[k].Msk[i]&(0x80>>j))	Lcd_WriteData_16Bit(fc);
-								else Lcd_WriteData_16Bit(bc);
-							}
-							else
-							{
-								POINT_COLOR=fc;
-								if(tfont32[k].Msk[i]&(0x80>>j))	LCD_DrawPoint(x,y);//һ
-								x++;
-								if((x-x0)==32)
-								{
-									x=x0;
-									y++;
-									break;
-								}
-							}
-						}
-					}
-					
-					
-				}				  	
-				continue;  //ҵӦֿ˳ֹظȡģӰ
-			}
-	
-	LCD_SetWindows(0,0,lcddev.width-1,lcddev.height-1);//ָΪȫ  
-} 
-
 /*****************************************************************************
  * @name       :void Show_Str(u16 x, u16 y, u16 fc, u16 bc, u8 *str,u8 size,u8 mode)
  * @date       :2018-08-09 
- * @function   :Display Chinese and English strings
- * @parameters :x:the bebinning x coordinate of the Chinese and English strings
-                y:the bebinning y coordinate of the Chinese and English strings
-								fc:the color value of Chinese and English strings
-								bc:the background color of Chinese and English strings
-								str:the start address of the Chinese and English strings
-								size:the size of Chinese and English strings
+ * @function   :Display ASCII strings, other characters are left blank
+ * @parameters :x:the bebinning x coordinate of the string
+                y:the bebinning y coordinate of the string
+								fc:the color value of the string
+								bc:the background color of the string
+								str:the start address of the string
+								size:the size of the string
 								mode:0-no overlying,1-overlying
  * @retvalue   :None
 ******************************************************************************/	   		   
 void Show_Str(u16 x, u16 y, u16 fc, u16 bc, u8 *str,u8 size,u8 mode)
 {					
 	u16 x0=x;							  	  
-  	u8 bHz=0;     //ַ 
+	u8 w=size>16?16:size;	//ֿûм12X24 16X32Ӣ,8X16
     while(*str!=0)//δ
     { 
-        if(!bHz)
-        {
-			if(x>(lcddev.width-size/2)||y>(lcddev.height-size)) 
-			return; 
-	        if(*str>0x80)bHz=1;// 
-	        else              //ַ
-	        {          
-		        if(*str==0x0D)//з
-		        {         
-		            y+=size;
-					x=x0;
-		            str++; 
-		        }  
-		        else
-				{
-					if(size>16)//ֿûм12X24 16X32Ӣ,8X16
-					{  
-					LCD_ShowChar(x,y,fc,bc,*str,16,mode);
-					x+=8; //ַ,Ϊȫֵһ 
-					}
-					else
-					{
-					LCD_ShowChar(x,y,fc,bc,*str,size,mode);
-					x+=size/2; //ַ,Ϊȫֵһ 
-					}
-				} 
-				str++; 
-		        
-	        }
-        }else// 
-        {   
-			if(x>(lcddev.width-size)||y>(lcddev.height-size)) 
-			return;  
-            bHz=0;//кֿ    
-			if(size==32)
-			GUI_DrawFont32(x,y,fc,bc,str,mode);	 	
-			else if(size==24)
-			GUI_DrawFont24(x,y,fc,bc,str,mode);	
-			else
-			GUI_DrawFont16(x,y,fc,bc,str,mode);
-				
-	        str+=2; 
-	        x+=size;//һƫ	    
-        }						 
+		if(x>(lcddev.width-size/2)||y>(lcddev.height-size)) 
+		return; 
+        if(*str==0x0D)//з
+        {         
+            y+=size;
+			x=x0;
+            str++; 
+        }  
+        else
+		{
+			if(*str>=' '&&*str<='~')
+				LCD_ShowChar(x,y,fc,bc,*str,w,mode);
+			x+=w/2; //ַ,Ϊȫֵһ 
+		} 
+		str++; 
     }   
 }
 
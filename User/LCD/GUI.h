@@ -47,6 +47,13 @@
 #ifndef __GUI_H__
 #define __GUI_H__
 
+#define GUI_POLY_CROSS 16	//edge crossings per scanline in GUI_FillPolygon()
+
+typedef struct
+{
+	int16_t x, y;
+} gui_point_t;
+
 void GUI_DrawPoint(u16 x,u16 y,u16 color);
 void LCD_Fill(u16 sx,u16 sy,u16 ex,u16 ey,u16 color);
 void LCD_DrawLine(u16 x1, u16 y1, u16 x2, u16 y2);
@@ -58,13 +65,13 @@ void LCD_ShowChar(u16 x,u16 y,u16 fc, u16 bc, u8 num,u8 size,u8 mode);
 void LCD_ShowNum(u16 x,u16 y,u32 num,u8 len,u8 size);
 void LCD_Show2Num(u16 x,u16 y,u16 num,u8 len,u8 size,u8 mode);
 void LCD_ShowString(u16 x,u16 y,u8 size,u8 *p,u8 mode);
-void GUI_DrawFont16(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode);
-void GUI_DrawFont24(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode);
-void GUI_DrawFont32(u16 x, u16 y, u16 fc, u16 bc, u8 *s,u8 mode);
+const u8 *GUI_Glyph16(u8 c);
 void Show_Str(u16 x, u16 y, u16 fc, u16 bc, u8 *str,u8 size,u8 mode);
 void Gui_Drawbmp16(u16 x,u16 y,const unsigned char *p); //ʾ40*40 QQͼƬ
 void gui_circle(int xc, int yc,u16 c,int r, int fill);
 void Gui_StrCenter(u16 x, u16 y, u16 fc, u16 bc, u8 *str,u8 size,u8 mode);
 void LCD_DrawFillRectangle(u16 x1, u16 y1, u16 x2, u16 y2);
+void GUI_FillRoundRect(u16 x0, u16 y0, u16 x1, u16 y1, u16 r, u16 color);
+void GUI_FillPolygon(const gui_point_t *p, u8 n, u16 color);
 #endif
 
@@ -0,0 +1,326 @@
+#include "backlight.h"
+#include "lcd.h"
+#include "lpm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static TIM_HandleTypeDef htim_bl;
+static uint16_t top;                    //ARR for BL_PWM_HZ at the running TIM2 clock
+static sched_timer_t idle_timer, step_timer;
+static uint8_t mode, next;              //BL_MODE_x now and at the idle timeout
+static uint8_t level, target;           //percent
+static uint8_t asleep, waking;          //panel in Sleep In, Sleep Out or Display On due
+static uint8_t up, pwm, pwm_ok;         //started, pin on TIM2, TIM2 set up
+static uint8_t on_level = BL_LEVEL_ON;
+static uint16_t dim_s = BL_DIM_S, off_s = BL_OFF_S;
+static uint32_t act_ms, sleep_ms, mode_ms, res_ms[BL_MODE_NUM], window_ms;
+
+//TIM2 runs at PCLK1, doubled when APB1 is divided
+static uint32_t Backlight_TimClk(void)
+{
+	uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+
+	return (RCC->CFGR & RCC_CFGR_PPRE1) == RCC_CFGR_PPRE1_DIV1 ? pclk1 : 2 * pclk1;
+}
+
+static void Backlight_Pin(uint32_t gpio_mode)
+{
+	GPIO_InitTypeDef io = {0};
+
+	io.Pin = TFT_SW_Pin;
+	io.Mode = gpio_mode;
+	io.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(TFT_SW_GPIO_Port, &io);
+}
+
+/*****************************************************************************
+ * @name       :static void Backlight_Apply(uint8_t pct)
+ * @date       :2026-10-19
+ * @function   :Set the backlight. Full on and off are a plain output with
+                TIM2 stopped, so Stop mode stays possible; levels between
+                need the PWM and hold LPM_LOCK_BL.
+ * @parameters :pct:brightness in percent
+ * @retvalue   :None
+******************************************************************************/
+static void Backlight_Apply(uint8_t pct)
+{
+	if(!pwm_ok)
+		pct = pct ? 100 : 0;
+	level = pct;
+	if(pct == 0 || pct >= 100)
+	{
+		HAL_GPIO_WritePin(TFT_SW_GPIO_Port, TFT_SW_Pin, pct ? GPIO_PIN_SET : GPIO_PIN_RESET);
+		if(pwm)
+		{
+			Backlight_Pin(GPIO_MODE_OUTPUT_PP);
+			HAL_TIM_PWM_Stop(&htim_bl, TIM_CHANNEL_1);
+			LPM_Unlock(LPM_LOCK_BL);
+			pwm = 0;
+		}
+		return;
+	}
+	__HAL_TIM_SET_COMPARE(&htim_bl, TIM_CHANNEL_1, (uint32_t)pct * pct * (top + 1) / 10000);
+	if(!pwm)
+	{
+		LPM_Lock(LPM_LOCK_BL);
+		HAL_TIM_PWM_Start(&htim_bl, TIM_CHANNEL_1);
+		Backlight_Pin(GPIO_MODE_AF_PP);
+		pwm = 1;
+	}
+}
+
+//arm the idle timer for the next mode, counted from the last key
+static void Backlight_Arm(void)
+{
+	uint32_t at, el = HAL_GetTick() - act_ms;
+
+	Sched_TimerStop(&idle_timer);
+	if(mode == BL_MODE_ON && dim_s && (!off_s || dim_s < off_s))
+	{
+		next = BL_MODE_DIM;
+		at = dim_s * 1000UL;
+	}
+	else if(mode != BL_MODE_OFF && off_s)
+	{
+		next = BL_MODE_OFF;
+		at = off_s * 1000UL;
+	}
+	else
+		return;
+	Sched_TimerStart(&idle_timer, BL_TASK, BL_SIG_IDLE, at > el ? at - el : 1, 0);
+}
+
+static void Backlight_Fade(uint8_t pct)
+{
+	target = pct;
+	if(!waking)
+		Sched_TimerStart(&step_timer, BL_TASK, BL_SIG_STEP, BL_FADE_MS, BL_FADE_MS);
+}
+
+/*****************************************************************************
+ * @name       :static void Backlight_Mode(uint8_t m)
+ * @date       :2026-10-19
+ * @function   :Enter a mode: wake the panel or take it out of idle mode
+                and fade to the on level, or enter idle mode and fade to the
+                dim level, or fade out (the panel sleeps once it is dark)
+ * @parameters :m:BL_MODE_x
+ * @retvalue   :None
+******************************************************************************/
+static void Backlight_Mode(uint8_t m)
+{
+	uint32_t now = HAL_GetTick();
+
+	res_ms[mode] += now - mode_ms;
+	mode_ms = now;
+	if(m == BL_MODE_ON && asleep && !waking)
+	{
+		waking = 1;                     //Sleep Out no sooner than BL_WAKE_MS after Sleep In
+		Sched_TimerStart(&step_timer, BL_TASK, BL_SIG_STEP,
+		                 now - sleep_ms < BL_WAKE_MS ? BL_WAKE_MS - (now - sleep_ms) : 1, 0);
+	}
+	else if(m != mode && !asleep)
+		LCD_IdleMode(m == BL_MODE_DIM);
+	mode = m;
+	Backlight_Fade(m == BL_MODE_ON ? on_level : m == BL_MODE_DIM ? BL_LEVEL_DIM : 0);
+	Backlight_Arm();
+}
+
+/*****************************************************************************
+ * @name       :void Backlight_Init(void)
+ * @date       :2026-10-19
+ * @function   :Set up the TIM2 PWM on TFT_SW and fade the backlight in,
+                once the panel shows its first page
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Backlight_Init(void)
+{
+	TIM_OC_InitTypeDef oc = {0};
+
+	__HAL_RCC_AFIO_CLK_ENABLE();
+	__HAL_AFIO_REMAP_TIM2_PARTIAL_1();   //CH1 on PA15, CH2 on PB3 stays with SPI1 as it is not enabled
+	__HAL_RCC_TIM2_CLK_ENABLE();
+	htim_bl.Instance = TIM2;
+	top = Backlight_TimClk() / BL_PWM_HZ - 1;
+	htim_bl.Init.Prescaler = 0;
+	htim_bl.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim_bl.Init.Period = top;
+	htim_bl.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim_bl.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+	oc.OCMode = TIM_OCMODE_PWM1;
+	oc.OCPolarity = TIM_OCPOLARITY_HIGH;
+	pwm_ok = HAL_TIM_PWM_Init(&htim_bl) == HAL_OK && HAL_TIM_PWM_ConfigChannel(&htim_bl, &oc, TIM_CHANNEL_1) == HAL_OK;
+	if(!pwm_ok)
+	{
+		on_level = 100;                 //no dimming, the backlight only switches
+		dim_s = 0;
+	}
+	up = 1;
+	act_ms = HAL_GetTick();
+	mode_ms = act_ms;
+	window_ms = act_ms;
+	mode = BL_MODE_ON;
+	Backlight_Apply(0);
+	Backlight_Fade(on_level);
+	Backlight_Arm();
+}
+
+/*****************************************************************************
+ * @name       :void Backlight_Clock(void)
+ * @date       :2026-10-19
+ * @function   :Keep BL_PWM_HZ and the level after a clock profile switch:
+                new period and compare, loaded at once with an update event
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Backlight_Clock(void)
+{
+	if(!pwm_ok)
+		return;
+	top = Backlight_TimClk() / BL_PWM_HZ - 1;
+	__HAL_TIM_SET_AUTORELOAD(&htim_bl, top);
+	__HAL_TIM_SET_COMPARE(&htim_bl, TIM_CHANNEL_1, (uint32_t)level * level * (top + 1) / 10000);
+	htim_bl.Instance->EGR = TIM_EGR_UG;
+}
+
+/*****************************************************************************
+ * @name       :uint8_t Backlight_Wake(void)
+ * @date       :2026-10-19
+ * @function   :Note user activity: restart the idle timeout and bring a
+                dimmed or dark screen back
+ * @parameters :None
+ * @retvalue   :1 if the screen was dimmed or dark
+******************************************************************************/
+uint8_t Backlight_Wake(void)
+{
+	uint8_t was = mode;
+
+	if(!up)
+		return 0;
+	act_ms = HAL_GetTick();
+	if(was == BL_MODE_ON)
+		Backlight_Arm();
+	else
+		Backlight_Mode(BL_MODE_ON);
+	return was != BL_MODE_ON;
+}
+
+//the panel shows what is drawn, drawing can be skipped otherwise
+uint8_t Backlight_Visible(void)
+{
+	return mode != BL_MODE_OFF && !asleep && !waking;
+}
+
+/*****************************************************************************
+ * @name       :void Backlight_Process(uint8_t sig)
+ * @date       :2026-10-19
+ * @function   :Idle timeouts, fade steps and the panel wake in BL_TASK
+ * @parameters :sig:BL_SIG_IDLE or BL_SIG_STEP
+ * @retvalue   :None
+******************************************************************************/
+void Backlight_Process(uint8_t sig)
+{
+	if(!up)
+		return;
+	if(sig == BL_SIG_IDLE)
+	{
+		Backlight_Mode(next);
+		return;
+	}
+	if(waking == 1)
+	{
+		LCD_SleepOut();
+		LCD_IdleMode(0);
+		asleep = 0;
+		waking = 2;
+		Sched_TimerStart(&step_timer, BL_TASK, BL_SIG_STEP, BL_WAKE_MS, 0);
+		return;
+	}
+	if(waking == 2)
+	{
+		LCD_DisplayOn();
+		waking = 0;
+		Backlight_Fade(target);
+		return;
+	}
+	if(level < target)
+		Backlight_Apply(target - level > BL_FADE_STEP ? level + BL_FADE_STEP : target);
+	else if(level > target)
+		Backlight_Apply(level - target > BL_FADE_STEP ? level - BL_FADE_STEP : target);
+	if(level != target)
+		return;
+	Sched_TimerStop(&step_timer);
+	if(mode == BL_MODE_OFF && !asleep)
+	{
+		LCD_DisplayOff();
+		LCD_SleepIn();
+		sleep_ms = HAL_GetTick();
+		asleep = 1;
+	}
+}
+
+void Backlight_Command(const char *args)
+{
+	if(strncmp(args, "dim ", 4) == 0)
+		dim_s = (uint16_t)strtol(args + 4, NULL, 10);
+	else if(strncmp(args, "off ", 4) == 0)
+		off_s = (uint16_t)strtol(args + 4, NULL, 10);
+	else if(*args >= '1' && *args <= '9' && pwm_ok)
+	{
+		on_level = (uint8_t)(atoi(args) < 100 ? atoi(args) : 100);
+		if(mode == BL_MODE_ON)
+			Backlight_Fade(on_level);
+	}
+	if(*args)
+		Backlight_Wake();
+	Backlight_Report();
+}
+
+//estimated display current of a mode in uA
+static uint32_t Backlight_Ua(uint8_t m)
+{
+	uint32_t pct = m == BL_MODE_ON ? on_level : m == BL_MODE_DIM ? BL_LEVEL_DIM : 0;
+
+	if(m == BL_MODE_OFF)
+		return BL_UA_PANEL_SLEEP;
+	return (uint32_t)((uint64_t)BL_UA_LED * pct * pct / 10000) + (m == BL_MODE_DIM ? BL_UA_PANEL_IDLE : BL_UA_PANEL);
+}
+
+/*****************************************************************************
+ * @name       :void Backlight_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the settings, the time in each mode since the last
+                call with its estimated display current, and the average
+                saved against a screen always fully lit, then start a new
+                window
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Backlight_Report(void)
+{
+	static const char * const name[BL_MODE_NUM] = {"on", "dim", "off"};
+	uint32_t now = HAL_GetTick(), win = now - window_ms, ua, pm;
+	uint64_t charge = 0;
+	uint8_t i;
+
+	res_ms[mode] += now - mode_ms;
+	mode_ms = now;
+	if(win == 0)
+		win = 1;
+	printf("backlight %u%%, dim %u%% after %u s, off after %u s, now %s%s\r\n", on_level, BL_LEVEL_DIM,
+	       dim_s, off_s, name[mode], pwm ? " (PWM)" : "");
+	for(i = 0; i < BL_MODE_NUM; i++)
+	{
+		ua = Backlight_Ua(i);
+		pm = (uint32_t)((uint64_t)res_ms[i] * 1000 / win);
+		printf("%-4s %3lu.%lu%% %6lu uA\r\n", name[i], (unsigned long)(pm / 10), (unsigned long)(pm % 10),
+		       (unsigned long)ua);
+		charge += (uint64_t)res_ms[i] * ua;
+		res_ms[i] = 0;
+	}
+	ua = (uint32_t)(charge / win);
+	printf("est. display %lu uA, %lu uA saved over %lu ms\r\n", (unsigned long)ua,
+	       (unsigned long)(BL_UA_LED + BL_UA_PANEL - ua), (unsigned long)win);
+	window_ms = now;
+}
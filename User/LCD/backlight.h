@@ -0,0 +1,46 @@
+#ifndef __BACKLIGHT_H
+#define __BACKLIGHT_H
+#include "main.h"
+#include "sched.h"
+
+//Backlight and panel power. TFT_SW (PA15) drives the backlight from TIM2
+//CH1 (partial remap 1) at BL_PWM_HZ, brightness in percent on a square law
+//so the steps look even. Level changes fade in BL_FADE_STEP steps. After
+//BL_DIM_S without a key the screen dims and the ST7789 enters idle mode
+//(8 colours); after BL_OFF_S the backlight fades out and the panel goes to
+//Sleep In with its RAM kept. A key wakes it; the key that does is not
+//passed on. At 0 and 100 % the pin is a plain output and TIM2 is stopped,
+//in between LPM_LOCK_BL keeps the MCU out of Stop. The console "bl"
+//command reports time per mode and the display current it saves, from
+//the typical currents below (to be measured on the board).
+#define BL_TASK             SCHED_TASK_UI
+#define BL_SIG_IDLE         5       //idle timeout
+#define BL_SIG_STEP         6       //fade step or panel wake delay
+#define BL_PWM_HZ           20000   //every clock profile, Backlight_Clock() follows the switch
+#define BL_LEVEL_ON         100     //percent
+#define BL_LEVEL_DIM        20
+#define BL_DIM_S            30      //0: never
+#define BL_OFF_S            120
+#define BL_FADE_STEP        4       //percent per step
+#define BL_FADE_MS          20      //per step
+#define BL_WAKE_MS          120     //Sleep Out to Display On
+
+#define BL_UA_LED           20000   //backlight at 100 %
+#define BL_UA_PANEL         6000    //ST7789 and panel, normal mode
+#define BL_UA_PANEL_IDLE    3500    //idle mode
+#define BL_UA_PANEL_SLEEP   10      //Sleep In
+
+#define BL_MODE_ON          0
+#define BL_MODE_DIM         1
+#define BL_MODE_OFF         2
+#define BL_MODE_NUM         3
+
+void Backlight_Init(void);
+void Backlight_Clock(void);
+uint8_t Backlight_Wake(void);
+uint8_t Backlight_Visible(void);
+void Backlight_Process(uint8_t sig);
+void Backlight_Command(const char *args);
+void Backlight_Report(void);
+
+#endif
@@ -0,0 +1,126 @@
+#include "digit.h"
+#include "digitfont.h"
+#include <string.h>
+
+static const uint32_t digit_pow10[DIGIT_CELLS + 1] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+//k thirds of the way from bg to fg, per channel
+static u16 Digit_Blend(u16 fg, u16 bg, u8 k)
+{
+	int16_t r = bg >> 11, g = bg >> 5 & 0x3F, b = bg & 0x1F;
+
+	r += ((fg >> 11) - r) * k / 3;
+	g += ((fg >> 5 & 0x3F) - g) * k / 3;
+	b += ((fg & 0x1F) - b) * k / 3;
+	return r << 11 | g << 5 | b;
+}
+
+/*****************************************************************************
+ * @name       :void Digit_Init(digit_t *d, u16 x, u16 y, u8 cells, u8 frac, u16 fg, u16 bg)
+ * @date       :2026-10-19
+ * @function   :Set up a readout, nothing is drawn. Call again after the
+                page under it was redrawn so the next value sends all cells.
+ * @parameters :d:readout
+                x,y:top left
+                cells:digit cells, up to DIGIT_CELLS
+                frac:cells after the decimal point, less than cells
+                fg,bg:digit and background colour
+ * @retvalue   :None
+******************************************************************************/
+void Digit_Init(digit_t *d, u16 x, u16 y, u8 cells, u8 frac, u16 fg, u16 bg)
+{
+	u8 k;
+
+	d->x = x;
+	d->y = y;
+	d->cells = cells < DIGIT_CELLS ? cells : DIGIT_CELLS;
+	d->frac = frac < d->cells ? frac : d->cells - 1;
+	for(k = 0; k < 4; k++)
+		d->clut[k] = TILE_PX(Digit_Blend(fg, bg, k));
+	memset(d->shown, DIGIT_NONE, sizeof(d->shown));
+}
+
+u16 Digit_Width(const digit_t *d)
+{
+	return d->cells * DIGIT_W + (d->frac ? DIGIT_POINT_W : 0);
+}
+
+//unpack a glyph, valid until the next call
+static const u8 *Digit_Glyph(u8 g)
+{
+	static u8 bits[LAYER_BYTES(DIGIT_W, DIGIT_H, 2)];
+	u8 y;
+
+	for(y = 0; y < DIGIT_H; y++)
+		memcpy(&bits[y * LAYER_STRIDE(DIGIT_W, 2)], digit_rows[digit_font[g][y >> 1] >> (y & 1 ? 0 : 4) & 15],
+		       LAYER_STRIDE(DIGIT_W, 2));
+	return bits;
+}
+
+//send one cell, a glyph or background when bits is NULL
+static void Digit_Cell(digit_t *d, u16 x, u16 w, const u8 *bits)
+{
+	layer_t l;
+	tile_item_t item = {TILE_RECT, x, d->y, x + w - 1, d->y + DIGIT_H - 1, TILE_PX(d->clut[0]), &l};
+
+	if(bits)
+	{
+		Layer_Init(&l, x, d->y, w, DIGIT_H, 2, (u8 *)bits, d->clut);    //read only, nothing draws into it
+		item.type = TILE_LAYER;
+	}
+	Tile_Render(x, d->y, x + w - 1, d->y + DIGIT_H - 1, &item, 1);
+}
+
+/*****************************************************************************
+ * @name       :u8 Digit_Show(digit_t *d, int32_t v)
+ * @date       :2026-10-19
+ * @function   :Show a value, sending only the cells whose glyph changed.
+                Leading zeros before the point are blank, the minus sign
+                takes the last blank cell. A value that does not fit shows
+                minus signs in all cells.
+ * @parameters :d:readout
+                v:value in units of the last cell
+ * @retvalue   :cells sent
+******************************************************************************/
+u8 Digit_Show(digit_t *d, int32_t v)
+{
+	u8 g[DIGIT_CELLS], lead = d->cells - d->frac - 1, sent = 0, i, k, over;
+	uint32_t u = v < 0 ? -(uint32_t)v : (uint32_t)v, p;
+
+	over = u >= digit_pow10[d->cells];
+	if(!over)
+	{
+		for(i = 0; i < d->cells; i++)
+		{
+			p = digit_pow10[d->cells - 1 - i];
+			for(k = 0; u >= p; k++)
+				u -= p;
+			g[i] = k;
+		}
+		for(i = 0; i < lead && !g[i]; i++)
+			g[i] = DIGIT_BLANK;
+		if(v < 0)
+		{
+			if(i)
+				g[i - 1] = DIGIT_MINUS;
+			else
+				over = 1;           //no room for the sign
+		}
+	}
+	if(over)
+		memset(g, DIGIT_MINUS, d->cells);
+	if(d->frac && d->shown[0] == DIGIT_NONE)
+		Digit_Cell(d, d->x + (d->cells - d->frac) * DIGIT_W, DIGIT_POINT_W, digit_point);
+	for(i = 0; i < d->cells; i++)
+	{
+		if(g[i] == d->shown[i])
+			continue;
+		Digit_Cell(d, d->x + i * DIGIT_W + (d->frac && i >= d->cells - d->frac ? DIGIT_POINT_W : 0),
+		           DIGIT_W, g[i] == DIGIT_BLANK ? NULL : Digit_Glyph(g[i]));
+		d->shown[i] = g[i];
+		sent++;
+	}
+	return sent;
+}
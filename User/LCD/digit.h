@@ -0,0 +1,38 @@
+#ifndef __DIGIT_H
+#define __DIGIT_H
+#include "main.h"
+#include "layer.h"
+
+//Large digits for the main readouts. The font (digitfont.h, made by
+//Tools/digitgen.py) is 16 x 32 seven-segment glyphs at 2 bpp coverage,
+//kept as the distinct rows and a row number per glyph row, 0.3 KB of
+//flash. A cell is unpacked into RAM and goes out through the strip
+//renderer as a layer with a colour table blended from background to
+//foreground, so the edges are anti-aliased. A readout is a row of digit
+//cells with a fixed decimal point. It keeps the glyph shown in each cell
+//and re-sends only the cells that changed, a 16 x 32 cell being 1 KB on
+//the wire (0.26 ms at the full profile). Values are converted by
+//subtracting powers of ten, without divisions.
+#define DIGIT_W             16
+#define DIGIT_H             32
+#define DIGIT_POINT_W       8
+#define DIGIT_CELLS         9       //digits of a readout at most, the point not counted
+#define DIGIT_MINUS         10      //glyph index
+#define DIGIT_GLYPHS        11
+#define DIGIT_BLANK         0xFE    //cell shown as background
+#define DIGIT_NONE          0xFF    //cell not drawn yet
+
+typedef struct
+{
+	u16 x, y;                       //top left of the first cell
+	u8 cells;                       //digit cells
+	u8 frac;                        //cells after the point, 0 for no point
+	u16 clut[4];                    //background to foreground, panel byte order
+	u8 shown[DIGIT_CELLS];          //glyph in each cell, DIGIT_BLANK or DIGIT_NONE
+} digit_t;
+
+void Digit_Init(digit_t *d, u16 x, u16 y, u8 cells, u8 frac, u16 fg, u16 bg);
+u16 Digit_Width(const digit_t *d);
+u8 Digit_Show(digit_t *d, int32_t v);
+
+#endif
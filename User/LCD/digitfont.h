@@ -0,0 +1,36 @@
+//Large digit font for digit.c, generated by Tools/digitgen.py.
+//16x32, 2 bpp coverage, MSB first: the distinct rows of 0..9 and the
+//minus sign, the row numbers of each glyph two to a byte, high nibble
+//first, then the 8 px wide decimal point.
+#ifndef __DIGITFONT_H
+#define __DIGITFONT_H
+
+static const u8 digit_rows[14][LAYER_STRIDE(DIGIT_W, 2)] = {
+	0x00,0x00,0x00,0x00,0x00,0xBF,0xFE,0x00,0x02,0xFF,0xFF,0x80,0x08,0xBF,0xFE,0x20,
+	0x2E,0x00,0x00,0xB8,0x3F,0x00,0x00,0xFC,0x08,0x00,0x00,0x20,0x00,0x00,0x00,0x20,
+	0x00,0x00,0x00,0xB8,0x00,0x00,0x00,0xFC,0x00,0xBF,0xFE,0x20,0x08,0xBF,0xFE,0x00,
+	0x2E,0x00,0x00,0x00,0x3F,0x00,0x00,0x00,
+};
+
+static const u8 digit_font[DIGIT_GLYPHS][DIGIT_H / 2] = {
+	{0x01,0x23,0x45,0x55,0x55,0x55,0x54,0x60,0x64,0x55,0x55,0x55,0x55,0x54,0x32,0x10,},   //'0'
+	{0x00,0x07,0x89,0x99,0x99,0x99,0x98,0x70,0x78,0x99,0x99,0x99,0x99,0x98,0x70,0x00,},   //'1'
+	{0x01,0x2A,0x89,0x99,0x99,0x99,0x98,0xA2,0xBC,0xDD,0xDD,0xDD,0xDD,0xDC,0xB2,0x10,},   //'2'
+	{0x01,0x2A,0x89,0x99,0x99,0x99,0x98,0xA2,0xA8,0x99,0x99,0x99,0x99,0x98,0xA2,0x10,},   //'3'
+	{0x00,0x06,0x45,0x55,0x55,0x55,0x54,0x32,0xA8,0x99,0x99,0x99,0x99,0x98,0x70,0x00,},   //'4'
+	{0x01,0x2B,0xCD,0xDD,0xDD,0xDD,0xDC,0xB2,0xA8,0x99,0x99,0x99,0x99,0x98,0xA2,0x10,},   //'5'
+	{0x01,0x2B,0xCD,0xDD,0xDD,0xDD,0xDC,0xB2,0x34,0x55,0x55,0x55,0x55,0x54,0x32,0x10,},   //'6'
+	{0x01,0x2A,0x89,0x99,0x99,0x99,0x98,0x70,0x78,0x99,0x99,0x99,0x99,0x98,0x70,0x00,},   //'7'
+	{0x01,0x23,0x45,0x55,0x55,0x55,0x54,0x32,0x34,0x55,0x55,0x55,0x55,0x54,0x32,0x10,},   //'8'
+	{0x01,0x23,0x45,0x55,0x55,0x55,0x54,0x32,0xA8,0x99,0x99,0x99,0x99,0x98,0xA2,0x10,},   //'9'
+	{0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x12,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,},   //'-'
+};
+
+static const u8 digit_point[LAYER_BYTES(DIGIT_POINT_W, DIGIT_H, 2)] = {
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0B,0xE0,0x0B,0xE0,0x0B,0xE0,0x00,0x00,
+};
+
+#endif
@@ -0,0 +1,150 @@
+#include "frame.h"
+#include "lcd.h"
+#include "clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static frame_snap_t snap;
+static volatile uint32_t snap_lock;     //odd while a block is being written
+
+static sched_timer_t frame_timer;
+static frame_render render;
+static uint8_t fps = FRAME_FPS;
+static uint8_t fresh;                   //draw the next frame even without a new block
+static uint32_t shown_seq, last_ms;
+static uint32_t drawn, skipped, missed, retries, render_last, render_max;  //render times in 72 MHz cycles
+
+/*****************************************************************************
+ * @name       :void Frame_Publish(const acq_block_t *b)
+ * @date       :2026-10-19
+ * @function   :Make a block the latest snapshot. Never waits, a reader
+                that overlapped the write reads again.
+ * @parameters :b:finished block
+ * @retvalue   :None
+******************************************************************************/
+void Frame_Publish(const acq_block_t *b)
+{
+	snap_lock++;
+	__DMB();
+	memcpy(snap.val, b->val, sizeof(snap.val));
+	snap.load_ua = b->load_ua;
+	snap.seq = b->seq;
+	__DMB();
+	snap_lock++;
+}
+
+//consistent copy of the latest snapshot
+void Frame_Read(frame_snap_t *s)
+{
+	uint32_t q;
+
+	for(;;)
+	{
+		q = snap_lock;
+		__DMB();
+		*s = snap;
+		__DMB();
+		if(!(q & 1) && q == snap_lock)
+			return;
+		retries++;
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Frame_Start(frame_render fn)
+ * @date       :2026-10-19
+ * @function   :Start pacing frames for a page. The first frame follows at
+                once, then one per period of the target rate.
+ * @parameters :fn:draws a frame from a snapshot
+ * @retvalue   :None
+******************************************************************************/
+void Frame_Start(frame_render fn)
+{
+	render = fn;
+	fresh = 1;
+	last_ms = HAL_GetTick();
+	Sched_TimerStart(&frame_timer, FRAME_TASK, FRAME_SIG_TICK, 1000 / fps, 1000 / fps);
+	Sched_Signal(FRAME_TASK, FRAME_SIG_TICK);
+	Clock_Require(CLOCK_USER_PAGE, CLOCK_FULL);     //for the page's lifetime, not per frame
+}
+
+void Frame_Stop(void)
+{
+	Sched_TimerStop(&frame_timer);
+	if(render)
+		Clock_Require(CLOCK_USER_PAGE, CLOCK_IDLE);
+	render = NULL;
+}
+
+void Frame_SetRate(uint8_t rate)
+{
+	fps = rate < 1 ? 1 : rate > FRAME_FPS_MAX ? FRAME_FPS_MAX : rate;
+	if(render)
+		Sched_TimerStart(&frame_timer, FRAME_TASK, FRAME_SIG_TICK, 1000 / fps, 1000 / fps);
+}
+
+/*****************************************************************************
+ * @name       :void Frame_Process(void)
+ * @date       :2026-10-19
+ * @function   :Frame tick in FRAME_TASK: count the ticks lost since the
+                last one, take the snapshot and draw it if it holds a new
+                block
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Frame_Process(void)
+{
+	uint32_t now = HAL_GetTick(), period = 1000 / fps, k;
+	frame_snap_t s;
+
+	if(!render)
+		return;
+	k = (now - last_ms + period / 2) / period;
+	if(k > 1)
+		missed += k - 1;
+	last_ms = now;
+	Frame_Read(&s);
+	if(s.seq == shown_seq && !fresh)
+	{
+		skipped++;
+		return;
+	}
+	shown_seq = s.seq;
+	fresh = 0;
+	LCD_FrameStart();
+	render(&s);
+	render_last = LCD_FrameEnd();
+	if(render_last > render_max)
+		render_max = render_last;
+	drawn++;
+}
+
+void Frame_Command(const char *args)
+{
+	if(strncmp(args, "fps ", 4) == 0)
+		Frame_SetRate((uint8_t)strtol(args + 4, NULL, 10));
+	Frame_Report();
+}
+
+/*****************************************************************************
+ * @name       :void Frame_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the frame counters since the last call over stdout,
+                then clear them
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Frame_Report(void)
+{
+	printf("ui %u fps%s: %lu drawn, %lu no new block, %lu missed, %lu snapshot retries\r\n", fps,
+	       render ? "" : " (idle)", (unsigned long)drawn, (unsigned long)skipped, (unsigned long)missed,
+	       (unsigned long)retries);
+	printf("render last %lu us, max %lu us of %lu us\r\n", (unsigned long)(render_last / 72),
+	       (unsigned long)(render_max / 72), (unsigned long)(1000000 / fps));
+	drawn = 0;
+	skipped = 0;
+	missed = 0;
+	retries = 0;
+	render_max = 0;
+}
@@ -0,0 +1,38 @@
+#ifndef __FRAME_H
+#define __FRAME_H
+#include "main.h"
+#include "sched.h"
+#include "acq.h"
+
+//Frame-paced refresh of the live pages. Acquisition publishes every block
+//into a snapshot under a sequence lock; the UI task takes one consistent
+//copy per frame at the target rate and hands it to the page's render
+//function. Drawing thus runs at the frame rate however fast blocks come
+//in (31 per second), a slow frame never holds up acquisition, and a page
+//never mixes fields of two blocks. A frame without a new block is not
+//drawn; ticks lost while the UI task was busy count as missed frames.
+//Readers must run at task level: the lock only makes them retry.
+#define FRAME_TASK          SCHED_TASK_UI
+#define FRAME_SIG_TICK      4       //frame timer
+#define FRAME_FPS           4       //default target rate
+#define FRAME_FPS_MAX       25
+
+typedef struct
+{
+	int32_t val[ACQ_CH_NUM];        //calibrated, as acq_block_t
+	int32_t load_ua;
+	uint32_t seq;                   //acquisition block
+} frame_snap_t;
+
+typedef void (*frame_render)(const frame_snap_t *s);
+
+void Frame_Publish(const acq_block_t *b);
+void Frame_Read(frame_snap_t *s);
+void Frame_Start(frame_render fn);
+void Frame_Stop(void);
+void Frame_SetRate(uint8_t rate);
+void Frame_Process(void);
+void Frame_Command(const char *args);
+void Frame_Report(void);
+
+#endif
@@ -0,0 +1,208 @@
+#include "layer.h"
+#include "gui.h"
+
+static void Layer_Touch(layer_t *l, u16 x0, u16 y0, u16 x1, u16 y1)
+{
+	if(l->dx0 > l->dx1)
+	{
+		l->dx0 = x0;
+		l->dy0 = y0;
+		l->dx1 = x1;
+		l->dy1 = y1;
+		return;
+	}
+	if(x0 < l->dx0)
+		l->dx0 = x0;
+	if(y0 < l->dy0)
+		l->dy0 = y0;
+	if(x1 > l->dx1)
+		l->dx1 = x1;
+	if(y1 > l->dy1)
+		l->dy1 = y1;
+}
+
+/*****************************************************************************
+ * @name       :void Layer_Init(layer_t *l, u16 x, u16 y, u16 w, u16 h, u8 bpp, u8 *bits, u16 *clut)
+ * @date       :2026-10-19
+ * @function   :Set up a layer on caller-owned memory, opaque and all dirty.
+                The bitmap and the colour table are not cleared.
+ * @parameters :l:layer
+                x,y:panel position
+                w,h:size in pixels
+                bpp:2, 4 or 8
+                bits:LAYER_BYTES(w, h, bpp) bytes
+                clut:1 << bpp entries
+ * @retvalue   :None
+******************************************************************************/
+void Layer_Init(layer_t *l, u16 x, u16 y, u16 w, u16 h, u8 bpp, u8 *bits, u16 *clut)
+{
+	l->x = x;
+	l->y = y;
+	l->w = w;
+	l->h = h;
+	l->bpp = bpp;
+	l->stride = LAYER_STRIDE(w, bpp);
+	l->key = LAYER_OPAQUE;
+	l->bits = bits;
+	l->clut = clut;
+	l->dx0 = 0;
+	l->dy0 = 0;
+	l->dx1 = w - 1;
+	l->dy1 = h - 1;
+}
+
+//the next flush redraws the layer where the index is used
+void Layer_Color(layer_t *l, u8 i, u16 color)
+{
+	l->clut[i] = TILE_PX(color);
+	Layer_Touch(l, 0, 0, l->w - 1, l->h - 1);
+}
+
+static void Layer_Set(layer_t *l, u8 *p, u16 x, u8 i)
+{
+	u8 bpp = l->bpp, mask = (1 << bpp) - 1, sh = 8 - bpp - (x * bpp & 7);
+
+	p += x * bpp >> 3;
+	*p = (*p & ~(mask << sh)) | (i & mask) << sh;
+}
+
+/*****************************************************************************
+ * @name       :void Layer_Fill(layer_t *l, u16 x0, u16 y0, u16 x1, u16 y1, u8 i)
+ * @date       :2026-10-19
+ * @function   :Fill a rectangle with an index, whole bytes at a time inside
+                the span
+ * @parameters :l:layer
+                x0,y0,x1,y1:rectangle in layer coordinates, inclusive,
+                clipped to the layer
+                i:colour index
+ * @retvalue   :None
+******************************************************************************/
+void Layer_Fill(layer_t *l, u16 x0, u16 y0, u16 x1, u16 y1, u8 i)
+{
+	u8 per = 8 / l->bpp, fill = i, k, *p;
+	u16 x, y;
+
+	if(x1 >= l->w)
+		x1 = l->w - 1;
+	if(y1 >= l->h)
+		y1 = l->h - 1;
+	if(x0 > x1 || y0 > y1)
+		return;
+	for(k = l->bpp; k < 8; k <<= 1)
+		fill |= fill << k;
+	for(y = y0; y <= y1; y++)
+	{
+		p = l->bits + y * l->stride;
+		for(x = x0; x <= x1 && x % per; x++)
+			Layer_Set(l, p, x, i);
+		for(; x + per - 1 <= x1; x += per)
+			p[x / per] = fill;
+		for(; x <= x1; x++)
+			Layer_Set(l, p, x, i);
+	}
+	Layer_Touch(l, x0, y0, x1, y1);
+}
+
+void Layer_Pixel(layer_t *l, u16 x, u16 y, u8 i)
+{
+	if(x >= l->w || y >= l->h)
+		return;
+	Layer_Set(l, l->bits + y * l->stride, x, i);
+	Layer_Touch(l, x, y, x, y);
+}
+
+/*****************************************************************************
+ * @name       :u16 Layer_Text(layer_t *l, u16 x, u16 y, const char *s, u8 i)
+ * @date       :2026-10-19
+ * @function   :Draw 16 px text into the layer, transparent, clipped to the
+                layer
+ * @parameters :l:layer
+                x,y:top left in layer coordinates
+                s:ASCII text
+                i:colour index
+ * @retvalue   :x after the text
+******************************************************************************/
+u16 Layer_Text(layer_t *l, u16 x, u16 y, const char *s, u8 i)
+{
+	const u8 *g, *t = (const u8 *)s;
+	u16 x0 = x, r, bits, j;
+
+	for(; *t && x < l->w; t++, x += 8)
+	{
+		g = GUI_Glyph16(*t);
+		if(!g)
+			continue;
+		for(r = 0; r < 16 && y + r < l->h; r++)
+		{
+			bits = __RBIT(g[r]) >> 16;     //glyph rows are LSB first
+			for(j = x; bits && j < l->w; bits <<= 1, j++)
+				if(bits & 0x8000)
+					Layer_Set(l, l->bits + (y + r) * l->stride, j, i);
+		}
+	}
+	if(x > x0 && y < l->h)
+		Layer_Touch(l, x0, y, (x < l->w ? x : l->w) - 1, y + 15 < l->h ? y + 15 : l->h - 1);
+	return x;
+}
+
+/*****************************************************************************
+ * @name       :void Layer_Expand(const layer_t *l, u16 lx, u16 ly, u16 n, u16 *dst)
+ * @date       :2026-10-19
+ * @function   :Expand part of a layer line through the colour table into a
+                strip, leaving the pixels of the transparent index alone
+ * @parameters :l:layer
+                lx,ly:first pixel in layer coordinates
+                n:number of pixels, within the line
+                dst:strip pixels
+ * @retvalue   :None
+******************************************************************************/
+void Layer_Expand(const layer_t *l, u16 lx, u16 ly, u16 n, u16 *dst)
+{
+	const u8 *p = l->bits + ly * l->stride;
+	const u16 *clut = l->clut;
+	u8 bpp = l->bpp, mask = (1 << bpp) - 1, sh, i;
+	u16 key = l->key;
+
+	if(bpp == 8)
+	{
+		for(p += lx; n; n--, dst++)
+			if((i = *p++) != key)
+				*dst = clut[i];
+		return;
+	}
+	p += lx * bpp >> 3;
+	sh = 8 - bpp - (lx * bpp & 7);
+	for(; n; n--, dst++)
+	{
+		i = *p >> sh & mask;
+		if(i != key)
+			*dst = clut[i];
+		if(sh)
+			sh -= bpp;
+		else
+		{
+			sh = 8 - bpp;
+			p++;
+		}
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Layer_Flush(layer_t *l, const tile_item_t *item, u8 n)
+ * @date       :2026-10-19
+ * @function   :Send the dirty part of the layer to the panel through the
+                strip renderer, nothing when the layer is unchanged
+ * @parameters :l:layer
+                item:draw list of everything at the layer's place, the
+                layer included (under and over it, panel coordinates)
+                n:number of items
+ * @retvalue   :None
+******************************************************************************/
+void Layer_Flush(layer_t *l, const tile_item_t *item, u8 n)
+{
+	if(l->dx0 > l->dx1)
+		return;
+	Tile_Render(l->x + l->dx0, l->y + l->dy0, l->x + l->dx1, l->y + l->dy1, item, n);
+	l->dx0 = 1;
+	l->dx1 = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef __LAYER_H
+#define __LAYER_H
+#include "main.h"
+#include "tile.h"
+
+//Palette-indexed offscreen layers. A widget keeps its own retained bitmap
+//at 2, 4 or 8 bits per pixel with a colour table of 1 << bpp entries, and
+//draws into it by index; the strip renderer expands it to RGB565 only
+//while rasterising a strip (TILE_LAYER item). A 135 x 40 widget is 1.4 KB
+//at 2 bpp against 10.8 KB in RGB565. Pixels are packed MSB first, lines
+//start on a byte. Index key is transparent, so a layer can overlay other
+//items. Drawing grows a dirty box, Layer_Flush() sends just that part.
+#define LAYER_OPAQUE        0xFFFF  //no transparent index
+#define LAYER_STRIDE(w, bpp)    (((w) * (bpp) + 7) / 8)
+#define LAYER_BYTES(w, h, bpp)  (LAYER_STRIDE(w, bpp) * (h))
+
+typedef struct
+{
+	u16 x, y;                       //panel position of the top left pixel
+	u16 w, h;
+	u8 bpp;                         //2, 4 or 8
+	u16 stride;                     //bytes per line
+	u16 key;                        //transparent index or LAYER_OPAQUE
+	u8 *bits;                       //LAYER_BYTES(w, h, bpp)
+	u16 *clut;                      //1 << bpp entries in panel byte order
+	u16 dx0, dy0, dx1, dy1;         //dirty box in layer coordinates, empty when dx0 > dx1
+} layer_t;
+
+void Layer_Init(layer_t *l, u16 x, u16 y, u16 w, u16 h, u8 bpp, u8 *bits, u16 *clut);
+void Layer_Color(layer_t *l, u8 i, u16 color);
+void Layer_Fill(layer_t *l, u16 x0, u16 y0, u16 x1, u16 y1, u8 i);
+void Layer_Pixel(layer_t *l, u16 x, u16 y, u8 i);
+u16 Layer_Text(layer_t *l, u16 x, u16 y, const char *s, u8 i);
+void Layer_Expand(const layer_t *l, u16 lx, u16 ly, u16 n, u16 *dst);
+void Layer_Flush(layer_t *l, const tile_item_t *item, u8 n);
+
+#endif
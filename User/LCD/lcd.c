@@ -46,6 +46,8 @@
 **************************************************************************************************/	
 #include "lcd.h"
 #include "stdlib.h"
+#include <stdio.h>
+#include <string.h>
 //#include "delay.h"	 
 //#include "spi.h"
 #include "main.h"
@@ -55,6 +57,14 @@ extern 	 SPI_HandleTypeDef hspi1;
 //ĬΪ
 _lcd_dev lcddev;
 
+#define LCD_CLEAR_CHUNK 64	//pixels per SPI call in LCD_PushColor()
+#define LCD_REF_HZ 72000000	//wire and draw time are counted in cycles of the full core clock
+
+lcd_stat_t lcd_stat;	//traffic since the last LCD_Report()
+static lcd_stat_t frame_at,frame_last;
+static u32 frame_cyc,frame_draw,frame_worst,frames;
+static u32 byte_cyc;	//wire time of a byte in LCD_REF_HZ cycles, at the last frame's SPI1 clock
+
 //ɫ,ɫ
 u16 POINT_COLOR = 0x0000,BACK_COLOR = 0xFFFF;  
 u16 DeviceCode;	 
@@ -74,6 +84,8 @@ void LCD_WR_REG(u8 data)
 	HAL_SPI_Transmit(&hspi1,&data,1,0xffff);
 //	HAL_SPI_Transmit_DMA(&hspi1,&data,1);
    LCD_CS_SET;	
+	LCD_Count(1);
+	lcd_stat.cmds++;
 }
 
 /*****************************************************************************
@@ -91,6 +103,7 @@ void LCD_WR_DATA(u8 data)
 	HAL_SPI_Transmit(&hspi1,&data,1,0xffff);
 //	HAL_SPI_Transmit_DMA(&hspi1,&data,1);
    LCD_CS_SET;
+	LCD_Count(1);
 }
 
 /*****************************************************************************
@@ -139,6 +152,8 @@ void Lcd_WriteData_16Bit(u16 Data)
 //	HAL_SPI_Transmit_DMA(&hspi1,&data_h,1);
 //	HAL_SPI_Transmit_DMA(&hspi1,&data_l,1);
    LCD_CS_SET;
+	LCD_Count(1);
+	LCD_Count(1);
 }
 
 /*****************************************************************************
@@ -164,26 +179,8 @@ void LCD_DrawPoint(u16 x,u16 y)
 ******************************************************************************/	
 void LCD_Clear(u16 Color)
 {
-  unsigned int i,m; 
-	u8 color_h = Color >>8;
-	u8 color_l = Color ;
-	
-	LCD_SetWindows(0,0,lcddev.width-1,lcddev.height-1);   
-	LCD_CS_CLR;
-	LCD_RS_SET;
-	for(i=0;i<lcddev.height;i++)
-	{
-		for(m=0;m<lcddev.width;m++)
-		{	
-//			SPI_WriteByte(SPI1,Color>>8);
-//			SPI_WriteByte(SPI1,Color);
-			HAL_SPI_Transmit(&hspi1,&color_h,1,0xffff);
-			HAL_SPI_Transmit(&hspi1,&color_l,1,0xffff);
-//			HAL_SPI_Transmit_DMA(&hspi1,&color_h,1);
-//			HAL_SPI_Transmit_DMA(&hspi1,&color_l,1);
-		}
-	}
-	 LCD_CS_SET;
+	LCD_SetWindows(0,0,lcddev.width-1,lcddev.height-1);
+	LCD_PushColor(Color,(u32)lcddev.width*lcddev.height);
 } 
 
 /*****************************************************************************
@@ -205,115 +202,265 @@ void LCD_GPIOInit(void)
 }
 
 /*****************************************************************************
- * @name       :void LCD_RESET(void)
- * @date       :2018-08-09 
- * @function   :Reset LCD screen
+ * @name       :void LCD_ResetStart(void)
+ * @date       :2026-10-19
+ * @function   :Pull the reset line low. The boot sequence does other work
+                while the pulse and the recovery time run.
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/	
-void LCD_RESET(void)
+void LCD_ResetStart(void)
 {
+	LCD_GPIOInit();
 	LCD_RST_CLR;
-	HAL_Delay(20);	
+}
+
+void LCD_ResetEnd(void)
+{
 	LCD_RST_SET;
-	HAL_Delay(20);
 }
 
+//ST7789 set-up: command, number of parameters, parameters
+static const u8 lcd_init_regs[] = {
+	0x36, 1, 0x00,
+	0x3A, 1, 0x05,
+	0xB2, 5, 0x0C, 0x0C, 0x00, 0x33, 0x33,
+	0xB7, 1, 0x35,
+	0xBB, 1, 0x19,
+	0xC0, 1, 0x2C,
+	0xC2, 1, 0x01,
+	0xC3, 1, 0x12,
+	0xC4, 1, 0x20,
+	0xC6, 1, 0x0F,
+	0xD0, 2, 0xA4, 0xA1,
+	0xE0, 14, 0xD0, 0x04, 0x0D, 0x11, 0x13, 0x2B, 0x3F, 0x54, 0x4C, 0x18, 0x0D, 0x0B, 0x1F, 0x23,
+	0xE1, 14, 0xD0, 0x04, 0x0C, 0x11, 0x13, 0x2C, 0x3F, 0x44, 0x51, 0x2F, 0x1F, 0x1F, 0x20, 0x23,
+	0x21, 0,
+	0x11, 0,
+};
+
 /*****************************************************************************
- * @name       :void LCD_RESET(void)
- * @date       :2018-08-09 
- * @function   :Initialization LCD screen
+ * @name       :void LCD_InitRegs(void)
+ * @date       :2026-10-19
+ * @function   :ST7789 register set-up, ends with Sleep Out. RAM may be
+                written 5 ms later, the display should stay off for 120 ms.
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/	 	 
-void LCD_Init(void)
-{  
-//	SPI1_Init(); //ӲSPI1ʼ
-	LCD_GPIOInit();//LCD GPIOʼ										 
- 	LCD_RESET(); //LCD λ
-//************* ST7789ʼ**********//	
-	LCD_WR_REG(0x36); 
-	LCD_WR_DATA(0x00);
-
-	LCD_WR_REG(0x3A); 
-	LCD_WR_DATA(0x05);
-
-	LCD_WR_REG(0xB2);
-	LCD_WR_DATA(0x0C);
-	LCD_WR_DATA(0x0C);
-	LCD_WR_DATA(0x00);
-	LCD_WR_DATA(0x33);
-	LCD_WR_DATA(0x33);
-
-	LCD_WR_REG(0xB7); 
-	LCD_WR_DATA(0x35);  
-
-	LCD_WR_REG(0xBB);
-	LCD_WR_DATA(0x19);
-
-	LCD_WR_REG(0xC0);
-	LCD_WR_DATA(0x2C);
-
-	LCD_WR_REG(0xC2);
-	LCD_WR_DATA(0x01);
-
-	LCD_WR_REG(0xC3);
-	LCD_WR_DATA(0x12);   
-
-	LCD_WR_REG(0xC4);
-	LCD_WR_DATA(0x20);  
-
-	LCD_WR_REG(0xC6); 
-	LCD_WR_DATA(0x0F);    
-
-	LCD_WR_REG(0xD0); 
-	LCD_WR_DATA(0xA4);
-	LCD_WR_DATA(0xA1);
-
-	LCD_WR_REG(0xE0);
-	LCD_WR_DATA(0xD0);
-	LCD_WR_DATA(0x04);
-	LCD_WR_DATA(0x0D);
-	LCD_WR_DATA(0x11);
-	LCD_WR_DATA(0x13);
-	LCD_WR_DATA(0x2B);
-	LCD_WR_DATA(0x3F);
-	LCD_WR_DATA(0x54);
-	LCD_WR_DATA(0x4C);
-	LCD_WR_DATA(0x18);
-	LCD_WR_DATA(0x0D);
-	LCD_WR_DATA(0x0B);
-	LCD_WR_DATA(0x1F);
-	LCD_WR_DATA(0x23);
-
-	LCD_WR_REG(0xE1);
-	LCD_WR_DATA(0xD0);
-	LCD_WR_DATA(0x04);
-	LCD_WR_DATA(0x0C);
-	LCD_WR_DATA(0x11);
-	LCD_WR_DATA(0x13);
-	LCD_WR_DATA(0x2C);
-	LCD_WR_DATA(0x3F);
-	LCD_WR_DATA(0x44);
-	LCD_WR_DATA(0x51);
-	LCD_WR_DATA(0x2F);
-	LCD_WR_DATA(0x1F);
-	LCD_WR_DATA(0x1F);
-	LCD_WR_DATA(0x20);
-	LCD_WR_DATA(0x23);
-
-	LCD_WR_REG(0x21); 
-
-	LCD_WR_REG(0x11); 
-	//Delay (120); 
-
-	LCD_WR_REG(0x29); 	
-  LCD_direction(USE_HORIZONTAL);//LCDʾ
-	LCD_LED_On;//
-//	LCD_CS_CLR;//  add
-	LCD_Clear(BLACK);//ȫɫ
+void LCD_InitRegs(void)
+{
+	const u8 *p = lcd_init_regs;
+	u8 n;
+
+	while(p < lcd_init_regs + sizeof(lcd_init_regs))
+	{
+		LCD_WR_REG(*p++);
+		for(n = *p++; n; n--)
+			LCD_WR_DATA(*p++);
+	}
+}
+
+void LCD_DisplayOn(void)
+{
+	LCD_WR_REG(0x29);
+}
+
+void LCD_DisplayOff(void)
+{
+	LCD_WR_REG(0x28);
 }
- 
+
+//Sleep In: the panel keeps its RAM, no command for 5 ms after it and no
+//Sleep Out within 120 ms
+void LCD_SleepIn(void)
+{
+	LCD_WR_REG(0x10);
+}
+
+//Sleep Out: RAM writes after 5 ms, Display On after 120 ms
+void LCD_SleepOut(void)
+{
+	LCD_WR_REG(0x11);
+}
+
+//Idle mode: 8 colours, the MSB of each channel, at less panel current
+void LCD_IdleMode(u8 on)
+{
+	LCD_WR_REG(on ? 0x39 : 0x38);
+}
+/*****************************************************************************
+ * @name       :void LCD_ScrollArea(u16 top, u16 lines)
+ * @date       :2026-10-19
+ * @function   :Define the vertical scrolling area (VSCRDEF): top fixed
+                lines, then the scrolling lines, the rest of the frame
+                memory stays fixed. LCD_ScrollArea(0, LCD_GRAM_LINES) with
+                LCD_ScrollStart(0) is the normal display.
+ * @parameters :top:fixed frame memory lines above the area
+                lines:lines in the area
+ * @retvalue   :None
+******************************************************************************/
+void LCD_ScrollArea(u16 top, u16 lines)
+{
+	u16 bottom = LCD_GRAM_LINES - top - lines;
+
+	LCD_WR_REG(0x33);
+	LCD_WR_DATA(top>>8);
+	LCD_WR_DATA(top);
+	LCD_WR_DATA(lines>>8);
+	LCD_WR_DATA(lines);
+	LCD_WR_DATA(bottom>>8);
+	LCD_WR_DATA(bottom);
+}
+/*****************************************************************************
+ * @name       :void LCD_ScrollStart(u16 line)
+ * @date       :2026-10-19
+ * @function   :Frame memory line shown at the top of the scrolling area
+                (VSCSAD), top <= line < top + lines
+ * @parameters :line:frame memory line
+ * @retvalue   :None
+******************************************************************************/
+void LCD_ScrollStart(u16 line)
+{
+	LCD_WR_REG(0x37);
+	LCD_WR_DATA(line>>8);
+	LCD_WR_DATA(line);
+}
+/*****************************************************************************
+ * @name       :void LCD_PushPixels(const u8 *buf, u16 n)
+ * @date       :2026-10-19
+ * @function   :Send pixels to the window opened by LCD_SetWindows() in a
+                single SPI transfer
+ * @parameters :buf:RGB565 pixels, high byte first
+                n:number of pixels
+ * @retvalue   :None
+******************************************************************************/
+void LCD_PushPixels(const u8 *buf, u16 n)
+{
+	LCD_CS_CLR;
+	LCD_RS_SET;
+	HAL_SPI_Transmit(&hspi1,(u8 *)buf,n*2,0xffff);
+	LCD_CS_SET;
+	LCD_Count(n*2);
+}
+
+/*****************************************************************************
+ * @name       :void LCD_PushColor(u16 color, u32 n)
+ * @date       :2026-10-19
+ * @function   :Send one colour to the window opened by LCD_SetWindows(),
+                LCD_CLEAR_CHUNK pixels per SPI call
+ * @parameters :color:RGB565 colour
+                n:number of pixels
+ * @retvalue   :None
+******************************************************************************/
+void LCD_PushColor(u16 color, u32 n)
+{
+	u8 buf[LCD_CLEAR_CHUNK*2];
+	u16 i,k = n < LCD_CLEAR_CHUNK ? n : LCD_CLEAR_CHUNK;
+
+	for(i=0;i<k;i++)
+	{
+		buf[2*i] = color>>8;
+		buf[2*i+1] = color;
+	}
+	LCD_CS_CLR;
+	LCD_RS_SET;
+	while(n)
+	{
+		k = n < LCD_CLEAR_CHUNK ? n : LCD_CLEAR_CHUNK;
+		HAL_SPI_Transmit(&hspi1,buf,k*2,0xffff);	//whole chunks instead of one call per byte
+		LCD_Count(k*2);
+		n -= k;
+	}
+	LCD_CS_SET;
+}
+
+/*****************************************************************************
+ * @name       :void LCD_Count(u32 n)
+ * @date       :2026-10-19
+ * @function   :Count one SPI transfer to the panel. Called by every path
+                that sends to the panel, DMA included, so it only adds.
+ * @parameters :n:bytes sent
+ * @retvalue   :None
+******************************************************************************/
+void LCD_Count(u32 n)
+{
+	lcd_stat.xfers++;
+	lcd_stat.bytes += n;
+}
+
+//8 SCK periods per byte at the current SPI1 prescaler
+static void LCD_WireRate(void)
+{
+	u32 br = (hspi1.Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos;
+
+	byte_cyc = (1UL << (4 + br)) * (LCD_REF_HZ / HAL_RCC_GetPCLK2Freq());
+}
+
+void LCD_FrameStart(void)
+{
+	LCD_WireRate();
+	frame_at = lcd_stat;
+	frame_cyc = DWT->CYCCNT;
+}
+
+/*****************************************************************************
+ * @name       :u32 LCD_FrameEnd(void)
+ * @date       :2026-10-19
+ * @function   :Close a frame opened by LCD_FrameStart(), keeping its traffic
+                and draw time as the last frame and the longest draw time
+ * @parameters :None
+ * @retvalue   :draw time in LCD_REF_HZ cycles
+******************************************************************************/
+u32 LCD_FrameEnd(void)
+{
+	frame_draw = (DWT->CYCCNT - frame_cyc) * (LCD_REF_HZ / SystemCoreClock);
+	if(frame_draw > frame_worst)
+		frame_worst = frame_draw;
+	frame_last.xfers = lcd_stat.xfers - frame_at.xfers;
+	frame_last.bytes = lcd_stat.bytes - frame_at.bytes;
+	frame_last.cmds = lcd_stat.cmds - frame_at.cmds;
+	frame_last.windows = lcd_stat.windows - frame_at.windows;
+	frames++;
+	return frame_draw;
+}
+
+//reference cycles as milliseconds with one decimal
+static void LCD_PrintMs(const char *name, uint64_t cyc)
+{
+	u32 t = (u32)(cyc / (LCD_REF_HZ / 10000));
+
+	printf("%s %lu.%lu ms", name, (unsigned long)(t / 10), (unsigned long)(t % 10));
+}
+
+/*****************************************************************************
+ * @name       :void LCD_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the panel traffic since the last call, the last frame
+                and the longest frame over stdout, then start a new window.
+                Wire time is what the bytes take at the SPI clock; draw time
+                well above it is spent in the CPU or between transfers.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void LCD_Report(void)
+{
+	if(frames == 0)
+		LCD_WireRate();
+	printf("%lu frames, %lu xfers, %lu bytes, %lu cmds, %lu windows,", (unsigned long)frames,
+	       (unsigned long)lcd_stat.xfers, (unsigned long)lcd_stat.bytes,
+	       (unsigned long)lcd_stat.cmds, (unsigned long)lcd_stat.windows);
+	LCD_PrintMs(" wire", (uint64_t)lcd_stat.bytes * byte_cyc);
+	printf("\r\nlast frame %lu xfers, %lu bytes, %lu windows,", (unsigned long)frame_last.xfers,
+	       (unsigned long)frame_last.bytes, (unsigned long)frame_last.windows);
+	LCD_PrintMs(" wire", (uint64_t)frame_last.bytes * byte_cyc);
+	LCD_PrintMs(", draw", frame_draw);
+	LCD_PrintMs("\r\nlongest draw", frame_worst);
+	printf("\r\n");
+	memset(&lcd_stat, 0, sizeof(lcd_stat));
+	frame_worst = 0;
+	frames = 0;
+}
+
 /*****************************************************************************
  * @name       :void LCD_SetWindows(u16 xStar, u16 yStar,u16 xEnd,u16 yEnd)
  * @date       :2018-08-09 
@@ -326,6 +473,7 @@ void LCD_Init(void)
 ******************************************************************************/ 
 void LCD_SetWindows(u16 xStar, u16 yStar,u16 xEnd,u16 yEnd)
 {	
+	lcd_stat.windows++;
 	LCD_WR_REG(lcddev.setxcmd);	
 	LCD_WR_DATA(xStar>>8);
 	LCD_WR_DATA(xStar);		
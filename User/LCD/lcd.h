@@ -67,6 +67,20 @@ typedef struct
 
 //LCD
 extern _lcd_dev lcddev;	//LCDҪ
+
+//Panel traffic, counted on every transfer so a change to a drawing routine
+//shows up as bytes and modelled wire time (console "lcd"). Only the bytes
+//are counted on the way; they become wire time when reported, at the SPI1
+//clock the last frame was drawn with.
+typedef struct
+{
+	u32 xfers;			//SPI transfers, DMA included
+	u32 bytes;			//bytes on the wire, commands included
+	u32 cmds;			//command bytes
+	u32 windows;		//LCD_SetWindows() calls
+}lcd_stat_t;
+
+extern lcd_stat_t lcd_stat;
 /////////////////////////////////////û///////////////////////////////////	 
 #define USE_HORIZONTAL  	 0 //Һ˳ʱת 	0-0ת1-90ת2-180ת3-270ת
 
@@ -80,6 +94,7 @@ extern _lcd_dev lcddev;	//
 
 #define LCD_W 135		//TFT 1.14
 #define LCD_H 240
+#define LCD_GRAM_LINES 320	//ST7789 frame memory lines, VSCRDEF counts the whole memory
 
 //#define LCD_W 80		//TFT 0.96
 //#define LCD_H 160
@@ -163,9 +178,22 @@ extern u16  BACK_COLOR; //
 #define LGRAYBLUE      	0XA651 //ǳɫ(мɫ)
 #define LBBLUE          0X2B12 //ǳɫ(ѡĿķɫ)
 	    															  
-void LCD_Init(void);
+void LCD_ResetStart(void);
+void LCD_ResetEnd(void);
+void LCD_InitRegs(void);
 void LCD_DisplayOn(void);
 void LCD_DisplayOff(void);
+void LCD_SleepIn(void);
+void LCD_SleepOut(void);
+void LCD_IdleMode(u8 on);
+void LCD_ScrollArea(u16 top, u16 lines);
+void LCD_ScrollStart(u16 line);
+void LCD_PushPixels(const u8 *buf, u16 n);
+void LCD_PushColor(u16 color, u32 n);
+void LCD_Count(u32 n);
+void LCD_FrameStart(void);
+u32 LCD_FrameEnd(void);
+void LCD_Report(void);
 void LCD_Clear(u16 Color);	 
 void LCD_SetCursor(u16 Xpos, u16 Ypos);
 void LCD_DrawPoint(u16 x,u16 y);//
@@ -0,0 +1,67 @@
+#include "rle.h"
+#include <string.h>
+
+void Rle_Begin(rle_dec_t *d, const rle_image_t *img)
+{
+	d->p = img->data;
+	d->n = 0;
+}
+
+/*****************************************************************************
+ * @name       :void Rle_Read(rle_dec_t *d, u16 *dst, u32 n)
+ * @date       :2026-10-19
+ * @function   :Decode the next pixels of the stream, literals are copied
+                as they are stored
+ * @parameters :d:decoder
+                dst:pixels in panel byte order, NULL skips them
+                n:number of pixels
+ * @retvalue   :None
+******************************************************************************/
+void Rle_Read(rle_dec_t *d, u16 *dst, u32 n)
+{
+	u16 k;
+	u8 c;
+
+	while(n)
+	{
+		if(!d->n)
+		{
+			c = *d->p++;
+			d->run = c >> 7;
+			if(d->run)
+			{
+				d->n = (c & 0x7F) + RLE_RUN_MIN;
+				memcpy(&d->px, d->p, 2);
+				d->p += 2;
+			}
+			else
+				d->n = c + 1;
+		}
+		k = d->n < n ? d->n : n;
+		d->n -= k;
+		n -= k;
+		if(d->run)
+		{
+			if(dst)
+				for(; k; k--)
+					*dst++ = d->px;
+		}
+		else
+		{
+			if(dst)
+			{
+				memcpy(dst, d->p, k * 2);
+				dst += k;
+			}
+			d->p += k * 2;
+		}
+	}
+}
+
+//draw an image through the strip renderer
+void Rle_Draw(u16 x, u16 y, const rle_image_t *img)
+{
+	const tile_item_t item = {TILE_IMAGE, x, y, x + img->w - 1, y + img->h - 1, 0, img};
+
+	Tile_Render(x, y, x + img->w - 1, y + img->h - 1, &item, 1);
+}
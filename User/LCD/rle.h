@@ -0,0 +1,35 @@
+#ifndef __RLE_H
+#define __RLE_H
+#include "main.h"
+#include "tile.h"
+
+//Run-length compressed RGB565 images, made offline by Tools/rleconv.py.
+//The image is one PackBits stream over pixels in panel byte order, runs
+//may cross lines. A control byte c < 0x80 is followed by c + 1 literal
+//pixels, c >= 0x80 by one pixel repeated (c & 0x7F) + 2 times. The decoder
+//keeps its place, so the strip renderer (TILE_IMAGE) streams an image into
+//the strip buffers strip by strip and never sees more than one line.
+//Flat UI graphics shrink a lot, dithered or anti-aliased icons less
+//(gImage_qq: 3200 -> 2309 bytes).
+#define RLE_LIT_MAX         128
+#define RLE_RUN_MIN         2
+
+typedef struct
+{
+	u16 w, h;
+	const u8 *data;
+} rle_image_t;
+
+typedef struct
+{
+	const u8 *p;                    //next byte of the stream
+	u16 n;                          //pixels left in the current record
+	u8 run;                         //record is a run of px
+	u16 px;                         //run pixel, panel byte order
+} rle_dec_t;
+
+void Rle_Begin(rle_dec_t *d, const rle_image_t *img);
+void Rle_Read(rle_dec_t *d, u16 *dst, u32 n);
+void Rle_Draw(u16 x, u16 y, const rle_image_t *img);
+
+#endif
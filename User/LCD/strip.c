@@ -0,0 +1,309 @@
+#include "strip.h"
+#include "lcd.h"
+#include "gui.h"
+#include "clock.h"
+#include <stdio.h>
+
+#define STRIP_BG            BLACK
+#define STRIP_GRID          GRAY2
+
+typedef struct
+{
+	const char *name;
+	const char *unit;
+	u16 color;
+	int32_t div_min;                //smallest division, keeps noise from filling the plot
+} strip_trace_t;
+
+static const strip_trace_t trace[STRIP_TRACES] = {{"I", "mA", YELLOW, 10}, {"U", "mV", GREEN, 50}};
+
+static strip_env_t env[STRIP_HIST][STRIP_TRACES];     //by line number % STRIP_HIST
+static strip_env_t acc[STRIP_TRACES];                  //line being collected
+static uint8_t acc_used;            //traces with a sample in acc
+static uint8_t acc_n;               //blocks in acc
+static uint32_t lines;              //lines committed
+static uint16_t count;              //lines in env
+static uint32_t shown;              //lines on the panel
+static uint16_t scroll;             //scrolling area offset of the oldest line
+static uint8_t visible;
+static uint8_t redraw;
+static int32_t lo[STRIP_TRACES], per_div[STRIP_TRACES];    //scale: lower edge, units per division
+static int32_t gain[STRIP_TRACES];  //pixels per unit, Q16
+static u8 buf[LCD_W * 2];
+
+static int32_t Strip_Floor(int32_t v, int32_t d)
+{
+	return v >= 0 ? v / d * d : -((-v + d - 1) / d) * d;
+}
+
+/*****************************************************************************
+ * @name       :static void Strip_Scale(uint8_t t)
+ * @date       :2026-10-19
+ * @function   :Fit the trace's scale to the envelopes in history: a 1-2-5
+                division with the lower edge on a division boundary. The
+                scale only changes when data is outside it or fits in a
+                quarter of it.
+ * @parameters :t:trace
+ * @retvalue   :None
+******************************************************************************/
+static void Strip_Scale(uint8_t t)
+{
+	static const uint8_t step[3] = {1, 2, 5};
+	int32_t mn = INT16_MAX, mx = INT16_MIN, range = per_div[t] * STRIP_DIVS, d, e, l = 0;
+	uint16_t i;
+	uint8_t k = 0;
+
+	for(i = 0; i < count; i++)
+	{
+		if(env[i][t].min < mn)
+			mn = env[i][t].min;
+		if(env[i][t].max > mx)
+			mx = env[i][t].max;
+	}
+	if(range && mn >= lo[t] && mx <= lo[t] + range && (mx - mn) * 4 > range)
+		return;
+	for(e = 1, d = 1; ; k++)
+	{
+		if(k == 3)
+		{
+			k = 0;
+			e *= 10;
+		}
+		d = step[k] * e;
+		if(d < trace[t].div_min)
+			continue;
+		l = Strip_Floor(mn, d);
+		if(l + d * STRIP_DIVS >= mx)
+			break;
+	}
+	if(d == per_div[t] && l == lo[t])
+		return;
+	per_div[t] = d;
+	lo[t] = l;
+	gain[t] = ((LCD_W - 1) << 16) / (d * STRIP_DIVS);
+	redraw = 1;
+}
+
+void Strip_Add(uint8_t t, int32_t v)
+{
+	if(v > INT16_MAX)
+		v = INT16_MAX;
+	else if(v < INT16_MIN)
+		v = INT16_MIN;
+	if(!(acc_used & (1 << t)))
+	{
+		acc[t].min = acc[t].max = v;
+		acc_used |= 1 << t;
+	}
+	else if(v < acc[t].min)
+		acc[t].min = v;
+	else if(v > acc[t].max)
+		acc[t].max = v;
+}
+
+/*****************************************************************************
+ * @name       :void Strip_Commit(void)
+ * @date       :2026-10-19
+ * @function   :Close the line being collected, rescale and wake the UI if
+                the chart is up. A trace without samples repeats its last
+                envelope.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Strip_Commit(void)
+{
+	strip_env_t *e = env[lines % STRIP_HIST];
+	uint8_t t;
+
+	for(t = 0; t < STRIP_TRACES; t++)
+	{
+		if(acc_used & (1 << t))
+			e[t] = acc[t];
+		else if(count)
+			e[t] = env[(lines - 1) % STRIP_HIST][t];
+		else
+			e[t].min = e[t].max = 0;
+	}
+	acc_used = 0;
+	lines++;
+	if(count < STRIP_HIST)
+		count++;
+	for(t = 0; t < STRIP_TRACES; t++)
+		Strip_Scale(t);
+	if(visible)
+		Sched_Signal(STRIP_TASK, STRIP_SIG_LINE);
+}
+
+void Strip_Block(const acq_block_t *b)
+{
+	Strip_Add(0, b->load_ua / 1000);
+	Strip_Add(1, b->val[ACQ_CH_UIN]);
+	if(++acc_n == STRIP_BLOCKS)
+	{
+		acc_n = 0;
+		Strip_Commit();
+	}
+}
+
+static u16 Strip_X(uint8_t t, int32_t v)
+{
+	v -= lo[t];
+	if(v < 0)
+		return 0;
+	if(v > per_div[t] * STRIP_DIVS)
+		return LCD_W - 1;
+	return (u16)((v * gain[t]) >> 16);
+}
+
+static void Strip_Pixel(u16 x, u16 c)
+{
+	buf[2 * x] = c >> 8;
+	buf[2 * x + 1] = c;
+}
+
+/*****************************************************************************
+ * @name       :static void Strip_Render(uint32_t s)
+ * @date       :2026-10-19
+ * @function   :Build one chart line in buf: background and grid, then per
+                trace the envelope joined to the line before and its extremes
+ * @parameters :s:line number, lines outside the history are left empty
+ * @retvalue   :None
+******************************************************************************/
+static void Strip_Render(uint32_t s)
+{
+	const strip_env_t *e, *p;
+	u16 x, a, b, c;
+	uint8_t t, i;
+	uint8_t valid = s < lines && lines - s <= count;
+
+	for(x = 0; x < LCD_W; x++)
+		Strip_Pixel(x, STRIP_BG);
+	if(valid && s % STRIP_GRID_LINES == 0)
+		for(x = 0; x < LCD_W; x += 2)
+			Strip_Pixel(x, STRIP_GRID);
+	else if(!(s & 1))
+		for(i = 0; i <= STRIP_DIVS; i++)
+			Strip_Pixel(i * (LCD_W - 1) / STRIP_DIVS, STRIP_GRID);
+	if(!valid)
+		return;
+	for(t = 0; t < STRIP_TRACES; t++)
+	{
+		e = &env[s % STRIP_HIST][t];
+		a = Strip_X(t, e->min);
+		b = Strip_X(t, e->max);
+		if(lines - s < count)           //the line before is in history too
+		{
+			p = &env[(s - 1) % STRIP_HIST][t];
+			if(Strip_X(t, p->max) < a)
+				a = Strip_X(t, p->max);
+			if(Strip_X(t, p->min) > b)
+				b = Strip_X(t, p->min);
+		}
+		c = (trace[t].color >> 1) & 0x7BEF;
+		for(x = a; x <= b; x++)
+			Strip_Pixel(x, c);
+		Strip_Pixel(Strip_X(t, e->min), trace[t].color);
+		Strip_Pixel(Strip_X(t, e->max), trace[t].color);
+	}
+}
+
+//chart line s into frame memory line y
+static void Strip_Line(uint32_t s, u16 y)
+{
+	Strip_Render(s);
+	LCD_SetWindows(0, y, LCD_W - 1, y);
+	LCD_PushPixels(buf, LCD_W);
+}
+
+static void Strip_Legend(void)
+{
+	char text[28];
+	u16 y;
+	uint8_t t;
+
+	for(t = 0; t < STRIP_TRACES; t++)
+	{
+		y = t ? LCD_H - 20 : 0;
+		LCD_Fill(0, y, LCD_W - 1, y + 19, BLUE);
+		sprintf(text, "%s %ld..%ld %s", trace[t].name, (long)lo[t], (long)(lo[t] + per_div[t] * STRIP_DIVS), trace[t].unit);
+		Show_Str(2, y + 2, trace[t].color, BLUE, (u8 *)text, 16, 1);
+	}
+}
+
+/*****************************************************************************
+ * @name       :static void Strip_Paint(void)
+ * @date       :2026-10-19
+ * @function   :Repaint the whole chart from history with the scrolling
+                offset back at 0, and the scale legends in the bars
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Strip_Paint(void)
+{
+	u16 j;
+
+	redraw = 0;
+	Strip_Legend();
+	scroll = 0;
+	LCD_ScrollStart(STRIP_TOP);
+	for(j = 0; j < STRIP_LINES; j++)
+		Strip_Line(lines - STRIP_LINES + j, STRIP_TOP + j);
+	shown = lines;
+}
+
+/*****************************************************************************
+ * @name       :void Strip_Show(void)
+ * @date       :2026-10-19
+ * @function   :Set up the scrolling area and draw the chart, it then
+                follows new lines until Strip_Hide(), at the full clock
+                profile. Portrait only.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Strip_Show(void)
+{
+	if(lcddev.width != LCD_W)
+		return;
+	Clock_Require(CLOCK_USER_PAGE, CLOCK_FULL);
+	LCD_ScrollArea(STRIP_TOP, STRIP_LINES);
+	visible = 1;
+	Strip_Paint();
+}
+
+//back to the normal display; call before anything else is drawn
+void Strip_Hide(void)
+{
+	if(!visible)
+		return;
+	visible = 0;
+	LCD_ScrollArea(0, LCD_GRAM_LINES);
+	LCD_ScrollStart(0);
+	Clock_Require(CLOCK_USER_PAGE, CLOCK_IDLE);
+}
+
+/*****************************************************************************
+ * @name       :void Strip_Draw(void)
+ * @date       :2026-10-19
+ * @function   :Draw the lines committed since the last call: each goes
+                into the frame memory line of the oldest one, then one
+                VSCSAD shows them at the bottom. A scale change, or more
+                new lines than the area holds, repaints instead.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Strip_Draw(void)
+{
+	if(!visible || shown == lines)
+		return;
+	if(redraw || lines - shown >= STRIP_LINES)
+	{
+		Strip_Paint();
+		return;
+	}
+	for(; shown != lines; shown++)
+	{
+		Strip_Line(shown, STRIP_TOP + scroll);
+		scroll = (scroll + 1) % STRIP_LINES;
+	}
+	LCD_ScrollStart(STRIP_TOP + scroll);
+}
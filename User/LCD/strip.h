@@ -0,0 +1,40 @@
+#ifndef __STRIP_H
+#define __STRIP_H
+#include "main.h"
+#include "sched.h"
+#include "acq.h"
+
+//Strip chart of the load current and Uin on the ST7789 vertical scrolling
+//area. The chart runs along the panel's scan direction, so in the portrait
+//orientation (USE_HORIZONTAL 0) time runs down the screen, one frame memory
+//line per STRIP_BLOCKS acquisition blocks. A new line costs one single-line
+//window write and a VSCSAD; the controller moves the rest of the plot.
+//Each line shows per trace the min..max envelope of its blocks in a dim
+//colour, joined to the line before, with both extremes in the trace colour.
+//The envelopes are kept, so an autoscale change or showing the chart again
+//repaints the area from history. A scale is STRIP_DIVS divisions of a
+//1-2-5 step; it grows at once and shrinks when the data fits a quarter.
+//Collection runs in ACQ_TASK, all drawing in STRIP_TASK.
+#define STRIP_TASK          SCHED_TASK_UI
+#define STRIP_SIG_LINE      3       //lines waiting to be drawn
+#define STRIP_TRACES        2
+#define STRIP_TOP           20      //first scrolling line, below the title bar
+#define STRIP_LINES         200     //scrolling lines, the bottom bar stays fixed
+#define STRIP_HIST          (STRIP_LINES + 1)   //the top line is joined to the one before it
+#define STRIP_BLOCKS        4       //acquisition blocks per line (128 ms)
+#define STRIP_DIVS          4
+#define STRIP_GRID_LINES    25      //lines between time grid rows (3.2 s)
+
+typedef struct
+{
+	int16_t min, max;
+} strip_env_t;
+
+void Strip_Block(const acq_block_t *b);
+void Strip_Add(uint8_t trace, int32_t v);
+void Strip_Commit(void);
+void Strip_Show(void);
+void Strip_Hide(void);
+void Strip_Draw(void);
+
+#endif
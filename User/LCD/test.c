@@ -51,11 +51,37 @@
 //#include "touch.h"
 //#include "key.h" 
 //#include "led.h"
-#include "pic.h"
+#include "stats.h"
+#include "ripple.h"
+#include "capacity.h"
+#include "cable.h"
+#include "strip.h"
+#include "tile.h"
+#include "layer.h"
+#include "digit.h"
+#include "widget.h"
+#include "frame.h"
+#include "sched.h"
+#include <stdio.h>
 
-//========================variable==========================//
-u16 ColorTab[5]={RED,GREEN,BLUE,YELLOW,BRED};//ɫ
-//=====================end of variable======================//
+#define BADGE_W 120	//mean load current badge on the statistics page, 2 bpp
+#define BADGE_H 20
+static u8 badge_bits[LAYER_BYTES(BADGE_W, BADGE_H, 2)];
+static u16 badge_clut[4];
+static layer_t badge;
+
+#define READOUT_NUM 3	//Uin, load current and power on the readout page
+#define READOUT_W (5 * DIGIT_W + DIGIT_POINT_W + 6 + 8)	//5 digits with the point, gap and unit, centred on the page
+#define READOUT_Y 40
+#define READOUT_PITCH 60
+static digit_t readout[READOUT_NUM];
+
+#define PANEL_CHART_H 80	//load current history on the widget page, one column per frame, page wide
+#define PANEL_FULL_MA 4000	//bar and chart full scale
+static const char * const panel_rows[] = {"off", "wait", "run", "done"};	//capacity test, beside the values
+static widget_value_t panel_val[READOUT_NUM] = {{"V", 3, ""}, {"A", 3, ""}, {"W", 3, ""}};
+static u8 panel_samples[LCD_W - 2 * WIDGET_PAD];
+static widget_t *panel_w[READOUT_NUM], *panel_bar, *panel_chart, *panel_menu;
 
 /*****************************************************************************
  * @name       :void DrawTestPage(u8 *str)
@@ -66,348 +92,288 @@ u16 ColorTab[5]={RED,GREEN,BLUE,YELLOW,BRED};//
 ******************************************************************************/ 
 void DrawTestPage(u8 *str)
 {
-	//ƹ̶up
-	LCD_Clear(WHITE);
-	LCD_Fill(0,0,lcddev.width,20,BLUE);
-	//ƹ̶down
-	LCD_Fill(0,lcddev.height-20,lcddev.width,lcddev.height,BLUE);
-	POINT_COLOR=WHITE;
-	Gui_StrCenter(0,2,WHITE,BLUE,str,16,1);//ʾ
-	Gui_StrCenter(0,lcddev.height-18,WHITE,BLUE,"www.lcdwiki.com",16,1);//ʾ
-	//Ʋ
-	//LCD_Fill(0,20,lcddev.width,lcddev.height-20,WHITE);
-}
+	u16 w = lcddev.width, h = lcddev.height;
+	const tile_item_t page[] = {
+		{TILE_RECT, 0, 0, w - 1, h - 1, WHITE, NULL},
+		{TILE_RECT, 0, 0, w - 1, 20, BLUE, NULL},			//top bar
+		{TILE_RECT, 0, h - 20, w - 1, h - 1, BLUE, NULL},	//bottom bar
+		{TILE_TEXT_CENTER, 0, 2, w - 1, 17, WHITE, (const char *)str},
+		{TILE_TEXT_CENTER, 0, h - 18, w - 1, h - 3, WHITE, "www.lcdwiki.com"},
+	};
 
-/*****************************************************************************
- * @name       :void Display_ButtonUp(u16 x1,u16 y1,u16 x2,u16 y2)
- * @date       :2018-08-24 
- * @function   :Drawing a 3D button
- * @parameters :x1:the bebinning x coordinate of the button
-                y1:the bebinning y coordinate of the button
-								x2:the ending x coordinate of the button
-								y2:the ending y coordinate of the button
- * @retvalue   :None
-******************************************************************************/ 
-void Display_ButtonUp(u16 x1,u16 y1,u16 x2,u16 y2)
-{
+	Tile_Page(page, sizeof(page) / sizeof(page[0]));	//one pass in strips instead of clear, fills and glyph windows
 	POINT_COLOR=WHITE;
-	LCD_DrawLine(x1,  y1,  x2,y1); //H
-	LCD_DrawLine(x1,  y1,  x1,y2); //V
-	
-	POINT_COLOR=GRAY1;
-	LCD_DrawLine(x1+1,y2-1,x2,y2-1);  //H
-	POINT_COLOR=GRAY2;
-	LCD_DrawLine(x1,y2,x2,y2);  //H
-	POINT_COLOR=GRAY1;
-	LCD_DrawLine(x2-1,y1+1,x2-1,y2);  //V
-	POINT_COLOR=GRAY2;
-  LCD_DrawLine(x2,y1,x2,y2); //V
 }
 
 /*****************************************************************************
- * @name       :void menu_test(void)
- * @date       :2018-08-24 
- * @function   :Drawing a 3D menu UI
- * @parameters :None
+ * @name       :static void Test_Badge(const char *text)
+ * @date       :2026-10-19
+ * @function   :Redraw the badge layer over the page: a frame and the text,
+                index 0 is transparent so the page shows through. Only the
+                part of the layer that changed goes to the panel.
+ * @parameters :text:badge text
  * @retvalue   :None
-******************************************************************************/ 
-void menu_test(void)
+******************************************************************************/
+static void Test_Badge(const char *text)
 {
-	LCD_Clear(GRAY0);
-	
-	Display_ButtonUp(71,8,169,28); //x1,y1,x2,y2
-	Gui_StrCenter(0,10,BRED,BLUE,"ͼʾ",16,1);
-
-	Display_ButtonUp(71,38,169,58); //x1,y1,x2,y2
-	Gui_StrCenter(0,40,BLACK,GRAY0,"ɫ",16,1);
-	
-	Display_ButtonUp(71,68,169,88); //x1,y1,x2,y2
-	Gui_StrCenter(0,70,BLUE,GRAY0,"ʾ",16,1);
+	const tile_item_t scene[] = {
+		{TILE_RECT, 0, 20, lcddev.width - 1, lcddev.height - 21, WHITE, NULL},	//page background
+		{TILE_LAYER, 0, 0, 0, 0, 0, &badge},
+	};
 
-	Display_ButtonUp(71,98,169,118); //x1,y1,x2,y2
-	Gui_StrCenter(16,100,RED,GRAY0,"ͼƬʾ",16,1);
-//	delay_ms(1500);
-//	delay_ms(500);
+	if(!badge.bits)
+	{
+		Layer_Init(&badge, (LCD_W - BADGE_W) / 2, 150, BADGE_W, BADGE_H, 2, badge_bits, badge_clut);
+		badge.key = 0;
+		Layer_Color(&badge, 1, GRAY2);
+		Layer_Color(&badge, 2, RED);
+	}
+	Layer_Fill(&badge, 0, 0, BADGE_W - 1, BADGE_H - 1, 0);
+	Layer_Fill(&badge, 0, 0, BADGE_W - 1, 1, 1);
+	Layer_Fill(&badge, 0, BADGE_H - 2, BADGE_W - 1, BADGE_H - 1, 1);
+	Layer_Fill(&badge, 0, 0, 1, BADGE_H - 1, 1);
+	Layer_Fill(&badge, BADGE_W - 2, 0, BADGE_W - 1, BADGE_H - 1, 1);
+	Layer_Text(&badge, 6, 2, text, 2);
+	Layer_Flush(&badge, scene, 2);
 }
 
 /*****************************************************************************
- * @name       :void main_test(void)
- * @date       :2018-08-09 
- * @function   :Drawing the main Interface of the Comprehensive Test Program
+ * @name       :void Test_Stats(void)
+ * @date       :2026-10-19
+ * @function   :session statistics page: load current range, mean and
+                quantiles, input and battery voltage
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/
-void main_test(void)
+void Test_Stats(void)
 {
-	DrawTestPage("ۺϲԳ");	
-	Gui_StrCenter(0,23,RED,BLUE,"ȫ",16,1);//ʾ
-	Gui_StrCenter(0,40,RED,BLUE,"ۺϲԳ",16,1);//ʾ	
-	Gui_StrCenter(0,57,GREEN,BLUE,"2.0\" ST7789",16,1);//ʾ
-	Gui_StrCenter(0,74,GREEN,BLUE,"240X320",16,1);//ʾ
-	Gui_StrCenter(0,91,BLUE,BLUE,"2019-12-21",16,1);//ʾ
-//	delay_ms(1500);		
-//	delay_ms(1500);
-}
+	stats_acc_t a;
+	char buf[32];
 
-/*****************************************************************************
- * @name       :void Test_Color(void)
- * @date       :2018-08-09 
- * @function   :Color fill test(white,black,red,green,blue)
- * @parameters :None
- * @retvalue   :None
-******************************************************************************/
-void Test_Color(void)
-{
-	//DrawTestPage("1:ɫ");
-	LCD_Fill(0,0,lcddev.width,lcddev.height,WHITE);
-	Show_Str(20,30,BLUE,YELLOW,"BL Test",16,1);
-//	delay_ms(800);
-	LCD_Fill(0,0,lcddev.width,lcddev.height,RED);
-	Show_Str(20,30,BLUE,YELLOW,"RED ",16,1);
-//	delay_ms(800);
-	LCD_Fill(0,0,lcddev.width,lcddev.height,GREEN);
-	Show_Str(20,30,BLUE,YELLOW,"GREEN ",16,1);
-//	delay_ms(800);
-	LCD_Fill(0,0,lcddev.width,lcddev.height,BLUE);
-	Show_Str(20,30,RED,YELLOW,"BLUE ",16,1);
-//	delay_ms(800);
+	DrawTestPage("Load statistics");
+	Stats_Get(ACQ_CH_I4A, STATS_SESSION, &a);
+	sprintf(buf, "I %ld/%ld/%ld mA", (long)a.min, (long)Stats_Mean(&a), (long)a.max);
+	Show_Str(10,25,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "p50 %ld uA", (long)Stats_Quantile(STATS_P50));
+	Show_Str(10,45,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "p95 %ld uA", (long)Stats_Quantile(STATS_P95));
+	Show_Str(10,65,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "p99 %ld uA", (long)Stats_Quantile(STATS_P99));
+	Show_Str(10,85,BLUE,YELLOW,(u8 *)buf,16,1);
+	Stats_Get(ACQ_CH_UIN, STATS_SESSION, &a);
+	sprintf(buf, "Uin %ld/%ld/%ld mV", (long)a.min, (long)Stats_Mean(&a), (long)a.max);
+	Show_Str(10,105,BLUE,YELLOW,(u8 *)buf,16,1);
+	Stats_Get(ACQ_CH_BAT, STATS_SESSION, &a);
+	sprintf(buf, "Bat %ld mV sd %lu", (long)Stats_Mean(&a), (unsigned long)Stats_Std(&a));
+	Show_Str(10,125,BLUE,YELLOW,(u8 *)buf,16,1);
+	Stats_Get(ACQ_CH_I4A, STATS_SESSION, &a);
+	sprintf(buf, "mean %ld mA", (long)Stats_Mean(&a));
+	Test_Badge(buf);
 }
 
 /*****************************************************************************
- * @name       :void Test_FillRec(void)
- * @date       :2018-08-09 
- * @function   :Rectangular display and fill test
-								Display red,green,blue,yellow,pink rectangular boxes in turn,
-								1500 milliseconds later,
-								Fill the rectangle in red,green,blue,yellow and pink in turn
+ * @name       :void Test_Ripple(void)
+ * @date       :2026-10-19
+ * @function   :last ripple analysis: input, rms, peak-to-peak and the
+                strongest spectral peaks
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/
-void Test_FillRec(void)
+void Test_Ripple(void)
 {
-	u8 i=0;
-	DrawTestPage("GUI");
-	LCD_Fill(0,20,lcddev.width,lcddev.height-20,WHITE);
-	for (i=0; i<5; i++) 
+	static const char * const name[ACQ_CH_NUM] = {"I_4A", "I_100mA", "Uin", "Bat"};
+	static const char * const unit[ACQ_CH_NUM] = {"mA", "uA", "mV", "mV"};
+	ripple_result_t r;
+	char buf[32];
+	u8 i;
+
+	DrawTestPage("Ripple spectrum");
+	if(!Ripple_Get(&r))
 	{
-		POINT_COLOR=ColorTab[i];
-		LCD_DrawRectangle(lcddev.width/2-40+(i*16),lcddev.height/2-40+(i*13),lcddev.width/2-40+(i*16)+30,lcddev.height/2-40+(i*13)+30); 
+		Show_Str(10,25,BLUE,YELLOW,"no analysis yet",16,1);
+		return;
 	}
-//	delay_ms(1500);	
-	LCD_Fill(0,20,lcddev.width,lcddev.height-20,WHITE); 
-	for (i=0; i<5; i++) 
+	sprintf(buf, "%s rms %ld pp %ld %s", name[r.ch], (long)r.rms, (long)r.pp, unit[r.ch]);
+	Show_Str(10,25,BLUE,YELLOW,(u8 *)buf,16,1);
+	for(i = 0; i < r.peaks; i++)
 	{
-		POINT_COLOR=ColorTab[i];
-		LCD_DrawFillRectangle(lcddev.width/2-40+(i*16),lcddev.height/2-40+(i*13),lcddev.width/2-40+(i*16)+30,lcddev.height/2-40+(i*13)+30); 
+		sprintf(buf, "%6lu Hz %5ld %s", (unsigned long)r.peak[i].hz, (long)r.peak[i].amp, unit[r.ch]);
+		Show_Str(10,45+i*20,BLUE,YELLOW,(u8 *)buf,16,1);
 	}
-//	delay_ms(1500);
 }
 
 /*****************************************************************************
- * @name       :void Test_Circle(void)
- * @date       :2018-08-09 
- * @function   :circular display and fill test
-								Display red,green,blue,yellow,pink circular boxes in turn,
-								1500 milliseconds later,
-								Fill the circular in red,green,blue,yellow and pink in turn
+ * @name       :void Test_Capacity(void)
+ * @date       :2026-10-19
+ * @function   :capacity test: state, time, charge and energy so far or the
+                summary of the last test
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/
-void Test_Circle(void)
+void Test_Capacity(void)
 {
-	u8 i=0;
-	DrawTestPage("GUIԲ");
-	LCD_Fill(0,20,lcddev.width,lcddev.height-20,WHITE);
-	for (i=0; i<5; i++)  
-		gui_circle(lcddev.width/2-40+(i*15),lcddev.height/2-25+(i*13),ColorTab[i],15,0);
-//	delay_ms(1500);	
-	LCD_Fill(0,20,lcddev.width,lcddev.height-20,WHITE); 
-	for (i=0; i<5; i++) 
-	  	gui_circle(lcddev.width/2-40+(i*15),lcddev.height/2-25+(i*13),ColorTab[i],15,1);
-//	delay_ms(1500);
-	HAL_Delay(1000);
+	static const char * const sname[] = {"off", "waiting", "running", "done"};
+	static const char * const rname[CAPACITY_END_NUM] = {"-", "current", "voltage", "timeout", "stop"};
+	const capacity_rec_t *c = Capacity_Get();
+	uint32_t mah = Capacity_MahX10(c), mwh = Capacity_MwhX10(c), s = c->ms / 1000;
+	char buf[32];
+
+	DrawTestPage("Capacity test");
+	sprintf(buf, "%s %lu:%02lu:%02lu", sname[c->state & 3], (unsigned long)(s / 3600),
+	        (unsigned long)(s / 60 % 60), (unsigned long)(s % 60));
+	Show_Str(10,25,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "%lu.%lu mAh", (unsigned long)(mah / 10), (unsigned long)(mah % 10));
+	Show_Str(10,45,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "%lu.%lu mWh", (unsigned long)(mwh / 10), (unsigned long)(mwh % 10));
+	Show_Str(10,65,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "peak %lu mA", (unsigned long)(c->peak_ua / 1000));
+	Show_Str(10,85,BLUE,YELLOW,(u8 *)buf,16,1);
+	if(c->state == CAPACITY_STATE_DONE)
+	{
+		sprintf(buf, "end: %s", rname[c->reason < CAPACITY_END_NUM ? c->reason : 0]);
+		Show_Str(10,105,BLUE,YELLOW,(u8 *)buf,16,1);
+	}
 }
 
 /*****************************************************************************
- * @name       :void English_Font_test(void)
- * @date       :2018-08-09 
- * @function   :English display test
+ * @name       :void Test_Cable(void)
+ * @date       :2026-10-19
+ * @function   :supply path resistance: estimate, spread and the newest
+                load step pairs
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/
-void English_Font_test(void)
+void Test_Cable(void)
 {
-	DrawTestPage("Ӣʾ");
-	Show_Str(10,22,BLUE,YELLOW,"6X12:abcdefgh01234567",12,0);
-	Show_Str(10,34,BLUE,YELLOW,"6X12:ABCDEFGH01234567",12,1);
-	Show_Str(10,47,BLUE,YELLOW,"6X12:~!@#$%^&*()_+{}:",12,0);
-	Show_Str(10,60,BLUE,YELLOW,"8X16:abcde01234",16,0);
-	Show_Str(10,76,BLUE,YELLOW,"8X16:ABCDE01234",16,1);
-	Show_Str(10,92,BLUE,YELLOW,"8X16:~!@#$%^&*()",16,0); 
-//	delay_ms(1200);
-	HAL_Delay(1000);
+	cable_est_t e;
+	char buf[32];
+
+	DrawTestPage("Cable resistance");
+	if(!Cable_Get(&e))
+	{
+		Show_Str(10,25,BLUE,YELLOW,"no load steps yet",16,1);
+		return;
+	}
+	sprintf(buf, "R %ld mOhm", (long)e.r_mohm);
+	Show_Str(10,25,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "median %ld mad %ld", (long)e.median_mohm, (long)e.mad_mohm);
+	Show_Str(10,45,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "pairs %u/%u", e.used, e.pairs);
+	Show_Str(10,65,BLUE,YELLOW,(u8 *)buf,16,1);
+	sprintf(buf, "steps %lu rej %lu", (unsigned long)e.steps, (unsigned long)e.rejected);
+	Show_Str(10,85,BLUE,YELLOW,(u8 *)buf,16,1);
+}
+
+//readout page frame, only changed digits go to the panel
+static void Test_ReadoutFrame(const frame_snap_t *s)
+{
+	int32_t mv = s->val[ACQ_CH_UIN], ma = s->val[ACQ_CH_I4A];
+
+	Digit_Show(&readout[0], mv);
+	Digit_Show(&readout[1], ma);
+	Digit_Show(&readout[2], (int32_t)((int64_t)mv * ma / 1000));
 }
 
 /*****************************************************************************
- * @name       :void Test_Triangle(void)
- * @date       :2018-08-09 
- * @function   :triangle display and fill test
-								Display red,green,blue,yellow,pink triangle boxes in turn,
-								1500 milliseconds later,
-								Fill the triangle in red,green,blue,yellow and pink in turn
+ * @name       :void Test_Readout(void)
+ * @date       :2026-10-19
+ * @function   :main readout page: input voltage, load current and power in
+                large digits, one frame per FRAME_FPS while it is up
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/
-void Test_Triangle(void)
+void Test_Readout(void)
 {
-	u8 i=0;
-	DrawTestPage("GUI Tri");
-	LCD_Fill(0,20,lcddev.width,lcddev.height-20,WHITE);
-	for(i=0;i<5;i++)
-	{
-		POINT_COLOR=ColorTab[i];
-		Draw_Triangel(lcddev.width/2-40+(i*15),lcddev.height/2-12+(i*11),lcddev.width/2-25-1+(i*15),lcddev.height/2-12-26-1+(i*11),lcddev.width/2-10-1+(i*15),lcddev.height/2-12+(i*11));
-	}
-//	delay_ms(1500);	
-	LCD_Fill(0,20,lcddev.width,lcddev.height-20,WHITE); 
-	for(i=0;i<5;i++)
+	static const char * const unit[READOUT_NUM] = {"V", "A", "W"};
+	u16 x = (lcddev.width - READOUT_W) / 2;
+	u8 i;
+
+	DrawTestPage("Readout");
+	for(i = 0; i < READOUT_NUM; i++)
 	{
-		POINT_COLOR=ColorTab[i];
-		Fill_Triangel(lcddev.width/2-40+(i*15),lcddev.height/2-12+(i*11),lcddev.width/2-25-1+(i*15),lcddev.height/2-12-26-1+(i*11),lcddev.width/2-10-1+(i*15),lcddev.height/2-12+(i*11));
+		Digit_Init(&readout[i], x, READOUT_Y + i * READOUT_PITCH, 5, 3, BLUE, WHITE);
+		Show_Str(x + Digit_Width(&readout[i]) + 6, READOUT_Y + i * READOUT_PITCH + DIGIT_H - 16,
+		         BLUE, YELLOW, (u8 *)unit[i], 16, 1);
 	}
-//	delay_ms(1500);
-	HAL_Delay(1000);
+	Frame_Start(Test_ReadoutFrame);
 }
 
-/*****************************************************************************
- * @name       :void Chinese_Font_test(void)
- * @date       :2018-08-09 
- * @function   :chinese display test
- * @parameters :None
- * @retvalue   :None
-******************************************************************************/
-void Chinese_Font_test(void)
-{	
-	DrawTestPage("ʾ");
-	Show_Str(10,25,BLUE,YELLOW,"16X16:ȫӻӭ",16,0);
-	Show_Str(10,45,BLUE,YELLOW,"24X24:Ĳ",24,1);
-	Show_Str(10,70,BLUE,YELLOW,"32X32:",32,1);
-//	delay_ms(1200);
-	HAL_Delay(1000);
+//widget page frame
+static void Test_PanelFrame(const frame_snap_t *s)
+{
+	int32_t mv = s->val[ACQ_CH_UIN], ma = s->val[ACQ_CH_I4A];
+
+	Widget_SetValue(panel_w[0], mv);
+	Widget_SetValue(panel_w[1], ma);
+	Widget_SetValue(panel_w[2], (int32_t)((int64_t)mv * ma / 1000));
+	Widget_SetValue(panel_bar, ma * WIDGET_FULL / PANEL_FULL_MA);
+	Widget_ChartPush(panel_chart, ma * WIDGET_FULL / PANEL_FULL_MA);
+	Widget_SetValue(panel_menu, Capacity_Get()->state & 3);
+	Widget_Update();
 }
 
 /*****************************************************************************
- * @name       :void Pic_test(void)
- * @date       :2018-08-09 
- * @function   :picture display test
+ * @name       :void Test_Panel(void)
+ * @date       :2026-10-19
+ * @function   :live load page built from widgets: input voltage, load
+                current and power stacked beside the capacity test state,
+                then a current bar and the current history across the
+                page. One frame per FRAME_FPS, only widgets that changed
+                are redrawn.
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/
-void Pic_test(void)
+void Test_Panel(void)
 {
-	DrawTestPage("ͼƬʾ");
-	//LCD_Fill(0,20,lcddev.width,lcddev.height-20,WHITE);
-	Gui_Drawbmp16(20,30,gImage_qq);
-	Show_Str(20+12,75,BLUE,YELLOW,"QQ",16,1);
-	Gui_Drawbmp16(70,30,gImage_qq);
-	Show_Str(70+12,75,BLUE,YELLOW,"QQ",16,1);
-//	Gui_Drawbmp16(150,30,gImage_qq);
-//	Show_Str(150+12,75,BLUE,YELLOW,"QQ",16,1);
-//	delay_ms(1200);
-	HAL_Delay(1000);
+	widget_t *root, *row, *col;
+	u16 w = lcddev.width - 2 * WIDGET_PAD;
+	u8 i;
+
+	if(w > sizeof(panel_samples))
+		w = sizeof(panel_samples);
+	DrawTestPage("Load panel");
+	root = Widget_Root(0, 21, lcddev.width - 1, lcddev.height - 21, WHITE);
+	row = Widget_Box(root, WIDGET_HBOX, WHITE);
+	col = Widget_Box(row, WIDGET_VBOX, WHITE);
+	for(i = 0; i < READOUT_NUM; i++)
+		panel_w[i] = Widget_Value(col, &panel_val[i], BLUE, WHITE);
+	panel_menu = Widget_Menu(row, panel_rows, sizeof(panel_rows) / sizeof(panel_rows[0]), BLUE, WHITE);
+	panel_bar = Widget_Bar(root, w, 10, RED, WHITE);
+	panel_chart = Widget_Chart(root, panel_samples, w, PANEL_CHART_H, GRAY1, WHITE);
+	Frame_Start(Test_PanelFrame);
 }
 
 /*****************************************************************************
- * @name       :void Rotate_Test(void)
- * @date       :2018-08-09 
- * @function   :rotate test
+ * @name       :void Test_Strip(void)
+ * @date       :2026-10-19
+ * @function   :live strip chart of the load current and Uin, scrolled by
+                the controller while the page is up
  * @parameters :None
  * @retvalue   :None
 ******************************************************************************/
-void Rotate_Test(void)
+void Test_Strip(void)
 {
-	u8 i=0;
-	u8 *Direction[4]={"Rotation:0","Rotation:90","Rotation:180","Rotation:270"};
-	
-	for(i=0;i<4;i++)
-	{
-		LCD_direction(i);
-		DrawTestPage("Ļת");
-		Show_Str(20,30,BLUE,YELLOW,Direction[i],16,1);
-		Gui_Drawbmp16(30,50,gImage_qq);
-	//	delay_ms(1000);delay_ms(1000);
-		HAL_Delay(1000);
-	}
-	LCD_direction(USE_HORIZONTAL);
+	DrawTestPage("Strip chart");
+	Strip_Show();
 }
 
 /*****************************************************************************
- * @name       :void Touch_Test(void)
- * @date       :2018-08-09 
- * @function   :touch test
+ * @name       :u16 Demo_Step(void)
+ * @date       :2026-10-19
+ * @function   :Draw the next page of the demo sequence, replaces the
+                blocking loop that used to run from main()
  * @parameters :None
- * @retvalue   :None
+ * @retvalue   :how long the page should stay up in ms
 ******************************************************************************/
-//void Touch_Test(void)
-//{
-//	u8 key;
-//	u16 i=0;
-//	u16 j=0;
-//	u16 colorTemp=0;
-////	TP_Init();
-////	KEY_Init();
-////	LED_Init();
-//	DrawTestPage("9:Touch(KEY0У׼)      ");
-//	LCD_ShowString(lcddev.width-24,0,16,"RST",1);//ʾ
-//	POINT_COLOR=RED;
-//	LCD_Fill(lcddev.width-52,2,lcddev.width-50+20,18,RED); 
-//		while(1)
-//	{
-////	 	key=KEY_Scan();
-////		tp_dev.scan(0); 		 
-//		if(tp_dev.sta&TP_PRES_DOWN)			//
-//		{	
-//		 	if(tp_dev.x<lcddev.width&&tp_dev.y<lcddev.height)
-//			{	
-//				if(tp_dev.x>(lcddev.width-24)&&tp_dev.y<16)
-//				{
-//					DrawTestPage("9:Touch(KEY0У׼)      ");//
-//					LCD_ShowString(lcddev.width-24,0,16,"RST",1);//ʾ
-//					POINT_COLOR=colorTemp;
-//					LCD_Fill(lcddev.width-52,2,lcddev.width-50+20,18,POINT_COLOR); 
-//				}
-//				else if((tp_dev.x>(lcddev.width-60)&&tp_dev.x<(lcddev.width-50+20))&&tp_dev.y<20)
-//				{
-//				LCD_Fill(lcddev.width-52,2,lcddev.width-50+20,18,ColorTab[j%5]); 
-//				POINT_COLOR=ColorTab[(j++)%5];
-//				colorTemp=POINT_COLOR;
-//				delay_ms(10);
-//				}
-
-//				else TP_Draw_Big_Point(tp_dev.x,tp_dev.y,POINT_COLOR);		//ͼ	  			   
-//			}
-//		}else delay_ms(10);	//ûаµʱ 	    
-//		if(key==1)	//KEY_RIGHT,ִУ׼
-//		{
-
-//			LCD_Clear(WHITE);//
-//		    TP_Adjust();  //ĻУ׼ 
-//			TP_Save_Adjdata();	 
-//			DrawTestPage("9:Touch(KEY0У׼)      ");
-//			LCD_ShowString(lcddev.width-24,0,16,"RST",1);//ʾ
-//			POINT_COLOR=colorTemp;
-//			LCD_Fill(lcddev.width-52,2,lcddev.width-50+20,18,POINT_COLOR); 
-//		}
-//		i++;
-//		if(i==30)
-//		{
-//			i=0;
-//			LED0=!LED0;
-//			//break;
-//		}
-//	}   
-//}
-
-
-
+u16 Demo_Step(void)
+{
+	static void (* const page[])(void) = {Test_Stats, Test_Ripple, Test_Capacity, Test_Cable, Test_Readout, Test_Panel, Test_Strip};
+	static u8 i = 0;
 
+	Strip_Hide();		//the pages draw on the normal display
+	Frame_Stop();		//live pages draw only while they are up
+	if(i == sizeof(page) / sizeof(page[0]))
+		i = 0;		//the sequence repeats, power off is the power manager's call
+	page[i++]();
+	return page[i - 1] == Test_Strip || page[i - 1] == Test_Readout || page[i - 1] == Test_Panel ? DEMO_STRIP_MS : DEMO_PAGE_MS;
+}
@@ -47,18 +47,16 @@
 #ifndef __TEST_H__
 #define __TEST_H__
 
+#define DEMO_PAGE_MS 1000	//Demo_Step() page dwell time
+#define DEMO_STRIP_MS 10000	//the live pages (strip chart, readout, load panel) stay up longer
+
 void DrawTestPage(u8 *str);
-void Display_ButtonUp(u16 x1,u16 y1,u16 x2,u16 y2);
-void menu_test(void);
-void Test_Color(void);
-void Test_FillRec(void);
-void Test_Circle(void);
-void Test_Triangle(void);
-void English_Font_test(void);
-void Chinese_Font_test(void);
-void Pic_test(void);
-void Load_Drow_Dialog(void);
-void Touch_Test(void);
-void main_test(void);
-void Rotate_Test(void);
+void Test_Stats(void);
+void Test_Ripple(void);
+void Test_Capacity(void);
+void Test_Cable(void);
+void Test_Readout(void);
+void Test_Panel(void);
+void Test_Strip(void);
+u16 Demo_Step(void);
 #endif
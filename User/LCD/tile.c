@@ -0,0 +1,363 @@
+#include "tile.h"
+#include "layer.h"
+#include "rle.h"
+#include "gui.h"
+#include "lpm.h"
+#include <string.h>
+
+extern SPI_HandleTypeDef hspi1;
+
+static DMA_HandleTypeDef hdma_tile;
+static union
+{
+	u16 px[2][TILE_PIXELS];
+	uint32_t w[TILE_PIXELS];       //Tile_Lend()
+} strip;
+static volatile uint8_t busy;       //strip on the DMA
+static uint8_t lent;                //strips lent out, nothing is drawn
+
+//decoders of the images in the area being drawn, a strip carries on where
+//the one above it stopped
+typedef struct
+{
+	const tile_item_t *it;
+	u16 line;                       //next image line of dec
+	rle_dec_t dec;
+} tile_stream_t;
+
+static tile_stream_t stream[TILE_STREAMS];
+
+/*****************************************************************************
+ * @name       :void Tile_Init(void)
+ * @date       :2026-10-19
+ * @function   :Set up the SPI1 TX DMA channel for the strips, after
+                MX_DMA_Init() and MX_SPI1_Init()
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Tile_Init(void)
+{
+	hdma_tile.Instance = TILE_DMA;
+	hdma_tile.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hdma_tile.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_tile.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_tile.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_tile.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hdma_tile.Init.Mode = DMA_NORMAL;
+	hdma_tile.Init.Priority = DMA_PRIORITY_LOW;
+	if(HAL_DMA_Init(&hdma_tile) != HAL_OK)
+		return;                     //strips then go out by polling
+	__HAL_LINKDMA(&hspi1, hdmatx, hdma_tile);
+	HAL_NVIC_SetPriority(TILE_DMA_IRQn, TILE_DMA_PRIO, 0);
+	HAL_NVIC_EnableIRQ(TILE_DMA_IRQn);
+}
+
+static void Tile_Span(u16 *row, u16 a, u16 b, u16 c)
+{
+	for(; a <= b; a++)
+		row[a] = c;
+}
+
+/*****************************************************************************
+ * @name       :static void Tile_Text(const tile_item_t *it, u16 *px, u16 x0, u16 w, u16 y0, u16 rows)
+ * @date       :2026-10-19
+ * @function   :Draw the glyph rows of a text item that fall in the strip.
+                Glyphs are clipped to the area.
+ * @parameters :it:text item
+                px:strip, w pixels per line
+                x0:panel column of px[0]
+                y0:panel line of the first strip line
+                rows:lines in the strip
+ * @retvalue   :None
+******************************************************************************/
+static void Tile_Text(const tile_item_t *it, u16 *px, u16 x0, u16 w, u16 y0, u16 rows)
+{
+	const u8 *s = it->data, *g;
+	u16 c = TILE_PX(it->color), x = it->x0, len, r, r1, bits, i, j, *row;
+
+	if(it->y0 >= y0 + rows || it->y0 + 16 <= y0)
+		return;
+	if(it->type == TILE_TEXT_CENTER)
+	{
+		len = strlen(it->data) * 8;     //as Gui_StrCenter()
+		if(len < it->x1 - it->x0 + 1)
+			x += (it->x1 - it->x0 + 1 - len) / 2;
+	}
+	r = it->y0 < y0 ? y0 - it->y0 : 0;
+	r1 = it->y0 + 16 > y0 + rows ? y0 + rows - it->y0 : 16;
+	for(; *s && x < x0 + w; s++, x += 8)
+	{
+		g = GUI_Glyph16(*s);
+		if(!g || x + 8 <= x0)
+			continue;
+		for(i = r; i < r1; i++)
+		{
+			row = px + (it->y0 + i - y0) * w;
+			bits = __RBIT(g[i]) >> 16;     //glyph rows are LSB first
+			for(j = x; bits; bits <<= 1, j++)
+				if((bits & 0x8000) && j >= x0 && j < x0 + w)
+					row[j - x0] = c;
+		}
+	}
+}
+
+//expand the part of a layer that falls in the strip
+static void Tile_Layer(const layer_t *l, u16 *px, u16 x0, u16 w, u16 y0, u16 rows)
+{
+	u16 a, b, y, yb;
+
+	if(l->y >= y0 + rows || l->y + l->h <= y0 || l->x >= x0 + w || l->x + l->w <= x0)
+		return;
+	a = l->x > x0 ? l->x : x0;
+	b = l->x + l->w < x0 + w ? l->x + l->w : x0 + w;
+	y = l->y > y0 ? l->y : y0;
+	yb = l->y + l->h < y0 + rows ? l->y + l->h : y0 + rows;
+	for(; y < yb; y++)
+		Layer_Expand(l, a - l->x, y - l->y, b - a, px + (y - y0) * w + (a - x0));
+}
+
+/*****************************************************************************
+ * @name       :static tile_stream_t *Tile_Stream(const tile_item_t *it, u16 line)
+ * @date       :2026-10-19
+ * @function   :Get the stream of an image item positioned at a line. A
+                decoder that is behind skips ahead, one that is past the line
+                or was taken over by another image starts again from the top.
+ * @parameters :it:image item
+                line:image line
+ * @retvalue   :stream of the item
+******************************************************************************/
+static tile_stream_t *Tile_Stream(const tile_item_t *it, u16 line)
+{
+	const rle_image_t *img = it->data;
+	u8 i, k = 0;
+
+	for(i = 0; i < TILE_STREAMS; i++)
+	{
+		if(stream[i].it == it)
+			break;
+		if(!stream[i].it)
+			k = i;
+	}
+	if(i == TILE_STREAMS || stream[i].line > line)
+	{
+		if(i < TILE_STREAMS)
+			k = i;
+		stream[k].it = it;
+		stream[k].line = 0;
+		Rle_Begin(&stream[k].dec, img);
+		i = k;
+	}
+	Rle_Read(&stream[i].dec, NULL, (u32)(line - stream[i].line) * img->w);
+	stream[i].line = line;
+	return &stream[i];
+}
+
+//decode the lines of an image that fall in the strip, clipped to the area
+static void Tile_Image(const tile_item_t *it, u16 *px, u16 x0, u16 w, u16 y0, u16 rows)
+{
+	const rle_image_t *img = it->data;
+	tile_stream_t *s;
+	u16 a, b, y, yb;
+
+	if(it->y0 >= y0 + rows || it->y0 + img->h <= y0 || it->x0 >= x0 + w || it->x0 + img->w <= x0)
+		return;
+	a = it->x0 > x0 ? it->x0 : x0;
+	b = it->x0 + img->w < x0 + w ? it->x0 + img->w : x0 + w;
+	y = it->y0 > y0 ? it->y0 : y0;
+	yb = it->y0 + img->h < y0 + rows ? it->y0 + img->h : y0 + rows;
+	s = Tile_Stream(it, y - it->y0);
+	for(; y < yb; y++)
+	{
+		Rle_Read(&s->dec, NULL, a - it->x0);
+		Rle_Read(&s->dec, px + (y - y0) * w + (a - x0), b - a);
+		Rle_Read(&s->dec, NULL, it->x0 + img->w - b);
+	}
+	s->line = yb - it->y0;
+}
+
+//the parts of the chart columns that fall in the strip
+static void Tile_Bars(const tile_item_t *it, u16 *px, u16 x0, u16 w, u16 y0, u16 rows)
+{
+	const u8 *h = it->data;
+	u16 c = TILE_PX(it->color), a, b, y, yb, j, *row;
+
+	if(it->y1 < y0 || it->y0 >= y0 + rows || it->x1 < x0 || it->x0 >= x0 + w)
+		return;
+	a = it->x0 > x0 ? it->x0 : x0;
+	b = it->x1 < x0 + w ? it->x1 : x0 + w - 1;
+	y = it->y0 > y0 ? it->y0 : y0;
+	yb = it->y1 < y0 + rows ? it->y1 : y0 + rows - 1;
+	for(; y <= yb; y++)
+	{
+		row = px + (y - y0) * w - x0;
+		for(j = a; j <= b; j++)
+			if(it->y1 - y < h[j - it->x0])
+				row[j] = c;
+	}
+}
+
+/*****************************************************************************
+ * @name       :static void Tile_Draw(const tile_item_t *item, u8 n, u16 *px, u16 x0, u16 w, u16 y0, u16 rows)
+ * @date       :2026-10-19
+ * @function   :Rasterise the items into one strip
+ * @parameters :item:draw list
+                n:number of items
+                px:strip, w pixels per line
+                x0:panel column of px[0]
+                y0:panel line of the first strip line
+                rows:lines in the strip
+ * @retvalue   :None
+******************************************************************************/
+static void Tile_Draw(const tile_item_t *item, u8 n, u16 *px, u16 x0, u16 w, u16 y0, u16 rows)
+{
+	const tile_item_t *it;
+	u16 a, b, ya, yb, y, c;
+
+	for(it = item; it < item + n; it++)
+	{
+		if(it->type == TILE_TEXT || it->type == TILE_TEXT_CENTER)
+		{
+			Tile_Text(it, px, x0, w, y0, rows);
+			continue;
+		}
+		if(it->type == TILE_LAYER)
+		{
+			Tile_Layer(it->data, px, x0, w, y0, rows);
+			continue;
+		}
+		if(it->type == TILE_IMAGE)
+		{
+			Tile_Image(it, px, x0, w, y0, rows);
+			continue;
+		}
+		if(it->type == TILE_BARS)
+		{
+			Tile_Bars(it, px, x0, w, y0, rows);
+			continue;
+		}
+		if(it->y1 < y0 || it->y0 >= y0 + rows || it->x1 < x0 || it->x0 >= x0 + w)
+			continue;
+		a = (it->x0 > x0 ? it->x0 : x0) - x0;
+		b = (it->x1 < x0 + w ? it->x1 : x0 + w - 1) - x0;
+		ya = it->y0 > y0 ? it->y0 : y0;
+		yb = it->y1 < y0 + rows ? it->y1 : y0 + rows - 1;
+		c = TILE_PX(it->color);
+		for(y = ya; y <= yb; y++)
+		{
+			if(it->type == TILE_RECT || y == it->y0 || y == it->y1)
+				Tile_Span(px + (y - y0) * w, a, b, c);
+			else
+			{
+				if(it->x0 >= x0)
+					px[(y - y0) * w + a] = c;
+				if(it->x1 < x0 + w)
+					px[(y - y0) * w + b] = c;
+			}
+		}
+	}
+}
+
+//start a strip on the DMA, CS and RS are already set
+static void Tile_Send(u16 *px, u16 n)
+{
+	busy = 1;
+	LCD_Count(n * 2);
+	if(HAL_SPI_Transmit_DMA(&hspi1, (u8 *)px, n * 2) != HAL_OK)
+	{
+		busy = 0;
+		HAL_SPI_Transmit(&hspi1, (u8 *)px, n * 2, 0xffff);
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Tile_Render(u16 x0, u16 y0, u16 x1, u16 y1, const tile_item_t *item, u8 n)
+ * @date       :2026-10-19
+ * @function   :Draw an area of the panel from a draw list, strip by strip,
+                rasterising each strip while the one before is on the DMA.
+                Returns once the last strip is out.
+ * @parameters :x0,y0,x1,y1:area, inclusive
+                item:draw list in panel coordinates
+                n:number of items
+ * @retvalue   :None
+******************************************************************************/
+void Tile_Render(u16 x0, u16 y0, u16 x1, u16 y1, const tile_item_t *item, u8 n)
+{
+	u16 w = x1 - x0 + 1, rows = TILE_PIXELS / w, h, y;
+	u8 k = 0;
+
+	if(lent)
+		return;
+	memset(stream, 0, sizeof(stream));
+	LCD_SetWindows(x0, y0, x1, y1);
+	LPM_Lock(LPM_LOCK_LCD);
+	LCD_CS_CLR;
+	LCD_RS_SET;
+	for(y = y0; y <= y1; y += h, k ^= 1)
+	{
+		h = y1 - y + 1 < rows ? y1 - y + 1 : rows;
+		Tile_Draw(item, n, strip.px[k], x0, w, y, h);
+		while(busy)
+			;
+		Tile_Send(strip.px[k], w * h);
+	}
+	while(busy)
+		;
+	LCD_CS_SET;
+	LPM_Unlock(LPM_LOCK_LCD);
+}
+
+void Tile_Page(const tile_item_t *item, u8 n)
+{
+	Tile_Render(0, 0, lcddev.width - 1, lcddev.height - 1, item, n);
+}
+
+uint8_t Tile_Busy(void)
+{
+	return busy;
+}
+
+/*****************************************************************************
+ * @name       :void *Tile_Lend(void)
+ * @date       :2026-10-19
+ * @function   :Lend both strips (TILE_PIXELS words) as a work buffer to a
+                module that needs one for a short while. Tile_Render() draws
+                nothing until Tile_Return().
+ * @parameters :None
+ * @retvalue   :the buffer, word aligned, NULL if a strip is on the DMA or
+                the strips are already lent
+******************************************************************************/
+void *Tile_Lend(void)
+{
+	if(lent || busy)
+		return NULL;
+	lent = 1;
+	return strip.w;
+}
+
+void Tile_Return(void)
+{
+	lent = 0;
+}
+
+uint8_t Tile_Lent(void)
+{
+	return lent;
+}
+
+void Tile_DMAIRQHandler(void)
+{
+	HAL_DMA_IRQHandler(&hdma_tile);
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	if(hspi == &hspi1)
+		busy = 0;
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+	//the strip is lost, the area shows stale lines until the next redraw
+	if(hspi == &hspi1)
+		busy = 0;
+}
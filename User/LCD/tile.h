@@ -0,0 +1,55 @@
+#ifndef __TILE_H
+#define __TILE_H
+#include "main.h"
+#include "lcd.h"
+
+//Strip renderer. A frame buffer for the panel would be 64 KB, so a page is
+//described as a list of draw items and rasterised a few lines at a time
+//into one of two strip buffers. A finished strip goes out on the SPI1 TX
+//DMA while the CPU rasterises the next one into the other buffer; the
+//window is opened once and CS stays low for the whole area. Items are
+//drawn in list order, each clipped to the strip, so later items cover
+//earlier ones and the first one should cover the area.
+//A strip holds TILE_PIXELS, i.e. TILE_ROWS lines of the portrait panel
+//(2.2 KB for both). At the full profile one strip is 0.48 ms on the wire,
+//so an area costs per strip the longer of transfer and rasterising
+//instead of their sum. LPM_LOCK_LCD is held while the DMA runs.
+//The strips are the largest buffer in RAM and idle between redraws, so
+//they can be lent out (Tile_Lend()); the caller must not draw until they
+//are back.
+#define TILE_ROWS           4       //portrait lines per strip
+#define TILE_PIXELS         (LCD_W * TILE_ROWS)
+#define TILE_DMA            DMA1_Channel3   //SPI1_TX request
+#define TILE_DMA_IRQn       DMA1_Channel3_IRQn
+#define TILE_DMA_PRIO       3
+#define TILE_STREAMS        2       //compressed images decoded at once in one area
+
+#define TILE_RECT           0       //filled rectangle
+#define TILE_FRAME          1       //one pixel outline of the rectangle
+#define TILE_TEXT           2       //16 px text from x0,y0, transparent
+#define TILE_TEXT_CENTER    3       //16 px text centred between x0 and x1
+#define TILE_LAYER          4       //palette-indexed layer at its own position (layer.h)
+#define TILE_IMAGE          5       //compressed image from x0,y0 (rle.h)
+#define TILE_BARS           6       //column chart rising from y1, one u8 height per column from x0
+
+//RGB565 in panel byte order, as the strips hold it
+#define TILE_PX(c)          ((u16)((u16)(c) << 8 | (u16)(c) >> 8))
+
+typedef struct
+{
+	u8 type;                        //TILE_x
+	u16 x0, y0, x1, y1;             //inclusive, panel coordinates, unused for a layer, x0,y0 for an image
+	u16 color;
+	const void *data;               //text: ASCII, a layer_t, an rle_image_t or bar heights
+} tile_item_t;
+
+void Tile_Init(void);
+void Tile_Render(u16 x0, u16 y0, u16 x1, u16 y1, const tile_item_t *item, u8 n);
+void Tile_Page(const tile_item_t *item, u8 n);
+uint8_t Tile_Busy(void);
+void *Tile_Lend(void);
+void Tile_Return(void);
+uint8_t Tile_Lent(void);
+void Tile_DMAIRQHandler(void);
+
+#endif
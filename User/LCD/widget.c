@@ -0,0 +1,480 @@
+#include "widget.h"
+#include <stdio.h>
+#include <string.h>
+
+static widget_t pool[WIDGET_MAX];
+static u8 used;                     //widgets taken from the pool, pool[0] is the root
+static u8 relayout;
+static tile_item_t list[WIDGET_ITEMS];
+static u8 items;
+
+#define WIDGET_ID(w)        ((u8)((w) - pool))
+
+static widget_t *Widget_New(widget_t *parent, u8 type, u16 fg, u16 bg, const void *data)
+{
+	widget_t *w, *c;
+
+	if(!parent || used == WIDGET_MAX)
+		return NULL;
+	w = &pool[used];
+	memset(w, 0, sizeof(*w));
+	w->type = type;
+	w->parent = WIDGET_ID(parent);
+	w->child = WIDGET_NONE;
+	w->next = WIDGET_NONE;
+	w->fg = fg;
+	w->bg = bg;
+	w->data = data;
+	if(parent->child == WIDGET_NONE)
+		parent->child = used;
+	else
+	{
+		for(c = &pool[parent->child]; c->next != WIDGET_NONE; c = &pool[c->next])
+			;
+		c->next = used;
+	}
+	used++;
+	relayout = 1;
+	return w;
+}
+
+/*****************************************************************************
+ * @name       :widget_t *Widget_Root(u16 x0, u16 y0, u16 x1, u16 y1, u16 bg)
+ * @date       :2026-10-19
+ * @function   :Start a new screen: empty the pool and make the root box,
+                which lays out its children top to bottom in a fixed area.
+                Widgets of the screen before are gone.
+ * @parameters :x0,y0,x1,y1:area of the screen, inclusive
+                bg:background colour
+ * @retvalue   :root widget
+******************************************************************************/
+widget_t *Widget_Root(u16 x0, u16 y0, u16 x1, u16 y1, u16 bg)
+{
+	widget_t *w = &pool[0];
+
+	memset(w, 0, sizeof(*w));
+	w->type = WIDGET_VBOX;
+	w->parent = WIDGET_NONE;
+	w->child = WIDGET_NONE;
+	w->next = WIDGET_NONE;
+	w->x0 = x0;
+	w->y0 = y0;
+	w->x1 = x1;
+	w->y1 = y1;
+	w->bg = bg;
+	used = 1;
+	relayout = 1;
+	return w;
+}
+
+widget_t *Widget_Box(widget_t *parent, u8 type, u16 bg)
+{
+	return Widget_New(parent, type == WIDGET_HBOX ? WIDGET_HBOX : WIDGET_VBOX, 0, bg, NULL);
+}
+
+widget_t *Widget_Label(widget_t *parent, const char *text, u16 fg, u16 bg)
+{
+	return Widget_New(parent, WIDGET_LABEL, fg, bg, text);
+}
+
+//value text, the number right aligned before the unit
+static void Widget_Format(widget_value_t *v, int32_t x)
+{
+	uint32_t u = x < 0 ? -(uint32_t)x : (uint32_t)x, p = 1;
+	char num[WIDGET_VALUE_LEN];
+	u8 i;
+
+	for(i = 0; i < v->frac; i++)
+		p *= 10;
+	if(v->frac)
+		snprintf(num, sizeof(num), "%s%lu.%0*lu", x < 0 ? "-" : "", (unsigned long)(u / p),
+		         v->frac, (unsigned long)(u % p));
+	else
+		snprintf(num, sizeof(num), "%ld", (long)x);
+	snprintf(v->text, sizeof(v->text), "%*s %s", (int)(WIDGET_VALUE_LEN - 2 - strlen(v->unit)), num, v->unit);
+}
+
+/*****************************************************************************
+ * @name       :widget_t *Widget_Value(widget_t *parent, widget_value_t *v, u16 fg, u16 bg)
+ * @date       :2026-10-19
+ * @function   :Add a value readout showing 0. The box is as wide as
+                WIDGET_VALUE_LEN - 1 characters, so new values never need
+                a layout pass.
+ * @parameters :parent:box to add to
+                v:unit, digits after the point and the text buffer, kept
+                by the caller
+                fg,bg:text and background colour
+ * @retvalue   :widget, NULL when the pool is full
+******************************************************************************/
+widget_t *Widget_Value(widget_t *parent, widget_value_t *v, u16 fg, u16 bg)
+{
+	widget_t *w = Widget_New(parent, WIDGET_VALUE, fg, bg, v);
+
+	if(w)
+		Widget_Format(v, 0);
+	return w;
+}
+
+widget_t *Widget_Bar(widget_t *parent, u16 w, u16 h, u16 fg, u16 bg)
+{
+	widget_t *b = Widget_New(parent, WIDGET_BAR, fg, bg, NULL);
+
+	if(b)
+	{
+		b->w = w;
+		b->h = h;
+	}
+	return b;
+}
+
+/*****************************************************************************
+ * @name       :widget_t *Widget_Chart(widget_t *parent, u8 *samples, u16 w, u16 h, u16 fg, u16 bg)
+ * @date       :2026-10-19
+ * @function   :Add a column chart scrolling to the left, one sample per
+                column. The samples are cleared.
+ * @parameters :parent:box to add to
+                samples:w bytes kept by the caller
+                w,h:size in pixels, h up to 255
+                fg,bg:column and background colour
+ * @retvalue   :widget, NULL when the pool is full
+******************************************************************************/
+widget_t *Widget_Chart(widget_t *parent, u8 *samples, u16 w, u16 h, u16 fg, u16 bg)
+{
+	widget_t *c = Widget_New(parent, WIDGET_CHART, fg, bg, samples);
+
+	if(c)
+	{
+		memset(samples, 0, w);
+		c->w = w;
+		c->h = h < 255 ? h : 255;
+	}
+	return c;
+}
+
+//the selected row is drawn in bg on fg
+widget_t *Widget_Menu(widget_t *parent, const char * const *rows, u8 n, u16 fg, u16 bg)
+{
+	widget_t *m = Widget_New(parent, WIDGET_MENU, fg, bg, rows);
+
+	if(m)
+		m->rows = n;
+	return m;
+}
+
+void Widget_Invalidate(widget_t *w)
+{
+	if(w)
+		w->flags |= WIDGET_DIRTY;
+}
+
+//a new text is always drawn, the caller may have changed the old buffer; a
+//longer one lays the screen out again, a shorter one keeps the box
+void Widget_SetText(widget_t *w, const char *text)
+{
+	if(!w || w->type != WIDGET_LABEL)
+		return;
+	w->data = text;
+	if(strlen(text) * 8 + 2 * WIDGET_PAD > w->w)
+		relayout = 1;
+	w->flags |= WIDGET_DIRTY;
+}
+
+/*****************************************************************************
+ * @name       :void Widget_SetValue(widget_t *w, int32_t v)
+ * @date       :2026-10-19
+ * @function   :Set the number of a value readout, the fill of a bar or the
+                selected row of a menu. The widget is only drawn again when
+                what it shows changes.
+ * @parameters :w:value, bar or menu
+                v:value in units of the last digit, fill in 1/WIDGET_FULL
+                or row
+ * @retvalue   :None
+******************************************************************************/
+void Widget_SetValue(widget_t *w, int32_t v)
+{
+	if(!w)
+		return;
+	if(w->type == WIDGET_BAR)
+		v = v < 0 ? 0 : v > WIDGET_FULL ? WIDGET_FULL : v;
+	if(v == w->value)
+		return;
+	w->value = v;
+	if(w->type == WIDGET_VALUE)
+		Widget_Format((widget_value_t *)w->data, v);
+	w->flags |= WIDGET_DIRTY;
+}
+
+//scroll the chart one column and add a sample in 1/WIDGET_FULL of its height
+void Widget_ChartPush(widget_t *w, int32_t v)
+{
+	u8 *s;
+
+	if(!w || w->type != WIDGET_CHART)
+		return;
+	s = (u8 *)w->data;
+	v = v < 0 ? 0 : v > WIDGET_FULL ? WIDGET_FULL : v;
+	memmove(s, s + 1, w->w - 1);
+	s[w->w - 1] = v * w->h / WIDGET_FULL;
+	w->flags |= WIDGET_DIRTY;
+}
+
+void Widget_Show(widget_t *w, u8 on)
+{
+	if(!w || w == pool || !(w->flags & WIDGET_HIDDEN) == !!on)
+		return;
+	w->flags ^= WIDGET_HIDDEN;
+	relayout = 1;
+}
+
+//size of a widget from its content, boxes from their visible children
+static void Widget_Measure(widget_t *w)
+{
+	const char * const *row;
+	widget_t *c;
+	u16 len;
+	u8 i, n = 0;
+
+	switch(w->type)
+	{
+	case WIDGET_LABEL:
+		w->w = strlen(w->data) * 8 + 2 * WIDGET_PAD;
+		w->h = WIDGET_ROW_H;
+		break;
+	case WIDGET_VALUE:
+		w->w = (WIDGET_VALUE_LEN - 1) * 8 + 2 * WIDGET_PAD;
+		w->h = WIDGET_ROW_H;
+		break;
+	case WIDGET_MENU:
+		row = w->data;
+		w->w = 0;
+		for(i = 0; i < w->rows; i++)
+		{
+			len = strlen(row[i]) * 8;
+			if(len > w->w)
+				w->w = len;
+		}
+		w->w += 2 * WIDGET_PAD;
+		w->h = w->rows * WIDGET_ROW_H;
+		break;
+	case WIDGET_VBOX:
+	case WIDGET_HBOX:
+		w->w = 0;
+		w->h = 0;
+		for(i = w->child; i != WIDGET_NONE; i = c->next)
+		{
+			c = &pool[i];
+			if(c->flags & WIDGET_HIDDEN)
+				continue;
+			Widget_Measure(c);
+			if(w->type == WIDGET_VBOX)
+			{
+				w->w = c->w > w->w ? c->w : w->w;
+				w->h += c->h;
+			}
+			else
+			{
+				w->w += c->w;
+				w->h = c->h > w->h ? c->h : w->h;
+			}
+			n++;
+		}
+		if(w->type == WIDGET_VBOX)
+			w->h += n * WIDGET_PAD;
+		else
+			w->w += n * WIDGET_PAD;
+		w->w += WIDGET_PAD;
+		w->h += WIDGET_PAD;
+		break;
+	}
+}
+
+/*****************************************************************************
+ * @name       :static void Widget_Place(widget_t *w, u16 x, u16 y, u16 xm, u16 ym)
+ * @date       :2026-10-19
+ * @function   :Give a widget its box at its measured size and place its
+                children inside. Boxes are clipped to the parent, a widget
+                that starts outside it gets an empty box and is not drawn.
+ * @parameters :w:widget
+                x,y:top left
+                xm,ym:last column and line of the parent
+ * @retvalue   :None
+******************************************************************************/
+static void Widget_Place(widget_t *w, u16 x, u16 y, u16 xm, u16 ym)
+{
+	widget_t *c;
+	u8 i;
+
+	w->x0 = x;
+	w->y0 = y;
+	if(x > xm || y > ym || !w->w || !w->h)
+	{
+		w->x0 = 1;                  //empty
+		w->x1 = 0;
+		return;
+	}
+	w->x1 = x + w->w - 1 < xm ? x + w->w - 1 : xm;
+	w->y1 = y + w->h - 1 < ym ? y + w->h - 1 : ym;
+	if(w->type != WIDGET_VBOX && w->type != WIDGET_HBOX)
+		return;
+	x += WIDGET_PAD;
+	y += WIDGET_PAD;
+	for(i = w->child; i != WIDGET_NONE; i = c->next)
+	{
+		c = &pool[i];
+		if(c->flags & WIDGET_HIDDEN)
+			continue;
+		Widget_Place(c, x, y, w->x1, w->y1);
+		if(w->type == WIDGET_VBOX)
+			y += c->h + WIDGET_PAD;
+		else
+			x += c->w + WIDGET_PAD;
+	}
+}
+
+static u8 Widget_Item(u8 type, u16 x0, u16 y0, u16 x1, u16 y1, u16 color, const void *data)
+{
+	tile_item_t *it = &list[items];
+
+	if(items == WIDGET_ITEMS)
+		return 0;
+	it->type = type;
+	it->x0 = x0;
+	it->y0 = y0;
+	it->x1 = x1;
+	it->y1 = y1;
+	it->color = color;
+	it->data = data;
+	items++;
+	return 1;
+}
+
+/*****************************************************************************
+ * @name       :static u8 Widget_Items(const widget_t *w, u8 deep)
+ * @date       :2026-10-19
+ * @function   :Add the draw items of a widget to the list, the background
+                first, then for a box those of its visible children
+ * @parameters :w:widget with a box
+                deep:also the children of a box
+ * @retvalue   :0 when the list is full
+******************************************************************************/
+static u8 Widget_Items(const widget_t *w, u8 deep)
+{
+	const widget_t *c;
+	const char * const *row;
+	u16 y, fill;
+	u8 i, ok;
+
+	ok = Widget_Item(TILE_RECT, w->x0, w->y0, w->x1, w->y1, w->bg, NULL);
+	switch(w->type)
+	{
+	case WIDGET_LABEL:
+	case WIDGET_VALUE:
+		ok &= Widget_Item(TILE_TEXT, w->x0 + WIDGET_PAD, w->y0 + (WIDGET_ROW_H - 16) / 2, w->x1, w->y1, w->fg,
+		                  w->type == WIDGET_LABEL ? w->data : ((const widget_value_t *)w->data)->text);
+		break;
+	case WIDGET_BAR:
+		ok &= Widget_Item(TILE_FRAME, w->x0, w->y0, w->x1, w->y1, w->fg, NULL);
+		if(w->x1 - w->x0 < 2 || w->y1 - w->y0 < 2)
+			break;
+		fill = (u32)(w->x1 - w->x0 - 1) * w->value / WIDGET_FULL;
+		if(fill)
+			ok &= Widget_Item(TILE_RECT, w->x0 + 1, w->y0 + 1, w->x0 + fill, w->y1 - 1, w->fg, NULL);
+		break;
+	case WIDGET_CHART:
+		ok &= Widget_Item(TILE_BARS, w->x0, w->y0, w->x1, w->y1, w->fg, w->data);
+		break;
+	case WIDGET_MENU:
+		row = w->data;
+		for(i = 0, y = w->y0; i < w->rows && y <= w->y1; i++, y += WIDGET_ROW_H)
+		{
+			if(i == w->value)
+				ok &= Widget_Item(TILE_RECT, w->x0, y, w->x1, y + WIDGET_ROW_H - 1 < w->y1 ? y + WIDGET_ROW_H - 1 : w->y1,
+				                  w->fg, NULL);
+			ok &= Widget_Item(TILE_TEXT, w->x0 + WIDGET_PAD, y + (WIDGET_ROW_H - 16) / 2, w->x1, w->y1,
+			                  i == w->value ? w->bg : w->fg, row[i]);
+		}
+		break;
+	default:
+		if(!deep)
+			break;
+		for(i = w->child; i != WIDGET_NONE && ok; i = c->next)
+		{
+			c = &pool[i];
+			if(!(c->flags & WIDGET_HIDDEN) && c->x0 <= c->x1)
+				ok = Widget_Items(c, 1);
+		}
+		break;
+	}
+	return ok;
+}
+
+static void Widget_Clean(widget_t *w)
+{
+	u8 i;
+
+	w->flags &= ~WIDGET_DIRTY;
+	for(i = w->child; i != WIDGET_NONE; i = pool[i].next)
+		Widget_Clean(&pool[i]);
+}
+
+/*****************************************************************************
+ * @name       :static void Widget_Redraw(widget_t *w)
+ * @date       :2026-10-19
+ * @function   :Draw the dirty widgets of a subtree. A dirty box is drawn in
+                one area with all its children when they fit the draw list,
+                otherwise its background goes first and the children are
+                drawn one by one after it.
+ * @parameters :w:top of the subtree
+ * @retvalue   :None
+******************************************************************************/
+static void Widget_Redraw(widget_t *w)
+{
+	u8 i;
+
+	if((w->flags & WIDGET_HIDDEN) || w->x0 > w->x1)
+		return;
+	if(w->flags & WIDGET_DIRTY)
+	{
+		items = 0;
+		if(Widget_Items(w, 1))
+		{
+			Tile_Render(w->x0, w->y0, w->x1, w->y1, list, items);
+			Widget_Clean(w);
+			return;
+		}
+		items = 0;
+		Widget_Items(w, 0);
+		Tile_Render(w->x0, w->y0, w->x1, w->y1, list, items);
+		w->flags &= ~WIDGET_DIRTY;
+		for(i = w->child; i != WIDGET_NONE; i = pool[i].next)
+			pool[i].flags |= WIDGET_DIRTY;
+	}
+	for(i = w->child; i != WIDGET_NONE; i = pool[i].next)
+		Widget_Redraw(&pool[i]);
+}
+
+/*****************************************************************************
+ * @name       :void Widget_Update(void)
+ * @date       :2026-10-19
+ * @function   :Lay the screen out again if needed, which redraws all of it,
+                then draw the widgets that changed since the last update
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Widget_Update(void)
+{
+	widget_t *root = &pool[0];
+
+	if(!used)
+		return;
+	if(relayout)
+	{
+		Widget_Measure(root);
+		root->w = root->x1 - root->x0 + 1;      //the root keeps its area
+		root->h = root->y1 - root->y0 + 1;
+		Widget_Place(root, root->x0, root->y0, root->x1, root->y1);
+		root->flags |= WIDGET_DIRTY;
+		relayout = 0;
+	}
+	Widget_Redraw(root);
+}
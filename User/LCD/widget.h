@@ -0,0 +1,69 @@
+#ifndef __WIDGET_H
+#define __WIDGET_H
+#include "main.h"
+#include "tile.h"
+
+//Retained widgets. A screen is a tree of labels, value readouts, bar
+//gauges, charts and menus in boxes that stack their children top to
+//bottom or left to right, taken from a static pool (WIDGET_MAX * 32
+//bytes, no heap). A layout pass measures the tree bottom up and places it
+//top down; it runs only after the tree changed or a label outgrew its box.
+//Setters compare with what is shown and only mark a widget dirty;
+//Widget_Update() then draws each dirty widget, with everything inside it,
+//as one area through the strip renderer, so a new reading costs the box
+//of the readout and not the page. Texts, chart samples and menu rows stay
+//with the caller, like layer bits.
+#define WIDGET_MAX          10
+#define WIDGET_NONE         0xFF    //pool link to no widget
+#define WIDGET_ITEMS        8       //draw list of one area
+#define WIDGET_PAD          2       //inside a box and between its children
+#define WIDGET_ROW_H        20      //a line of 16 px text
+#define WIDGET_VALUE_LEN    11      //value text with the unit and the terminator, 84 px wide
+#define WIDGET_FULL         1000    //bar fill and chart samples are in 1/1000 of full scale
+
+#define WIDGET_VBOX         0       //children top to bottom
+#define WIDGET_HBOX         1       //children left to right
+#define WIDGET_LABEL        2
+#define WIDGET_VALUE        3
+#define WIDGET_BAR          4
+#define WIDGET_CHART        5
+#define WIDGET_MENU         6
+
+#define WIDGET_DIRTY        0x01    //draw at the next update
+#define WIDGET_HIDDEN       0x02    //left out of the layout
+
+typedef struct
+{
+	u8 type;                        //WIDGET_x
+	u8 flags;
+	u8 parent, child, next;         //pool indices or WIDGET_NONE
+	u8 rows;                        //menu rows
+	u16 w, h;                       //measured size, given for a bar or a chart
+	u16 x0, y0, x1, y1;             //placed box, inclusive, empty when x0 > x1
+	u16 fg, bg;
+	int32_t value;                  //value shown, bar fill or selected menu row
+	const void *data;               //label text, widget_value_t, chart heights or menu rows
+} widget_t;
+
+typedef struct
+{
+	const char *unit;
+	u8 frac;                        //digits after the point
+	char text[WIDGET_VALUE_LEN];
+} widget_value_t;
+
+widget_t *Widget_Root(u16 x0, u16 y0, u16 x1, u16 y1, u16 bg);
+widget_t *Widget_Box(widget_t *parent, u8 type, u16 bg);
+widget_t *Widget_Label(widget_t *parent, const char *text, u16 fg, u16 bg);
+widget_t *Widget_Value(widget_t *parent, widget_value_t *v, u16 fg, u16 bg);
+widget_t *Widget_Bar(widget_t *parent, u16 w, u16 h, u16 fg, u16 bg);
+widget_t *Widget_Chart(widget_t *parent, u8 *samples, u16 w, u16 h, u16 fg, u16 bg);
+widget_t *Widget_Menu(widget_t *parent, const char * const *rows, u8 n, u16 fg, u16 bg);
+void Widget_SetText(widget_t *w, const char *text);
+void Widget_SetValue(widget_t *w, int32_t v);
+void Widget_ChartPush(widget_t *w, int32_t v);
+void Widget_Show(widget_t *w, u8 on);
+void Widget_Invalidate(widget_t *w);
+void Widget_Update(void);
+
+#endif
@@ -0,0 +1,303 @@
+#include "log.h"
+#include "w25qxx.h"
+#include "timestamp.h"
+#include <stdio.h>
+
+#define LOG_STATE_OFF       0       //no flash found
+#define LOG_STATE_IDLE      1
+#define LOG_STATE_ERASE     2
+#define LOG_STATE_PROG      3
+
+static log_rec_t page_buf[2][LOG_REC_PER_PAGE];
+static uint8_t fill;                //buffer collecting records
+static uint8_t fill_n;
+static uint8_t wr_n;                //records in the other buffer waiting for flash, 0 = free
+static uint8_t flush_req;
+static uint8_t state;
+static uint32_t page;               //next flash page to program
+static uint32_t pages;              //flash size in pages
+static uint32_t seq;
+static uint32_t dropped;            //records lost because both buffers were full
+static sched_timer_t rec_timer;
+static sched_timer_t poll_timer;
+
+/*****************************************************************************
+ * @name       :static void Log_Locate(void)
+ * @date       :2026-10-19
+ * @function   :Find where the previous session stopped: the sector whose
+                first record has the highest number holds the newest data,
+                writing resumes at its first empty page.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Log_Locate(void)
+{
+	uint32_t s, first, best = 0, best_seq = 0;
+	uint32_t p, end;
+	uint8_t found = 0, i;
+	log_rec_t *r = page_buf[0];
+
+	for(s = 0; s < w25qxx.SectorCount - LOG_RESERVED_SECTORS; s++)
+	{
+		W25qxx_ReadBytesNow((uint8_t *)&first, s * w25qxx.SectorSize, sizeof(first));
+		if(first != LOG_SEQ_ERASED && (!found || first > best_seq))
+		{
+			best = s;
+			best_seq = first;
+			found = 1;
+		}
+	}
+	page = 0;
+	seq = 0;
+	if(!found)
+		return;
+	p = W25qxx_SectorToPage(best);
+	end = p + w25qxx.SectorSize / w25qxx.PageSize;
+	for(; p < end; p++)
+	{
+		W25qxx_ReadBytesNow((uint8_t *)r, p * w25qxx.PageSize, LOG_PAGE_SIZE);
+		if(r[0].seq == LOG_SEQ_ERASED)
+			break;
+		for(i = 0; i < LOG_REC_PER_PAGE && r[i].seq != LOG_SEQ_ERASED; i++)
+			seq = r[i].seq + 1;
+	}
+	page = p < pages ? p : 0;
+}
+
+/*****************************************************************************
+ * @name       :void Log_Init(void)
+ * @date       :2026-10-19
+ * @function   :Probe the flash, resume after the last stored record and
+                start recording. Without a flash the log stays off and never
+                reports pending data.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Log_Init(void)
+{
+	if(!W25qxx_Init())
+	{
+		state = LOG_STATE_OFF;
+		return;
+	}
+	pages = w25qxx.PageCount - LOG_RESERVED_SECTORS * (w25qxx.SectorSize / w25qxx.PageSize);
+	Log_Locate();
+	state = LOG_STATE_IDLE;
+	Log_Start();
+}
+
+void Log_Start(void)
+{
+	if(state != LOG_STATE_OFF)
+		Sched_TimerStart(&rec_timer, LOG_TASK, LOG_SIG_TICK, LOG_PERIOD_MS, LOG_PERIOD_MS);
+}
+
+/*****************************************************************************
+ * @name       :void Log_Stop(void)
+ * @date       :2026-10-19
+ * @function   :Stop taking records and write out what is buffered, e.g.
+                before the supply is dropped. Log_Pending() tells when the
+                data is on the flash.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Log_Stop(void)
+{
+	Sched_TimerStop(&rec_timer);
+	Log_Flush();
+}
+
+void Log_Flush(void)
+{
+	Sched_Signal(LOG_TASK, LOG_SIG_FLUSH);
+}
+
+uint8_t Log_Pending(void)
+{
+	if(state == LOG_STATE_OFF)
+		return 0;
+	return fill_n || wr_n || flush_req || state != LOG_STATE_IDLE;
+}
+
+/*****************************************************************************
+ * @name       :static void Log_Kick(void)
+ * @date       :2026-10-19
+ * @function   :Hand a full (or, on flush, partial) page to the flash and
+                start the next erase or program step
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Log_Kick(void)
+{
+	if(state != LOG_STATE_IDLE)
+		return;
+	if(wr_n == 0 && (fill_n == LOG_REC_PER_PAGE || (flush_req && fill_n)))
+	{
+		wr_n = fill_n;
+		fill ^= 1;
+		fill_n = 0;
+	}
+	if(wr_n == 0)
+	{
+		flush_req = 0;
+		return;
+	}
+	if(W25qxx_IsBusy())
+	{
+		Sched_TimerStart(&poll_timer, LOG_TASK, LOG_SIG_POLL, LOG_PROG_POLL_MS, 0);
+		return;
+	}
+	if(page % (w25qxx.SectorSize / w25qxx.PageSize) == 0)
+	{
+		W25qxx_EraseSectorStart(W25qxx_PageToSector(page));
+		state = LOG_STATE_ERASE;
+		Sched_TimerStart(&poll_timer, LOG_TASK, LOG_SIG_POLL, LOG_ERASE_POLL_MS, 0);
+	}
+	else
+	{
+		W25qxx_WritePageStart((uint8_t *)page_buf[fill ^ 1], page, 0, wr_n * sizeof(log_rec_t));
+		state = LOG_STATE_PROG;
+		Sched_TimerStart(&poll_timer, LOG_TASK, LOG_SIG_POLL, LOG_PROG_POLL_MS, 0);
+	}
+}
+
+/*****************************************************************************
+ * @name       :static void Log_Poll(void)
+ * @date       :2026-10-19
+ * @function   :Advance the erase -> program -> next page sequence once the
+                chip reports ready
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Log_Poll(void)
+{
+	if(state == LOG_STATE_IDLE)
+	{
+		Log_Kick();
+		return;
+	}
+	if(W25qxx_IsBusy())
+	{
+		Sched_TimerStart(&poll_timer, LOG_TASK, LOG_SIG_POLL,
+		                 state == LOG_STATE_ERASE ? LOG_ERASE_POLL_MS : LOG_PROG_POLL_MS, 0);
+		return;
+	}
+	if(state == LOG_STATE_ERASE)
+	{
+		W25qxx_WritePageStart((uint8_t *)page_buf[fill ^ 1], page, 0, wr_n * sizeof(log_rec_t));
+		state = LOG_STATE_PROG;
+		Sched_TimerStart(&poll_timer, LOG_TASK, LOG_SIG_POLL, LOG_PROG_POLL_MS, 0);
+		return;
+	}
+	if(++page >= pages)
+		page = 0;
+	wr_n = 0;
+	state = LOG_STATE_IDLE;
+	Log_Kick();
+}
+
+static void Log_Record(void)
+{
+	log_rec_t *r;
+	ts_t ts;
+	uint8_t ch;
+
+	if(fill_n == LOG_REC_PER_PAGE)
+	{
+		dropped++;
+		return;
+	}
+	r = &page_buf[fill][fill_n++];
+	TS_Now(&ts);
+	r->seq = seq++;
+	r->sec = (TS_GetFlags() & TS_FLAG_VALID) ? ts.sec : 0;
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+		r->avg[ch] = acq_last.avg[ch];
+}
+
+/*****************************************************************************
+ * @name       :void Log_Process(uint8_t sig)
+ * @date       :2026-10-19
+ * @function   :LOG_TASK handler
+ * @parameters :sig:LOG_SIG_TICK, LOG_SIG_POLL, LOG_SIG_FLUSH or LOG_SIG_EVENT
+ * @retvalue   :None
+******************************************************************************/
+void Log_Process(uint8_t sig)
+{
+	if(state == LOG_STATE_OFF)
+		return;
+	if(sig == LOG_SIG_TICK)
+		Log_Record();
+	else if(sig == LOG_SIG_FLUSH)
+		flush_req = 1;
+	if(sig == LOG_SIG_POLL)
+		Log_Poll();
+	else
+		Log_Kick();
+}
+
+/*****************************************************************************
+ * @name       :void Log_Event(uint8_t type, const ts_t *ts, uint16_t a, uint16_t b)
+ * @date       :2026-10-19
+ * @function   :Queue an event record in the measurement stream. Callable
+                from any task; the page is handed to the flash from LOG_TASK.
+ * @parameters :type:LOG_EVT_x
+                ts:time of the event
+                a, b:payload, see LOG_EVT_x
+ * @retvalue   :None
+******************************************************************************/
+void Log_Event(uint8_t type, const ts_t *ts, uint16_t a, uint16_t b)
+{
+	log_evt_t *e;
+
+	if(state == LOG_STATE_OFF)
+		return;
+	if(fill_n == LOG_REC_PER_PAGE)
+	{
+		dropped++;
+		return;
+	}
+	e = (log_evt_t *)&page_buf[fill][fill_n++];
+	e->seq = seq++;
+	e->sec = (TS_GetFlags() & TS_FLAG_VALID) ? ts->sec : 0;
+	e->type = type;
+	e->tag = LOG_EVT_TAG;
+	e->ms = ts->usec / 1000;
+	e->a = a;
+	e->b = b;
+	Sched_Signal(LOG_TASK, LOG_SIG_EVENT);
+}
+
+/*****************************************************************************
+ * @name       :uint32_t Log_Crc(const void *p, uint32_t len)
+ * @date       :2026-10-19
+ * @function   :CRC-32 of a record kept in the reserved sectors, from the
+                CRC unit (poly 0x04C11DB7, words in memory order)
+ * @parameters :p:record, word aligned
+                len:bytes, multiple of 4
+ * @retvalue   :CRC
+******************************************************************************/
+uint32_t Log_Crc(const void *p, uint32_t len)
+{
+	const uint32_t *w = p;
+
+	__HAL_RCC_CRC_CLK_ENABLE();
+	CRC->CR = CRC_CR_RESET;
+	for(len >>= 2; len; len--)
+		CRC->DR = *w++;
+	return CRC->DR;
+}
+
+uint32_t Log_GetSeq(void)
+{
+	return seq;
+}
+
+void Log_Report(void)
+{
+	static const char * const name[] = {"off", "idle", "erase", "prog"};
+
+	printf("log %s  page %lu/%lu  seq %lu  buffered %u  dropped %lu\r\n", name[state],
+	       (unsigned long)page, (unsigned long)pages, (unsigned long)seq,
+	       (unsigned)(fill_n + wr_n), (unsigned long)dropped);
+}
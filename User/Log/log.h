@@ -0,0 +1,63 @@
+#ifndef __LOG_H
+#define __LOG_H
+#include "main.h"
+#include "sched.h"
+#include "acq.h"
+#include "timestamp.h"
+
+//Measurement log on the SPI2 W25Qxx flash. One record per LOG_PERIOD_MS is
+//collected in a RAM page; full pages are programmed while the next one
+//fills. The flash is used as a ring: the sector ahead of the write pointer
+//is erased just before its first page is needed. Erase and program are
+//started and then polled from LOG_TASK, the CPU never waits on the chip.
+//Events (log_evt_t) share the ring and the record numbering; they are told
+//apart by LOG_EVT_TAG where a measurement has the high byte of avg[0].
+#define LOG_TASK            SCHED_TASK_LOG
+#define LOG_SIG_TICK        0       //record timer
+#define LOG_SIG_POLL        1       //flash busy poll
+#define LOG_SIG_FLUSH       2       //program the partial page now
+#define LOG_SIG_EVENT       6       //an event record was queued
+
+#define LOG_PERIOD_MS       1000
+#define LOG_PROG_POLL_MS    1       //page program takes ~0.7 ms
+#define LOG_ERASE_POLL_MS   10      //sector erase takes 45..400 ms
+#define LOG_PAGE_SIZE       256
+#define LOG_SEQ_ERASED      0xFFFFFFFF
+#define LOG_RESERVED_SECTORS 19     //top of the flash: capacity checkpoints (capacity.h), event captures (cap.h), calibration (cal.h)
+
+typedef struct
+{
+	uint32_t seq;                   //record number, LOG_SEQ_ERASED = empty slot
+	uint32_t sec;                   //Unix seconds, 0 while the clock is unknown
+	uint16_t avg[ACQ_CH_NUM];       //raw block averages, see acq_block_t
+} log_rec_t;
+
+#define LOG_EVT_TAG         0xE5    //raw averages are 12 bit, their high byte is < 0x10
+#define LOG_EVT_VSTEP       1       //Uin left its plateau: a = plateau mV, b = reading at detection
+#define LOG_EVT_PLATEAU     2       //Uin settled: a = mV, b = CHARGE_CLS_x
+#define LOG_EVT_CAPACITY    3       //capacity test ended: a = mAh (saturated), b = CAPACITY_END_x
+
+typedef struct
+{
+	uint32_t seq;                   //shared with log_rec_t
+	uint32_t sec;                   //Unix seconds, 0 while the clock is unknown
+	uint8_t type;                   //LOG_EVT_x
+	uint8_t tag;                    //LOG_EVT_TAG
+	uint16_t ms;                    //milliseconds within sec
+	uint16_t a, b;                  //per type
+} log_evt_t;                        //same size as log_rec_t
+
+#define LOG_REC_PER_PAGE    (LOG_PAGE_SIZE / sizeof(log_rec_t))
+
+void Log_Init(void);
+void Log_Start(void);
+void Log_Stop(void);
+void Log_Flush(void);
+uint8_t Log_Pending(void);
+uint32_t Log_GetSeq(void);
+uint32_t Log_Crc(const void *p, uint32_t len);
+void Log_Event(uint8_t type, const ts_t *ts, uint16_t a, uint16_t b);
+void Log_Process(uint8_t sig);
+void Log_Report(void);
+
+#endif
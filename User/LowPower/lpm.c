@@ -0,0 +1,309 @@
+#include "lpm.h"
+#include "timestamp.h"
+#include "clock.h"
+#include <stdio.h>
+
+#define LPM_EXTI_ALARM   EXTI_IMR_MR17      //RTC alarm is routed to EXTI line 17
+
+static volatile uint8_t locks;
+static uint8_t rtc_ok;                  //LSE running and RTC prescaler set
+static uint64_t res_us[LPM_MODE_NUM];   //residency in the current report window
+static uint32_t entries[LPM_MODE_NUM];
+static uint32_t window_ms;
+
+/*****************************************************************************
+ * @name       :void LPM_Init(void)
+ * @date       :2026-10-19
+ * @function   :Open the backup domain and start the LSE crystal. The crystal
+                takes up to ~2 s to settle, Stop mode is only used once it
+                runs; until then every idle is a Sleep.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void LPM_Init(void)
+{
+	__HAL_RCC_PWR_CLK_ENABLE();
+	__HAL_RCC_BKP_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+	if((RCC->BDCR & RCC_BDCR_RTCSEL) != RCC_BDCR_RTCSEL_LSE)
+	{
+		//the RTC clock source can only be changed after a backup domain reset
+		__HAL_RCC_BACKUPRESET_FORCE();
+		__HAL_RCC_BACKUPRESET_RELEASE();
+	}
+	RCC->BDCR |= RCC_BDCR_LSEON;
+	HAL_NVIC_SetPriority(RTC_Alarm_IRQn, 3, 0);
+	HAL_NVIC_EnableIRQ(RTC_Alarm_IRQn);
+	window_ms = HAL_GetTick();
+}
+
+static void LPM_RtcWrite(void)
+{
+	while(!(RTC->CRL & RTC_CRL_RTOFF));
+	RTC->CRL |= RTC_CRL_CNF;
+}
+
+static void LPM_RtcWriteDone(void)
+{
+	RTC->CRL &= ~RTC_CRL_CNF;
+	while(!(RTC->CRL & RTC_CRL_RTOFF));
+}
+
+static void LPM_RtcSync(void)
+{
+	RTC->CRL &= ~RTC_CRL_RSF;
+	while(!(RTC->CRL & RTC_CRL_RSF));
+}
+
+/*****************************************************************************
+ * @name       :static uint8_t LPM_RtcReady(void)
+ * @date       :2026-10-19
+ * @function   :Finish the RTC set-up once the LSE is stable: LSE clock,
+                LPM_RTC_HZ counter, alarm routed to EXTI line 17
+ * @parameters :None
+ * @retvalue   :1 when the RTC can be used as Stop-mode wake-up timer
+******************************************************************************/
+static uint8_t LPM_RtcReady(void)
+{
+	if(rtc_ok)
+		return 1;
+	if(!(RCC->BDCR & RCC_BDCR_LSERDY))
+		return 0;
+	RCC->BDCR |= RCC_BDCR_RTCSEL_LSE | RCC_BDCR_RTCEN;
+	LPM_RtcSync();
+	LPM_RtcWrite();
+	RTC->PRLH = 0;
+	RTC->PRLL = 32768 / LPM_RTC_HZ - 1;
+	LPM_RtcWriteDone();
+	RTC->CRH |= RTC_CRH_ALRIE;
+	EXTI->IMR |= LPM_EXTI_ALARM;
+	EXTI->RTSR |= LPM_EXTI_ALARM;
+	rtc_ok = 1;
+	return 1;
+}
+
+static uint32_t LPM_RtcCount(void)
+{
+	uint16_t h, l;
+
+	do
+	{
+		h = RTC->CNTH;
+		l = RTC->CNTL;
+	} while(h != RTC->CNTH);
+	return ((uint32_t)h << 16) | l;
+}
+
+static void LPM_RtcAlarm(uint32_t alarm)
+{
+	LPM_RtcWrite();
+	RTC->ALRH = alarm >> 16;
+	RTC->ALRL = alarm & 0xFFFF;
+	LPM_RtcWriteDone();
+	RTC->CRL &= ~RTC_CRL_ALRF;
+	EXTI->PR = LPM_EXTI_ALARM;
+	NVIC_ClearPendingIRQ(RTC_Alarm_IRQn);
+}
+
+void LPM_AlarmIRQHandler(void)
+{
+	RTC->CRL &= ~RTC_CRL_ALRF;
+	EXTI->PR = LPM_EXTI_ALARM;
+}
+
+/*****************************************************************************
+ * @name       :static void LPM_TickRestart(uint32_t load, uint32_t e)
+ * @date       :2026-10-19
+ * @function   :Credit the HAL tick with the ticks that passed while SysTick
+                was reprogrammed or stopped and restart it in phase
+ * @parameters :load:SysTick cycles per tick
+                e:cycles since the last tick boundary before the idle
+ * @retvalue   :None
+******************************************************************************/
+static void LPM_TickRestart(uint32_t load, uint32_t e)
+{
+	uint32_t rem;
+
+	uwTick += e / load;
+	rem = load - e % load;
+	if(rem <= LPM_TICK_COMP)
+	{
+		uwTick++;           //boundary is a few cycles away, count it now
+		rem = load;
+	}
+	SysTick->LOAD = rem - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+	SysTick->LOAD = load - 1;   //takes effect at the next reload
+}
+
+/*****************************************************************************
+ * @name       :static void LPM_Sleep(uint32_t ms)
+ * @date       :2026-10-19
+ * @function   :Sleep with SysTick stretched to the deadline. The 24-bit
+                counter limits one sleep to ~233 ms at 72 MHz, the scheduler
+                simply sleeps again.
+ * @parameters :ms:time to the next timer deadline
+ * @retvalue   :None
+******************************************************************************/
+static void LPM_Sleep(uint32_t ms)
+{
+	uint32_t load = SysTick->LOAD + 1;
+	uint32_t val, reload, e;
+
+	if(ms > SysTick_LOAD_RELOAD_Msk / load)
+		ms = SysTick_LOAD_RELOAD_Msk / load;
+	if(ms < 2)
+	{
+		__WFI();            //the next tick is the deadline anyway
+		return;
+	}
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+	if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;   //a tick is due, serve it first
+		return;
+	}
+	val = SysTick->VAL;
+	reload = val + (ms - 1) * load;
+	SysTick->LOAD = reload - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	__DSB();
+	__WFI();
+	__ISB();
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+	if(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+	{
+		//deadline reached, the counter has reloaded and the tick is pending
+		SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+		e = reload + (reload - 1 - SysTick->VAL);
+	}
+	else
+		e = reload - 1 - SysTick->VAL;      //woken early by another interrupt
+	LPM_TickRestart(load, e + load - val + LPM_TICK_COMP);
+}
+
+/*****************************************************************************
+ * @name       :static void LPM_Stop(uint32_t ms)
+ * @date       :2026-10-19
+ * @function   :Stop mode with the RTC alarm as wake-up timer. The elapsed
+                time is read back from the RTC counter, so an early key wake
+                is accounted for as well.
+ * @parameters :ms:time to sleep, at most LPM_STOP_MAX_MS
+ * @retvalue   :None
+******************************************************************************/
+static void LPM_Stop(uint32_t ms)
+{
+	uint32_t load = SysTick->LOAD + 1;
+	uint32_t val, cnt0, us;
+
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+	if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		return;
+	}
+	val = SysTick->VAL;
+	cnt0 = LPM_RtcCount();
+	LPM_RtcAlarm(cnt0 + ms * LPM_RTC_HZ / 1000);
+	HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+	Clock_Restore();            //Stop falls back to HSI, restore the profile's oscillators
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+	SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+	LPM_RtcSync();              //APB1 was stopped, wait for fresh RTC registers
+	us = (uint32_t)((uint64_t)(LPM_RtcCount() - cnt0) * 1000000 / LPM_RTC_HZ);
+	LPM_TickRestart(load, (uint32_t)((uint64_t)us * load / 1000) + load - val);
+}
+
+/*****************************************************************************
+ * @name       :void LPM_Idle(uint32_t ms)
+ * @date       :2026-10-19
+ * @function   :Idle until the next deadline or an interrupt. Call with IRQs
+                masked: a pending interrupt still ends the sleep and is
+                served once the caller unmasks.
+ * @parameters :ms:time to the next timer deadline, 0xFFFFFFFF for none
+ * @retvalue   :None
+******************************************************************************/
+void LPM_Idle(uint32_t ms)
+{
+	uint32_t t0;
+	uint8_t mode = LPM_MODE_SLEEP;
+
+	if(ms == 0)
+		return;
+	t0 = TS_LocalUs();
+	if(ms >= LPM_STOP_MIN_MS && locks == 0 && LPM_RtcReady())
+	{
+		if(ms > LPM_STOP_MAX_MS)
+			ms = LPM_STOP_MAX_MS;
+		LPM_Stop(ms - LPM_STOP_WAKE_MS);
+		mode = LPM_MODE_STOP;
+	}
+	else
+		LPM_Sleep(ms);
+	res_us[mode] += TS_LocalUs() - t0;
+	entries[mode]++;
+}
+
+void LPM_Lock(uint8_t lock)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	locks |= lock;
+	__set_PRIMASK(primask);
+}
+
+void LPM_Unlock(uint8_t lock)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	locks &= ~lock;
+	__set_PRIMASK(primask);
+}
+
+uint8_t LPM_Locks(void)
+{
+	return locks;
+}
+
+/*****************************************************************************
+ * @name       :void LPM_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print residency per power mode and the resulting average MCU
+                current over stdout, then start a new window
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void LPM_Report(void)
+{
+	static const char * const name[LPM_MODE_NUM] = {"run", "sleep", "stop"};
+	uint32_t ua[LPM_MODE_NUM] = {Clock_GetUa(0), Clock_GetUa(1), LPM_UA_STOP};
+	uint32_t now = HAL_GetTick();
+	uint64_t win = (uint64_t)(now - window_ms) * 1000;
+	uint64_t idle = res_us[LPM_MODE_SLEEP] + res_us[LPM_MODE_STOP];
+	uint64_t charge = 0;
+	uint32_t pm;
+	uint8_t i;
+
+	if(win == 0)
+		win = 1;
+	res_us[LPM_MODE_RUN] = win > idle ? win - idle : 0;
+	entries[LPM_MODE_RUN] = entries[LPM_MODE_SLEEP] + entries[LPM_MODE_STOP];
+	printf("mode   wakes   time  locks %02X\r\n", locks);
+	for(i = 0; i < LPM_MODE_NUM; i++)
+	{
+		pm = (uint32_t)(res_us[i] * 1000 / win);
+		printf("%-6s %5lu %3lu.%lu%%\r\n", name[i], (unsigned long)entries[i],
+		       (unsigned long)(pm / 10), (unsigned long)(pm % 10));
+		charge += res_us[i] * ua[i];
+		res_us[i] = 0;
+		entries[i] = 0;
+	}
+	printf("est. MCU current %lu uA over %lu ms%s\r\n", (unsigned long)(charge / win),
+	       (unsigned long)(now - window_ms), rtc_ok ? "" : ", LSE not ready");
+	window_ms = now;
+}
@@ -0,0 +1,45 @@
+#ifndef __LPM_H
+#define __LPM_H
+#include "main.h"
+
+//Tickless idle. When no task is ready the scheduler hands the time to its
+//next timer deadline to LPM_Idle():
+// - Sleep: SysTick is reprogrammed to fire at the deadline, any interrupt
+//   (ADC DMA half-transfer, key EXTI, UART, I2C) wakes the core early.
+// - Stop:  used when nothing needs the peripheral clocks (no lock held) and
+//   the deadline is far enough away. The internal RTC on LSE wakes the
+//   core through the alarm, key EXTI lines wake it early.
+//HAL tick and SysTick phase are carried across both, so timestamps stay
+//continuous.
+#define LPM_MODE_RUN        0
+#define LPM_MODE_SLEEP      1
+#define LPM_MODE_STOP       2
+#define LPM_MODE_NUM        3
+
+#define LPM_STOP_MIN_MS     20      //shorter idles are not worth the HSE/PLL restart
+#define LPM_STOP_MAX_MS     30000   //keeps the tick credit within 32 bits
+#define LPM_STOP_WAKE_MS    3       //wake early to cover the clock restart
+#define LPM_TICK_COMP       40      //cycles SysTick is stopped around a reprogram
+
+#define LPM_RTC_HZ          16384   //RTC counter rate, LSE / (PRL + 1)
+
+//typical MCU supply current in Stop (STM32F103 datasheet, 25 C), run and
+//sleep current depend on the clock profile, see Clock_GetUa()
+#define LPM_UA_STOP         14
+
+//Stop-mode locks: a set bit means a peripheral needs its clock
+#define LPM_LOCK_ACQ        0x01    //ADC + TIM3 + DMA sampling
+#define LPM_LOCK_I2C        0x02    //transfer on the bus
+#define LPM_LOCK_UART       0x04    //console TX DMA running
+#define LPM_LOCK_LCD        0x08    //panel strip on the SPI1 DMA
+#define LPM_LOCK_BL         0x10    //backlight PWM on TIM2
+
+void LPM_Init(void);
+void LPM_Idle(uint32_t ms);
+void LPM_Lock(uint8_t lock);
+void LPM_Unlock(uint8_t lock);
+uint8_t LPM_Locks(void);
+void LPM_Report(void);
+void LPM_AlarmIRQHandler(void);
+
+#endif
@@ -2,4 +2,233 @@
 #include "stdlib.h"
 //#include "delay.h"	 
 //#include "spi.h"
-#include "main.h"
\ No newline at end of file
+#include "main.h"
+#include "acq.h"
+#include "log.h"
+#include "cap.h"
+#include "capacity.h"
+#include <stdio.h>
+
+//open-circuit voltage of a Li-ion cell at 0, 10, ... 100 % state of charge
+static const uint16_t soc_mv[11] = {3300, 3590, 3660, 3720, 3760, 3800, 3850, 3920, 3990, 4080, 4180};
+
+static uint8_t state;
+static uint8_t path;
+static uint8_t usb;                 //USB input present, with hysteresis
+static uint8_t ticks;               //BOOT samples / cut-off samples
+static uint32_t bat_filt;           //mV << POWER_FILTER_SHIFT
+static uint16_t uin_mv;
+static uint32_t acq_seq;
+static uint32_t off_ms;             //shutdown start
+static sched_timer_t power_timer;
+
+/*****************************************************************************
+ * @name       :static void Power_SetPath(uint8_t p)
+ * @date       :2026-10-19
+ * @function   :Switch the system rail. Break before make: the USB input
+                must never be tied to the cell, the regulator input
+                capacitance bridges the gap.
+ * @parameters :p:POWER_PATH_USB or POWER_PATH_BAT
+ * @retvalue   :None
+******************************************************************************/
+static void Power_SetPath(uint8_t p)
+{
+	if(p == path)
+		return;
+	if(p == POWER_PATH_USB)
+	{
+		USBA_BAT_Off;
+		USBA_SD_On;
+	}
+	else
+	{
+		USBA_SD_Off;
+		USBA_BAT_On;
+	}
+	path = p;
+}
+
+/*****************************************************************************
+ * @name       :static uint8_t Power_Sample(void)
+ * @date       :2026-10-19
+ * @function   :Take the latest acquisition block: filter the cell voltage
+                and update the USB presence flag
+ * @parameters :None
+ * @retvalue   :0 when no new block arrived since the last call
+******************************************************************************/
+static uint8_t Power_Sample(void)
+{
+	int32_t mv;
+
+	if(acq_last.seq == acq_seq)
+		return 0;
+	acq_seq = acq_last.seq;
+	mv = acq_last.val[ACQ_CH_BAT] > 0 ? acq_last.val[ACQ_CH_BAT] : 0;
+	if(bat_filt == 0)
+		bat_filt = mv << POWER_FILTER_SHIFT;
+	else
+		bat_filt += mv - (bat_filt >> POWER_FILTER_SHIFT);
+	uin_mv = acq_last.val[ACQ_CH_UIN] > 0 ? acq_last.val[ACQ_CH_UIN] : 0;
+	if(uin_mv > POWER_USB_MV)
+		usb = 1;
+	else if(uin_mv < POWER_USB_MV - POWER_USB_HYST_MV)
+		usb = 0;
+	return 1;
+}
+
+uint16_t Power_GetBatMv(void)
+{
+	return bat_filt >> POWER_FILTER_SHIFT;
+}
+
+uint16_t Power_GetUinMv(void)
+{
+	return uin_mv;
+}
+
+/*****************************************************************************
+ * @name       :uint8_t Power_GetSoc(void)
+ * @date       :2026-10-19
+ * @function   :State of charge from the filtered cell voltage, linear
+                between the points of soc_mv[]
+ * @parameters :None
+ * @retvalue   :0..100 %
+******************************************************************************/
+uint8_t Power_GetSoc(void)
+{
+	uint16_t mv = Power_GetBatMv();
+	uint8_t i;
+
+	if(mv <= soc_mv[0])
+		return 0;
+	for(i = 1; i < 10 && mv >= soc_mv[i]; i++);
+	if(mv >= soc_mv[i])
+		return 100;
+	return (i - 1) * 10 + (mv - soc_mv[i - 1]) * 10 / (soc_mv[i] - soc_mv[i - 1]);
+}
+
+uint8_t Power_GetState(void)
+{
+	return state;
+}
+
+uint8_t Power_GetPath(void)
+{
+	return path;
+}
+
+void Power_Init(void)
+{
+	state = POWER_STATE_BOOT;
+	Sched_TimerStart(&power_timer, POWER_TASK, POWER_SIG_TICK, POWER_PERIOD_MS, POWER_PERIOD_MS);
+}
+
+void Power_Shutdown(void)
+{
+	Sched_Signal(POWER_TASK, POWER_SIG_OFF);
+}
+
+/*****************************************************************************
+ * @name       :static void Power_BeginShutdown(void)
+ * @date       :2026-10-19
+ * @function   :Stop logging and poll until the log, a pending capture and
+                a capacity checkpoint are on the flash, PWR_EN is only
+                released after that (or after POWER_FLUSH_MAX_MS)
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Power_BeginShutdown(void)
+{
+	if(state >= POWER_STATE_SHUTDOWN)
+		return;
+	state = POWER_STATE_SHUTDOWN;
+	off_ms = HAL_GetTick();
+	Log_Stop();
+	Capacity_Checkpoint();      //a running capacity test resumes at the next boot
+	Sched_TimerStart(&power_timer, POWER_TASK, POWER_SIG_TICK, POWER_FLUSH_POLL_MS, POWER_FLUSH_POLL_MS);
+}
+
+static void Power_Tick(void)
+{
+	uint16_t mv;
+
+	if(state < POWER_STATE_SHUTDOWN && !Power_Sample())
+		return;
+	mv = Power_GetBatMv();
+	switch(state)
+	{
+		case POWER_STATE_BOOT:
+			if(++ticks < POWER_BOOT_TICKS)
+				break;
+			ticks = 0;
+			if(!usb && mv < POWER_CUTOFF_MV)
+			{
+				printf("power: battery empty (%u mV)\r\n", mv);
+				Power_BeginShutdown();
+				break;
+			}
+			Power_SetPath(usb ? POWER_PATH_USB : POWER_PATH_BAT);
+			state = POWER_STATE_RUN;
+			break;
+		case POWER_STATE_RUN:
+			Power_SetPath(usb ? POWER_PATH_USB : POWER_PATH_BAT);
+			if(!usb && mv < POWER_LOW_MV)
+			{
+				printf("power: battery low (%u mV, %u%%)\r\n", mv, Power_GetSoc());
+				state = POWER_STATE_LOW_BAT;
+				ticks = 0;
+			}
+			break;
+		case POWER_STATE_LOW_BAT:
+			Power_SetPath(usb ? POWER_PATH_USB : POWER_PATH_BAT);
+			if(usb || mv >= POWER_LOW_MV + POWER_LOW_HYST_MV)
+				state = POWER_STATE_RUN;
+			else if(mv >= POWER_CUTOFF_MV)
+				ticks = 0;
+			else if(++ticks >= POWER_CUTOFF_TICKS)
+			{
+				printf("power: cut-off (%u mV)\r\n", mv);
+				Power_BeginShutdown();
+			}
+			break;
+		case POWER_STATE_SHUTDOWN:
+			if((Log_Pending() || Cap_Pending() || Capacity_Pending()) && HAL_GetTick() - off_ms < POWER_FLUSH_MAX_MS)
+				break;
+			PWR_Off;
+			state = POWER_STATE_OFF;
+			Sched_TimerStart(&power_timer, POWER_TASK, POWER_SIG_TICK, POWER_OFF_RETRY_MS, 0);
+			break;
+		default:
+			//still alive: the key or the USB input holds the supply, start over
+			PWR_On;
+			state = POWER_STATE_BOOT;
+			ticks = 0;
+			Log_Start();
+			Sched_TimerStart(&power_timer, POWER_TASK, POWER_SIG_TICK, POWER_PERIOD_MS, POWER_PERIOD_MS);
+			break;
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Power_Process(uint8_t sig)
+ * @date       :2026-10-19
+ * @function   :POWER_TASK handler
+ * @parameters :sig:POWER_SIG_TICK or POWER_SIG_OFF
+ * @retvalue   :None
+******************************************************************************/
+void Power_Process(uint8_t sig)
+{
+	if(sig == POWER_SIG_OFF)
+		Power_BeginShutdown();
+	else
+		Power_Tick();
+}
+
+void Power_Report(void)
+{
+	static const char * const st_name[POWER_STATE_NUM] = {"boot", "run", "low", "shutdown", "off"};
+	static const char * const path_name[] = {"none", "usb", "bat"};
+
+	printf("power %s  path %s  bat %u mV %u%%  in %u mV\r\n", st_name[state], path_name[path],
+	       Power_GetBatMv(), Power_GetSoc(), uin_mv);
+}
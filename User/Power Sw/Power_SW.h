@@ -3,11 +3,64 @@
 //#include "sys.h"	 
 //#include "stdlib.h"
 #include "main.h"
+#include "sched.h"
 
 #define PWR_On HAL_GPIO_WritePin(PWR_EN_GPIO_Port,PWR_EN_Pin,GPIO_PIN_SET)
 
 #define PWR_Off HAL_GPIO_WritePin(PWR_EN_GPIO_Port,PWR_EN_Pin,GPIO_PIN_RESET)
 
+#define USBA_SD_On HAL_GPIO_WritePin(USBA_SD_SW_GPIO_Port,USBA_SD_SW_Pin,GPIO_PIN_SET)
 
+#define USBA_SD_Off HAL_GPIO_WritePin(USBA_SD_SW_GPIO_Port,USBA_SD_SW_Pin,GPIO_PIN_RESET)
 
-#endif 
\ No newline at end of file
+#define USBA_BAT_On HAL_GPIO_WritePin(USBA_BAT_SW_GPIO_Port,USBA_BAT_SW_Pin,GPIO_PIN_SET)
+
+#define USBA_BAT_Off HAL_GPIO_WritePin(USBA_BAT_SW_GPIO_Port,USBA_BAT_SW_Pin,GPIO_PIN_RESET)
+
+//Power manager. The key press powers the board up, PWR_EN latches the
+//supply; releasing it switches the board off once the key is let go.
+//The system rail is fed either from the USB-A input (USBA_SD_SW) or from
+//the internal cell (USBA_BAT_SW), never from both. The cell voltage on
+//Bat_sample is IIR filtered and mapped to a state of charge through a
+//piecewise linear open-circuit curve. While the USB input feeds the rail
+//the cell is not loaded and the SoC reads slightly high.
+#define POWER_TASK          SCHED_TASK_POWER
+#define POWER_SIG_TICK      0       //state machine timer
+#define POWER_SIG_OFF       1       //shutdown request
+
+#define POWER_STATE_BOOT    0       //filter settling, no path chosen yet
+#define POWER_STATE_RUN     1
+#define POWER_STATE_LOW_BAT 2       //on the cell below POWER_LOW_MV
+#define POWER_STATE_SHUTDOWN 3      //log flushing, PWR_EN still held
+#define POWER_STATE_OFF     4       //PWR_EN released
+#define POWER_STATE_NUM     5
+
+#define POWER_PATH_NONE     0
+#define POWER_PATH_USB      1
+#define POWER_PATH_BAT      2
+
+#define POWER_PERIOD_MS     250
+#define POWER_BOOT_TICKS    4       //samples before the first decision
+#define POWER_FILTER_SHIFT  3       //IIR weight 1/8, ~2 s time constant
+#define POWER_FLUSH_POLL_MS 10
+#define POWER_FLUSH_MAX_MS  1000    //worst case sector erase + page program
+#define POWER_OFF_RETRY_MS  2000    //still running after PWR_Off: supply held externally
+
+#define POWER_USB_MV        4400    //USB input present above this
+#define POWER_USB_HYST_MV   300
+#define POWER_LOW_MV        3450    //low-battery warning
+#define POWER_LOW_HYST_MV   100
+#define POWER_CUTOFF_MV     3300    //flush the log and switch off
+#define POWER_CUTOFF_TICKS  8       //consecutive samples below the cut-off
+
+void Power_Init(void);
+void Power_Process(uint8_t sig);
+void Power_Shutdown(void);
+uint8_t Power_GetState(void);
+uint8_t Power_GetPath(void);
+uint8_t Power_GetSoc(void);
+uint16_t Power_GetBatMv(void);
+uint16_t Power_GetUinMv(void);
+void Power_Report(void);
+
+#endif 
@@ -0,0 +1,155 @@
+#include "pcf8563.h"
+
+static uint8_t bcd2bin(uint8_t v)
+{
+	return (v >> 4) * 10 + (v & 0x0F);
+}
+
+static uint8_t bin2bcd(uint8_t v)
+{
+	return ((v / 10) << 4) | (v % 10);
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef PCF8563_Init(void)
+ * @date       :2026-10-19
+ * @function   :Queue the start-up writes: run the oscillator, no alarm/timer
+                IRQs, CLKOUT off. Returns without waiting for the bus.
+ * @parameters :None
+ * @retvalue   :HAL_OK when queued
+******************************************************************************/
+HAL_StatusTypeDef PCF8563_Init(void)
+{
+	static uint8_t ctrl[2] = {0x00, 0x00};   //CTRL1: STOP=0, CTRL2: no interrupts
+	static uint8_t clkout = 0x00;            //CLKOUT off, saves ~0.1uA on the backup cell
+	static i2c_xfer_t x_ctrl, x_clkout;
+
+	I2C_Bus_Setup(&x_ctrl, PCF8563_ADDR, I2C_XFER_WRITE, PCF8563_REG_CTRL1, ctrl, 2, NULL);
+	I2C_Bus_Setup(&x_clkout, PCF8563_ADDR, I2C_XFER_WRITE, PCF8563_REG_CLKOUT, &clkout, 1, NULL);
+	if(I2C_Bus_Submit(&x_ctrl) != HAL_OK)
+		return HAL_BUSY;
+	return I2C_Bus_Submit(&x_clkout);
+}
+
+/*****************************************************************************
+ * @name       :void PCF8563_Decode(const uint8_t *raw, rtc_time_t *t)
+ * @date       :2026-10-19
+ * @function   :Convert the 7 BCD time registers (0x02..0x08) to rtc_time_t
+ * @parameters :raw:register burst starting at PCF8563_REG_SECONDS
+                t:decoded time
+ * @retvalue   :None
+******************************************************************************/
+void PCF8563_Decode(const uint8_t *raw, rtc_time_t *t)
+{
+	t->valid   = (raw[0] & PCF8563_VL) ? 0 : 1;
+	t->second  = bcd2bin(raw[0] & 0x7F);
+	t->minute  = bcd2bin(raw[1] & 0x7F);
+	t->hour    = bcd2bin(raw[2] & 0x3F);
+	t->day     = bcd2bin(raw[3] & 0x3F);
+	t->weekday = raw[4] & 0x07;
+	t->month   = bcd2bin(raw[5] & 0x1F);
+	t->year    = 2000 + bcd2bin(raw[6]);
+}
+
+/*****************************************************************************
+ * @name       :void PCF8563_Encode(const rtc_time_t *t, uint8_t *raw)
+ * @date       :2026-10-19
+ * @function   :Convert rtc_time_t to the 7 BCD time registers (0x02..0x08)
+ * @parameters :t:time to encode
+                raw:register burst starting at PCF8563_REG_SECONDS
+ * @retvalue   :None
+******************************************************************************/
+void PCF8563_Encode(const rtc_time_t *t, uint8_t *raw)
+{
+	raw[0] = bin2bcd(t->second);     //also clears VL
+	raw[1] = bin2bcd(t->minute);
+	raw[2] = bin2bcd(t->hour);
+	raw[3] = bin2bcd(t->day);
+	raw[4] = t->weekday & 0x07;
+	raw[5] = bin2bcd(t->month);
+	raw[6] = bin2bcd(t->year % 100);
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef PCF8563_ReadTimeAsync(i2c_xfer_t *x, uint8_t *raw, i2c_done_cb done)
+ * @date       :2026-10-19
+ * @function   :Queue a burst read of the time registers (one transaction),
+                decode 'raw' with PCF8563_Decode() in the callback
+ * @parameters :x:transfer descriptor owned by the caller
+                raw:PCF8563_TIME_LEN bytes
+                done:completion callback
+ * @retvalue   :HAL_BUSY if x is still in flight
+******************************************************************************/
+HAL_StatusTypeDef PCF8563_ReadTimeAsync(i2c_xfer_t *x, uint8_t *raw, i2c_done_cb done)
+{
+	I2C_Bus_Setup(x, PCF8563_ADDR, I2C_XFER_READ, PCF8563_REG_SECONDS, raw, PCF8563_TIME_LEN, done);
+	return I2C_Bus_Submit(x);
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef PCF8563_SetTimeAsync(i2c_xfer_t *x, uint8_t *raw,
+                                                      const rtc_time_t *t, i2c_done_cb done)
+ * @date       :2026-10-19
+ * @function   :Queue a burst write of the time registers
+ * @parameters :x:transfer descriptor owned by the caller
+                raw:PCF8563_TIME_LEN bytes, must stay valid until 'done'
+                t:time to set
+                done:completion callback
+ * @retvalue   :HAL_BUSY if x is still in flight
+******************************************************************************/
+HAL_StatusTypeDef PCF8563_SetTimeAsync(i2c_xfer_t *x, uint8_t *raw, const rtc_time_t *t, i2c_done_cb done)
+{
+	if(I2C_Bus_InFlight(x))
+		return HAL_BUSY;
+	PCF8563_Encode(t, raw);
+	I2C_Bus_Setup(x, PCF8563_ADDR, I2C_XFER_WRITE, PCF8563_REG_SECONDS, raw, PCF8563_TIME_LEN, done);
+	return I2C_Bus_Submit(x);
+}
+
+/*****************************************************************************
+ * @name       :uint32_t RTC_ToEpoch(const rtc_time_t *t)
+ * @date       :2026-10-19
+ * @function   :Calendar time to seconds since 1970-01-01 (days-from-civil)
+ * @parameters :t:calendar time
+ * @retvalue   :Unix time in seconds
+******************************************************************************/
+uint32_t RTC_ToEpoch(const rtc_time_t *t)
+{
+	int32_t y = t->year - (t->month <= 2);
+	uint32_t era = y / 400;
+	uint32_t yoe = y - era * 400;
+	uint32_t doy = (153 * (t->month + (t->month > 2 ? -3 : 9)) + 2) / 5 + t->day - 1;
+	uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	uint32_t days = era * 146097 + doe - 719468;
+
+	return days * 86400UL + t->hour * 3600UL + t->minute * 60UL + t->second;
+}
+
+/*****************************************************************************
+ * @name       :void RTC_FromEpoch(uint32_t epoch, rtc_time_t *t)
+ * @date       :2026-10-19
+ * @function   :Seconds since 1970-01-01 to calendar time (civil-from-days)
+ * @parameters :epoch:Unix time in seconds
+                t:calendar time
+ * @retvalue   :None
+******************************************************************************/
+void RTC_FromEpoch(uint32_t epoch, rtc_time_t *t)
+{
+	uint32_t days = epoch / 86400UL;
+	uint32_t rem = epoch % 86400UL;
+	uint32_t z = days + 719468;
+	uint32_t era = z / 146097;
+	uint32_t doe = z - era * 146097;
+	uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	uint32_t mp = (5 * doy + 2) / 153;
+
+	t->day     = doy - (153 * mp + 2) / 5 + 1;
+	t->month   = mp < 10 ? mp + 3 : mp - 9;
+	t->year    = yoe + era * 400 + (t->month <= 2);
+	t->hour    = rem / 3600;
+	t->minute  = (rem / 60) % 60;
+	t->second  = rem % 60;
+	t->weekday = (days + 4) % 7;     //1970-01-01 was a Thursday
+	t->valid   = 1;
+}
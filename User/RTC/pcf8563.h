@@ -0,0 +1,46 @@
+#ifndef __PCF8563_H
+#define __PCF8563_H
+#include "main.h"
+#include "i2c_bus.h"
+
+//RTC on I2C1 (RTC_SCL PB8 / RTC_SDA PB9), all accesses go through the I2C_Bus queue
+#define PCF8563_ADDR          0xA2    //7-bit 0x51, HAL takes the 8-bit form
+
+//PCF8563 registers
+#define PCF8563_REG_CTRL1     0x00
+#define PCF8563_REG_CTRL2     0x01
+#define PCF8563_REG_SECONDS   0x02    //bit7 = VL, clock integrity not guaranteed
+#define PCF8563_REG_MINUTES   0x03
+#define PCF8563_REG_HOURS     0x04
+#define PCF8563_REG_DAYS      0x05
+#define PCF8563_REG_WEEKDAYS  0x06
+#define PCF8563_REG_MONTHS    0x07    //bit7 = century
+#define PCF8563_REG_YEARS     0x08
+#define PCF8563_REG_CLKOUT    0x0D
+
+#define PCF8563_VL            0x80
+
+typedef struct
+{
+	uint16_t year;      //2000..2099
+	uint8_t  month;     //1..12
+	uint8_t  day;       //1..31
+	uint8_t  hour;      //0..23
+	uint8_t  minute;    //0..59
+	uint8_t  second;    //0..59
+	uint8_t  weekday;   //0..6, 0 = Sunday
+	uint8_t  valid;     //0 when the VL flag reports lost oscillator
+} rtc_time_t;
+
+#define PCF8563_TIME_LEN      7       //registers 0x02..0x08
+
+HAL_StatusTypeDef PCF8563_Init(void);
+HAL_StatusTypeDef PCF8563_ReadTimeAsync(i2c_xfer_t *x, uint8_t *raw, i2c_done_cb done);
+HAL_StatusTypeDef PCF8563_SetTimeAsync(i2c_xfer_t *x, uint8_t *raw, const rtc_time_t *t, i2c_done_cb done);
+void PCF8563_Decode(const uint8_t *raw, rtc_time_t *t);
+void PCF8563_Encode(const rtc_time_t *t, uint8_t *raw);
+
+uint32_t RTC_ToEpoch(const rtc_time_t *t);
+void RTC_FromEpoch(uint32_t epoch, rtc_time_t *t);
+
+#endif
@@ -0,0 +1,476 @@
+#include "timestamp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TS_STATE_IDLE   0
+#define TS_STATE_HUNT   1
+#define TS_STATE_BOOT   2               //waiting for the boot-time read
+#define TS_STATE_UNSET  3               //RTC lost its time, waiting for TS_SetTime()
+
+#define TS_BRACKET_MAX  (4 * TS_HUNT_STEP_MS)   //widest usable edge bracket (ms)
+
+typedef struct
+{
+	//timebase: wall clock base_sec was current at local time (base_ms, base_us)
+	uint32_t base_sec;
+	uint32_t base_ms;
+	uint32_t base_us;
+	int32_t  corr_q32;    //drift correction as a fraction of elapsed time, * 2^32
+	//discipline anchor: the last RTC seconds edge used for drift measurement
+	uint32_t anchor_sec;
+	uint32_t anchor_ms;
+	uint32_t anchor_us;
+	uint8_t  anchor_ok;
+	int32_t  drift_q4;    //local clock rate error in ppm * 16, positive = local fast
+	uint8_t  flags;
+	//resync state machine
+	uint8_t  state;
+	uint8_t  hunt_reads;
+	uint32_t hunt_sec;
+	uint32_t hunt_start;
+	uint32_t prev_ms;
+	uint32_t prev_us;
+	uint32_t next_ms;
+} ts_state_t;
+
+static ts_state_t ts;
+static i2c_xfer_t ts_xfer;
+static uint8_t ts_raw[PCF8563_TIME_LEN];
+static i2c_xfer_t ts_set_xfer;
+static uint8_t ts_set_raw[PCF8563_TIME_LEN];
+static uint32_t ts_set_sec;
+
+/*****************************************************************************
+ * @name       :static void TS_Local(uint32_t *ms, uint32_t *us)
+ * @date       :2026-10-19
+ * @function   :Read the free-running local clock: HAL tick plus the elapsed
+                part of the current SysTick period, safe with IRQs masked
+ * @parameters :ms:HAL tick
+                us:microseconds into that tick (0..999)
+ * @retvalue   :None
+******************************************************************************/
+static void TS_Local(uint32_t *ms, uint32_t *us)
+{
+	uint32_t t, val, wrap;
+	uint32_t load = SysTick->LOAD + 1;
+
+	do
+	{
+		t = HAL_GetTick();
+		val = SysTick->VAL;
+		wrap = 0;
+		if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)   //reloaded but not yet serviced
+		{
+			val = SysTick->VAL;
+			wrap = 1;
+		}
+	} while(t != HAL_GetTick());
+	*ms = t + wrap;
+	*us = (load - 1 - val) * 1000 / load;
+}
+
+static uint64_t TS_Span(uint32_t ms0, uint32_t us0, uint32_t ms1, uint32_t us1)
+{
+	return (uint64_t)(uint32_t)(ms1 - ms0) * 1000 + us1 - us0;
+}
+
+/*****************************************************************************
+ * @name       :uint32_t TS_LocalUs(void)
+ * @date       :2026-10-19
+ * @function   :Free-running microsecond counter (wraps every ~71 minutes)
+ * @parameters :None
+ * @retvalue   :local time in microseconds
+******************************************************************************/
+uint32_t TS_LocalUs(void)
+{
+	uint32_t ms, us;
+
+	TS_Local(&ms, &us);
+	return ms * 1000 + us;
+}
+
+/*****************************************************************************
+ * @name       :void TS_Now(ts_t *ts)
+ * @date       :2026-10-19
+ * @function   :Wall-clock timestamp for the hot path, never touches I2C.
+                Callable from interrupt context.
+ * @parameters :now:filled with Unix seconds and microseconds
+ * @retvalue   :None
+******************************************************************************/
+void TS_Now(ts_t *now)
+{
+	uint32_t ms, us, primask, sec, bms, bus;
+	int32_t corr;
+	uint64_t el;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	TS_Local(&ms, &us);
+	sec = ts.base_sec;
+	bms = ts.base_ms;
+	bus = ts.base_us;
+	corr = ts.corr_q32;
+	__set_PRIMASK(primask);
+
+	el = TS_Span(bms, bus, ms, us);
+	el -= (uint64_t)(((int64_t)el * corr) >> 32);
+	now->sec = sec + (uint32_t)(el / 1000000);
+	now->usec = (uint32_t)(el % 1000000);
+}
+
+static void TS_SetBase(uint32_t sec, uint32_t ms, uint32_t us)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	ts.base_sec = sec;
+	ts.base_ms = ms;
+	ts.base_us = us;
+	ts.corr_q32 = (int32_t)(((int64_t)ts.drift_q4 << 32) / (16 * 1000000LL));
+	__set_PRIMASK(primask);
+}
+
+/*****************************************************************************
+ * @name       :static void TS_Lock(uint32_t sec, uint32_t ms, uint32_t us)
+ * @date       :2026-10-19
+ * @function   :RTC second 'sec' started at local time (ms, us): measure the
+                drift against the previous anchor and rebase the timebase
+ * @parameters :sec:Unix seconds of the edge
+                ms,us:local time of the edge
+ * @retvalue   :None
+******************************************************************************/
+static void TS_Lock(uint32_t sec, uint32_t ms, uint32_t us)
+{
+	uint32_t rtc_s;
+	int64_t err_us;
+	int32_t ppm_q4;
+
+	if(ts.anchor_ok && (int32_t)(sec - ts.anchor_sec) >= TS_MIN_SPAN_S)
+	{
+		rtc_s = sec - ts.anchor_sec;
+		err_us = (int64_t)TS_Span(ts.anchor_ms, ts.anchor_us, ms, us) - (int64_t)rtc_s * 1000000;
+		ppm_q4 = (int32_t)(err_us * 16 / rtc_s);   //us of error per second is ppm
+		if(ppm_q4 > -TS_PPM_LIMIT * 16 && ppm_q4 < TS_PPM_LIMIT * 16)
+		{
+			if(ts.flags & TS_FLAG_DRIFT)
+				ts.drift_q4 += (ppm_q4 - ts.drift_q4) / 4;
+			else
+				ts.drift_q4 = ppm_q4;
+			ts.flags |= TS_FLAG_DRIFT;
+		}
+		ts.anchor_ok = 0;   //stepped RTC or fresh estimate: re-anchor below
+	}
+	if(!ts.anchor_ok)
+	{
+		ts.anchor_sec = sec;
+		ts.anchor_ms = ms;
+		ts.anchor_us = us;
+		ts.anchor_ok = 1;
+	}
+	TS_SetBase(sec, ms, us);
+	ts.flags |= TS_FLAG_VALID | TS_FLAG_FINE;
+	ts.flags &= ~TS_FLAG_RTC_LOST;
+}
+
+static void TS_Fail(uint32_t now)
+{
+	ts.flags |= TS_FLAG_RTC_LOST;
+	ts.state = TS_STATE_IDLE;
+	ts.next_ms = now + TS_RETRY_MS;
+}
+
+/*****************************************************************************
+ * @name       :static void TS_SampleTime(const i2c_xfer_t *x, uint32_t *ms, uint32_t *us)
+ * @date       :2026-10-19
+ * @function   :Local (ms, us) time at which a transfer went on the bus
+ * @parameters :x:finished transfer
+                ms,us:local time
+ * @retvalue   :None
+******************************************************************************/
+static void TS_SampleTime(const i2c_xfer_t *x, uint32_t *ms, uint32_t *us)
+{
+	uint32_t d;
+
+	TS_Local(ms, us);
+	d = *ms * 1000 + *us - x->t_start;
+	*ms -= d / 1000;
+	d %= 1000;
+	if(*us < d)
+	{
+		*ms -= 1;
+		*us += 1000;
+	}
+	*us -= d;
+}
+
+static void TS_BootDone(i2c_xfer_t *x)
+{
+	uint32_t ms, us;
+	rtc_time_t t;
+
+	if(x->status != I2C_XFER_DONE)
+	{
+		TS_Fail(HAL_GetTick());
+		return;
+	}
+	PCF8563_Decode(ts_raw, &t);
+	if(!t.valid)
+	{
+		ts.flags |= TS_FLAG_RTC_LOST;   //oscillator stopped: time is a guess until set
+		ts.state = TS_STATE_UNSET;
+		return;
+	}
+	TS_SampleTime(x, &ms, &us);
+	TS_SetBase(RTC_ToEpoch(&t), ms, us);
+	ts.flags |= TS_FLAG_VALID;
+	ts.state = TS_STATE_IDLE;
+	ts.next_ms = HAL_GetTick();         //refine on the next seconds edge
+}
+
+/*****************************************************************************
+ * @name       :static void TS_HuntDone(i2c_xfer_t *x)
+ * @date       :2026-10-19
+ * @function   :One RTC read of the edge hunt finished. Lock when the seconds
+                register ticked over since the previous read.
+ * @parameters :x:finished transfer
+ * @retvalue   :None
+******************************************************************************/
+static void TS_HuntDone(i2c_xfer_t *x)
+{
+	uint32_t now = HAL_GetTick();
+	uint32_t ms, us, sec, half;
+	rtc_time_t t;
+
+	PCF8563_Decode(ts_raw, &t);
+	if(x->status != I2C_XFER_DONE || !t.valid)
+	{
+		TS_Fail(now);
+		return;
+	}
+	TS_SampleTime(x, &ms, &us);
+	sec = RTC_ToEpoch(&t);
+	if(ts.hunt_reads && sec != ts.hunt_sec
+	   && (uint32_t)(ms - ts.prev_ms) <= TS_BRACKET_MAX)
+	{
+		//the edge lies between the previous read and this one, take the middle
+		half = (uint32_t)(TS_Span(ts.prev_ms, ts.prev_us, ms, us) / 2) + ts.prev_us;
+		TS_Lock(sec, ts.prev_ms + half / 1000, half % 1000);
+		ts.state = TS_STATE_IDLE;
+		ts.next_ms = now + TS_RESYNC_MS;
+		return;
+	}
+	if((uint32_t)(now - ts.hunt_start) > TS_HUNT_TIMEOUT)
+	{
+		//loop too slow to bracket an edge, keep the coarse time and retry
+		TS_SetBase(sec, ms, us);
+		ts.flags = (ts.flags | TS_FLAG_VALID) & ~TS_FLAG_FINE;
+		ts.state = TS_STATE_IDLE;
+		ts.next_ms = now + TS_RETRY_MS;
+		return;
+	}
+	ts.hunt_reads++;
+	ts.hunt_sec = sec;
+	ts.prev_ms = ms;
+	ts.prev_us = us;
+	ts.next_ms = now + TS_HUNT_STEP_MS;
+}
+
+/*****************************************************************************
+ * @name       :void TS_Init(void)
+ * @date       :2026-10-19
+ * @function   :Queue the boot-time RTC read. Its callback sets a coarse (1 s)
+                timebase and starts looking for a seconds edge to refine it.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void TS_Init(void)
+{
+	uint32_t ms, us;
+
+	ts.flags = 0;
+	ts.drift_q4 = 0;
+	ts.anchor_ok = 0;
+	ts.state = TS_STATE_BOOT;
+	TS_Local(&ms, &us);
+	TS_SetBase(0, ms, us);
+	PCF8563_Init();
+	if(PCF8563_ReadTimeAsync(&ts_xfer, ts_raw, TS_BootDone) != HAL_OK)
+		TS_Fail(ms);
+}
+
+/*****************************************************************************
+ * @name       :uint32_t TS_Process(void)
+ * @date       :2026-10-19
+ * @function   :Resync state machine, call from the I2C bus task after
+                I2C_Bus_Process(). Idle between resyncs; while hunting it
+                queues an RTC read every TS_HUNT_STEP_MS until the seconds
+                register ticks over. Never waits for the I2C bus.
+ * @parameters :None
+ * @retvalue   :ms until the next call is due. A read in flight wakes the
+                bus task on completion, so the value is only a fallback then.
+******************************************************************************/
+uint32_t TS_Process(void)
+{
+	uint32_t now = HAL_GetTick();
+
+	if(ts.state == TS_STATE_BOOT || ts.state == TS_STATE_UNSET || I2C_Bus_InFlight(&ts_xfer))
+		return TS_RETRY_MS;
+	if((int32_t)(now - ts.next_ms) < 0)
+		return ts.next_ms - now;
+	if(ts.state == TS_STATE_IDLE)
+	{
+		ts.state = TS_STATE_HUNT;
+		ts.hunt_reads = 0;
+		ts.hunt_start = now;
+	}
+	if(PCF8563_ReadTimeAsync(&ts_xfer, ts_raw, TS_HuntDone) != HAL_OK)
+		TS_Fail(now);
+	return TS_RETRY_MS;
+}
+
+static void TS_SetDone(i2c_xfer_t *x)
+{
+	uint32_t ms, us;
+
+	if(x->status != I2C_XFER_DONE)
+	{
+		TS_Fail(HAL_GetTick());
+		return;
+	}
+	TS_SampleTime(x, &ms, &us);
+	TS_SetBase(ts_set_sec, ms, us);
+	ts.flags = (ts.flags | TS_FLAG_VALID) & ~(TS_FLAG_FINE | TS_FLAG_RTC_LOST);
+	ts.anchor_ok = 0;                   //the RTC was stepped, old anchor is meaningless
+	if(ts.state == TS_STATE_UNSET)
+		ts.state = TS_STATE_IDLE;       //the time is good again, hunt and discipline can start
+	TS_RequestResync();
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef TS_SetTime(const rtc_time_t *t)
+ * @date       :2026-10-19
+ * @function   :Queue an RTC write; on completion the timebase follows and
+                re-locks on the next edge
+ * @parameters :t:new wall-clock time
+ * @retvalue   :HAL_BUSY if a previous set is still in flight
+******************************************************************************/
+HAL_StatusTypeDef TS_SetTime(const rtc_time_t *t)
+{
+	if(I2C_Bus_InFlight(&ts_set_xfer))
+		return HAL_BUSY;
+	ts_set_sec = RTC_ToEpoch(t);
+	return PCF8563_SetTimeAsync(&ts_set_xfer, ts_set_raw, t, TS_SetDone);
+}
+
+void TS_RequestResync(void)
+{
+	if(ts.state != TS_STATE_BOOT && ts.state != TS_STATE_UNSET)
+		ts.state = TS_STATE_IDLE;
+	ts.next_ms = HAL_GetTick();
+	Sched_Signal(I2C_BUS_TASK, I2C_BUS_SIG);    //the bus task may be asleep until the periodic resync
+}
+
+uint8_t TS_GetFlags(void)
+{
+	return ts.flags;
+}
+
+int32_t TS_GetDriftPpm(void)
+{
+	return ts.drift_q4 / 16;
+}
+
+/*****************************************************************************
+ * @name       :static uint8_t TS_Parse(const char *s, rtc_time_t *t)
+ * @date       :2026-10-19
+ * @function   :Parse "YYYY-MM-DD HH:MM:SS", the weekday is worked out
+ * @parameters :s:text
+                t:parsed time
+ * @retvalue   :1 for a real date and time in 2000..2099, 0 otherwise
+******************************************************************************/
+static uint8_t TS_Parse(const char *s, rtc_time_t *t)
+{
+	static const char sep[6] = {'-', '-', ' ', ':', ':', '\0'};
+	uint32_t v[6];
+	rtc_time_t chk;
+	char *end;
+	uint8_t i;
+
+	for(i = 0; i < 6; i++)
+	{
+		v[i] = strtoul(s, &end, 10);
+		if(end == s || *end != sep[i])
+			return 0;
+		s = end + 1;
+	}
+	if(v[0] < 2000 || v[0] > 2099 || v[1] < 1 || v[1] > 12 || v[2] < 1 || v[2] > 31
+	   || v[3] > 23 || v[4] > 59 || v[5] > 59)
+		return 0;
+	t->year = v[0];
+	t->month = v[1];
+	t->day = v[2];
+	t->hour = v[3];
+	t->minute = v[4];
+	t->second = v[5];
+	t->valid = 1;
+	RTC_FromEpoch(RTC_ToEpoch(t), &chk);
+	t->weekday = chk.weekday;
+	return chk.day == t->day;           //31 April or 29 February of a common year rolls over
+}
+
+/*****************************************************************************
+ * @name       :void TS_Command(const char *args)
+ * @date       :2026-10-19
+ * @function   :Console front end: "YYYY-MM-DD HH:MM:SS" sets the RTC and the
+                timebase, "sync" asks for a resync now, nothing prints the
+                clock, the flags and the drift
+ * @parameters :args:text after the command name
+ * @retvalue   :None
+******************************************************************************/
+void TS_Command(const char *args)
+{
+	rtc_time_t t;
+
+	if(strcmp(args, "sync") == 0)
+		TS_RequestResync();
+	else if(*args)
+	{
+		if(!TS_Parse(args, &t))
+			printf("time: expected YYYY-MM-DD HH:MM:SS\r\n");
+		else if(TS_SetTime(&t) != HAL_OK)
+			printf("time: RTC busy, try again\r\n");
+		else
+			printf("time: set, locking on the next RTC second\r\n");
+		return;
+	}
+	TS_Report();
+}
+
+/*****************************************************************************
+ * @name       :void TS_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the wall clock, the flags, the resync state and the drift
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void TS_Report(void)
+{
+	static const char * const state[] = {"idle", "hunting", "boot read", "unset"};
+	rtc_time_t t;
+	ts_t now;
+
+	TS_Now(&now);
+	RTC_FromEpoch(now.sec, &t);
+	printf("time %04u-%02u-%02u %02u:%02u:%02u.%03lu  %s%s%s  %s, next resync %lu s\r\n", t.year, t.month,
+	       t.day, t.hour, t.minute, t.second, (unsigned long)(now.usec / 1000),
+	       ts.flags & TS_FLAG_VALID ? "valid" : "not set", ts.flags & TS_FLAG_FINE ? " fine" : "",
+	       ts.flags & TS_FLAG_RTC_LOST ? " rtc-lost" : "", state[ts.state],
+	       (unsigned long)((int32_t)(ts.next_ms - HAL_GetTick()) > 0 ? (ts.next_ms - HAL_GetTick()) / 1000 : 0));
+	if(ts.flags & TS_FLAG_DRIFT)
+		printf("drift %+ld ppm, local clock %s\r\n", (long)TS_GetDriftPpm(), ts.drift_q4 > 0 ? "fast" : "slow");
+	else
+		printf("drift not measured yet\r\n");
+	if(ts.state == TS_STATE_UNSET)
+		printf("RTC lost its time, set it with 'time YYYY-MM-DD HH:MM:SS'\r\n");
+}
@@ -0,0 +1,38 @@
+#ifndef __TIMESTAMP_H
+#define __TIMESTAMP_H
+#include "main.h"
+#include "pcf8563.h"
+
+//Sample time-stamping: the PCF8563 is only read at boot and on resync, every
+//timestamp in between is interpolated from HAL tick + SysTick->VAL and
+//corrected by the drift measured between two RTC second edges.
+#define TS_RESYNC_MS      600000  //periodic resync against the RTC, 10 min
+#define TS_RETRY_MS       5000    //retry delay after a failed resync
+#define TS_HUNT_STEP_MS   10      //RTC poll period while looking for a seconds edge
+#define TS_HUNT_TIMEOUT   1500    //an edge must show up within this window (ms)
+#define TS_PPM_LIMIT      1000    //larger errors mean the RTC was stepped, not drift
+#define TS_MIN_SPAN_S     30      //shortest anchor span used for a drift estimate
+
+#define TS_FLAG_VALID     0x01    //wall clock known (at least to the second)
+#define TS_FLAG_FINE      0x02    //locked to an RTC seconds edge
+#define TS_FLAG_DRIFT     0x04    //drift estimate available
+#define TS_FLAG_RTC_LOST  0x08    //RTC reported VL or does not answer
+
+typedef struct
+{
+	uint32_t sec;        //Unix seconds
+	uint32_t usec;       //0..999999
+} ts_t;
+
+void TS_Init(void);
+uint32_t TS_Process(void);
+void TS_Now(ts_t *ts);
+uint32_t TS_LocalUs(void);
+HAL_StatusTypeDef TS_SetTime(const rtc_time_t *t);
+void TS_RequestResync(void);
+uint8_t TS_GetFlags(void);
+int32_t TS_GetDriftPpm(void);
+void TS_Command(const char *args);
+void TS_Report(void);
+
+#endif
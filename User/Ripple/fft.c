@@ -0,0 +1,233 @@
+#include "fft.h"
+
+//sin(2 pi k / FFT_N_MAX), k = 0..FFT_N_MAX / 4, Q15
+static const int16_t fft_sin[FFT_N_MAX / 4 + 1] =
+{
+	    0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+	 2411,  2611,  2811,  3012,  3212,  3412,  3612,  3812,  4011,  4211,  4410,  4609,
+	 4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6787,  6983,
+	 7180,  7376,  7571,  7767,  7962,  8157,  8351,  8546,  8740,  8933,  9127,  9319,
+	 9512,  9704,  9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+	11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+	14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269, 15447, 15624, 15800, 15976,
+	16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+	18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001,
+	20160, 20318, 20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+	22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312, 23453, 23593,
+	23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+	25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674,
+	26791, 26906, 27020, 27133, 27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+	28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+	29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+	30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050,
+	31114, 31177, 31238, 31298, 31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+	31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251,
+	32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+	32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753,
+	32758, 32762, 32766, 32767, 32767
+};
+
+//cos and sin of 2 pi a / FFT_N_MAX, a < 3 / 4 turn
+static void Fft_Twiddle(uint16_t a, int16_t *c, int16_t *s)
+{
+	uint16_t r = a & (FFT_N_MAX / 4 - 1);
+
+	switch(a / (FFT_N_MAX / 4))
+	{
+	case 0:
+		*s = fft_sin[r];
+		*c = fft_sin[FFT_N_MAX / 4 - r];
+		break;
+	case 1:
+		*s = fft_sin[FFT_N_MAX / 4 - r];
+		*c = -fft_sin[r];
+		break;
+	default:
+		*s = -fft_sin[r];
+		*c = -fft_sin[FFT_N_MAX / 4 - r];
+		break;
+	}
+}
+
+static int32_t Fft_Shift(int32_t v, uint8_t s)
+{
+	return s ? (v + (1 << (s - 1))) >> s : v;
+}
+
+static int32_t Fft_Abs(int32_t v)
+{
+	return v < 0 ? -v : v;
+}
+
+/*****************************************************************************
+ * @name       :void Fft_Hann(int16_t *x, uint16_t n)
+ * @date       :2026-10-19
+ * @function   :Apply a Hann window in place, w = (1 - cos(2 pi i / n)) / 2
+ * @parameters :x:samples, Q15
+                n:number of samples, power of two, FFT_N_MIN..FFT_N_MAX
+ * @retvalue   :None
+******************************************************************************/
+void Fft_Hann(int16_t *x, uint16_t n)
+{
+	uint16_t i, step = FFT_N_MAX / n;
+	int16_t c, s;
+	int32_t w;
+
+	for(i = 0; i <= n / 2; i++)
+	{
+		Fft_Twiddle(i * step, &c, &s);
+		w = (32768 - c) >> 1;
+		x[i] = (x[i] * w + 16384) >> 15;
+		if(i != 0 && i != n / 2)
+			x[n - i] = (x[n - i] * w + 16384) >> 15;
+	}
+}
+
+//one radix-2 pass over bit-reversed input, returns the output peak
+static int32_t Fft_Radix2(int16_t *z, uint16_t m, uint8_t sh)
+{
+	int32_t ar, ai, br, bi, peak = 0;
+	uint16_t i;
+
+	for(i = 0; i < 2 * m; i += 4)
+	{
+		ar = z[i];
+		ai = z[i + 1];
+		br = z[i + 2];
+		bi = z[i + 3];
+		z[i] = Fft_Shift(ar + br, sh);
+		z[i + 1] = Fft_Shift(ai + bi, sh);
+		z[i + 2] = Fft_Shift(ar - br, sh);
+		z[i + 3] = Fft_Shift(ai - bi, sh);
+		peak |= Fft_Abs(z[i]) | Fft_Abs(z[i + 1]) | Fft_Abs(z[i + 2]) | Fft_Abs(z[i + 3]);
+	}
+	return peak;
+}
+
+/*****************************************************************************
+ * @name       :static int32_t Fft_Radix4(int16_t *z, uint16_t m, uint16_t h, uint8_t sh)
+ * @date       :2026-10-19
+ * @function   :One radix-2^2 pass: merges the radix-2 passes of span h and
+                2h. With W = e^(-2 pi i j / 4h) and a, b, c, d at j, j + h,
+                j + 2h, j + 3h:
+                  A = a + W^2 b + (W c + W^3 d)      C = a + W^2 b - (...)
+                  B = a - W^2 b - i (W c - W^3 d)    D = a - W^2 b + i (...)
+ * @parameters :z:complex points, interleaved
+                m:number of complex points
+                h:span of the first merged radix-2 pass
+                sh:right shift applied to the outputs
+ * @retvalue   :OR of the output magnitudes, for the next pass's shift
+******************************************************************************/
+static int32_t Fft_Radix4(int16_t *z, uint16_t m, uint16_t h, uint8_t sh)
+{
+	int32_t ar, ai, br, bi, cr, ci, dr, di, tr, ti, ur, ui, peak = 0;
+	uint16_t g, j, step = FFT_N_MAX / (4 * h);
+	int16_t c1, s1, c2, s2, c3, s3, *p;
+
+	for(j = 0; j < h; j++)
+	{
+		Fft_Twiddle(2 * j * step, &c1, &s1);
+		Fft_Twiddle(j * step, &c2, &s2);
+		Fft_Twiddle(3 * j * step, &c3, &s3);
+		for(g = j; g < m; g += 4 * h)
+		{
+			p = &z[2 * g];
+			ar = p[0];
+			ai = p[1];
+			//x W, W = c - i s
+			br = (p[2 * h] * c1 + p[2 * h + 1] * s1 + 16384) >> 15;
+			bi = (p[2 * h + 1] * c1 - p[2 * h] * s1 + 16384) >> 15;
+			cr = (p[4 * h] * c2 + p[4 * h + 1] * s2 + 16384) >> 15;
+			ci = (p[4 * h + 1] * c2 - p[4 * h] * s2 + 16384) >> 15;
+			dr = (p[6 * h] * c3 + p[6 * h + 1] * s3 + 16384) >> 15;
+			di = (p[6 * h + 1] * c3 - p[6 * h] * s3 + 16384) >> 15;
+			tr = cr + dr;
+			ti = ci + di;
+			ur = cr - dr;
+			ui = ci - di;
+			p[0] = Fft_Shift(ar + br + tr, sh);
+			p[1] = Fft_Shift(ai + bi + ti, sh);
+			p[4 * h] = Fft_Shift(ar + br - tr, sh);
+			p[4 * h + 1] = Fft_Shift(ai + bi - ti, sh);
+			p[2 * h] = Fft_Shift(ar - br + ui, sh);
+			p[2 * h + 1] = Fft_Shift(ai - bi - ur, sh);
+			p[6 * h] = Fft_Shift(ar - br - ui, sh);
+			p[6 * h + 1] = Fft_Shift(ai - bi + ur, sh);
+			peak |= Fft_Abs(p[0]) | Fft_Abs(p[1]) | Fft_Abs(p[2 * h]) | Fft_Abs(p[2 * h + 1]) |
+			        Fft_Abs(p[4 * h]) | Fft_Abs(p[4 * h + 1]) | Fft_Abs(p[6 * h]) | Fft_Abs(p[6 * h + 1]);
+		}
+	}
+	return peak;
+}
+
+/*****************************************************************************
+ * @name       :uint8_t Fft_Real(int16_t *x, uint16_t n)
+ * @date       :2026-10-19
+ * @function   :Real FFT in place. On return the buffer holds n / 2 uint32_t
+                bin powers |X[k] / 2|^2, k = 0..n/2-1 (Nyquist dropped),
+                each to be scaled by 4^exp.
+ * @parameters :x:n samples, Q15, 4-byte aligned
+                n:power of two, FFT_N_MIN..FFT_N_MAX
+ * @retvalue   :block exponent exp
+******************************************************************************/
+uint8_t Fft_Real(int16_t *x, uint16_t n)
+{
+	uint32_t *w = (uint32_t *)x, t;
+	uint16_t m = n / 2, i, k, h;
+	uint8_t bits = 31 - __CLZ(m), exp = 0, sh;
+	int32_t peak = 0, er, ei, qr, qi, vr, vi, xr, xi;
+	int16_t c, s;
+
+	//complex FFT of m points
+	for(i = 0; i < m; i++)
+	{
+		k = __RBIT(i) >> (32 - bits);
+		if(k > i)
+		{
+			t = w[i];
+			w[i] = w[k];
+			w[k] = t;
+		}
+	}
+	for(i = 0; i < n; i++)
+		peak |= Fft_Abs(x[i]);
+	h = 1;
+	if(bits & 1)
+	{
+		//growth <= 1 + sqrt(2)
+		sh = peak < 13573 ? 0 : peak < 27146 ? 1 : 2;
+		peak = Fft_Radix2(x, m, sh);
+		exp += sh;
+		h = 2;
+	}
+	for(; h < m; h *= 4)
+	{
+		//growth <= 1 + 3 sqrt(2)
+		sh = peak < 6249 ? 0 : peak < 12498 ? 1 : peak < 24996 ? 2 : 3;
+		peak = Fft_Radix4(x, m, h, sh);
+		exp += sh;
+	}
+
+	//split: X[k] = E + W^k O, X[m-k] = conj(E - W^k O), with
+	//E = (Z[k] + conj Z[m-k]) / 2, O = -i (Z[k] - conj Z[m-k]) / 2;
+	//e = 2E and q = 2O below, the powers are of X / 2
+	xr = x[0] + x[1];
+	w[0] = (uint32_t)xr * (uint32_t)xr >> 2;
+	for(k = 1; k <= m / 2; k++)
+	{
+		er = x[2 * k] + x[2 * (m - k)];
+		ei = x[2 * k + 1] - x[2 * (m - k) + 1];
+		qr = x[2 * k + 1] + x[2 * (m - k) + 1];        //-i (Z[k] - conj Z[m-k])
+		qi = x[2 * (m - k)] - x[2 * k];
+		Fft_Twiddle(k * (FFT_N_MAX / n), &c, &s);
+		vr = (int32_t)(((int64_t)qr * c + (int64_t)qi * s + 16384) >> 15);
+		vi = (int32_t)(((int64_t)qi * c - (int64_t)qr * s + 16384) >> 15);
+		xr = (er + vr) >> 2;
+		xi = (ei + vi) >> 2;
+		w[k] = (uint32_t)xr * (uint32_t)xr + (uint32_t)xi * (uint32_t)xi;
+		xr = (er - vr) >> 2;
+		xi = (ei - vi) >> 2;
+		w[m - k] = (uint32_t)xr * (uint32_t)xr + (uint32_t)xi * (uint32_t)xi;
+	}
+	return exp;
+}
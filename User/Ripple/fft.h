@@ -0,0 +1,18 @@
+#ifndef __FFT_H
+#define __FFT_H
+#include "main.h"
+
+//Q15 real FFT. N real samples are packed as N/2 complex points (even
+//samples real, odd imaginary), transformed by a radix-2^2 decimation in
+//time FFT (radix-4 butterflies with three twiddle multiplies, plus one
+//radix-2 pass when log2(N/2) is odd) and split into the real spectrum.
+//Block floating point: every pass shifts right only as far as the peak of
+//its input requires, the shifts add up to the returned block exponent.
+//All twiddles come from one quarter-wave sine table for FFT_N_MAX.
+#define FFT_N_MAX           1024
+#define FFT_N_MIN           16
+
+void Fft_Hann(int16_t *x, uint16_t n);
+uint8_t Fft_Real(int16_t *x, uint16_t n);
+
+#endif
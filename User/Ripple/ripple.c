@@ -0,0 +1,270 @@
+#include "ripple.h"
+#include "clock.h"
+#include "cal.h"
+#include "tile.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define RIPPLE_IDLE         0
+#define RIPPLE_WAIT         1
+#define RIPPLE_BURST        2
+
+static const char * const ripple_name[ACQ_CH_NUM] = {"i4a", "i100m", "uin", "bat"};
+static const char * const ripple_unit[ACQ_CH_NUM] = {"mA", "uA", "mV", "mV"};
+
+//raw samples, then bin powers; the display strips, borrowed for the analysis
+#if TILE_PIXELS < FFT_N_MAX / 2
+#error the tile strips are too small for FFT_N_MAX
+#endif
+static uint32_t *ripple_buf;
+static ripple_result_t result;
+static uint8_t state, tries, valid;
+static uint8_t req_ch;
+static uint16_t req_n;
+static sched_timer_t ripple_timer;
+
+static uint32_t Ripple_Sqrt(uint64_t v)
+{
+	uint64_t r = 0, bit = 1ULL << 62;
+
+	while(bit > v)
+		bit >>= 2;
+	for(; bit; bit >>= 2)
+	{
+		if(v >= r + bit)
+		{
+			v -= r + bit;
+			r = (r >> 1) + bit;
+		}
+		else
+			r >>= 1;
+	}
+	return (uint32_t)r;
+}
+
+//raw counts in Q8 to channel units, slope of the calibration around mid
+static int32_t Ripple_Units(uint8_t ch, uint16_t mid, uint64_t q8)
+{
+	uint16_t lo = mid > 64 ? mid - 64 : 0;
+	int32_t d;
+
+	if(lo > 4095 - 128)
+		lo = 4095 - 128;
+	d = Cal_Apply(ch, lo + 128) - Cal_Apply(ch, lo);
+	return (int32_t)(((int64_t)q8 * d + (64 << 8)) / (128 << 8));
+}
+
+/*****************************************************************************
+ * @name       :static void Ripple_Analyse(uint32_t rate)
+ * @date       :2026-10-19
+ * @function   :Turn the captured block into the result: mean and range,
+                window and FFT, then rms over all bins and the strongest
+                local maxima. With P the bin powers |X / 2|^2 and e the
+                block exponent, a Hann-windowed block of 8 x counts gives
+                  rms = 0.577 sqrt(sum P) 2^e / n counts
+                and a tone of amplitude sqrt(2) rms over its main lobe.
+ * @parameters :rate:sample rate, Hz
+ * @retvalue   :None
+******************************************************************************/
+static void Ripple_Analyse(uint32_t rate)
+{
+	uint16_t *raw = (uint16_t *)ripple_buf;
+	int16_t *x = (int16_t *)ripple_buf;
+	uint32_t *p = ripple_buf, sum = 0, start;
+	uint16_t n = req_n, lo = 0xFFFF, hi = 0, mid, i, k, j, bins[RIPPLE_PEAKS];
+	uint64_t total = 0, e, c;
+	uint8_t exp, np = 0;
+
+	for(i = 0; i < n; i++)
+	{
+		sum += raw[i];
+		if(raw[i] < lo)
+			lo = raw[i];
+		if(raw[i] > hi)
+			hi = raw[i];
+	}
+	mid = sum / n;
+	for(i = 0; i < n; i++)
+		x[i] = (int16_t)(((int32_t)raw[i] - mid) * 8);     //+-4095 counts to Q15
+	start = DWT->CYCCNT;
+	Fft_Hann(x, n);
+	exp = Fft_Real(x, n);
+	result.cycles = DWT->CYCCNT - start;
+
+	for(k = RIPPLE_SKIP_BINS; k < n / 2; k++)
+		total += p[k];
+	//local maxima above -30 dB of the total AC power, strongest first
+	for(k = RIPPLE_SKIP_BINS; k < n / 2 - 1; k++)
+	{
+		if(p[k] <= p[k - 1] || p[k] < p[k + 1] || ((uint64_t)p[k] << 10) <= total)
+			continue;
+		if(np < RIPPLE_PEAKS)
+			np++;
+		else if(p[k] <= p[bins[np - 1]])
+			continue;
+		for(j = np - 1; j > 0 && p[bins[j - 1]] < p[k]; j--)
+			bins[j] = bins[j - 1];
+		bins[j] = k;
+	}
+
+	result.ch = req_ch;
+	result.n = n;
+	result.rate_hz = rate;
+	result.pp = Ripple_Units(req_ch, mid, (uint64_t)(hi - lo) << 8);
+	result.rms = Ripple_Units(req_ch, mid, ((uint64_t)Ripple_Sqrt(total) * 148 << exp) / n);  //0.577 in Q8
+	result.peaks = np;
+	for(i = 0; i < np; i++)
+	{
+		e = c = 0;
+		for(j = bins[i] - RIPPLE_LOBE; j <= bins[i] + RIPPLE_LOBE; j++)
+			if(j >= RIPPLE_SKIP_BINS && j < n / 2)
+			{
+				e += p[j];
+				c += (uint64_t)p[j] * j;
+			}
+		result.peak[i].hz = (uint32_t)((c * 256 / e * rate / n + 128) >> 8);
+		result.peak[i].amp = Ripple_Units(req_ch, mid, ((uint64_t)Ripple_Sqrt(e) * 209 << exp) / n);  //0.816
+	}
+}
+
+static void Ripple_Finish(void)
+{
+	state = RIPPLE_IDLE;
+	if(ripple_buf)
+		Tile_Return();
+	ripple_buf = NULL;
+	Clock_Require(CLOCK_USER_RIPPLE, CLOCK_IDLE);
+}
+
+/*****************************************************************************
+ * @name       :void Ripple_Start(uint8_t ch, uint16_t n)
+ * @date       :2026-10-19
+ * @function   :Start an analysis: requests the full clock profile and
+                captures once it runs, the report is printed when done
+ * @parameters :ch:ACQ_CH_x
+                n:block size, power of two, FFT_N_MIN..FFT_N_MAX
+ * @retvalue   :None
+******************************************************************************/
+void Ripple_Start(uint8_t ch, uint16_t n)
+{
+	if(state != RIPPLE_IDLE)
+	{
+		printf("ripple busy\r\n");
+		return;
+	}
+	req_ch = ch;
+	req_n = n;
+	tries = 0;
+	state = RIPPLE_WAIT;
+	Clock_Require(CLOCK_USER_RIPPLE, CLOCK_FULL);
+	Sched_TimerStart(&ripple_timer, RIPPLE_TASK, RIPPLE_SIG_WAIT, RIPPLE_WAIT_MS, 0);
+}
+
+/*****************************************************************************
+ * @name       :void Ripple_Process(uint8_t sig, uint32_t arg)
+ * @date       :2026-10-19
+ * @function   :RIPPLE_TASK handler for RIPPLE_SIG_WAIT and RIPPLE_SIG_DONE
+ * @parameters :sig:RIPPLE_SIG_x
+                arg:RIPPLE_SIG_DONE: 1 if the block is complete
+ * @retvalue   :None
+******************************************************************************/
+void Ripple_Process(uint8_t sig, uint32_t arg)
+{
+	static uint32_t rate;
+
+	if(sig == RIPPLE_SIG_WAIT && state == RIPPLE_WAIT)
+	{
+		if(!ripple_buf)
+			ripple_buf = Tile_Lend();
+		//a profile switch in the middle of the block would change the rate
+		if((!ripple_buf || Clock_GetProfile() != CLOCK_FULL) && ++tries < RIPPLE_WAIT_TRIES)
+		{
+			Sched_TimerStart(&ripple_timer, RIPPLE_TASK, RIPPLE_SIG_WAIT, RIPPLE_WAIT_MS, 0);
+			return;
+		}
+		if(!ripple_buf)
+		{
+			printf("ripple: no buffer\r\n");
+			Ripple_Finish();
+			return;
+		}
+		rate = Acq_BurstRate();
+		if(Acq_Burst(req_ch, (uint16_t *)ripple_buf, req_n, RIPPLE_TASK, RIPPLE_SIG_DONE) == HAL_OK)
+			state = RIPPLE_BURST;
+		else
+		{
+			printf("ripple: sampling is stopped or a fast capture holds the ADC\r\n");
+			Ripple_Finish();
+		}
+	}
+	else if(sig == RIPPLE_SIG_DONE && state == RIPPLE_BURST)
+	{
+		if(arg)
+		{
+			Ripple_Analyse(rate);
+			valid = 1;
+			Ripple_Report();
+		}
+		else
+			printf("ripple: capture aborted\r\n");
+		Ripple_Finish();
+	}
+}
+
+uint8_t Ripple_Get(ripple_result_t *r)
+{
+	if(valid)
+		*r = result;
+	return valid;
+}
+
+/*****************************************************************************
+ * @name       :void Ripple_Command(const char *args)
+ * @date       :2026-10-19
+ * @function   :Console front end: "<ch> [n]" starts an analysis of one
+                input, nothing prints the last result
+ * @parameters :args:text after the command name
+ * @retvalue   :None
+******************************************************************************/
+void Ripple_Command(const char *args)
+{
+	const char *p = strchr(args, ' ');
+	size_t len = p ? (size_t)(p - args) : strlen(args);
+	uint32_t n = p ? strtoul(p + 1, NULL, 10) : RIPPLE_N_DEFAULT;
+	uint8_t ch;
+
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+		if(len && strlen(ripple_name[ch]) == len && strncmp(args, ripple_name[ch], len) == 0)
+			break;
+	if(ch == ACQ_CH_NUM)
+		Ripple_Report();
+	else if(n < FFT_N_MIN || n > FFT_N_MAX || (n & (n - 1)))
+		printf("ripple: n is a power of two, %u..%u\r\n", FFT_N_MIN, FFT_N_MAX);
+	else
+		Ripple_Start(ch, n);
+}
+
+/*****************************************************************************
+ * @name       :void Ripple_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print the last analysis over stdout
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Ripple_Report(void)
+{
+	const char *u = ripple_unit[result.ch];
+	uint8_t i;
+
+	if(!valid)
+	{
+		printf("ripple: no analysis yet, 'ripple <i4a|i100m|uin|bat> [n]'\r\n");
+		return;
+	}
+	printf("ripple %s  n %u at %lu Hz  bin %lu Hz  fft %lu cycles\r\n", ripple_name[result.ch], result.n,
+	       (unsigned long)result.rate_hz, (unsigned long)(result.rate_hz / result.n), (unsigned long)result.cycles);
+	printf("rms %ld %s  pp %ld %s\r\n", (long)result.rms, u, (long)result.pp, u);
+	for(i = 0; i < result.peaks; i++)
+		printf("%7lu Hz %6ld %s\r\n", (unsigned long)result.peak[i].hz, (long)result.peak[i].amp, u);
+}
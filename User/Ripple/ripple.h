@@ -0,0 +1,50 @@
+#ifndef __RIPPLE_H
+#define __RIPPLE_H
+#include "main.h"
+#include "sched.h"
+#include "acq.h"
+#include "fft.h"
+
+//On-demand ripple and noise analysis. One input is captured back to back
+//at the full ADC rate (Acq_Burst()) with the clock at its full profile,
+//the block mean is removed, the rest Hann windowed and transformed by the
+//Q15 real FFT. Reported: AC rms and peak-to-peak of the block and the
+//strongest spectral peaks with frequency (power-weighted centre of the
+//main lobe) and amplitude (from the lobe's energy, so it does not depend
+//on where the tone falls between bins), in channel units.
+#define RIPPLE_TASK         SCHED_TASK_TELEM
+#define RIPPLE_SIG_WAIT     1       //timer: waiting for the full clock profile
+#define RIPPLE_SIG_DONE     2       //message from Acq_Burst(), arg = complete
+
+#define RIPPLE_N_DEFAULT    1024
+#define RIPPLE_PEAKS        5
+#define RIPPLE_LOBE         2       //Hann main lobe: peak bin +-2
+#define RIPPLE_SKIP_BINS    3       //DC and its window leakage
+#define RIPPLE_WAIT_MS      2
+#define RIPPLE_WAIT_TRIES   50      //then capture at whatever clock runs
+
+typedef struct
+{
+	uint32_t hz;
+	int32_t amp;                    //amplitude (peak), channel units
+} ripple_peak_t;
+
+typedef struct
+{
+	uint8_t ch;                     //ACQ_CH_x
+	uint8_t peaks;                  //valid entries in peak[], strongest first
+	uint16_t n;                     //samples
+	uint32_t rate_hz;
+	uint32_t cycles;                //window + FFT + split
+	int32_t rms;                    //AC rms, channel units
+	int32_t pp;                     //peak-to-peak, channel units
+	ripple_peak_t peak[RIPPLE_PEAKS];
+} ripple_result_t;
+
+void Ripple_Start(uint8_t ch, uint16_t n);
+void Ripple_Process(uint8_t sig, uint32_t arg);
+uint8_t Ripple_Get(ripple_result_t *r);
+void Ripple_Command(const char *args);
+void Ripple_Report(void);
+
+#endif
@@ -0,0 +1,355 @@
+#include "sched.h"
+#include "lpm.h"
+#include <stdio.h>
+
+typedef struct
+{
+	uint8_t  sig;
+	uint32_t arg;
+} sched_msg_t;
+
+typedef struct
+{
+	const char *name;
+	sched_handler run;
+	volatile uint32_t signals;      //pending signal bits
+	sched_msg_t queue[SCHED_QUEUE_LEN];
+	volatile uint8_t head, tail;
+	//runtime accounting, reset by Sched_Report()
+	uint32_t runs;
+	uint64_t cycles;
+	uint32_t max_cycles;
+	uint16_t dropped;               //messages lost to a full queue
+} sched_task_t;
+
+static sched_task_t tasks[SCHED_TASK_NUM];
+static volatile uint32_t ready;         //bit n: task n has a pending event
+static sched_timer_t *wheel[SCHED_WHEEL_SLOTS];
+static uint32_t wheel_tick;             //last tick the wheel was advanced to
+static uint32_t window_ms;              //start of the accounting window
+
+/*****************************************************************************
+ * @name       :void Sched_Init(void)
+ * @date       :2026-10-19
+ * @function   :Reset all tasks and timers and start the DWT cycle counter
+                used for runtime accounting
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Sched_Init(void)
+{
+	uint8_t i;
+
+	for(i = 0; i < SCHED_TASK_NUM; i++)
+	{
+		tasks[i].name = "-";
+		tasks[i].run = NULL;
+	}
+	for(i = 0; i < SCHED_WHEEL_SLOTS; i++)
+		wheel[i] = NULL;
+	ready = 0;
+	wheel_tick = HAL_GetTick();
+	window_ms = wheel_tick;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void Sched_Register(uint8_t task, const char *name, sched_handler run)
+{
+	tasks[task].name = name;
+	tasks[task].run = run;
+}
+
+/*****************************************************************************
+ * @name       :void Sched_Signal(uint8_t task, uint8_t sig)
+ * @date       :2026-10-19
+ * @function   :Raise a signal bit on a task. Repeated signals before the
+                task runs are merged. Callable from interrupts.
+ * @parameters :task:SCHED_TASK_xxx
+                sig:signal number 0..31
+ * @retvalue   :None
+******************************************************************************/
+void Sched_Signal(uint8_t task, uint8_t sig)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	tasks[task].signals |= 1UL << sig;
+	ready |= 1UL << task;
+	__set_PRIMASK(primask);
+}
+
+/*****************************************************************************
+ * @name       :HAL_StatusTypeDef Sched_Post(uint8_t task, uint8_t sig, uint32_t arg)
+ * @date       :2026-10-19
+ * @function   :Queue a message for a task. Callable from interrupts.
+ * @parameters :task:SCHED_TASK_xxx
+                sig:message type, passed to the handler
+                arg:message argument
+ * @retvalue   :HAL_BUSY when the task queue is full (the message is dropped)
+******************************************************************************/
+HAL_StatusTypeDef Sched_Post(uint8_t task, uint8_t sig, uint32_t arg)
+{
+	sched_task_t *t = &tasks[task];
+	uint32_t primask = __get_PRIMASK();
+	uint8_t next;
+
+	__disable_irq();
+	next = (t->head + 1) & (SCHED_QUEUE_LEN - 1);
+	if(next == t->tail)
+	{
+		t->dropped++;
+		__set_PRIMASK(primask);
+		return HAL_BUSY;
+	}
+	t->queue[t->head].sig = sig;
+	t->queue[t->head].arg = arg;
+	t->head = next;
+	ready |= 1UL << task;
+	__set_PRIMASK(primask);
+	return HAL_OK;
+}
+
+static void Sched_TimerLink(sched_timer_t *t)
+{
+	sched_timer_t **slot = &wheel[t->expire & (SCHED_WHEEL_SLOTS - 1)];
+
+	t->next = *slot;
+	*slot = t;
+	t->armed = 1;
+}
+
+/*****************************************************************************
+ * @name       :void Sched_TimerStop(sched_timer_t *t)
+ * @date       :2026-10-19
+ * @function   :Disarm a timer, a no-op if it is not running. Task context only.
+ * @parameters :t:timer
+ * @retvalue   :None
+******************************************************************************/
+void Sched_TimerStop(sched_timer_t *t)
+{
+	sched_timer_t **p;
+
+	if(!t->armed)
+		return;
+	for(p = &wheel[t->expire & (SCHED_WHEEL_SLOTS - 1)]; *p; p = &(*p)->next)
+	{
+		if(*p == t)
+		{
+			*p = t->next;
+			break;
+		}
+	}
+	t->armed = 0;
+}
+
+/*****************************************************************************
+ * @name       :void Sched_TimerStart(sched_timer_t *t, uint8_t task, uint8_t sig,
+                                      uint32_t delay, uint32_t period)
+ * @date       :2026-10-19
+ * @function   :(Re)arm a timer that raises 'sig' on 'task'. Task context only.
+ * @parameters :t:timer, must stay valid while armed
+                task:SCHED_TASK_xxx
+                sig:signal number
+                delay:ms until the first expiry
+                period:reload in ms, 0 for one-shot
+ * @retvalue   :None
+******************************************************************************/
+void Sched_TimerStart(sched_timer_t *t, uint8_t task, uint8_t sig, uint32_t delay, uint32_t period)
+{
+	Sched_TimerStop(t);
+	if(delay == 0)
+		delay = 1;          //the current tick's slot has already been scanned
+	t->task = task;
+	t->sig = sig;
+	t->period = period;
+	t->expire = HAL_GetTick() + delay;
+	Sched_TimerLink(t);
+}
+
+/*****************************************************************************
+ * @name       :static void Sched_Timers(void)
+ * @date       :2026-10-19
+ * @function   :Advance the wheel to the current tick. Only the slots passed
+                since the last call are scanned; after a gap longer than the
+                wheel every slot is scanned once.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+static void Sched_Timers(void)
+{
+	uint32_t now = HAL_GetTick();
+	uint32_t n = now - wheel_tick;
+	sched_timer_t **p, *t;
+
+	if(n > SCHED_WHEEL_SLOTS)
+		n = SCHED_WHEEL_SLOTS;
+	while(n--)
+	{
+		p = &wheel[++wheel_tick & (SCHED_WHEEL_SLOTS - 1)];
+		while((t = *p) != NULL)
+		{
+			if((int32_t)(now - t->expire) < 0)
+			{
+				p = &t->next;
+				continue;
+			}
+			*p = t->next;
+			t->armed = 0;
+			Sched_Signal(t->task, t->sig);
+			if(t->period)
+			{
+				t->expire += t->period;
+				if((int32_t)(now - t->expire) >= 0)
+					t->expire = now + t->period;   //overran, drop the missed ticks
+				Sched_TimerLink(t);
+			}
+		}
+	}
+	wheel_tick = now;
+}
+
+/*****************************************************************************
+ * @name       :uint8_t Sched_Dispatch(void)
+ * @date       :2026-10-19
+ * @function   :Run one event of the most urgent ready task to completion.
+                Signals are delivered before queued messages.
+ * @parameters :None
+ * @retvalue   :0 when no task was ready
+******************************************************************************/
+uint8_t Sched_Dispatch(void)
+{
+	sched_task_t *t;
+	uint32_t primask, start, d;
+	uint8_t id, sig;
+	uint32_t arg = 0;
+
+	Sched_Timers();
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if(ready == 0)
+	{
+		__set_PRIMASK(primask);
+		return 0;
+	}
+	id = __CLZ(__RBIT(ready));
+	t = &tasks[id];
+	if(t->signals)
+	{
+		sig = __CLZ(__RBIT(t->signals));
+		t->signals &= ~(1UL << sig);
+	}
+	else
+	{
+		sig = t->queue[t->tail].sig;
+		arg = t->queue[t->tail].arg;
+		t->tail = (t->tail + 1) & (SCHED_QUEUE_LEN - 1);
+	}
+	if(t->signals == 0 && t->head == t->tail)
+		ready &= ~(1UL << id);
+	__set_PRIMASK(primask);
+
+	if(t->run == NULL)
+		return 1;
+	start = DWT->CYCCNT;
+	t->run(sig, arg);
+	d = DWT->CYCCNT - start;
+	d *= SCHED_REF_HZ / SystemCoreClock;    //profiles are integer fractions of 72 MHz
+	t->runs++;
+	t->cycles += d;
+	if(d > t->max_cycles)
+		t->max_cycles = d;
+	return 1;
+}
+
+/*****************************************************************************
+ * @name       :uint32_t Sched_NextTimeout(void)
+ * @date       :2026-10-19
+ * @function   :Time until the earliest armed timer expires
+ * @parameters :None
+ * @retvalue   :ms, 0 if one is already due, 0xFFFFFFFF if none is armed
+******************************************************************************/
+uint32_t Sched_NextTimeout(void)
+{
+	uint32_t now = HAL_GetTick();
+	uint32_t best = 0xFFFFFFFF;
+	sched_timer_t *t;
+	uint8_t i;
+
+	for(i = 0; i < SCHED_WHEEL_SLOTS; i++)
+	{
+		for(t = wheel[i]; t; t = t->next)
+		{
+			if((int32_t)(t->expire - now) <= 0)
+				return 0;
+			if(t->expire - now < best)
+				best = t->expire - now;
+		}
+	}
+	return best;
+}
+
+/*****************************************************************************
+ * @name       :void Sched_Run(void)
+ * @date       :2026-10-19
+ * @function   :Scheduler main loop, never returns. When no task is ready
+                the MCU idles until the next timer deadline; the check and
+                the idle run with IRQs masked so an event raised in between
+                still ends the idle.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Sched_Run(void)
+{
+	for(;;)
+	{
+		if(Sched_Dispatch())
+			continue;
+		__disable_irq();
+		if(ready == 0)
+			LPM_Idle(Sched_NextTimeout());
+		__enable_irq();
+	}
+}
+
+/*****************************************************************************
+ * @name       :void Sched_Report(void)
+ * @date       :2026-10-19
+ * @function   :Print per-task runtime over stdout and start a new window
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Sched_Report(void)
+{
+	uint32_t now = HAL_GetTick();
+	uint32_t cyc_per_us = SCHED_REF_HZ / 1000000;
+	uint64_t window = (uint64_t)(now - window_ms) * (SCHED_REF_HZ / 1000);
+	uint64_t busy = 0;
+	sched_task_t *t;
+	uint8_t i;
+
+	if(window == 0)
+		window = 1;
+	printf("task      runs  load  max_us drop\r\n");
+	for(i = 0; i < SCHED_TASK_NUM; i++)
+	{
+		t = &tasks[i];
+		if(t->run == NULL)
+			continue;
+		printf("%-8s %5lu %3lu.%lu%% %6lu %4u\r\n", t->name, (unsigned long)t->runs,
+		       (unsigned long)(t->cycles * 1000 / window / 10), (unsigned long)(t->cycles * 1000 / window % 10),
+		       (unsigned long)(t->max_cycles / cyc_per_us), t->dropped);
+		busy += t->cycles;
+		t->runs = 0;
+		t->cycles = 0;
+		t->max_cycles = 0;
+		t->dropped = 0;
+	}
+	busy = busy < window ? window - busy : 0;      //idle plus dispatch overhead
+	printf("other          %3lu.%lu%%  window %lu ms\r\n",
+	       (unsigned long)(busy * 1000 / window / 10), (unsigned long)(busy * 1000 / window % 10),
+	       (unsigned long)(now - window_ms));
+	window_ms = now;
+}
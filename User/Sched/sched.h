@@ -0,0 +1,45 @@
+#ifndef __SCHED_H
+#define __SCHED_H
+#include "main.h"
+
+//Run-to-completion cooperative scheduler. A task is a plain handler that is
+//called once per event; the most urgent ready task (lowest id) always runs
+//next. Events are either coalescing signal bits (ISR safe, never lost) or
+//queued messages that carry an argument. Timers live on a hashed wheel
+//driven by the HAL tick and deliver signals.
+#define SCHED_TASK_ACQ        0     //acquisition post-processing
+#define SCHED_TASK_BUS        1     //I2C queue service, RTC discipline
+#define SCHED_TASK_POWER      2
+#define SCHED_TASK_LOG        3
+#define SCHED_TASK_UI         4
+#define SCHED_TASK_TELEM      5     //UART console / telemetry
+#define SCHED_TASK_NUM        6
+
+#define SCHED_QUEUE_LEN       8     //messages per task, power of two
+#define SCHED_WHEEL_SLOTS     32    //timer wheel size in ms, power of two
+#define SCHED_REF_HZ          72000000  //task cycles are counted at this core clock
+
+typedef void (*sched_handler)(uint8_t sig, uint32_t arg);
+
+typedef struct sched_timer
+{
+	uint32_t expire;                //HAL tick of the next expiry
+	uint32_t period;                //0 = one-shot
+	uint8_t  task;
+	uint8_t  sig;
+	uint8_t  armed;
+	struct sched_timer *next;
+} sched_timer_t;
+
+void Sched_Init(void);
+void Sched_Register(uint8_t task, const char *name, sched_handler run);
+void Sched_Signal(uint8_t task, uint8_t sig);
+HAL_StatusTypeDef Sched_Post(uint8_t task, uint8_t sig, uint32_t arg);
+void Sched_TimerStart(sched_timer_t *t, uint8_t task, uint8_t sig, uint32_t delay, uint32_t period);
+void Sched_TimerStop(sched_timer_t *t);
+uint8_t Sched_Dispatch(void);
+uint32_t Sched_NextTimeout(void);
+void Sched_Run(void);
+void Sched_Report(void);
+
+#endif
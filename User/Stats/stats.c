@@ -0,0 +1,360 @@
+#include "stats.h"
+#include "cal.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+	uint32_t n;
+	int32_t min, max;
+	int32_t ref;                    //first sample, keeps the sums small
+	int64_t sum;                    //sum of (x - ref)
+	int64_t sq;                     //sum of (x - ref)^2
+} stats_win_t;
+
+static const char * const stats_name[ACQ_CH_NUM] = {"i4a", "i100m", "uin", "bat"};
+static const char * const stats_unit[ACQ_CH_NUM] = {"mA", "uA", "mV", "mV"};
+static const uint16_t stats_p[STATS_Q_NUM] = {32768, 62259, 64881};    //0.50, 0.95, 0.99 in Q16
+
+static stats_win_t win[ACQ_CH_NUM];
+static stats_acc_t last[ACQ_CH_NUM];
+static stats_acc_t session[ACQ_CH_NUM];
+static stats_p2_t p2[STATS_Q_NUM];
+static uint32_t hist[STATS_HIST_BINS];
+
+static void Stats_WinClear(void)
+{
+	memset(win, 0, sizeof(win));
+}
+
+/*****************************************************************************
+ * @name       :static void Stats_WinClose(uint8_t ch)
+ * @date       :2026-10-19
+ * @function   :Turn the exact window sums into mean and squared deviations
+                and merge them into the session (Chan's form of the Welford
+                update)
+ * @parameters :ch:channel
+ * @retvalue   :None
+******************************************************************************/
+static void Stats_WinClose(uint8_t ch)
+{
+	stats_win_t *w = &win[ch];
+	stats_acc_t *b = &last[ch], *a = &session[ch];
+	int64_t d, t, q;
+	uint32_t n;
+
+	if(w->n == 0)
+		return;
+	b->n = w->n;
+	b->min = w->min;
+	b->max = w->max;
+	b->mean = ((int64_t)w->ref << 16) + (w->sum << 16) / w->n;
+	//sq - sum^2 / n, split so the square cannot overflow
+	b->m2 = w->sq - (w->sum * (w->sum / w->n) + w->sum * (w->sum % w->n) / w->n);
+	if(a->n == 0)
+	{
+		*a = *b;
+		return;
+	}
+	n = a->n + b->n;
+	d = b->mean - a->mean;
+	//delta^2 in units^2, Q16; at full resolution below 32768 units
+	if(d > -((int64_t)1 << 31) && d < ((int64_t)1 << 31))
+		t = (d * d) >> 16;
+	else
+		t = (d >> 8) * (d >> 8);
+	a->mean += d * b->n / n;
+	//between-window term t * b->n * a->n / n, split like the one above,
+	//for the whole units^2 and then for the fraction, which matters when
+	//the windows differ by a unit or two
+	q = (t >> 16) * b->n;
+	a->m2 += b->m2 + q / n * a->n + (int64_t)((uint64_t)(q % n) * a->n / n);
+	q = (t & 0xFFFF) * b->n;
+	a->m2 += (q / n * a->n + (int64_t)((uint64_t)(q % n) * a->n / n)) >> 16;
+	a->n = n;
+	if(b->min < a->min)
+		a->min = b->min;
+	if(b->max > a->max)
+		a->max = b->max;
+}
+
+static void Stats_P2Init(stats_p2_t *e, uint16_t p)
+{
+	memset(e, 0, sizeof(*e));
+	e->f[1] = p >> 1;
+	e->f[2] = p;
+	e->f[3] = (65536 + p) >> 1;
+	e->f[4] = 65536;
+}
+
+//rounded division, b > 0: truncating steps would drag the P2 markers down
+static int64_t Stats_Div(int64_t a, int32_t b)
+{
+	return (a >= 0 ? a + b / 2 : a - b / 2) / b;
+}
+
+/*****************************************************************************
+ * @name       :static void Stats_P2Add(stats_p2_t *e, int32_t x)
+ * @date       :2026-10-19
+ * @function   :P2 quantile update (Jain/Chlamtac): five markers, the middle
+                three move by one position at most per sample along a
+                parabola through their neighbours
+ * @parameters :e:estimator
+                x:sample, uA
+ * @retvalue   :None
+******************************************************************************/
+static void Stats_P2Add(stats_p2_t *e, int32_t x)
+{
+	int32_t *q = e->q, *n = e->pos, qp;
+	int64_t d, a, b;
+	int8_t s;
+	uint8_t i, k;
+
+	x <<= 8;
+	if(e->count < 5)
+	{
+		for(i = e->count; i > 0 && q[i - 1] > x; i--)
+			q[i] = q[i - 1];
+		q[i] = x;
+		n[e->count] = e->count;
+		e->count++;
+		return;
+	}
+	if(x < q[0])
+	{
+		q[0] = x;
+		k = 0;
+	}
+	else if(x >= q[4])
+	{
+		q[4] = x;
+		k = 3;
+	}
+	else
+		for(k = 0; x >= q[k + 1]; k++);
+	for(i = k + 1; i < 5; i++)
+		n[i]++;
+	e->count++;
+	for(i = 1; i < 4; i++)
+	{
+		d = (int64_t)(e->count - 1) * e->f[i] - ((int64_t)n[i] << 16);
+		if(!((d >= 65536 && n[i + 1] - n[i] > 1) || (d <= -65536 && n[i] - n[i - 1] > 1)))
+			continue;
+		s = d > 0 ? 1 : -1;
+		//parabolic prediction
+		a = Stats_Div((int64_t)(n[i] - n[i - 1] + s) * (q[i + 1] - q[i]), n[i + 1] - n[i]);
+		b = Stats_Div((int64_t)(n[i + 1] - n[i] - s) * (q[i] - q[i - 1]), n[i] - n[i - 1]);
+		qp = q[i] + (int32_t)Stats_Div(s * (a + b), n[i + 1] - n[i - 1]);
+		if(q[i - 1] < qp && qp < q[i + 1])
+			q[i] = qp;
+		else                            //linear towards the neighbour
+			q[i] += (int32_t)Stats_Div(q[i + s] - q[i], s * (n[i + s] - n[i]));
+		n[i] += s;
+	}
+}
+
+static uint8_t Stats_Bin(int32_t x)
+{
+	uint8_t e;
+
+	if(x < STATS_HIST_SUB)
+		return x < 0 ? 0 : x;
+	e = 31 - __CLZ(x);                      //x >= 4: e >= 2
+	e = (e - 1) * STATS_HIST_SUB + ((x >> (e - 2)) & (STATS_HIST_SUB - 1));
+	return e < STATS_HIST_BINS ? e : STATS_HIST_BINS - 1;
+}
+
+uint32_t Stats_HistLow(uint8_t bin)
+{
+	if(bin < STATS_HIST_SUB)
+		return bin;
+	return (uint32_t)(STATS_HIST_SUB + (bin & (STATS_HIST_SUB - 1))) << (bin / STATS_HIST_SUB - 1);
+}
+
+uint32_t Stats_HistBin(uint8_t bin)
+{
+	return bin < STATS_HIST_BINS ? hist[bin] : 0;
+}
+
+void Stats_Reset(void)
+{
+	uint8_t i;
+
+	Stats_WinClear();
+	memset(last, 0, sizeof(last));
+	memset(session, 0, sizeof(session));
+	memset(hist, 0, sizeof(hist));
+	for(i = 0; i < STATS_Q_NUM; i++)
+		Stats_P2Init(&p2[i], stats_p[i]);
+}
+
+void Stats_Init(void)
+{
+	Stats_Reset();
+}
+
+/*****************************************************************************
+ * @name       :void Stats_Block(uint16_t (*f)[ACQ_CH_NUM], uint8_t n)
+ * @date       :2026-10-19
+ * @function   :Feed every frame of an acquisition block. Called by
+                Acq_Process() with the DMA half that just completed.
+ * @parameters :f:frames
+                n:number of frames
+ * @retvalue   :None
+******************************************************************************/
+void Stats_Block(uint16_t (*f)[ACQ_CH_NUM], uint8_t n)
+{
+	stats_win_t *w;
+	int32_t v[ACQ_CH_NUM], x, cur;
+	uint8_t i, ch, q;
+
+	for(i = 0; i < n; i++)
+	{
+		for(ch = 0; ch < ACQ_CH_NUM; ch++)
+		{
+			w = &win[ch];
+			v[ch] = Cal_Apply(ch, f[i][ch]);
+			if(w->n == 0)
+			{
+				w->ref = w->min = w->max = v[ch];
+			}
+			else if(v[ch] < w->min)
+				w->min = v[ch];
+			else if(v[ch] > w->max)
+				w->max = v[ch];
+			x = v[ch] - w->ref;
+			w->sum += x;
+			w->sq += (int64_t)x * x;
+			w->n++;
+		}
+		cur = f[i][ACQ_CH_I100MA] < STATS_RANGE_RAW ? v[ACQ_CH_I100MA] : v[ACQ_CH_I4A] * 1000;
+		hist[Stats_Bin(cur)]++;
+		for(q = 0; q < STATS_Q_NUM; q++)
+			Stats_P2Add(&p2[q], cur);
+		if(win[0].n == STATS_WINDOW_N)
+		{
+			for(ch = 0; ch < ACQ_CH_NUM; ch++)
+				Stats_WinClose(ch);
+			Stats_WinClear();
+		}
+	}
+}
+
+void Stats_Get(uint8_t ch, uint8_t which, stats_acc_t *a)
+{
+	*a = which == STATS_SESSION ? session[ch] : last[ch];
+}
+
+int32_t Stats_Mean(const stats_acc_t *a)
+{
+	return (int32_t)((a->mean + 32768) >> 16);
+}
+
+uint32_t Stats_Std(const stats_acc_t *a)
+{
+	uint64_t v, r = 0, bit = 1ULL << 62;
+
+	if(a->n < 2 || a->m2 <= 0)
+		return 0;
+	v = (uint64_t)a->m2 / (a->n - 1);
+	while(bit > v)
+		bit >>= 2;
+	for(; bit; bit >>= 2)
+	{
+		if(v >= r + bit)
+		{
+			v -= r + bit;
+			r = (r >> 1) + bit;
+		}
+		else
+			r >>= 1;
+	}
+	return (uint32_t)r;
+}
+
+/*****************************************************************************
+ * @name       :int32_t Stats_Quantile(uint8_t q)
+ * @date       :2026-10-19
+ * @function   :Session quantile of the load current
+ * @parameters :q:STATS_P50, STATS_P95 or STATS_P99
+ * @retvalue   :estimate in uA, 0 before the first sample
+******************************************************************************/
+int32_t Stats_Quantile(uint8_t q)
+{
+	const stats_p2_t *e = &p2[q];
+
+	if(e->count == 0)
+		return 0;
+	if(e->count < 5)
+		return (e->q[((e->count - 1) * e->f[2] + 32768) >> 16] + 128) >> 8;
+	return (e->q[2] + 128) >> 8;
+}
+
+/*****************************************************************************
+ * @name       :void Stats_Report(uint8_t which)
+ * @date       :2026-10-19
+ * @function   :Print count, min, mean, max and standard deviation of every
+                channel, then the current quantiles
+ * @parameters :which:STATS_WIN or STATS_SESSION
+ * @retvalue   :None
+******************************************************************************/
+void Stats_Report(uint8_t which)
+{
+	stats_acc_t a;
+	uint8_t ch;
+
+	printf("stats %s  n %lu\r\n", which == STATS_SESSION ? "session" : "last window",
+	       (unsigned long)(which == STATS_SESSION ? session[0].n : last[0].n));
+	for(ch = 0; ch < ACQ_CH_NUM; ch++)
+	{
+		Stats_Get(ch, which, &a);
+		printf("%-5s %ld/%ld/%ld sd %lu %s\r\n", stats_name[ch], (long)a.min, (long)Stats_Mean(&a),
+		       (long)a.max, (unsigned long)Stats_Std(&a), stats_unit[ch]);
+	}
+	printf("load p50 %ld  p95 %ld  p99 %ld uA\r\n", (long)Stats_Quantile(STATS_P50),
+	       (long)Stats_Quantile(STATS_P95), (long)Stats_Quantile(STATS_P99));
+}
+
+/*****************************************************************************
+ * @name       :void Stats_ReportHist(void)
+ * @date       :2026-10-19
+ * @function   :Print the non-empty octaves of the histogram as lower edge
+                (uA) and share of the session in 0.1 %. The four bins of an
+                octave are summed so the report fits the console buffer.
+ * @parameters :None
+ * @retvalue   :None
+******************************************************************************/
+void Stats_ReportHist(void)
+{
+	uint64_t total = 0;
+	uint32_t sum;
+	uint8_t i, j, col = 0;
+
+	for(i = 0; i < STATS_HIST_BINS; i++)
+		total += hist[i];
+	if(total == 0)
+		return;
+	for(i = 0; i < STATS_HIST_BINS; i += STATS_HIST_SUB)
+	{
+		for(sum = 0, j = 0; j < STATS_HIST_SUB; j++)
+			sum += hist[i + j];
+		if(sum == 0)
+			continue;
+		printf("%7lu:%4lu%s", (unsigned long)Stats_HistLow(i), (unsigned long)(sum * 1000ULL / total),
+		       ++col % 6 ? " " : "\r\n");
+	}
+	if(col % 6)
+		printf("\r\n");
+}
+
+void Stats_Command(const char *args)
+{
+	if(strcmp(args, "reset") == 0)
+		Stats_Reset();
+	else if(strcmp(args, "win") == 0)
+		Stats_Report(STATS_WIN);
+	else if(strcmp(args, "hist") == 0)
+		Stats_ReportHist();
+	else
+		Stats_Report(STATS_SESSION);
+}
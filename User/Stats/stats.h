@@ -0,0 +1,58 @@
+#ifndef __STATS_H
+#define __STATS_H
+#include "main.h"
+#include "acq.h"
+
+//Streaming statistics over every acquisition frame, in constant memory.
+//Per channel (calibrated units): count, min, max, mean and variance for the
+//running window, the last completed window and the session. Inside a
+//window the samples are summed exactly as integers, shifted by the window's
+//first sample; each closed window is merged into the session with the
+//Welford/Chan update, so the session needs no per-sample division.
+//The load current, autoranged to uA (I_100mA range until it nears full
+//scale), also feeds a log-scale histogram and P2 estimators for p50, p95
+//and p99 over the session.
+#define STATS_WINDOW_S      60
+#define STATS_WINDOW_N      (STATS_WINDOW_S * ACQ_RATE_HZ)     //exact sums stay in 64 bits up to 65536
+#define STATS_RANGE_RAW     ACQ_RANGE_RAW
+#define STATS_HIST_SUB      4       //bins per octave
+#define STATS_HIST_BINS     88      //up to 2^22 uA
+
+#define STATS_P50           0
+#define STATS_P95           1
+#define STATS_P99           2
+#define STATS_Q_NUM         3
+
+#define STATS_WIN           0       //last completed window
+#define STATS_SESSION       1
+
+typedef struct
+{
+	uint32_t n;
+	int32_t min, max;
+	int64_t mean;                   //Q16
+	int64_t m2;                     //sum of squared deviations
+} stats_acc_t;
+
+typedef struct
+{
+	int32_t q[5];                   //marker heights, uA Q8 (4 A fits)
+	int32_t pos[5];                 //marker positions, 0-based
+	uint32_t f[5];                  //desired position / (count - 1), Q16
+	uint32_t count;
+} stats_p2_t;
+
+void Stats_Init(void);
+void Stats_Reset(void);
+void Stats_Block(uint16_t (*f)[ACQ_CH_NUM], uint8_t n);
+void Stats_Get(uint8_t ch, uint8_t which, stats_acc_t *a);
+int32_t Stats_Mean(const stats_acc_t *a);
+uint32_t Stats_Std(const stats_acc_t *a);
+int32_t Stats_Quantile(uint8_t q);
+uint32_t Stats_HistBin(uint8_t bin);
+uint32_t Stats_HistLow(uint8_t bin);
+void Stats_Command(const char *args);
+void Stats_Report(uint8_t which);
+void Stats_ReportHist(void);
+
+#endif
@@ -14,6 +14,24 @@
 
 w25qxx_t w25qxx;
 
+/**
+ * @function: static uint8_t W25qxx_Xfer(SPI_TypeDef *Spi, uint8_t Data)
+ * @description: one byte on the registers, full duplex master; the HAL
+ *               transmit/receive pair costs 0.7 KB of flash for the same
+ * @param {SPI_TypeDef} *Spi enabled SPI
+ * @param {uint8_t} Data byte to send
+ * @return {*} byte received
+ */
+static uint8_t W25qxx_Xfer(SPI_TypeDef *Spi, uint8_t Data)
+{
+  while (!(Spi->SR & SPI_SR_TXE))
+    ;
+  *(__IO uint8_t *)&Spi->DR = Data;
+  while (!(Spi->SR & SPI_SR_RXNE))
+    ;
+  return *(__IO uint8_t *)&Spi->DR;
+}
+
 /**
  * @function: uint8_t W25qxx_Spi(uint8_t Data)
  * @description: W25qxx的spi字节读写
@@ -22,9 +40,8 @@ w25qxx_t w25qxx;
  */
 uint8_t W25qxx_Spi(uint8_t Data)
 {
-  uint8_t ret;
-  HAL_SPI_TransmitReceive(&_W25QXX_SPI, &Data, &ret, 1, 100);
-  return ret;
+  __HAL_SPI_ENABLE(&_W25QXX_SPI);     //Clock_Peripherals() leaves it off
+  return W25qxx_Xfer(_W25QXX_SPI.Instance, Data);
 }
 
 /**
@@ -36,7 +53,9 @@ uint8_t W25qxx_Spi(uint8_t Data)
  */
 void W25qxx_Receive(uint8_t *Data, uint16_t DataSize)
 {
-  HAL_SPI_Receive(&_W25QXX_SPI, Data, DataSize, 2000);
+  __HAL_SPI_ENABLE(&_W25QXX_SPI);
+  while (DataSize--)
+    *Data++ = W25qxx_Xfer(_W25QXX_SPI.Instance, 0xFF);
 }
 
 /**
@@ -205,10 +224,9 @@ void W25qxx_WaitForWriteEnd(void)
 bool W25qxx_Init(void)
 {
   w25qxx.Lock = 1;
-  while (HAL_GetTick() < 100) //启动100m后才开始初始化
+  while (HAL_GetTick() < _W25QXX_POWERUP_MS) //上电后等待tVSL再访问
     W25qxx_Delay(1);
   _W25QXX_CS_(1);
-  W25qxx_Delay(100);
   uint32_t id;
 #if (_W25QXX_DEBUG == 1)
   printf("w25qxx Init Begin...\r\n");
@@ -1118,3 +1136,88 @@ void W25qxx_ReadBlock(uint8_t *pBuffer, uint32_t Block_Address, uint32_t OffsetI
   W25qxx_Delay(100);
 #endif
 }
+
+/**
+ * @function: bool W25qxx_IsBusy(void)
+ * @description: read the BUSY bit once, does not wait
+ * @param {*}
+ * @return {true} erase/program still running
+ * @return {false} ready for the next command
+ */
+bool W25qxx_IsBusy(void)
+{
+  return (W25qxx_ReadStatusRegister(1) & 0x01) == 0x01;
+}
+
+/**
+ * @function: static void W25qxx_Address(uint32_t Address)
+ * @description: send a 3 or 4 byte address, CS must be low
+ * @param {uint32_t} Address byte address
+ * @return {*}
+ */
+static void W25qxx_Address(uint32_t Address)
+{
+  if (w25qxx.ID >= W25Q256)
+    W25qxx_Spi((Address & 0xFF000000) >> 24);
+  W25qxx_Spi((Address & 0xFF0000) >> 16);
+  W25qxx_Spi((Address & 0xFF00) >> 8);
+  W25qxx_Spi(Address & 0xFF);
+}
+
+/**
+ * @function: void W25qxx_EraseSectorStart(uint32_t SectorAddr)
+ * @description: start a sector erase and return, the chip stays busy for 45..400 ms
+ * @param {uint32_t} SectorAddr sector to erase, the chip must not be busy
+ * @return {*}
+ */
+void W25qxx_EraseSectorStart(uint32_t SectorAddr)
+{
+  _W25QXX_CS_(0);
+  W25qxx_Spi(WRITE_ENABLE);
+  _W25QXX_CS_(1);
+  _W25QXX_CS_(0);
+  W25qxx_Spi(SECTOR_ERASE);
+  W25qxx_Address(SectorAddr * w25qxx.SectorSize);
+  _W25QXX_CS_(1);
+}
+
+/**
+ * @function: void W25qxx_WritePageStart(uint8_t *pBuffer, uint32_t Page_Address, uint32_t OffsetInByte, uint32_t NumByteToWrite_up_to_PageSize)
+ * @description: start a page program and return, the chip stays busy for ~0.7 ms
+ * @param {uint8_t} *pBuffer data to write
+ * @param {uint32_t} Page_Address page to write, the chip must not be busy
+ * @param {uint32_t} OffsetInByte
+ * @param {uint32_t} NumByteToWrite_up_to_PageSize
+ * @return {*}
+ */
+void W25qxx_WritePageStart(uint8_t *pBuffer, uint32_t Page_Address, uint32_t OffsetInByte, uint32_t NumByteToWrite_up_to_PageSize)
+{
+  if (((NumByteToWrite_up_to_PageSize + OffsetInByte) > w25qxx.PageSize) || (NumByteToWrite_up_to_PageSize == 0))
+    NumByteToWrite_up_to_PageSize = w25qxx.PageSize - OffsetInByte;
+  _W25QXX_CS_(0);
+  W25qxx_Spi(WRITE_ENABLE);
+  _W25QXX_CS_(1);
+  _W25QXX_CS_(0);
+  W25qxx_Spi(PAGE_PROGRAM);
+  W25qxx_Address((Page_Address * w25qxx.PageSize) + OffsetInByte);
+  W25qxx_Transmit(pBuffer, NumByteToWrite_up_to_PageSize);
+  _W25QXX_CS_(1);
+}
+
+/**
+ * @function: void W25qxx_ReadBytesNow(uint8_t *pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
+ * @description: W25qxx_ReadBytes without the lock and the trailing delay
+ * @param {uint8_t} *pBuffer read data
+ * @param {uint32_t} ReadAddr byte address, the chip must not be busy
+ * @param {uint32_t} NumByteToRead
+ * @return {*}
+ */
+void W25qxx_ReadBytesNow(uint8_t *pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
+{
+  _W25QXX_CS_(0);
+  W25qxx_Spi(FAST_READ);
+  W25qxx_Address(ReadAddr);
+  W25qxx_Spi(0);
+  W25qxx_Receive(pBuffer, NumByteToRead);
+  _W25QXX_CS_(1);
+}
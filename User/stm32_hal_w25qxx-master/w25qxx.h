@@ -8,11 +8,12 @@ extern "C"{
 #include <stdbool.h>
 #include "spi.h"
 
-#define _W25QXX_SPI hspi1
-#define _W25QXX_CS_GPIO W25Qxx_CS_GPIO_Port
-#define _W25QXX_CS_PIN W25Qxx_CS_Pin
+#define _W25QXX_SPI hspi2
+#define _W25QXX_CS_GPIO SD_CS_GPIO_Port
+#define _W25QXX_CS_PIN SD_CS_Pin
 #define _W25QXX_USE_FREERTOS 0
 #define _W25QXX_DEBUG 0
+#define _W25QXX_POWERUP_MS 1 // tVSL is 10 us, reads (ID probe) need no longer wait
 #define _W25QXX_CS_(_x) HAL_GPIO_WritePin(_W25QXX_CS_GPIO, _W25QXX_CS_PIN, ((_x) ? GPIO_PIN_SET : GPIO_PIN_RESET))
 
 //W25qxx寄存器
@@ -96,6 +97,11 @@ extern "C"{
   void W25qxx_ReadPage(uint8_t *pBuffer, uint32_t Page_Address, uint32_t OffsetInByte, uint32_t NumByteToRead_up_to_PageSize);
   void W25qxx_ReadSector(uint8_t *pBuffer, uint32_t Sector_Address, uint32_t OffsetInByte, uint32_t NumByteToRead_up_to_SectorSize);
   void W25qxx_ReadBlock(uint8_t *pBuffer, uint32_t Block_Address, uint32_t OffsetInByte, uint32_t NumByteToRead_up_to_BlockSize);
+  // non-blocking variants: start the operation and return, poll W25qxx_IsBusy() before the next one
+  bool W25qxx_IsBusy(void);
+  void W25qxx_EraseSectorStart(uint32_t SectorAddr);
+  void W25qxx_WritePageStart(uint8_t *pBuffer, uint32_t Page_Address, uint32_t OffsetInByte, uint32_t NumByteToWrite_up_to_PageSize);
+  void W25qxx_ReadBytesNow(uint8_t *pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead);
 
 #ifdef __cplusplus
 }